@@ -101,13 +101,75 @@ namespace pcpp
 	};
 
 	/**
-	 * Computes the checksum for a vector of buffers
+	 * Computes the checksum for a vector of buffers. On x86 CPUs the checksum is computed using SSE2 or AVX2 instructions, according to
+	 * the features of the CPU the code runs on
 	 * @param[in] vec The vector of buffers
 	 * @param[in] vecSize Number of ScalarBuffers in vector
 	 * @return The checksum result
 	 */
 	uint16_t compute_checksum(ScalarBuffer<uint16_t> vec[], size_t vecSize);
 
+	/**
+	 * An enum of the implementations compute_checksum() can sum the data with
+	 */
+	enum ChecksumImplementation
+	{
+		/** Plain C++ code, available on all platforms */
+		ChecksumScalar,
+		/** SSE2 instructions */
+		ChecksumSSE2,
+		/** AVX2 instructions */
+		ChecksumAVX2
+	};
+
+	/**
+	 * @param[in] implementation A checksum implementation
+	 * @return True if the implementation is built in and the CPU the code runs on supports it, false otherwise
+	 */
+	bool isChecksumImplementationSupported(ChecksumImplementation implementation);
+
+	/**
+	 * Computes the checksum for a vector of buffers using a specific implementation instead of the one compute_checksum() selects according
+	 * to the CPU. This is mostly useful for testing and benchmarking the implementations
+	 * @param[in] vec The vector of buffers
+	 * @param[in] vecSize Number of ScalarBuffers in vector
+	 * @param[in] implementation The implementation to use
+	 * @return The checksum result, or 0 if the implementation isn't supported (see isChecksumImplementationSupported())
+	 */
+	uint16_t compute_checksum(ScalarBuffer<uint16_t> vec[], size_t vecSize, ChecksumImplementation implementation);
+
+	/**
+	 * Incrementally update an Internet checksum after some of the data it covers changed, as described in RFC 1624. This takes O(1)
+	 * time compared to recomputing the checksum over the whole data. The checksum and the data must be in the same byte order, e.g
+	 * all of them as they appear in the packet
+	 * @param[in] checksum The checksum before the change
+	 * @param[in] oldData The data before the change
+	 * @param[in] newData The data after the change
+	 * @param[in] dataLen The length of the changed data. Must be even and the data must start at an even offset of the checksummed data
+	 * @return The updated checksum
+	 */
+	uint16_t update_checksum(uint16_t checksum, const uint8_t* oldData, const uint8_t* newData, size_t dataLen);
+
+	/**
+	 * Incrementally update an Internet checksum after a 16-bit field it covers changed, as described in RFC 1624. The checksum and the
+	 * values must be in the same byte order, e.g all of them as they appear in the packet
+	 * @param[in] checksum The checksum before the change
+	 * @param[in] oldValue The field value before the change
+	 * @param[in] newValue The field value after the change
+	 * @return The updated checksum
+	 */
+	uint16_t update_checksum16(uint16_t checksum, uint16_t oldValue, uint16_t newValue);
+
+	/**
+	 * Incrementally update an Internet checksum after a 32-bit field it covers changed (e.g an IPv4 address), as described in RFC 1624.
+	 * The checksum and the values must be in the same byte order, e.g all of them as they appear in the packet
+	 * @param[in] checksum The checksum before the change
+	 * @param[in] oldValue The field value before the change
+	 * @param[in] newValue The field value after the change
+	 * @return The updated checksum
+	 */
+	uint16_t update_checksum32(uint16_t checksum, uint32_t oldValue, uint32_t newValue);
+
 	/**
 	 * Computes Fowler-Noll-Vo (FNV-1) 32bit hash function on an array of byte buffers. The hash is calculated on each
 	 * byte in each byte buffer, as if all byte buffers were one long byte buffer
@@ -2,7 +2,9 @@
 #define PCAPPP_LRU_LIST
 
 #include <map>
-#include <list>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
 
 #if __cplusplus > 199711L || _MSC_VER >= 1800
 #include <utility>
@@ -17,21 +19,208 @@
 namespace pcpp
 {
 
+	/**
+	 * @struct LRUListHash
+	 * The default hash function of LRUList. It hashes integral types and pointers, and LRUList of these types finds its elements in a hash
+	 * index. LRUList of any other type finds its elements using operator< in an ordered index, unless a hash function is given as its second
+	 * template parameter
+	 */
+	template<typename T>
+	struct LRUListHash
+	{
+		/**
+		 * @param[in] element The element to hash
+		 * @return The hash value of the element
+		 */
+		size_t operator()(const T& element) const
+		{
+			// the elements are often small consecutive numbers or hash values of their own, so they are mixed (MurmurHash3 64-bit
+			// finalizer) to spread them over the whole index
+			uint64_t key = (uint64_t)element;
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			key *= 0xc4ceb9fe1a85ec53ULL;
+			key ^= key >> 33;
+			return (size_t)key;
+		}
+	};
+
+	// the element types LRUListHash can hash
+	template<typename T> struct LRUListHashable { enum { value = 0 }; };
+	template<typename T> struct LRUListHashable<T*> { enum { value = 1 }; };
+#define PCAPPP_LRU_LIST_HASHABLE(Type) template<> struct LRUListHashable<Type> { enum { value = 1 }; };
+	PCAPPP_LRU_LIST_HASHABLE(bool)
+	PCAPPP_LRU_LIST_HASHABLE(char)
+	PCAPPP_LRU_LIST_HASHABLE(signed char)
+	PCAPPP_LRU_LIST_HASHABLE(unsigned char)
+	PCAPPP_LRU_LIST_HASHABLE(wchar_t)
+	PCAPPP_LRU_LIST_HASHABLE(short)
+	PCAPPP_LRU_LIST_HASHABLE(unsigned short)
+	PCAPPP_LRU_LIST_HASHABLE(int)
+	PCAPPP_LRU_LIST_HASHABLE(unsigned int)
+	PCAPPP_LRU_LIST_HASHABLE(long)
+	PCAPPP_LRU_LIST_HASHABLE(unsigned long)
+	PCAPPP_LRU_LIST_HASHABLE(long long)
+	PCAPPP_LRU_LIST_HASHABLE(unsigned long long)
+#undef PCAPPP_LRU_LIST_HASHABLE
+
+	// a hash function given by the user is always used, the default one only for the types it can hash
+	template<typename T, typename Hash> struct LRUListUsesHashIndex { enum { value = 1 }; };
+	template<typename T> struct LRUListUsesHashIndex<T, LRUListHash<T> > { enum { value = LRUListHashable<T>::value }; };
+
+	static const size_t LRUListNoNode = (size_t)-1;
+
+	// the index of LRUList, which maps each element to the position of its node in the node pool
+	template<typename T, typename Hash, bool HashIndex>
+	class LRUListIndex;
+
+	// an open-addressing hash index: each slot holds the position of a node or LRUListNoNode. Its size is a power of 2 and collisions are
+	// resolved by linear probing
+	template<typename T, typename Hash>
+	class LRUListIndex<T, Hash, true>
+	{
+	public:
+		LRUListIndex() : m_Slots(MinCapacity, LRUListNoNode), m_Count(0) {}
+
+		size_t getCapacity() const { return m_Slots.size(); }
+
+		template<typename Nodes>
+		size_t find(const T& element, const Nodes& nodes) const
+		{
+			return m_Slots[findSlot(element, nodes)];
+		}
+
+		// the element must not be in the index
+		template<typename Nodes>
+		void insert(const T& element, size_t node, const Nodes& nodes)
+		{
+			if ((m_Count + 1) * MaxLoadDenominator > m_Slots.size() * MaxLoadNumerator)
+				grow(nodes);
+
+			m_Slots[findSlot(element, nodes)] = node;
+			m_Count++;
+		}
+
+		template<typename Nodes>
+		void erase(const T& element, const Nodes& nodes)
+		{
+			size_t hole = findSlot(element, nodes);
+			if (m_Slots[hole] == LRUListNoNode)
+				return;
+
+			// backward-shift deletion: the slots following the removed one are moved back until reaching an empty slot or a node that is
+			// already in its home slot, so lookups never need to skip over deleted slots
+			size_t mask = m_Slots.size() - 1;
+			size_t next = hole;
+			while (true)
+			{
+				next = (next + 1) & mask;
+				if (m_Slots[next] == LRUListNoNode)
+					break;
+
+				// the node can move to the hole only if its home slot isn't cyclically within (hole, next]
+				size_t home = homeSlot(nodes[m_Slots[next]].value);
+				bool canMove = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+				if (canMove)
+				{
+					m_Slots[hole] = m_Slots[next];
+					hole = next;
+				}
+			}
+			m_Slots[hole] = LRUListNoNode;
+			m_Count--;
+		}
+
+	private:
+		enum
+		{
+			MinCapacity = 16,
+			// the index grows when it's more than 3/4 full
+			MaxLoadNumerator = 3,
+			MaxLoadDenominator = 4
+		};
+
+		std::vector<size_t> m_Slots;
+		size_t m_Count;
+		Hash m_Hash;
+
+		size_t homeSlot(const T& element) const
+		{
+			return m_Hash(element) & (m_Slots.size() - 1);
+		}
+
+		// return the slot pointing at the node holding the element, or the empty slot where it should be added if it isn't in the index
+		template<typename Nodes>
+		size_t findSlot(const T& element, const Nodes& nodes) const
+		{
+			size_t mask = m_Slots.size() - 1;
+			size_t slot = homeSlot(element);
+			while (m_Slots[slot] != LRUListNoNode && !(nodes[m_Slots[slot]].value == element))
+				slot = (slot + 1) & mask;
+
+			return slot;
+		}
+
+		template<typename Nodes>
+		void grow(const Nodes& nodes)
+		{
+			std::vector<size_t> oldSlots(m_Slots.size() * 2, LRUListNoNode);
+			oldSlots.swap(m_Slots);
+			for (std::vector<size_t>::const_iterator iter = oldSlots.begin(); iter != oldSlots.end(); ++iter)
+			{
+				if (*iter != LRUListNoNode)
+					m_Slots[findSlot(nodes[*iter].value, nodes)] = *iter;
+			}
+		}
+	};
+
+	// an ordered index for element types with no hash function, as LRUList used before it had a hash index
+	template<typename T, typename Hash>
+	class LRUListIndex<T, Hash, false>
+	{
+	public:
+		size_t getCapacity() const { return m_Map.size(); }
+
+		template<typename Nodes>
+		size_t find(const T& element, const Nodes&) const
+		{
+			typename std::map<T, size_t>::const_iterator iter = m_Map.find(element);
+			return (iter != m_Map.end() ? iter->second : LRUListNoNode);
+		}
+
+		template<typename Nodes>
+		void insert(const T& element, size_t node, const Nodes&)
+		{
+			m_Map.insert(std::make_pair(element, node));
+		}
+
+		template<typename Nodes>
+		void erase(const T& element, const Nodes&)
+		{
+			m_Map.erase(element);
+		}
+
+	private:
+		std::map<T, size_t> m_Map;
+	};
+
 	/**
 	 * @class LRUList
 	 * A template class that implements a LRU cache with limited size. Each time the user puts an element it goes to head of the
 	 * list as the most recently used element (if the element was already in the list it advances to the head of the list).
 	 * The last element in the list is the one least recently used and will be pulled out of the list if it reaches its max size
-	 * and a new element comes in. All actions on this LRU list are O(1)
+	 * and a new element comes in. All actions on this LRU list are O(1) for elements with a hash function (see LRUListHash), and
+	 * O(log(getSize())) for other elements, which need operator<.<BR>
+	 * The list nodes are kept in a pool that grows up to the max size of the list and is reused afterwards. Elements with a hash function
+	 * are found using an open-addressing hash index and compared using operator==, so once the list is full putting and erasing them
+	 * doesn't allocate memory
 	 */
-	template<typename T>
+	template<typename T, typename Hash = LRUListHash<T> >
 	class LRUList
 	{
 	public:
 
-		typedef typename std::list<T>::iterator ListIterator;
-		typedef typename std::map<T, ListIterator>::iterator MapIterator;
-
 		/**
 		 * A c'tor for this class
 		 * @param[in] maxSize The max size this list can go
@@ -39,12 +228,17 @@ namespace pcpp
 		LRUList(size_t maxSize)
 		{
 			m_MaxSize = maxSize;
+			m_Head = LRUListNoNode;
+			m_Tail = LRUListNoNode;
+			m_FreeNodes = LRUListNoNode;
+			m_Size = 0;
 		}
 
 		/**
 		 * Puts an element in the list. This element will be inserted (or advanced if it already exists) to the head of the
 		 * list as the most recently used element. If the list already reached its max size and the element is new this method
-		 * will remove the least recently used element and return a value in deletedValue. Method complexity is O(log(getSize())).
+		 * will remove the least recently used element and return a value in deletedValue. Method complexity is O(1) (O(log(getSize()))
+		 * for elements without a hash function).
 		 * This is a optimized version of the method T* put(const T&).
 		 * @param[in] element The element to insert or to advance to the head of the list (if already exists)
 		 * @param[out] deletedValue The value of deleted element if a pointer is not NULL. This parameter is optional.
@@ -53,29 +247,35 @@ namespace pcpp
 		 */
 		int put(const T& element, T* deletedValue = NULL)
 		{
-			m_CacheItemsList.push_front(element);
-
-			// Inserting a new element. If an element with an equivalent key already exists the method returns an iterator to the element that prevented the insertion
-			std::pair<MapIterator, bool> pair = m_CacheItemsMap.insert(std::make_pair(element, m_CacheItemsList.begin()));
-			if (pair.second == false) // already exists
+			size_t node = m_Index.find(element, m_Nodes);
+			if (node != LRUListNoNode) // already exists
 			{
-				m_CacheItemsList.erase(pair.first->second);
-				pair.first->second = m_CacheItemsList.begin();
+				if (node != m_Head)
+				{
+					unlink(node);
+					linkAtHead(node);
+				}
+
+				return 0;
 			}
 
-			if (m_CacheItemsMap.size() > m_MaxSize)
-			{
-				ListIterator lruIter = m_CacheItemsList.end();
-				lruIter--;
+			node = allocateNode(element);
+			m_Index.insert(element, node, m_Nodes);
+			linkAtHead(node);
+			m_Size++;
 
+			if (m_Size > m_MaxSize)
+			{
+				// the element is found in the index by its value, so it's removed from the index before its value is moved out
+				size_t lruNode = m_Tail;
+				m_Index.erase(m_Nodes[lruNode].value, m_Nodes);
 				if (deletedValue != NULL)
 #if __cplusplus > 199711L || _MSC_VER >= 1800
-					*deletedValue = std::move(*lruIter);
+					*deletedValue = std::move(m_Nodes[lruNode].value);
 #else
-					*deletedValue = *lruIter;
+					*deletedValue = m_Nodes[lruNode].value;
 #endif
-				m_CacheItemsMap.erase(*lruIter);
-				m_CacheItemsList.erase(lruIter);
+				freeNode(lruNode);
 				return 1;
 			}
 
@@ -88,7 +288,7 @@ namespace pcpp
 		 */
 		const T& getMRUElement() const
 		{
-			return m_CacheItemsList.front();
+			return m_Nodes[m_Head].value;
 		}
 
 		/**
@@ -97,7 +297,7 @@ namespace pcpp
 		 */
 		const T& getLRUElement() const
 		{
-			return m_CacheItemsList.back();
+			return m_Nodes[m_Tail].value;
 		}
 
 		/**
@@ -106,12 +306,12 @@ namespace pcpp
 		 */
 		void eraseElement(const T& element)
 		{
-			MapIterator iter = m_CacheItemsMap.find(element);
-			if (iter == m_CacheItemsMap.end())
+			size_t node = m_Index.find(element, m_Nodes);
+			if (node == LRUListNoNode)
 				return;
 
-			m_CacheItemsList.erase(iter->second);
-			m_CacheItemsMap.erase(iter);
+			m_Index.erase(element, m_Nodes);
+			freeNode(node);
 		}
 
 		/**
@@ -122,12 +322,88 @@ namespace pcpp
 		/**
 		 * @return The number of elements currently in this list
 		 */
-		size_t getSize() const { return m_CacheItemsMap.size(); }
+		size_t getSize() const { return m_Size; }
+
+		/**
+		 * @return The number of list nodes allocated so far. Nodes of erased elements are reused, so this is the largest size the list
+		 * has reached
+		 */
+		size_t getNumOfAllocatedNodes() const { return m_Nodes.size(); }
+
+		/**
+		 * @return The number of slots in the hash index, or the number of elements if the elements are kept in an ordered index
+		 */
+		size_t getIndexCapacity() const { return m_Index.getCapacity(); }
 
 	private:
-		std::list<T> m_CacheItemsList;
-		std::map<T, ListIterator> m_CacheItemsMap;
+		// a list node. Nodes are linked by their position in m_Nodes, so the pool can grow without invalidating the links. Free nodes
+		// are chained through their next member
+		struct Node
+		{
+			T value;
+			size_t prev;
+			size_t next;
+
+			Node(const T& element) : value(element), prev(LRUListNoNode), next(LRUListNoNode) {}
+		};
+
+		std::vector<Node> m_Nodes;
+		LRUListIndex<T, Hash, LRUListUsesHashIndex<T, Hash>::value != 0> m_Index;
+		size_t m_Head;
+		size_t m_Tail;
+		size_t m_FreeNodes;
+		size_t m_Size;
 		size_t m_MaxSize;
+
+		size_t allocateNode(const T& element)
+		{
+			if (m_FreeNodes == LRUListNoNode)
+			{
+				m_Nodes.push_back(Node(element));
+				return m_Nodes.size() - 1;
+			}
+
+			size_t node = m_FreeNodes;
+			m_FreeNodes = m_Nodes[node].next;
+			m_Nodes[node].value = element;
+			return node;
+		}
+
+		// unlink a node that was removed from the index and return it to the pool
+		void freeNode(size_t node)
+		{
+			unlink(node);
+			m_Nodes[node].value = T();
+			m_Nodes[node].next = m_FreeNodes;
+			m_FreeNodes = node;
+			m_Size--;
+		}
+
+		void linkAtHead(size_t node)
+		{
+			m_Nodes[node].prev = LRUListNoNode;
+			m_Nodes[node].next = m_Head;
+			if (m_Head != LRUListNoNode)
+				m_Nodes[m_Head].prev = node;
+			else
+				m_Tail = node;
+			m_Head = node;
+		}
+
+		void unlink(size_t node)
+		{
+			size_t prev = m_Nodes[node].prev;
+			size_t next = m_Nodes[node].next;
+			if (prev != LRUListNoNode)
+				m_Nodes[prev].next = next;
+			else
+				m_Head = next;
+
+			if (next != LRUListNoNode)
+				m_Nodes[next].prev = prev;
+			else
+				m_Tail = prev;
+		}
 	};
 
 } // namespace pcpp
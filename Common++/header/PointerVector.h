@@ -81,6 +81,14 @@ namespace pcpp
 		 */
 		void pushBack(T* element) { m_Vector.push_back(element); }
 
+		/**
+		 * Insert a new (pointer to an) element to the vector before a certain position
+		 * @param[in] position The position to insert the element before
+		 * @param[in] element The element to insert
+		 * @return An iterator pointing to the inserted element
+		 */
+		VectorIterator insert(VectorIterator position, T* element) { return m_Vector.insert(position, element); }
+
 		/**
 		 * Get the first element of the vector
 		 * @return An iterator object pointing to the first element of the vector
@@ -131,6 +139,19 @@ namespace pcpp
 			return m_Vector.erase(position);
 		}
 
+		/**
+		 * Removes from the vector a range of elements [first, last). Once the elements are erased, they're also freed
+		 * @param[in] first The position of the first element to erase
+		 * @param[in] last The position following the last element to erase
+		 * @return An iterator pointing to the new location of the element that followed the last element erased by the function call
+		 */
+		VectorIterator erase(VectorIterator first, VectorIterator last)
+		{
+			for (VectorIterator iter = first; iter != last; iter++)
+				delete (*iter);
+			return m_Vector.erase(first, last);
+		}
+
 		/**
 		 * Remove an element from the vector without freeing it
 		 * param[in] position The position of the element to remove from the vector
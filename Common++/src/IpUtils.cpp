@@ -14,6 +14,12 @@
 #define NS_INT16SZ	2
 #endif
 
+// x86 CPUs get SSE2 and AVX2 implementations of the checksum, selected at runtime according to the CPU features
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define PCPP_CHECKSUM_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
 namespace pcpp
 {
 
@@ -59,41 +65,166 @@ uint32_t in_addr2int(in_addr inAddr)
 #endif
 }
 
-uint16_t compute_checksum(ScalarBuffer<uint16_t> vec[], size_t vecSize)
+// Buffers are summed as native 16-bit words, so the partial sum of each buffer has the same byte order as the data. It doesn't matter
+// how many words are added at a time: since 2^16 = 1 (mod 2^16-1), a one's complement sum of 32-bit or 64-bit words folded to 16 bits
+// equals the sum of the 16-bit words they're made of. This lets the vectorized implementations add 32-bit words into 64-bit lanes
+
+static uint16_t foldChecksum(uint64_t sum)
 {
-	uint32_t sum = 0;
-	for (size_t i = 0; i<vecSize; i++)
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)sum;
+}
+
+static uint64_t sumChecksumTail(const uint8_t* data, size_t len)
+{
+	uint64_t sum = 0;
+	while (len >= 4)
 	{
-		uint32_t local_sum = 0;
-		size_t buff_len = vec[i].len;
-		while (buff_len > 1) {
-			LOG_DEBUG("Value to add = 0x%4X", *(vec[i].buffer));
-			local_sum += *(vec[i].buffer);
-			++(vec[i].buffer);
-			buff_len -= 2;
-		}
-		LOG_DEBUG("Local sum = %d, 0x%4X", local_sum, local_sum);
+		uint32_t word;
+		memcpy(&word, data, 4);
+		sum += word;
+		data += 4;
+		len -= 4;
+	}
 
-		if (buff_len == 1)
-		{
-			uint8_t lastByte = *(vec[i].buffer);
-			LOG_DEBUG("1 byte left, adding value: 0x%4X", lastByte);
-			local_sum += lastByte;
-			LOG_DEBUG("Local sum = %d, 0x%4X", local_sum, local_sum);
-		}
+	if (len >= 2)
+	{
+		uint16_t word;
+		memcpy(&word, data, 2);
+		sum += word;
+		data += 2;
+		len -= 2;
+	}
 
-		while (local_sum>>16) {
-			local_sum = (local_sum & 0xffff) + (local_sum >> 16);
-		}
-		local_sum = ntohs(local_sum);
-		LOG_DEBUG("Local sum = %d, 0x%4X", local_sum, local_sum);
-		sum += local_sum;
+	// an odd trailing byte is padded with a zero byte to a full 16-bit word
+	if (len == 1)
+	{
+		uint16_t word = 0;
+		memcpy(&word, data, 1);
+		sum += word;
 	}
 
-	while (sum>>16) {
-		sum = (sum & 0xffff) + (sum >> 16);
+	return sum;
+}
+
+static uint16_t sumChecksumScalar(const uint8_t* data, size_t len)
+{
+	uint64_t sum = 0;
+	while (len >= 8)
+	{
+		uint64_t word;
+		memcpy(&word, data, 8);
+		sum += (word & 0xffffffff) + (word >> 32);
+		data += 8;
+		len -= 8;
 	}
 
+	return foldChecksum(sum + sumChecksumTail(data, len));
+}
+
+#ifdef PCPP_CHECKSUM_X86_DISPATCH
+
+__attribute__((target("sse2")))
+static uint16_t sumChecksumSSE2(const uint8_t* data, size_t len)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sum0 = zero;
+	__m128i sum1 = zero;
+	while (len >= 32)
+	{
+		__m128i block0 = _mm_loadu_si128((const __m128i*)data);
+		__m128i block1 = _mm_loadu_si128((const __m128i*)(data + 16));
+		sum0 = _mm_add_epi64(sum0, _mm_unpacklo_epi32(block0, zero));
+		sum1 = _mm_add_epi64(sum1, _mm_unpackhi_epi32(block0, zero));
+		sum0 = _mm_add_epi64(sum0, _mm_unpacklo_epi32(block1, zero));
+		sum1 = _mm_add_epi64(sum1, _mm_unpackhi_epi32(block1, zero));
+		data += 32;
+		len -= 32;
+	}
+
+	uint64_t lanes[2];
+	_mm_storeu_si128((__m128i*)lanes, _mm_add_epi64(sum0, sum1));
+	return foldChecksum(lanes[0] + lanes[1] + sumChecksumTail(data, len));
+}
+
+__attribute__((target("avx2")))
+static uint16_t sumChecksumAVX2(const uint8_t* data, size_t len)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i sum0 = zero;
+	__m256i sum1 = zero;
+	while (len >= 64)
+	{
+		__m256i block0 = _mm256_loadu_si256((const __m256i*)data);
+		__m256i block1 = _mm256_loadu_si256((const __m256i*)(data + 32));
+		sum0 = _mm256_add_epi64(sum0, _mm256_unpacklo_epi32(block0, zero));
+		sum1 = _mm256_add_epi64(sum1, _mm256_unpackhi_epi32(block0, zero));
+		sum0 = _mm256_add_epi64(sum0, _mm256_unpacklo_epi32(block1, zero));
+		sum1 = _mm256_add_epi64(sum1, _mm256_unpackhi_epi32(block1, zero));
+		data += 64;
+		len -= 64;
+	}
+
+	uint64_t lanes[4];
+	_mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi64(sum0, sum1));
+	uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+	// the remaining bytes are less than one iteration, they're not worth another vector pass
+	return foldChecksum(sum + sumChecksumTail(data, len));
+}
+
+#endif // PCPP_CHECKSUM_X86_DISPATCH
+
+typedef uint16_t (*ChecksumSumFunc)(const uint8_t* data, size_t len);
+
+static ChecksumSumFunc selectChecksumSumFunc()
+{
+#ifdef PCPP_CHECKSUM_X86_DISPATCH
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return sumChecksumAVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return sumChecksumSSE2;
+#endif
+	return sumChecksumScalar;
+}
+
+// the implementation matching the CPU the code runs on. It's selected once, while the library is loaded, so that concurrent
+// calls only ever read it
+static const ChecksumSumFunc s_SelectedChecksumSumFunc = selectChecksumSumFunc();
+
+static ChecksumSumFunc getChecksumSumFunc(ChecksumImplementation implementation)
+{
+	switch (implementation)
+	{
+	case ChecksumScalar:
+		return sumChecksumScalar;
+#ifdef PCPP_CHECKSUM_X86_DISPATCH
+	case ChecksumSSE2:
+		__builtin_cpu_init();
+		return (__builtin_cpu_supports("sse2") ? sumChecksumSSE2 : NULL);
+	case ChecksumAVX2:
+		__builtin_cpu_init();
+		return (__builtin_cpu_supports("avx2") ? sumChecksumAVX2 : NULL);
+#endif
+	default:
+		return NULL;
+	}
+}
+
+static uint16_t computeChecksumWith(ChecksumSumFunc sumFunc, ScalarBuffer<uint16_t> vec[], size_t vecSize)
+{
+	uint32_t sum = 0;
+	for (size_t i = 0; i < vecSize; i++)
+	{
+		uint16_t localSum = sumFunc((const uint8_t*)vec[i].buffer, vec[i].len);
+		sum += ntohs(localSum);
+	}
+
+	sum = foldChecksum(sum);
+
 	LOG_DEBUG("Sum before invert = %d, 0x%4X", sum, sum);
 
 	sum = ~sum;
@@ -103,6 +234,56 @@ uint16_t compute_checksum(ScalarBuffer<uint16_t> vec[], size_t vecSize)
 	return ((uint16_t) sum);
 }
 
+uint16_t compute_checksum(ScalarBuffer<uint16_t> vec[], size_t vecSize)
+{
+	// static initializers of other translation units may run before s_SelectedChecksumSumFunc is set. Select the implementation
+	// locally in that case rather than writing to shared state
+	ChecksumSumFunc sumFunc = s_SelectedChecksumSumFunc;
+	if (sumFunc == NULL)
+		sumFunc = selectChecksumSumFunc();
+
+	return computeChecksumWith(sumFunc, vec, vecSize);
+}
+
+bool isChecksumImplementationSupported(ChecksumImplementation implementation)
+{
+	return getChecksumSumFunc(implementation) != NULL;
+}
+
+uint16_t compute_checksum(ScalarBuffer<uint16_t> vec[], size_t vecSize, ChecksumImplementation implementation)
+{
+	ChecksumSumFunc sumFunc = getChecksumSumFunc(implementation);
+	if (sumFunc == NULL)
+	{
+		LOG_ERROR("Checksum implementation %d isn't supported", (int)implementation);
+		return 0;
+	}
+
+	return computeChecksumWith(sumFunc, vec, vecSize);
+}
+
+uint16_t update_checksum(uint16_t checksum, const uint8_t* oldData, const uint8_t* newData, size_t dataLen)
+{
+	// RFC 1624 eqn. 3: HC' = ~(~HC + ~m + m'). ~m is summed as ~(sum of m) which is the same in one's complement arithmetic
+	uint64_t sum = (uint16_t)~checksum;
+	sum += (uint16_t)~sumChecksumScalar(oldData, dataLen);
+	sum += sumChecksumScalar(newData, dataLen);
+	return (uint16_t)~foldChecksum(sum);
+}
+
+uint16_t update_checksum16(uint16_t checksum, uint16_t oldValue, uint16_t newValue)
+{
+	uint32_t sum = (uint16_t)~checksum;
+	sum += (uint16_t)~oldValue;
+	sum += newValue;
+	return (uint16_t)~foldChecksum(sum);
+}
+
+uint16_t update_checksum32(uint16_t checksum, uint32_t oldValue, uint32_t newValue)
+{
+	return update_checksum(checksum, (const uint8_t*)&oldValue, (const uint8_t*)&newValue, sizeof(uint32_t));
+}
+
 
 static const uint32_t FNV_PRIME = 16777619u;
 static const uint32_t OFFSET_BASIS = 2166136261u;
@@ -15,8 +15,16 @@
 
 #include <Packet.h>
 #include <DnsLayer.h>
+#include <EthLayer.h>
+#include <IPv4Layer.h>
+#include <TcpLayer.h>
+#include <PayloadLayer.h>
+#include <TcpReassembly.h>
 #include <PcapFileDevice.h>
+#include <arpa/inet.h>
+#include <algorithm>
 #include <iostream>
+#include <random>
 #include <chrono>
 #include <string>
 #include <vector>
@@ -54,9 +62,77 @@ bool handle_packet(Packet& packet) {
     return true;
 }
 
+void on_tcp_message(int side, const TcpStreamData& tcpData, void* cookie) {
+    *(size_t*)cookie += tcpData.getDataLength();
+}
+
+// feed TcpReassembly with numOfFlows concurrent connections: a SYN for every flow and then two data packets for every flow, so
+// the cost of creating and looking up connections is measured rather than the cost of parsing packets
+size_t handle_tcp_flows(size_t numOfFlows) {
+    EthLayer ethLayer(MacAddress("00:11:22:33:44:55"), MacAddress("66:77:88:99:aa:bb"));
+    IPv4Layer ipLayer(IPv4Address("10.0.0.1"), IPv4Address("192.168.0.1"));
+    TcpLayer tcpLayer(1024, 80);
+    uint8_t payload[64] = { 0 };
+    PayloadLayer payloadLayer(payload, sizeof(payload), false);
+    Packet packet;
+    packet.addLayer(&ethLayer);
+    packet.addLayer(&ipLayer);
+    packet.addLayer(&tcpLayer);
+    packet.addLayer(&payloadLayer);
+    packet.computeCalculateFields();
+
+    iphdr* ipHdr = packet.getLayerOfType<IPv4Layer>()->getIPv4Header();
+    tcphdr* tcpHdr = packet.getLayerOfType<TcpLayer>()->getTcpHeader();
+    size_t payloadLen = packet.getLayerOfType<TcpLayer>()->getLayerPayloadSize();
+    size_t bytes = 0;
+    size_t packets = 0;
+    TcpReassembly tcpReassembly(on_tcp_message, &bytes);
+
+    for (int round = 0; round < 3; ++round) {
+        for (size_t flow = 0; flow < numOfFlows; ++flow) {
+            // every flow gets its own client address and port
+            ipHdr->ipSrc = htonl(0x0a000000 | (uint32_t)(flow >> 6));
+            tcpHdr->portSrc = htons((uint16_t)(1024 + (flow & 0x3f)));
+            tcpHdr->synFlag = (round == 0 ? 1 : 0);
+            // the SYN carries a payload too, so the next expected sequence is 1 + payloadLen
+            tcpHdr->sequenceNumber = htonl(round == 0 ? 0 : (uint32_t)(1 + round * payloadLen));
+            tcpReassembly.reassemblePacket(packet);
+            ++packets;
+        }
+    }
+
+    tcpReassembly.closeAllConnections();
+    return packets;
+}
+
+// feed TcpReassembly with the packets of a file after shuffling them in windows of reorderWindow packets, so most TCP segments
+// arrive out-of-order and are buffered until the segments before them arrive. Only the reassembly is measured
+size_t handle_tcp_reorder(PcapFileReaderDevice& reader, std::chrono::high_resolution_clock::time_point& start) {
+    const size_t reorderWindow = 256;
+    std::vector<RawPacket> rawPackets;
+    RawPacket rawPacket;
+    while (reader.getNextPacket(rawPacket))
+        rawPackets.push_back(rawPacket);
+
+    // a fixed seed so all repetitions and builds replay the same order
+    std::mt19937 randomGenerator(0);
+    for (size_t i = 0; i < rawPackets.size(); i += reorderWindow)
+        std::shuffle(rawPackets.begin() + i, rawPackets.begin() + std::min(i + reorderWindow, rawPackets.size()), randomGenerator);
+
+    size_t bytes = 0;
+    start = std::chrono::high_resolution_clock::now();
+    TcpReassembly tcpReassembly(on_tcp_message, &bytes);
+    for (size_t i = 0; i < rawPackets.size(); ++i)
+        tcpReassembly.reassemblePacket(&rawPackets[i]);
+
+    tcpReassembly.closeAllConnections();
+    return rawPackets.size();
+}
+
 int main(int argc, char *argv[]) { 
     if(argc != 4) {
-        std::cout << "Usage: " << *argv << " <input-file> <dns|packet> <repetitions>\n";
+        std::cout << "Usage: " << *argv << " <input-file> <dns|packet|parse|parse-reuse|parse-reparse|parse-batch|tcp-reorder> <repetitions>\n";
+        std::cout << "       " << *argv << " <num-of-flows> tcp-flows <repetitions>\n";
         return 1;
     }
     std::chrono::high_resolution_clock myClock;
@@ -67,9 +143,18 @@ int main(int argc, char *argv[]) {
     for(int i = 0; i < total_runs; ++i) {
         count = 0;
         PcapFileReaderDevice reader(argv[1]);
-        reader.open();
+        if(input_type != "tcp-flows")
+            reader.open();
         std::chrono::high_resolution_clock::time_point start;
-        if(input_type == "dns") {
+        if(input_type == "tcp-flows") {
+            // TCP reassembly of synthetic connections, the first argument is the number of connections rather than a file
+            start = std::chrono::high_resolution_clock::now();
+            count = handle_tcp_flows(std::stoul(argv[1]));
+        }
+        else if(input_type == "tcp-reorder") {
+            count = handle_tcp_reorder(reader, start);
+        }
+        else if(input_type == "dns") {
             start = std::chrono::high_resolution_clock::now();
             RawPacket rawPacket;
             while (reader.getNextPacket(rawPacket))
@@ -78,6 +163,58 @@ int main(int argc, char *argv[]) {
             	handle_dns(packet);
             }
         }
+        else if(input_type == "parse") {
+            // full parse with a new Packet per frame: layers are allocated from a fresh arena every time
+            start = std::chrono::high_resolution_clock::now();
+            RawPacket rawPacket;
+            while (reader.getNextPacket(rawPacket))
+            {
+            	Packet packet(&rawPacket);
+            	handle_packet(packet);
+            }
+        }
+        else if(input_type == "parse-reuse") {
+            // full parse re-using the same Packet: its layer arena is rewound instead of allocating memory per frame
+            start = std::chrono::high_resolution_clock::now();
+            RawPacket rawPacket;
+            Packet packet;
+            while (reader.getNextPacket(rawPacket))
+            {
+            	packet.setRawPacket(&rawPacket, false);
+            	handle_packet(packet);
+            }
+        }
+        else if(input_type == "parse-reparse") {
+            // full parse re-using the same Packet and the layers of the previous frame wherever the protocol stack is the same
+            start = std::chrono::high_resolution_clock::now();
+            RawPacket rawPacket;
+            Packet packet;
+            while (reader.getNextPacket(rawPacket))
+            {
+            	packet.reparse(&rawPacket);
+            	handle_packet(packet);
+            }
+        }
+        else if(input_type == "parse-batch") {
+            // full parse of bursts of frames, the way packets are received from DPDK or PF_RING, using Packet::parseBatch()
+            start = std::chrono::high_resolution_clock::now();
+            const size_t burstSize = 64;
+            RawPacket rawPackets[burstSize];
+            RawPacket* rawPacketPtrs[burstSize];
+            Packet packets[burstSize];
+            for (size_t j = 0; j < burstSize; j++)
+            	rawPacketPtrs[j] = &rawPackets[j];
+            size_t numOfPackets = burstSize;
+            while (numOfPackets == burstSize)
+            {
+            	numOfPackets = 0;
+            	while (numOfPackets < burstSize && reader.getNextPacket(rawPackets[numOfPackets]))
+            		numOfPackets++;
+            	Packet::parseBatch(rawPacketPtrs, packets, numOfPackets);
+            	for (size_t j = 0; j < numOfPackets; j++)
+            		handle_packet(packets[j]);
+            }
+        }
         else {
             start = std::chrono::high_resolution_clock::now();
             RawPacket rawPacket;
@@ -90,7 +227,8 @@ int main(int argc, char *argv[]) {
         auto end = std::chrono::high_resolution_clock::now();
         durations.push_back(end - start);
         total_packets += count;
-        reader.close();
+        if(input_type != "tcp-flows")
+            reader.close();
     }
     auto total_time = std::accumulate(
         durations.begin(),
@@ -144,6 +144,9 @@ namespace pcpp
 		std::string toString() const;
 
 		OsiModelLayer getOsiModelLayer() const { return OsiModelDataLinkLayer; }
+
+	protected:
+		bool isNextLayerReusable(const Layer* nextLayer) const;
 	};
 
 } // namespace pcpp
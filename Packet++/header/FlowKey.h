@@ -0,0 +1,151 @@
+#ifndef PACKETPP_FLOW_KEY
+#define PACKETPP_FLOW_KEY
+
+#include "IpAddress.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/// @file
+
+/**
+ * \namespace pcpp
+ * \brief The main namespace for the PcapPlusPlus lib
+ */
+namespace pcpp
+{
+
+	class Packet;
+	class PacketView;
+	class RawPacket;
+
+	/**
+	 * @class FlowKey
+	 * A value type holding the 5-tuple (IP addresses, ports and transport protocol) of an IPv4 or IPv6 TCP/UDP packet. The 5-tuple
+	 * is kept in a canonical, direction-independent form: the two endpoints (IP address + port) are ordered so that both directions
+	 * of a connection produce equal keys. Which endpoint the packet was sent from is reported separately by the methods that fill the
+	 * key.<BR>
+	 * The key has a fixed size and layout and doesn't allocate memory, so it can be used directly as a hash table or map key. hash()
+	 * computes a seeded 64-bit hash of the key, which has far fewer collisions than hash5Tuple() at large table sizes and allows
+	 * seeding the hash per table or per thread.<BR>
+	 * A key can be filled from a parsed Packet, from a PacketView or directly from a RawPacket without creating a Packet. For tunneled
+	 * packets the innermost IP header is used, and the key is valid only if a TCP or UDP header comes right after it
+	 */
+	class FlowKey
+	{
+	public:
+		/**
+		 * A c'tor for this class that creates an invalid (empty) key
+		 */
+		FlowKey();
+
+		/**
+		 * Fill the key from a parsed packet
+		 * @param[in] packet The packet to take the 5-tuple from
+		 * @param[out] isReversed An optional pointer that is set to true if the packet was sent from endpoint 1 of the key, or false if
+		 * it was sent from endpoint 0
+		 * @return True if the packet contains an IPv4 or IPv6 header followed by a TCP or UDP header, false otherwise in which case the
+		 * key is invalid
+		 */
+		bool fromPacket(const Packet& packet, bool* isReversed = NULL);
+
+		/**
+		 * Fill the key from a decoded packet view
+		 * @param[in] packetView The packet view to take the 5-tuple from
+		 * @param[out] isReversed An optional pointer that is set to true if the packet was sent from endpoint 1 of the key, or false if
+		 * it was sent from endpoint 0
+		 * @return True if the view contains an IPv4 or IPv6 header followed by a TCP or UDP header, false otherwise in which case the
+		 * key is invalid
+		 */
+		bool fromPacketView(const PacketView& packetView, bool* isReversed = NULL);
+
+		/**
+		 * Fill the key directly from a raw packet. The raw packet is decoded using PacketView, so no Packet or Layer objects are created
+		 * @param[in] rawPacket The raw packet to take the 5-tuple from
+		 * @param[out] isReversed An optional pointer that is set to true if the packet was sent from endpoint 1 of the key, or false if
+		 * it was sent from endpoint 0
+		 * @return True if the raw packet contains an IPv4 or IPv6 header followed by a TCP or UDP header, false otherwise in which case
+		 * the key is invalid
+		 */
+		bool fromRawPacket(RawPacket* rawPacket, bool* isReversed = NULL);
+
+		/**
+		 * Make the key invalid
+		 */
+		void clear();
+
+		/**
+		 * @return True if the key holds a 5-tuple, false otherwise
+		 */
+		bool isValid() const { return m_IPVersion != 0; }
+
+		/**
+		 * @return 4 for an IPv4 key, 6 for an IPv6 key or 0 if the key is invalid
+		 */
+		uint8_t getIPVersion() const { return m_IPVersion; }
+
+		/**
+		 * @return The transport protocol number (::PACKETPP_IPPROTO_TCP or ::PACKETPP_IPPROTO_UDP) or 0 if the key is invalid
+		 */
+		uint8_t getProtocol() const { return m_Protocol; }
+
+		/**
+		 * @param[in] endpoint The endpoint index, 0 or 1
+		 * @return The IPv4 address of the endpoint or IPv4Address#Zero if this isn't an IPv4 key
+		 */
+		IPv4Address getIPv4Address(size_t endpoint) const;
+
+		/**
+		 * @param[in] endpoint The endpoint index, 0 or 1
+		 * @return The IPv6 address of the endpoint or IPv6Address#Zero if this isn't an IPv6 key
+		 */
+		IPv6Address getIPv6Address(size_t endpoint) const;
+
+		/**
+		 * @param[in] endpoint The endpoint index, 0 or 1
+		 * @return The port of the endpoint (in host byte order)
+		 */
+		uint16_t getPort(size_t endpoint) const { return m_Port[endpoint]; }
+
+		/**
+		 * Compute a 64-bit hash of the key. Equal keys always have the same hash for the same seed
+		 * @param[in] seed The hash seed. Using a different (e.g random) seed per table makes the hash values unpredictable to whoever
+		 * generates the traffic. Default value is 0
+		 * @return The hash value
+		 */
+		uint64_t hash(uint64_t seed = 0) const;
+
+		/**
+		 * Compare two keys
+		 * @param[in] other The key to compare with
+		 * @return True if both keys hold the same 5-tuple, or both are invalid
+		 */
+		bool operator==(const FlowKey& other) const;
+
+		/**
+		 * Compare two keys
+		 * @param[in] other The key to compare with
+		 * @return True if the keys hold different 5-tuples
+		 */
+		bool operator!=(const FlowKey& other) const { return !(*this == other); }
+
+		/**
+		 * An arbitrary strict weak ordering of keys, which allows using FlowKey as a std::map key
+		 * @param[in] other The key to compare with
+		 * @return True if this key is ordered before the other key
+		 */
+		bool operator<(const FlowKey& other) const;
+
+	private:
+		// the key is hashed and compared as 5 64-bit words, so the layout must stay 40 bytes with no uninitialized padding
+		uint8_t m_IPAddr[2][16];
+		uint16_t m_Port[2];
+		uint8_t m_IPVersion;
+		uint8_t m_Protocol;
+		uint16_t m_Reserved;
+
+		bool set(uint8_t ipVersion, const uint8_t* srcIP, const uint8_t* dstIP, size_t ipAddrLen, uint16_t srcPort, uint16_t dstPort, uint8_t protocol, bool* isReversed);
+	};
+
+} // namespace pcpp
+
+#endif /* PACKETPP_FLOW_KEY */
@@ -0,0 +1,259 @@
+#ifndef PACKETPP_FLOW_TABLE
+#define PACKETPP_FLOW_TABLE
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// @file
+
+/**
+ * \namespace pcpp
+ * \brief The main namespace for the PcapPlusPlus lib
+ */
+namespace pcpp
+{
+
+	/**
+	 * @class FlowTable
+	 * An open-addressing hash table mapping 32-bit flow keys (such as the values returned by hash5Tuple()) to values of type T.<BR>
+	 * All entries are kept in one flat array whose size is a power of 2, and collisions are resolved by linear probing. A lookup
+	 * therefore usually touches a single cache line, and adding a key doesn't allocate memory unless the table has to grow. Erased
+	 * entries are removed using backward-shift deletion, so the table never fills up with tombstones.<BR>
+	 * Values are copied when the table grows, so T should be a small copyable type such as a pointer. Pointers returned by find()
+	 * and insert() are invalidated by the next call to insert() or erase()
+	 */
+	template<typename T>
+	class FlowTable
+	{
+	public:
+		/**
+		 * A c'tor for this class
+		 * @param[in] initialCapacity The number of entries to reserve room for. The table grows automatically when needed, so this
+		 * is only a hint. Default value is 0 which means a small default capacity
+		 */
+		FlowTable(size_t initialCapacity = 0) : m_Entries(NULL), m_Capacity(0), m_Size(0)
+		{
+			size_t capacity = MinCapacity;
+			while (capacity * MaxLoadNumerator < initialCapacity * MaxLoadDenominator)
+				capacity <<= 1;
+
+			allocate(capacity);
+		}
+
+		/**
+		 * A d'tor for this class. Notice values are not freed, so if they are pointers the caller is responsible for freeing them
+		 */
+		~FlowTable() { delete [] m_Entries; }
+
+		/**
+		 * Look up a key
+		 * @param[in] key The key to look for
+		 * @return A pointer to the value mapped to the key or NULL if the key isn't in the table
+		 */
+		T* find(uint32_t key)
+		{
+			size_t slot = findSlot(key);
+			return (m_Entries[slot].used ? &m_Entries[slot].value : NULL);
+		}
+
+		/**
+		 * Look up a key
+		 * @param[in] key The key to look for
+		 * @return A pointer to the value mapped to the key or NULL if the key isn't in the table
+		 */
+		const T* find(uint32_t key) const
+		{
+			size_t slot = findSlot(key);
+			return (m_Entries[slot].used ? &m_Entries[slot].value : NULL);
+		}
+
+		/**
+		 * Map a key to a value. If the key is already in the table its value is replaced
+		 * @param[in] key The key
+		 * @param[in] value The value to map the key to
+		 * @return A pointer to the value stored in the table
+		 */
+		T* insert(uint32_t key, const T& value)
+		{
+			size_t slot = findSlot(key);
+			if (!m_Entries[slot].used)
+			{
+				if ((m_Size + 1) * MaxLoadDenominator > m_Capacity * MaxLoadNumerator)
+				{
+					grow();
+					slot = findSlot(key);
+				}
+
+				m_Entries[slot].key = key;
+				m_Entries[slot].used = true;
+				m_Size++;
+			}
+
+			m_Entries[slot].value = value;
+			return &m_Entries[slot].value;
+		}
+
+		/**
+		 * Remove a key from the table
+		 * @param[in] key The key to remove
+		 * @return True if the key was found and removed, false if it wasn't in the table
+		 */
+		bool erase(uint32_t key)
+		{
+			size_t hole = findSlot(key);
+			if (!m_Entries[hole].used)
+				return false;
+
+			// shift back the entries following the removed one until reaching an empty slot or an entry that is already in its
+			// home slot, so lookups never need to skip over deleted entries
+			size_t mask = m_Capacity - 1;
+			size_t next = hole;
+			while (true)
+			{
+				next = (next + 1) & mask;
+				if (!m_Entries[next].used)
+					break;
+
+				// the entry can move to the hole only if its home slot isn't cyclically within (hole, next]
+				size_t home = homeSlot(m_Entries[next].key);
+				bool canMove = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+				if (canMove)
+				{
+					m_Entries[hole] = m_Entries[next];
+					hole = next;
+				}
+			}
+
+			m_Entries[hole].used = false;
+			m_Entries[hole].value = T();
+			m_Size--;
+			return true;
+		}
+
+		/**
+		 * Remove all keys from the table. The capacity of the table is kept
+		 */
+		void clear()
+		{
+			for (size_t i = 0; i < m_Capacity; i++)
+			{
+				m_Entries[i].used = false;
+				m_Entries[i].value = T();
+			}
+
+			m_Size = 0;
+		}
+
+		/**
+		 * @return The number of keys in the table
+		 */
+		size_t size() const { return m_Size; }
+
+		/**
+		 * @return True if the table contains no keys, false otherwise
+		 */
+		bool empty() const { return m_Size == 0; }
+
+		/**
+		 * @return The number of slots in the table. Slots are numbered 0 to getCapacity()-1 and can be iterated using isSlotUsed(),
+		 * getKeyAt() and getValueAt(). Values may be modified while iterating but keys must not be inserted or erased
+		 */
+		size_t getCapacity() const { return m_Capacity; }
+
+		/**
+		 * @param[in] slot The slot index
+		 * @return True if the slot holds a key, false if it's empty
+		 */
+		bool isSlotUsed(size_t slot) const { return m_Entries[slot].used; }
+
+		/**
+		 * @param[in] slot The slot index. The slot must be in use
+		 * @return The key stored in the slot
+		 */
+		uint32_t getKeyAt(size_t slot) const { return m_Entries[slot].key; }
+
+		/**
+		 * @param[in] slot The slot index. The slot must be in use
+		 * @return A reference to the value stored in the slot
+		 */
+		T& getValueAt(size_t slot) { return m_Entries[slot].value; }
+
+	private:
+		enum
+		{
+			MinCapacity = 16,
+			// the table grows when it's more than 3/4 full
+			MaxLoadNumerator = 3,
+			MaxLoadDenominator = 4
+		};
+
+		struct Entry
+		{
+			uint32_t key;
+			bool used;
+			T value;
+
+			Entry() : key(0), used(false), value() {}
+		};
+
+		Entry* m_Entries;
+		size_t m_Capacity;
+		size_t m_Size;
+
+		// the table owns its entries array and isn't meant to be copied
+		FlowTable(const FlowTable&);
+		FlowTable& operator=(const FlowTable&);
+
+		size_t homeSlot(uint32_t key) const
+		{
+			// flow keys are often hash values already, but they are mixed again (MurmurHash3 finalizer) so that keys differing only
+			// in their high bits don't end up in the same region of the table
+			key ^= key >> 16;
+			key *= 0x85ebca6b;
+			key ^= key >> 13;
+			key *= 0xc2b2ae35;
+			key ^= key >> 16;
+			return key & (m_Capacity - 1);
+		}
+
+		// return the slot holding the key, or the empty slot where the key should be inserted if it isn't in the table
+		size_t findSlot(uint32_t key) const
+		{
+			size_t mask = m_Capacity - 1;
+			size_t slot = homeSlot(key);
+			while (m_Entries[slot].used && m_Entries[slot].key != key)
+				slot = (slot + 1) & mask;
+
+			return slot;
+		}
+
+		void allocate(size_t capacity)
+		{
+			m_Entries = new Entry[capacity];
+			m_Capacity = capacity;
+			m_Size = 0;
+		}
+
+		void grow()
+		{
+			Entry* oldEntries = m_Entries;
+			size_t oldCapacity = m_Capacity;
+
+			allocate(oldCapacity * 2);
+			for (size_t i = 0; i < oldCapacity; i++)
+			{
+				if (!oldEntries[i].used)
+					continue;
+
+				size_t slot = findSlot(oldEntries[i].key);
+				m_Entries[slot] = oldEntries[i];
+				m_Size++;
+			}
+
+			delete [] oldEntries;
+		}
+	};
+
+} // namespace pcpp
+
+#endif /* PACKETPP_FLOW_TABLE */
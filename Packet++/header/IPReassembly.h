@@ -5,7 +5,9 @@
 #include "LRUList.h"
 #include "IpAddress.h"
 #include "PointerVector.h"
+#include "FlowTable.h"
 #include <map>
+#include <vector>
 
 /**
  * @file
@@ -29,12 +31,33 @@
  * - If a non-IP packet arrives it's returned as is to the user
  * - If a non-fragment packet arrives it's returned as is to the user
  *
+ * pcpp#IPReassembly can optionally work in pooled buffer mode (determined in pcpp#IPReassembly c'tor), which avoids most of the copying
+ * and memory allocations described above:
+ * - Each packet being reassembled gets a buffer of the maximum IP payload size (64KB) from a pool. The pool allocates these buffers in slabs
+ *   and reuses them once packets are reassembled or dropped
+ * - Each fragment's data is copied once, straight to its offset in the buffer, whether it arrived in order or not. There are no out-of-order
+ *   lists and the buffer is never reallocated
+ * - The parts of the packet that are still missing are tracked by a hole list as described in RFC 815. The packet is reassembled once the
+ *   first and last fragments arrived and there are no holes left
+ * - When the packet is reassembled its headers and payload are copied once more into a RawPacket of the exact size which is returned to
+ *   the user, and the buffer goes back to the pool
+ *
+ * Pooled buffer mode trades memory for speed: each packet being reassembled holds a 64KB buffer, so the memory it uses may get up to the
+ * capacity limit described below times 64KB. Please consider setting a lower capacity limit when using it
+ *
  * In order to limit the amount of memory used by this mechanism there is a limit to the number of concurrent packets being reassembled.
  * The default limit is #PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE but the user can set any value (determined in pcpp#IPReassembly
  * c'tor). Once capacity (the number of concurrent reassembled packets) exceeds this number, the packet that was least recently used will be
  * dropped from the map along with all the data that was reassembled so far. This means that if the next fragment from this packet suddenly
  * appears it will be treated as a new reassembled packet (which will create another record in the map). The user can be notified when
  * reassembled packets are removed from the map by registering to the pcpp#IPReassembly#OnFragmentsClean callback in pcpp#IPReassembly c'tor
+ *
+ * Packets whose fragments stop arriving (for example when the last fragment was lost) can also be dropped after a timeout, which is disabled
+ * by default and can be set in pcpp#IPReassembly c'tor (#PCPP_IP_REASSEMBLY_DEFAULT_TIMEOUT is the common value operating systems use).
+ * The timeout counts from the first fragment seen for a packet and is measured by the timestamps of the processed packets rather than by
+ * the clock, so it works the same on live traffic and on pcap files. Packets are kept in a timer wheel with one slot per second, so
+ * finding the packets that timed out doesn't depend on the number of packets being reassembled. Packets dropped because of the timeout are
+ * also reported through the pcpp#IPReassembly#OnFragmentsClean callback
  */
 
 /**
@@ -49,6 +72,13 @@ namespace pcpp
 	 */
 	#define PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE 500000
 
+	/** The reassembly timeout (in seconds) operating systems commonly use. IPReassembly doesn't time packets out unless a timeout is set in
+	 * its c'tor
+	 */
+	#define PCPP_IP_REASSEMBLY_DEFAULT_TIMEOUT 30
+
+	class IPFragmentWrapper;
+
 	/**
 	 * @class IPReassembly
 	 * Contains the IP reassembly (a.k.a IP de-fragmentation) mechanism. Encapsulates both IPv4 and IPv6 reassembly.
@@ -229,7 +259,7 @@ namespace pcpp
 			{
 				m_FragmentID = other.m_FragmentID;
 				m_SrcIP = other.m_SrcIP;
-				m_SrcIP = other.m_DstIP;
+				m_DstIP = other.m_DstIP;
 				return *this;
 			}
 
@@ -289,7 +319,8 @@ namespace pcpp
 		 * @typedef OnFragmentsClean
 		 * The IP reassembly mechanism has a certain capacity of concurrent packets it can handle. This capacity is determined in its c'tor
 		 * (default value is #PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE). When traffic volume exceeds this capacity the mechanism starts
-		 * dropping packets in a LRU manner (least recently used are dropped first). Whenever a packet is dropped this callback is fired
+		 * dropping packets in a LRU manner (least recently used are dropped first). Packets are also dropped when the reassembly timeout
+		 * set in the c'tor expires before they're fully reassembled. Whenever a packet is dropped this callback is fired
 		 * @param[in] key A pointer to the identifier of the packet that is being dropped
 		 * @param[in] userCookie A pointer to the cookie provided by the user in IPReassemby c'tor (or NULL if no cookie provided)
 		 */
@@ -316,16 +347,40 @@ namespace pcpp
 			REASSEMBLED =           0x20
 		};
 
+		/**
+		 * @struct ReassemblyStatistics
+		 * Counters describing what happened to the packets processed by IPReassembly
+		 */
+		struct ReassemblyStatistics
+		{
+			/** The number of packets that were fully reassembled */
+			uint64_t numOfReassembledPackets;
+			/** The number of packets dropped because their reassembly timeout expired */
+			uint64_t numOfExpiredPackets;
+			/** The number of fragments whose data overlapped data already received for their packet, including duplicated fragments */
+			uint64_t numOfOverlappingFragments;
+
+			ReassemblyStatistics() : numOfReassembledPackets(0), numOfExpiredPackets(0), numOfOverlappingFragments(0) {}
+		};
+
 		/**
 		 * A c'tor for this class.
-		 * @param[in] onFragmentsCleanCallback The callback to be called when packets are dropped due to capacity limit.
+		 * @param[in] onFragmentsCleanCallback The callback to be called when packets are dropped due to capacity limit or timeout.
 		 * Please read more about capacity limit in IPReassembly.h file description. This parameter is optional, default value is NULL (no callback)
 		 * @param[in] callbackUserCookie A pointer to an object provided by the user. This pointer will be returned when invoking the
 		 * onFragmentsCleanCallback. This parameter is optional, default cookie is NULL
 		 * @param[in] maxPacketsToStore Set the capacity limit of the IP reassembly mechanism. Default capacity is #PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE
+		 * @param[in] usePooledBuffers Reassemble packets in buffers taken from a pool, writing each fragment straight to its offset. Please read
+		 * more about pooled buffer mode in IPReassembly.h file description. This parameter is optional, default value is false
+		 * @param[in] timeoutSec The number of seconds (by packet timestamps) a packet can wait for its fragments since its first fragment was
+		 * seen. Packets that aren't fully reassembled by then are dropped. This parameter is optional, default value is 0 which means packets
+		 * don't time out
 		 */
-		IPReassembly(OnFragmentsClean onFragmentsCleanCallback = NULL, void *callbackUserCookie = NULL, size_t maxPacketsToStore = PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE)
-			: m_PacketLRU(maxPacketsToStore), m_OnFragmentsCleanCallback(onFragmentsCleanCallback), m_CallbackUserCookie(callbackUserCookie) {}
+		IPReassembly(OnFragmentsClean onFragmentsCleanCallback = NULL, void *callbackUserCookie = NULL, size_t maxPacketsToStore = PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE,
+			bool usePooledBuffers = false, uint32_t timeoutSec = 0)
+			: m_PacketLRU(maxPacketsToStore), m_OnFragmentsCleanCallback(onFragmentsCleanCallback), m_CallbackUserCookie(callbackUserCookie),
+			  m_UsePooledBuffers(usePooledBuffers), m_FreeBuffers(NULL), m_TimeoutSec(timeoutSec), m_CurrentTime(0),
+			  m_TimerWheel(timeoutSec > 0 ? timeoutSec + 1 : 0) {}
 
 		/**
 		 * A d'tor for this class
@@ -417,7 +472,22 @@ namespace pcpp
 		/**
 		 * Get the current number of packets being processed
 		 */
-		size_t getCurrentCapacity() const { return m_FragmentMap.size(); }
+		size_t getCurrentCapacity() const { return m_UsePooledBuffers ? m_BufferMap.size() : m_FragmentMap.size(); }
+
+		/**
+		 * @return True if this instance works in pooled buffer mode (as determined in the c'tor), false otherwise
+		 */
+		bool isUsingPooledBuffers() const { return m_UsePooledBuffers; }
+
+		/**
+		 * @return The reassembly timeout in seconds as determined in the c'tor, or 0 if packets don't time out
+		 */
+		uint32_t getTimeout() const { return m_TimeoutSec; }
+
+		/**
+		 * @return The counters of reassembled, expired and overlapping packets since this instance was created
+		 */
+		const ReassemblyStatistics& getStatistics() const { return m_Statistics; }
 
 	private:
 
@@ -439,17 +509,69 @@ namespace pcpp
 			uint32_t fragmentID;
 			PacketKey* packetKey;
 			PointerVector<IPFragment> outOfOrderFragments;
-			IPFragmentData(PacketKey* pktKey, uint32_t fragId) { currentOffset = 0; data = NULL; deleteData = true; fragmentID = fragId; packetKey = pktKey; }
+			time_t expiryTime;
+			IPFragmentData(PacketKey* pktKey, uint32_t fragId) { currentOffset = 0; data = NULL; deleteData = true; fragmentID = fragId; packetKey = pktKey; expiryTime = 0; }
 			~IPFragmentData() { delete packetKey; if (deleteData && data != NULL) { delete data; } }
 		};
 
+		// a packet reassembled in pooled buffer mode. The objects and their payload buffers are allocated in slabs and reused, and the
+		// vectors keep their capacity between uses
+		struct ReassemblyBuffer
+		{
+			// a range of payload bytes that is still missing (RFC 815). Both ends are inclusive
+			struct Hole
+			{
+				uint32_t first;
+				uint32_t last;
+			};
+
+			uint8_t* payload;
+			// the bytes of the first fragment that come before the IP payload
+			std::vector<uint8_t> headers;
+			std::vector<Hole> holes;
+			// the payload length, known once the last fragment arrived
+			uint32_t payloadLength;
+			bool gotFirstFragment;
+			bool gotLastFragment;
+			timespec timestamp;
+			LinkLayerType linkLayerType;
+			uint32_t fragmentID;
+			time_t expiryTime;
+			IPv4PacketKey ipv4Key;
+			IPv6PacketKey ipv6Key;
+			// points at ipv4Key or ipv6Key
+			PacketKey* packetKey;
+			ReassemblyBuffer* nextFree;
+		};
+
 		LRUList<uint32_t> m_PacketLRU;
 		std::map<uint32_t, IPFragmentData*> m_FragmentMap;
 		OnFragmentsClean m_OnFragmentsCleanCallback;
 		void* m_CallbackUserCookie;
+		bool m_UsePooledBuffers;
+		FlowTable<ReassemblyBuffer*> m_BufferMap;
+		std::vector<ReassemblyBuffer*> m_BufferSlabs;
+		std::vector<uint8_t*> m_PayloadSlabs;
+		ReassemblyBuffer* m_FreeBuffers;
+		ReassemblyStatistics m_Statistics;
+		uint32_t m_TimeoutSec;
+		// the latest packet timestamp seen (in seconds), which is the time the timer wheel has advanced to
+		time_t m_CurrentTime;
+		// a slot per second holding the hashes of the packets that expire in it. Slots are emptied as the wheel advances. Hashes of packets
+		// that were reassembled or dropped before their time are skipped then
+		std::vector<std::vector<uint32_t> > m_TimerWheel;
 
 		void addNewFragment(uint32_t hash, IPFragmentData* fragData);
 		bool matchOutOfOrderFragments(IPFragmentData* fragData);
+		Packet* processPacketPooled(Packet* fragment, IPFragmentWrapper* fragWrapper, uint32_t hash, ReassemblyStatus& status, ProtocolType parseUntil, OsiModelLayer parseUntilLayer);
+		time_t scheduleExpiry(uint32_t hash);
+		void expirePackets(time_t now);
+		void expirePacket(uint32_t hash, time_t now);
+		ReassemblyBuffer* allocateBuffer();
+		void releaseBuffer(uint32_t hash, ReassemblyBuffer* buffer);
+		static uint32_t getContiguousPayloadLength(const ReassemblyBuffer* buffer);
+		static RawPacket* copyBufferToRawPacket(const ReassemblyBuffer* buffer, uint32_t payloadLength);
+		static Packet* createReassembledPacket(RawPacket* rawPacket, ProtocolType ipProtocol, uint16_t payloadLength, ProtocolType parseUntil, OsiModelLayer parseUntilLayer);
 	};
 
 } // namespace pcpp
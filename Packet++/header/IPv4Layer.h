@@ -465,8 +465,11 @@ namespace pcpp
 		/**
 		 * Set the source IP address
 		 * @param[in] ipAddr The IP address to set
+		 * @param[in] updateChecksums If true the IPv4 header checksum and the checksum of the TCP or UDP layer that follows this layer
+		 * (if any) are updated incrementally (RFC 1624) to reflect the new address, instead of having to recompute them using
+		 * computeCalculateFields(). Default value is false
 		 */
-		void setSrcIpAddress(const IPv4Address& ipAddr) { getIPv4Header()->ipSrc = ipAddr.toInt(); }
+		void setSrcIpAddress(const IPv4Address& ipAddr, bool updateChecksums = false);
 
 		/**
 		 * Get the destination IP address in the form of IPv4Address
@@ -477,8 +480,18 @@ namespace pcpp
 		/**
 		 * Set the dest IP address
 		 * @param[in] ipAddr The IP address to set
+		 * @param[in] updateChecksums If true the IPv4 header checksum and the checksum of the TCP or UDP layer that follows this layer
+		 * (if any) are updated incrementally (RFC 1624) to reflect the new address, instead of having to recompute them using
+		 * computeCalculateFields(). Default value is false
 		 */
-		void setDstIpAddress(const IPv4Address& ipAddr) { getIPv4Header()->ipDst = ipAddr.toInt(); }
+		void setDstIpAddress(const IPv4Address& ipAddr, bool updateChecksums = false);
+
+		/**
+		 * Decrement the time-to-live value by one and update the IPv4 header checksum incrementally (RFC 1624), as done by a router
+		 * forwarding the packet
+		 * @return True if the TTL was decremented, false if it's already 0
+		 */
+		bool decrementTTL();
 
 		/**
 		 * @return True if this packet is a fragment (in sense of IP fragmentation), false otherwise
@@ -586,7 +599,7 @@ namespace pcpp
 		 * Calculate the following fields:
 		 * - iphdr#ipVersion = 4;
 		 * - iphdr#totalLength = total packet length
-		 * - iphdr#headerChecksum = calculated
+		 * - iphdr#headerChecksum = calculated, or 0 if the checksum is offloaded (see Packet#setChecksumOffload())
 		 * - iphdr#protocol = calculated if next layer is known: ::PACKETPP_IPPROTO_TCP for TCP, ::PACKETPP_IPPROTO_UDP for UDP, ::PACKETPP_IPPROTO_ICMP for ICMP
 		 */
 		void computeCalculateFields();
@@ -603,6 +616,10 @@ namespace pcpp
 		 */
 		static inline bool isDataValid(const uint8_t* data, size_t dataLen);
 
+	protected:
+		bool isNextLayerReusable(const Layer* nextLayer) const;
+		void rebindData(uint8_t* data, size_t dataLen);
+
 	private:
 		int m_NumOfTrailingBytes;
 		int m_TempHeaderExtension;
@@ -614,6 +631,7 @@ namespace pcpp
 		void adjustOptionsTrailer(size_t totalOptSize);
 		void initLayer();
 		void initLayerInPacket(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, bool setTotalLenAsDataLen);
+		void updateChecksumsForAddressChange(uint32_t oldAddr, uint32_t newAddr);
 	};
 
 
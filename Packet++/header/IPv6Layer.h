@@ -176,6 +176,10 @@ namespace pcpp
 
 		OsiModelLayer getOsiModelLayer() const { return OsiModelNetworkLayer; }
 
+	protected:
+		bool isNextLayerReusable(const Layer* nextLayer) const;
+		void rebindData(uint8_t* data, size_t dataLen);
+
 	private:
 		void initLayer();
 		void parseExtensions();
@@ -76,9 +76,10 @@ namespace pcpp
 		virtual ~Layer();
 
 		/**
-		 * @return A pointer to the next layer in the protocol stack or NULL if the layer is the last one
+		 * @return A pointer to the next layer in the protocol stack or NULL if the layer is the last one. If the packet this layer belongs to
+		 * is parsed lazily (see Packet#setLazyParsing()) and the next layer wasn't parsed yet, it is parsed by this method
 		 */
-		Layer* getNextLayer() const { return m_NextLayer; }
+		Layer* getNextLayer() const { return (m_NextLayer != NULL || m_Packet == NULL) ? m_NextLayer : parseNextLayerOnDemand(); }
 
 		/**
 		 * @return A pointer to the previous layer in the protocol stack or NULL if the layer is the first one
@@ -159,6 +160,36 @@ namespace pcpp
 		 */
 		virtual OsiModelLayer getOsiModelLayer() const = 0;
 
+		/**
+		 * Allocate a layer instance on the heap. This is the allocation used by a plain <tt>new SomeLayer(...)</tt> expression
+		 * @param[in] size The size of the layer instance
+		 * @return A pointer to the allocated memory
+		 */
+		static void* operator new(size_t size);
+
+		/**
+		 * Allocate a layer instance from the layer arena of a packet (see pcpp#LayerArena). This allocation is used by the layers
+		 * when parsing the next layer of a packet, for example: <tt>new(m_Packet) TcpLayer(...)</tt>. If packet is NULL the layer
+		 * is allocated on the heap
+		 * @param[in] size The size of the layer instance
+		 * @param[in] packet The packet whose arena the layer should be allocated from
+		 * @return A pointer to the allocated memory
+		 */
+		static void* operator new(size_t size, Packet* packet);
+
+		/**
+		 * Release the memory of a layer instance, whether it was allocated on the heap or from a packet's layer arena
+		 * @param[in] ptr A pointer to the layer memory
+		 */
+		static void operator delete(void* ptr);
+
+		/**
+		 * Release the memory of a layer instance allocated from a packet's layer arena if its constructor throws
+		 * @param[in] ptr A pointer to the layer memory
+		 * @param[in] packet The packet whose arena the layer was allocated from
+		 */
+		static void operator delete(void* ptr, Packet* packet);
+
 	protected:
 		uint8_t* m_Data;
 		size_t m_DataLen;
@@ -181,9 +212,28 @@ namespace pcpp
 
 		void setNextLayer(Layer* nextLayer) { m_NextLayer = nextLayer; }
 		void setPrevLayer(Layer* prevLayer) { m_PrevLayer = prevLayer; }
+		Layer* parseNextLayerOnDemand() const;
 
 		virtual bool extendLayer(int offsetInLayer, size_t numOfBytesToExtend);
 		virtual bool shortenLayer(int offsetInLayer, size_t numOfBytesToShorten);
+
+		/**
+		 * Used by Packet#reparse() to check whether the layer parseNextLayer() would create for the current data is of the same type as
+		 * nextLayer, which is the layer that followed this layer in the previously parsed packet. If it is, nextLayer is re-bound to the
+		 * new data using rebindData() instead of being deleted and re-created. The default implementation returns false, meaning the
+		 * next layer is always re-created
+		 * @param[in] nextLayer The layer that followed this layer in the previously parsed packet
+		 * @return True if nextLayer can be re-bound to the data following this layer, false otherwise
+		 */
+		virtual bool isNextLayerReusable(const Layer* nextLayer) const { return false; }
+
+		/**
+		 * Used by Packet#reparse() to re-bind a layer of a previously parsed packet to the data of a new packet. Layers that keep
+		 * state derived from their data should override this method and re-initialize that state
+		 * @param[in] data A pointer to the new data
+		 * @param[in] dataLen The new data length in bytes
+		 */
+		virtual void rebindData(uint8_t* data, size_t dataLen) { m_Data = data; m_DataLen = dataLen; }
 	};
 
 } // namespace pcpp
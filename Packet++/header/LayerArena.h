@@ -0,0 +1,118 @@
+#ifndef PACKETPP_LAYER_ARENA
+#define PACKETPP_LAYER_ARENA
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @file
+
+/**
+ * \namespace pcpp
+ * \brief The main namespace for the PcapPlusPlus lib
+ */
+namespace pcpp
+{
+
+	/**
+	 * @class LayerArena
+	 * A bump allocator used by pcpp#Packet to allocate the layers it creates while parsing a raw packet. Instead of calling malloc/free
+	 * for each layer, layers are carved out of a few large memory blocks that are kept by the arena and reused every time the packet
+	 * is re-parsed (for example when calling Packet#setRawPacket() with a new raw packet). Releasing all layers of a packet therefore
+	 * doesn't return any memory to the heap, it only rewinds the arena to the beginning of its first block.<BR>
+	 * Every memory chunk handed out by the arena (or by allocateFromHeap()) is prefixed by a small header pointing to the block it was
+	 * carved from, so deallocate() can tell arena memory from heap memory. Each block also counts its live allocations: a layer that was
+	 * detached from the packet (see Packet#detachLayer()) keeps its block alive after the arena is reset or destroyed, and the block is
+	 * freed only when that layer is deleted
+	 */
+	class LayerArena
+	{
+	public:
+		/**
+		 * The default size in bytes of a single arena block. It's large enough to hold the layers of most packets in one block
+		 */
+		static const size_t DefaultBlockSize = 2048;
+
+		/**
+		 * A c'tor for this class. No memory is allocated until the first call to allocate()
+		 * @param[in] blockSize The size in bytes of each block the arena allocates. Default value is DefaultBlockSize
+		 */
+		LayerArena(size_t blockSize = DefaultBlockSize);
+
+		/**
+		 * A d'tor for this class. Frees all blocks that don't contain live allocations. Blocks that still contain live allocations
+		 * (e.g detached layers) are freed when their last allocation is deallocated
+		 */
+		~LayerArena();
+
+		/**
+		 * Allocate memory from the arena
+		 * @param[in] size The number of bytes to allocate
+		 * @return A pointer to the allocated memory, aligned to the platform's max alignment. The memory must be released using deallocate()
+		 */
+		void* allocate(size_t size);
+
+		/**
+		 * Rewind the arena so all its blocks can be reused. Should be called only after all the layers allocated from the arena were
+		 * deleted or detached. Blocks that still contain live (detached) allocations are handed over to those allocations
+		 */
+		void reset();
+
+		/**
+		 * Rewind the arena to the end of a certain allocation, so the next call to allocate() returns the memory that comes right after it.
+		 * Should be called only when all allocations made after this one were already released
+		 * @param[in] ptr A pointer to memory returned by allocate() of this arena
+		 */
+		void rewindAfter(const void* ptr);
+
+		/**
+		 * Check whether a memory chunk was allocated from this arena
+		 * @param[in] ptr A pointer to memory returned by allocate() or allocateFromHeap()
+		 * @return True if the memory was allocated from one of this arena's blocks, false otherwise
+		 */
+		bool isAllocatedFromArena(const void* ptr) const;
+
+		/**
+		 * @return The number of allocations made from this arena that weren't released yet
+		 */
+		size_t getLiveAllocationCount() const;
+
+		/**
+		 * Allocate memory from the heap with the same memory layout as memory allocated from the arena, so it can be released
+		 * using deallocate()
+		 * @param[in] size The number of bytes to allocate
+		 * @return A pointer to the allocated memory
+		 */
+		static void* allocateFromHeap(size_t size);
+
+		/**
+		 * Release memory returned by allocate() or allocateFromHeap(). Heap memory is freed immediately. Arena memory is reclaimed
+		 * when the arena is reset or when its block is no longer used
+		 * @param[in] ptr A pointer to the memory to release. If NULL nothing happens
+		 */
+		static void deallocate(void* ptr);
+
+	private:
+		struct Block
+		{
+			Block* next;
+			size_t capacity;
+			size_t used;
+			size_t liveAllocations;
+			bool orphaned;
+		};
+
+		Block* m_FirstBlock;
+		Block* m_CurBlock;
+		size_t m_BlockSize;
+
+		Block* createBlock(size_t capacity);
+		static uint8_t* getBlockData(Block* block);
+
+		// arena cannot be copied
+		LayerArena(const LayerArena& other);
+		LayerArena& operator=(const LayerArena& other);
+	};
+
+} // namespace pcpp
+
+#endif /* PACKETPP_LAYER_ARENA */
@@ -3,6 +3,7 @@
 
 #include "RawPacket.h"
 #include "Layer.h"
+#include "LayerArena.h"
 #include <vector>
 
 /// @file
@@ -33,6 +34,13 @@ namespace pcpp
 		uint64_t m_ProtocolTypes;
 		size_t m_MaxPacketLen;
 		bool m_FreeRawPacket;
+		LayerArena m_LayerArena;
+		bool m_LazyParsing;
+		bool m_AllLayersParsed;
+		ProtocolType m_ParseUntil;
+		OsiModelLayer m_ParseUntilLayer;
+		ProtocolType m_EnabledProtocols;
+		uint8_t m_ChecksumOffloadFlags;
 
 	public:
 
@@ -111,7 +119,9 @@ namespace pcpp
 		RawPacket* getRawPacket() const { return m_RawPacket; }
 
 		/**
-		 * Set a RawPacket and re-construct all packet layers
+		 * Set a RawPacket and re-construct all packet layers. Layers created while parsing are allocated from a memory arena owned by
+		 * this packet which is reused on every call to this method, so re-using the same Packet instance for many raw packets avoids
+		 * allocating memory for the layers of each packet
 		 * @param[in] rawPacket Raw packet to set
 		 * @param[in] freeRawPacket A flag indicating if the destructor should also call the raw packet destructor or not
 		 * @param[in] parseUntil Parse the packet until it reaches this protocol. Can be useful for cases when you need to parse only up to a certain layer and want to avoid the
@@ -121,6 +131,95 @@ namespace pcpp
 		 */
 		void setRawPacket(RawPacket* rawPacket, bool freeRawPacket, ProtocolType parseUntil = UnknownProtocol, OsiModelLayer parseUntilLayer = OsiModelLayerUnknown);
 
+		/**
+		 * Set a new RawPacket and re-parse it while re-using the layers of the previously parsed packet wherever possible. This method is
+		 * meant for the common case of parsing many packets with the same (or a similar) protocol stack, e.g when capturing from a single
+		 * link: layers are walked from the bottom up and as long as a layer of the new packet is of the same type as the layer at the same
+		 * position in the previous packet (currently Ethernet, VLAN, IPv4, IPv6, TCP and UDP), the existing layer object is re-bound to the
+		 * new data instead of being destructed and re-created. The rest of the packet is parsed as usual using the layer arena, so parsing a
+		 * stream of packets this way doesn't allocate any memory once the arena is warm.<BR>
+		 * If the previous layers can't be re-used (for example layers were added to or detached from the packet) this method behaves exactly
+		 * like setRawPacket(). Pointers to layers of the previous packet should be considered invalid after calling this method, even though
+		 * some of them may still point to valid layers of the new packet
+		 * @param[in] rawPacket Raw packet to set. The raw packet isn't owned by the packet and won't be freed by it (unless it's the raw
+		 * packet this packet already owns)
+		 * @param[in] parseUntil Parse the packet until it reaches this protocol. Default value is ::UnknownProtocol which means don't take
+		 * this parameter into account
+		 * @param[in] parseUntilLayer Parse the packet until certain layer in OSI model. Default value is ::OsiModelLayerUnknown which means
+		 * don't take this parameter into account
+		 */
+		void reparse(RawPacket* rawPacket, ProtocolType parseUntil = UnknownProtocol, OsiModelLayer parseUntilLayer = OsiModelLayerUnknown);
+
+		/**
+		 * Parse a burst of raw packets into an array of packets, e.g a burst received from DpdkDevice#receivePackets(), a batch of
+		 * packets handed over by PfRingDevice or packets read with IFileReaderDevice#getNextPackets(). Each raw packet is parsed into the
+		 * packet at the same index using reparse(), so packets that are re-used across bursts keep re-using their layers and their arena.
+		 * While a packet is parsed the headers of the packets that follow it in the burst are prefetched, so they're already in the
+		 * cache by the time they're parsed
+		 * @param[in] rawPackets An array of pointers to the raw packets to parse. The raw packets aren't owned by the packets and won't
+		 * be freed by them
+		 * @param[in] packets An array of packets to parse the raw packets into. Must contain at least count packets
+		 * @param[in] count The number of raw packets to parse
+		 * @param[in] parseUntil Parse the packets until they reach this protocol. Default value is ::UnknownProtocol which means don't
+		 * take this parameter into account
+		 * @param[in] parseUntilLayer Parse the packets until certain layer in OSI model. Default value is ::OsiModelLayerUnknown which
+		 * means don't take this parameter into account
+		 */
+		static void parseBatch(RawPacket** rawPackets, Packet* packets, size_t count, ProtocolType parseUntil = UnknownProtocol, OsiModelLayer parseUntilLayer = OsiModelLayerUnknown);
+
+		/**
+		 * Set whether this packet parses its layers lazily. When lazy parsing is enabled setRawPacket() and reparse() only parse the first
+		 * layer of the packet, and the rest of the layers are parsed on demand when they're first accessed, for example by
+		 * Layer#getNextLayer(), getLayerOfType(), getLastLayer() or isPacketOfType(). This avoids the cost of parsing layers that are never
+		 * looked at, e.g when only the L2-L4 layers of most packets are needed but the application layer is needed for some of them. Notice
+		 * that a negative answer from isPacketOfType() requires parsing the whole packet. Modifying the packet (e.g adding or removing
+		 * layers) parses all of its layers first. The setting takes effect the next time a raw packet is set, the default is eager parsing
+		 * @param[in] lazyParsing True to parse layers on demand, false to parse all layers when a raw packet is set
+		 */
+		void setLazyParsing(bool lazyParsing);
+
+		/**
+		 * @return True if this packet parses its layers lazily, false otherwise. See setLazyParsing()
+		 */
+		bool isLazyParsing() const { return m_LazyParsing; }
+
+		/**
+		 * Set the protocols this packet detects when parsing the application layer. The dissectors of disabled protocols aren't run at
+		 * all, so the data that would have been detected as one of them is parsed by the next candidate dissector or emitted as a
+		 * PayloadLayer. This allows skipping expensive detection heuristics (e.g of SIP, SDP, BGP, Radius or SSL) while still parsing
+		 * other protocols at the same depth, which isn't possible with the parseUntil parameters. The mask applies to the protocols
+		 * detected on top of TCP and UDP (see PortDissectorRegistry) and to SDP. A protocol that is split into sub-protocols (such as
+		 * ::HTTP or ::SIP) is skipped only if all of its sub-protocols are disabled. The setting takes effect the next time a raw packet
+		 * is set. The default value is the one set by setDefaultEnabledProtocols() when the packet was created
+		 * @param[in] enabledProtocols A bitmask of the enabled protocols, e.g `pcpp::AllProtocols & ~(pcpp::SIP | pcpp::SDP)`
+		 */
+		void setEnabledProtocols(ProtocolType enabledProtocols) { m_EnabledProtocols = enabledProtocols; }
+
+		/**
+		 * @return A bitmask of the protocols this packet detects. See setEnabledProtocols()
+		 */
+		ProtocolType getEnabledProtocols() const { return m_EnabledProtocols; }
+
+		/**
+		 * Check whether a protocol is detected by this packet. See setEnabledProtocols()
+		 * @param[in] protocolType The protocol to check. If it's a bitmask of several protocols the method returns true if at least one
+		 * of them is enabled
+		 * @return True if the protocol is enabled, false otherwise
+		 */
+		bool isProtocolEnabled(ProtocolType protocolType) const { return (m_EnabledProtocols & protocolType) != 0; }
+
+		/**
+		 * Set the enabled protocols of packets that are created from now on, including packets created internally by PcapPlusPlus
+		 * (for example by DpdkDevice#receivePackets()). See setEnabledProtocols(). The default value is ::AllProtocols
+		 * @param[in] enabledProtocols A bitmask of the enabled protocols
+		 */
+		static void setDefaultEnabledProtocols(ProtocolType enabledProtocols);
+
+		/**
+		 * @return The enabled protocols of newly created packets. See setDefaultEnabledProtocols()
+		 */
+		static ProtocolType getDefaultEnabledProtocols();
+
 		/**
 		 * Get a pointer to the Packet's RawPacket in a read-only manner
 		 * @return A pointer to the Packet's RawPacket
@@ -137,7 +236,7 @@ namespace pcpp
 		 * Get a pointer to the last (highest) layer in the packet
 		 * @return A pointer to the last (highest) layer in the packet
 		 */
-		Layer* getLastLayer() const { return m_LastLayer; }
+		Layer* getLastLayer() const { return m_AllLayersParsed ? m_LastLayer : parseAllLayersAndGetLast(); }
 
 		/**
 		 * Add a new layer as the last layer in the packet. This method gets a pointer to the new layer as a parameter
@@ -148,7 +247,7 @@ namespace pcpp
 		 * @return True if everything went well or false otherwise (an appropriate error log message will be printed in
 		 * such cases)
 		 */
-		bool addLayer(Layer* newLayer, bool ownInPacket = false) { return insertLayer(m_LastLayer, newLayer, ownInPacket); }
+		bool addLayer(Layer* newLayer, bool ownInPacket = false) { return insertLayer(getLastLayer(), newLayer, ownInPacket); }
 
 		/**
 		 * Insert a new layer after an existing layer in the packet. This method gets a pointer to the new layer as a
@@ -278,7 +377,7 @@ namespace pcpp
 		 * @param[in] protocolType The protocol type to search
 		 * @return True if the packet contains the protocol, false otherwise
 		 */
-		bool isPacketOfType(ProtocolType protocolType) const { return m_ProtocolTypes & protocolType; }
+		bool isPacketOfType(ProtocolType protocolType) const { return (m_ProtocolTypes & protocolType) != 0 || (!m_AllLayersParsed && parseUntilProtocolFound(protocolType)); }
 
 		/**
 		 * Each layer can have fields that can be calculate automatically from other fields using Layer#computeCalculateFields(). This method forces all layers to calculate these
@@ -286,6 +385,30 @@ namespace pcpp
 		 */
 		void computeCalculateFields();
 
+		/**
+		 * Set the checksums computeCalculateFields() leaves for the device sending the packet to compute (checksum offload), which
+		 * saves computing them in software for packets sent through devices that support it (e.g DpdkDevice). Only the checksums of
+		 * the outermost IP header and of the TCP or UDP header right on top of it can be offloaded, other checksums are always
+		 * computed in software. computeCalculateFields() prepares the offloaded checksum fields the way devices expect them and
+		 * describes the offloaded checksums in the raw packet (see RawPacket#getChecksumOffloadInfo()). Notice that devices that
+		 * don't support checksum offload (such as PcapLiveDevice) send the packet as is, with incorrect checksums
+		 * @param[in] flags A bitmask of ::ChecksumOffloadFlags. The default value is ::ChecksumOffloadNone
+		 */
+		void setChecksumOffload(uint8_t flags) { m_ChecksumOffloadFlags = flags; }
+
+		/**
+		 * @return A bitmask of ::ChecksumOffloadFlags of the checksums that are left for the device to compute. See setChecksumOffload()
+		 */
+		uint8_t getChecksumOffload() const { return m_ChecksumOffloadFlags; }
+
+		/**
+		 * Check whether the checksum of a certain layer of this packet is left for the device to compute. This is used by the layers'
+		 * computeCalculateFields() and rarely needs to be called directly. See setChecksumOffload()
+		 * @param[in] layer The layer to check
+		 * @return True if the layer's checksum is offloaded, false if it should be computed in software
+		 */
+		bool isChecksumOffloaded(const Layer* layer) const;
+
 		/**
 		 * Each layer can print a string representation of the layer most important data using Layer#toString(). This method aggregates this string from all layers and
 		 * print it to a complete string containing all packet's relevant data
@@ -316,6 +439,15 @@ namespace pcpp
 		std::string printPacketInfo(bool timeAsLocalTime) const;
 
 		Layer* createFirstLayer(LinkLayerType linkType);
+		bool isFirstLayerReusable(const RawPacket* rawPacket) const;
+		bool areLayersReusable() const;
+		void parseLayers(Layer* startLayer, ProtocolType parseUntil, OsiModelLayer parseUntilLayer);
+		bool parseNextLayerOnDemand();
+		void parseRemainingLayers();
+		Layer* parseAllLayersAndGetLast() const;
+		bool parseUntilProtocolFound(ProtocolType protocolType) const;
+		static void prefetchRawPacketHeaders(const RawPacket* rawPacket);
+		static bool isOutermostIPLayer(const Layer* layer);
 	}; // class Packet
 
 
@@ -0,0 +1,209 @@
+#ifndef PACKETPP_PACKET_VIEW
+#define PACKETPP_PACKET_VIEW
+
+#include "ProtocolType.h"
+#include "RawPacket.h"
+#include "IpAddress.h"
+
+/// @file
+
+/**
+ * \namespace pcpp
+ * \brief The main namespace for the PcapPlusPlus lib
+ */
+namespace pcpp
+{
+
+	class Packet;
+
+	/**
+	 * @class PacketView
+	 * A lightweight, allocation-free decoder of the most common packet headers, meant for hot paths such as flow classification that
+	 * only need the packet's 5-tuple and the offset of the transport layer payload. Unlike pcpp#Packet which creates a linked list of
+	 * polymorphic Layer objects, PacketView does a single linear pass over the raw data and records the protocol, offset and length of
+	 * each header it recognizes in a fixed-size array. It doesn't call any virtual method and doesn't allocate memory, so it can be
+	 * created on the stack for every packet.<BR>
+	 * The following headers are decoded: Ethernet II, Linux cooked capture (SLL), VLAN, MPLS, IPv4, IPv6 (including extension headers),
+	 * TCP, UDP, GREv0, GREv1, VXLAN and GTPv1. Protocols are identified using the same rules pcpp#Packet uses, so the decoded headers
+	 * match the layers of a Packet parsed from the same raw packet. Decoding stops at the first header that isn't in this list (for example
+	 * application layer protocols), at IP fragments, or when MaxHeaders headers were decoded. When more information is needed the view can
+	 * be upgraded to a full Packet using toPacket().<BR>
+	 * For tunneled traffic (IP-in-IP, GRE, VXLAN, GTP) the network and transport headers getters refer to the innermost headers
+	 */
+	class PacketView
+	{
+	public:
+		/**
+		 * The maximum number of headers a PacketView records
+		 */
+		static const size_t MaxHeaders = 16;
+
+		/**
+		 * @struct HeaderInfo
+		 * The protocol, offset and length of a single header decoded by PacketView
+		 */
+		struct HeaderInfo
+		{
+			/** The header protocol */
+			ProtocolType protocol;
+			/** The offset of the header from the beginning of the raw data */
+			uint16_t offset;
+			/** The header length in bytes. For IPv6 it includes all extension headers */
+			uint16_t length;
+		};
+
+		/**
+		 * A c'tor for this class that creates an empty view. Use parse() to decode a raw packet
+		 */
+		PacketView();
+
+		/**
+		 * A c'tor for this class that decodes a raw packet. See parse() for more details
+		 * @param[in] rawPacket A pointer to the raw packet to decode. The raw packet isn't copied so it should stay valid as long as
+		 * the view is used
+		 */
+		PacketView(RawPacket* rawPacket);
+
+		/**
+		 * Decode a raw packet. Information about the previously decoded raw packet (if any) is discarded
+		 * @param[in] rawPacket A pointer to the raw packet to decode. The raw packet isn't copied so it should stay valid as long as
+		 * the view is used
+		 * @return True if at least one header was decoded, false if rawPacket is NULL, empty or its link type isn't supported
+		 */
+		bool parse(RawPacket* rawPacket);
+
+		/**
+		 * Discard all decoded headers
+		 */
+		void clear();
+
+		/**
+		 * @return A pointer to the decoded raw packet or NULL if the view is empty
+		 */
+		RawPacket* getRawPacket() const { return m_RawPacket; }
+
+		/**
+		 * @return The number of decoded headers
+		 */
+		size_t getHeaderCount() const { return m_HeaderCount; }
+
+		/**
+		 * Get a decoded header by its index. Headers are ordered from the lowest (e.g Ethernet) to the highest (e.g TCP)
+		 * @param[in] index The header index. Must be smaller than getHeaderCount()
+		 * @return The information of the requested header
+		 */
+		const HeaderInfo& getHeader(size_t index) const { return m_Headers[index]; }
+
+		/**
+		 * Get a pointer to the data of a decoded header
+		 * @param[in] header A header returned by one of this view's getters
+		 * @return A pointer to the beginning of the header in the raw packet data
+		 */
+		const uint8_t* getHeaderData(const HeaderInfo& header) const { return m_RawPacket->getRawData() + header.offset; }
+
+		/**
+		 * Search for a header of a certain protocol
+		 * @param[in] protocolType The protocol to search for. Can also be a bitmask of protocols (e.g ::GRE), in which case the first
+		 * header that matches one of them is returned
+		 * @param[in] innermost If true the search starts from the highest header, meaning for tunneled packets the innermost header of this
+		 * protocol is returned. Default value is false
+		 * @return A pointer to the header information or NULL if no such header was decoded
+		 */
+		const HeaderInfo* getHeaderOfType(ProtocolType protocolType, bool innermost = false) const;
+
+		/**
+		 * Check whether one of the decoded headers is of a certain protocol
+		 * @param[in] protocolType The protocol to check
+		 * @return True if a header of this protocol was decoded, false otherwise
+		 */
+		bool isPacketOfType(ProtocolType protocolType) const { return (m_ProtocolTypes & protocolType) != 0; }
+
+		/**
+		 * @return The innermost IPv4 or IPv6 header or NULL if the packet doesn't contain an IP header
+		 */
+		const HeaderInfo* getNetworkHeader() const { return m_NetworkHeaderIndex < 0 ? NULL : &m_Headers[m_NetworkHeaderIndex]; }
+
+		/**
+		 * @return The innermost TCP or UDP header or NULL if the packet doesn't contain one. Notice that a TCP or UDP header that belongs
+		 * to an outer IP header of a tunnel isn't returned if the inner IP packet doesn't contain a transport header
+		 */
+		const HeaderInfo* getTransportHeader() const { return m_TransportHeaderIndex < 0 ? NULL : &m_Headers[m_TransportHeaderIndex]; }
+
+		/**
+		 * @return True if the innermost IP header is an IPv4 or IPv6 fragment. In this case the transport header isn't decoded
+		 */
+		bool isFragment() const { return m_IsFragment; }
+
+		/**
+		 * @return The source IPv4 address of the innermost IP header or IPv4Address#Zero if it isn't an IPv4 header
+		 */
+		IPv4Address getSrcIPv4Address() const;
+
+		/**
+		 * @return The destination IPv4 address of the innermost IP header or IPv4Address#Zero if it isn't an IPv4 header
+		 */
+		IPv4Address getDstIPv4Address() const;
+
+		/**
+		 * @return The source IPv6 address of the innermost IP header or IPv6Address#Zero if it isn't an IPv6 header
+		 */
+		IPv6Address getSrcIPv6Address() const;
+
+		/**
+		 * @return The destination IPv6 address of the innermost IP header or IPv6Address#Zero if it isn't an IPv6 header
+		 */
+		IPv6Address getDstIPv6Address() const;
+
+		/**
+		 * @return The source port of the innermost TCP or UDP header (in host byte order) or 0 if there is no such header
+		 */
+		uint16_t getSrcPort() const;
+
+		/**
+		 * @return The destination port of the innermost TCP or UDP header (in host byte order) or 0 if there is no such header
+		 */
+		uint16_t getDstPort() const;
+
+		/**
+		 * @return The offset from the beginning of the raw data of the payload that follows the innermost TCP or UDP header, or 0 if there
+		 * is no such header
+		 */
+		size_t getTransportPayloadOffset() const;
+
+		/**
+		 * @return The length of the payload that follows the innermost TCP or UDP header, or 0 if there is no such header. Padding and
+		 * trailer bytes that don't belong to the IP packet are excluded
+		 */
+		size_t getTransportPayloadLen() const;
+
+		/**
+		 * Upgrade the view to a full Packet by parsing the raw packet this view was created from
+		 * @param[out] packet The packet to parse the raw packet into. Layers of the raw packet previously parsed into this packet are
+		 * re-used where possible (see Packet#reparse()). The raw packet isn't owned by the packet
+		 * @param[in] parseUntil Parse the packet until it reaches this protocol. Default value is ::UnknownProtocol which means parse
+		 * all layers
+		 * @param[in] parseUntilLayer Parse the packet until certain layer in OSI model. Default value is ::OsiModelLayerUnknown which means
+		 * parse all layers
+		 * @return True if the packet was parsed, false if the view is empty
+		 */
+		bool toPacket(Packet& packet, ProtocolType parseUntil = UnknownProtocol, OsiModelLayer parseUntilLayer = OsiModelLayerUnknown) const;
+
+	private:
+		RawPacket* m_RawPacket;
+		HeaderInfo m_Headers[MaxHeaders];
+		size_t m_HeaderCount;
+		uint64_t m_ProtocolTypes;
+		int m_NetworkHeaderIndex;
+		int m_TransportHeaderIndex;
+		size_t m_NetworkEnd;
+		bool m_IsFragment;
+
+		bool addHeader(ProtocolType protocol, size_t offset, size_t length);
+		static ProtocolType getProtocolByEtherType(uint16_t etherType, const uint8_t* payload, size_t payloadLen);
+		static ProtocolType getProtocolByIPVersion(const uint8_t* payload, size_t payloadLen);
+		static ProtocolType getProtocolByIPProtocol(uint8_t ipProtocol, const uint8_t* payload, size_t payloadLen);
+	};
+
+} // namespace pcpp
+
+#endif /* PACKETPP_PACKET_VIEW */
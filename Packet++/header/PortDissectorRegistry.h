@@ -0,0 +1,222 @@
+#ifndef PACKETPP_PORT_DISSECTOR_REGISTRY
+#define PACKETPP_PORT_DISSECTOR_REGISTRY
+
+#include "ProtocolType.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/// @file
+
+/**
+ * \namespace pcpp
+ * \brief The main namespace for the PcapPlusPlus lib
+ */
+namespace pcpp
+{
+
+	class Layer;
+	class Packet;
+
+	/**
+	 * @class PortDissectorRegistry
+	 * A registry of the dissectors TcpLayer and UdpLayer use to detect the protocol that comes on top of them. Each dissector is
+	 * registered for a transport protocol (::TCP or ::UDP) together with the list of ports it should be tried on. The registry keeps a
+	 * 64K-entry table per transport protocol that maps each port to a bitmask of the dissectors registered on it, so detecting the next
+	 * layer of a TCP or UDP packet takes two table lookups and only runs the dissectors registered on the packet's source or destination
+	 * port, instead of checking every known protocol one after another.<BR>
+	 * Candidate dissectors are tried by priority (the order they were registered in, unless changed using setDissectorPriority()) and
+	 * the first one that recognizes the data creates the next layer. If none does, a PayloadLayer is created.<BR>
+	 * All built-in dissectors (HTTP, SSL/TLS, SIP, BGP, DHCP, VXLAN, DNS, Radius and GTPv1) are registered on their well-known ports
+	 * when the registry is created. Dissectors can be disabled, moved to other ports or re-prioritized at runtime, and user-defined
+	 * dissectors can be added. Notice the registry is shared by all packets and isn't thread-safe: it should be modified only while no
+	 * packets are parsed.<BR>
+	 * This class is a singleton which can be reached using getInstance()
+	 */
+	class PortDissectorRegistry
+	{
+	public:
+		/**
+		 * A dissector function. It gets the transport layer payload and returns the layer it created from it, or NULL if it doesn't
+		 * recognize the data, in which case the next candidate dissector is tried
+		 * @param[in] data A pointer to the transport layer payload
+		 * @param[in] dataLen The payload length
+		 * @param[in] prevLayer The TCP or UDP layer the payload belongs to
+		 * @param[in] packet The packet the layer belongs to. Layers should be allocated using `new(packet)`
+		 * @param[in] srcPort The transport layer source port (in host byte order)
+		 * @param[in] dstPort The transport layer destination port (in host byte order)
+		 * @return The created layer or NULL if the data wasn't recognized
+		 */
+		typedef Layer* (*DissectorFunc)(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t srcPort, uint16_t dstPort);
+
+		/**
+		 * Which of the packet's ports is matched against the ports of a dissector
+		 */
+		enum PortDirection
+		{
+			/** The dissector is tried only if the packet's source port is one of its ports */
+			MatchSrcPort = 0x1,
+			/** The dissector is tried only if the packet's destination port is one of its ports */
+			MatchDstPort = 0x2,
+			/** The dissector is tried if either the packet's source or destination port is one of its ports */
+			MatchAnyPort = 0x3
+		};
+
+		/**
+		 * The maximum number of dissectors that can be registered per transport protocol
+		 */
+		static const size_t MaxDissectors = 32;
+
+		/**
+		 * The number of entries in the port table of each transport protocol
+		 */
+		static const size_t NumOfPorts = 65536;
+
+		/**
+		 * @return The singleton instance of the registry
+		 */
+		static PortDissectorRegistry& getInstance()
+		{
+			static PortDissectorRegistry instance;
+			return instance;
+		}
+
+		/**
+		 * Register a new dissector with the lowest priority. The dissector isn't tried on any port until ports are added using addPort()
+		 * @param[in] transport The transport protocol the dissector is registered for. Can be ::TCP or ::UDP
+		 * @param[in] protocol The protocol the dissector detects. It's used to identify the dissector in the registry so it must be
+		 * unique per transport protocol
+		 * @param[in] dissector The dissector function
+		 * @param[in] portDirection Which of the packet's ports is matched against the dissector ports. Default value is MatchAnyPort
+		 * @return True if the dissector was registered, false if transport is invalid, a dissector for this protocol is already
+		 * registered or MaxDissectors dissectors are already registered
+		 */
+		bool registerDissector(ProtocolType transport, ProtocolType protocol, DissectorFunc dissector, PortDirection portDirection = MatchAnyPort);
+
+		/**
+		 * Remove a dissector from the registry
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @return True if the dissector was removed, false if no such dissector is registered
+		 */
+		bool unregisterDissector(ProtocolType transport, ProtocolType protocol);
+
+		/**
+		 * Add a port the dissector is tried on
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @param[in] port The port to add
+		 * @return True if the port was added or was already registered for this dissector, false if no such dissector is registered
+		 */
+		bool addPort(ProtocolType transport, ProtocolType protocol, uint16_t port);
+
+		/**
+		 * Stop trying a dissector on a certain port
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @param[in] port The port to remove
+		 * @return True if the port was removed, false if no such dissector is registered or it isn't registered on this port
+		 */
+		bool removePort(ProtocolType transport, ProtocolType protocol, uint16_t port);
+
+		/**
+		 * Check whether a dissector is tried on a certain port
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @param[in] port The port to check
+		 * @return True if the dissector is registered on this port, false otherwise
+		 */
+		bool isPortRegistered(ProtocolType transport, ProtocolType protocol, uint16_t port) const;
+
+		/**
+		 * Enable or disable a dissector on all of its ports. A disabled dissector keeps its ports and priority
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @param[in] enabled True to enable the dissector, false to disable it
+		 * @return True if the dissector was found, false otherwise
+		 */
+		bool setDissectorEnabled(ProtocolType transport, ProtocolType protocol, bool enabled);
+
+		/**
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @return True if the dissector is registered and enabled, false otherwise
+		 */
+		bool isDissectorEnabled(ProtocolType transport, ProtocolType protocol) const;
+
+		/**
+		 * Change the order in which a dissector is tried relative to the other dissectors of the same transport protocol
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @param[in] priority The new priority of the dissector where 0 is the highest priority. If it's larger than the number of
+		 * registered dissectors the dissector gets the lowest priority
+		 * @return True if the dissector was found, false otherwise
+		 */
+		bool setDissectorPriority(ProtocolType transport, ProtocolType protocol, size_t priority);
+
+		/**
+		 * @param[in] transport The transport protocol the dissector is registered for
+		 * @param[in] protocol The protocol of the dissector
+		 * @return The priority of the dissector (0 is the highest priority) or -1 if no such dissector is registered
+		 */
+		int getDissectorPriority(ProtocolType transport, ProtocolType protocol) const;
+
+		/**
+		 * Remove all user changes and user-defined dissectors, and register the built-in dissectors on their default ports
+		 */
+		void resetToDefaults();
+
+		/**
+		 * Create the layer that comes on top of a TCP or UDP layer by trying the dissectors registered on its ports. Dissectors of
+		 * protocols that are disabled in the packet (see Packet#setEnabledProtocols()) are skipped
+		 * @param[in] transport The transport protocol, ::TCP or ::UDP
+		 * @param[in] data A pointer to the transport layer payload
+		 * @param[in] dataLen The payload length
+		 * @param[in] prevLayer The TCP or UDP layer the payload belongs to
+		 * @param[in] packet The packet the layer belongs to
+		 * @param[in] srcPort The transport layer source port (in host byte order)
+		 * @param[in] dstPort The transport layer destination port (in host byte order)
+		 * @return The layer created by the first dissector that recognized the data or NULL if no dissector recognized it
+		 */
+		Layer* dissect(ProtocolType transport, uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t srcPort, uint16_t dstPort) const;
+
+	private:
+		struct Dissector
+		{
+			ProtocolType protocol;
+			DissectorFunc func;
+			PortDirection portDirection;
+			bool enabled;
+		};
+
+		struct TransportDissectors
+		{
+			// ordered by priority
+			Dissector dissectors[MaxDissectors];
+			size_t numOfDissectors;
+			// bit i of each entry is set if dissectors[i] is registered on this port
+			uint32_t portTable[NumOfPorts];
+			// bits of the enabled dissectors that match the source or destination port
+			uint32_t srcPortMask;
+			uint32_t dstPortMask;
+		};
+
+		TransportDissectors m_TcpDissectors;
+		TransportDissectors m_UdpDissectors;
+
+		PortDissectorRegistry();
+
+		// registry cannot be copied
+		PortDissectorRegistry(const PortDissectorRegistry& other);
+		PortDissectorRegistry& operator=(const PortDissectorRegistry& other);
+
+		TransportDissectors* getTransportDissectors(ProtocolType transport);
+		const TransportDissectors* getTransportDissectors(ProtocolType transport) const;
+		static int findDissectorIndex(const TransportDissectors& transportDissectors, ProtocolType protocol);
+		static void addDissector(TransportDissectors& transportDissectors, ProtocolType protocol, DissectorFunc dissector, PortDirection portDirection, bool (*isDefaultPort)(uint16_t));
+		static void removeDissector(TransportDissectors& transportDissectors, size_t index);
+		static void updatePortMasks(TransportDissectors& transportDissectors);
+	};
+
+} // namespace pcpp
+
+#endif /* PACKETPP_PORT_DISSECTOR_REGISTRY */
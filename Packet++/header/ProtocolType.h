@@ -227,6 +227,11 @@ namespace pcpp
 	 */
 	const ProtocolType BGP = 0x200000000;
 
+	/**
+	 * A bitmask of all protocols
+	 */
+	const ProtocolType AllProtocols = 0xFFFFFFFFFFFFFFFF;
+
 	/**
 	 * An enum representing OSI model layers
 	 */
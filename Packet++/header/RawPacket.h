@@ -211,6 +211,58 @@ namespace pcpp
 	 */
 #define PCPP_MAX_PACKET_SIZE 65536
 
+	/**
+	 * The checksums the device sending a packet can be asked to compute instead of computing them in software (checksum offload).
+	 * Values can be combined as a bitmask
+	 */
+	enum ChecksumOffloadFlags
+	{
+		/** All checksums are computed in software */
+		ChecksumOffloadNone = 0x00,
+		/** The IPv4 header checksum */
+		ChecksumOffloadIPv4 = 0x01,
+		/** The TCP checksum */
+		ChecksumOffloadTCP = 0x02,
+		/** The UDP checksum */
+		ChecksumOffloadUDP = 0x04,
+		/** All of the above */
+		ChecksumOffloadAll = 0x07
+	};
+
+	/**
+	 * @struct ChecksumOffloadInfo
+	 * Describes which checksums of a raw packet were left for the sending device to compute and where the headers they cover are.
+	 * It's filled by Packet#computeCalculateFields() when checksum offload is enabled for the packet (see Packet#setChecksumOffload()).
+	 * Offloaded checksums are left in the packet in the form devices expect: the IPv4 header checksum is 0 and the TCP/UDP checksum
+	 * contains the (not inverted) checksum of the pseudo header, so the device only needs to add the sum of the L4 header and payload.
+	 * DPDK devices translate this information to mbuf offload flags. For partial checksum interfaces such as Linux's virtio_net_hdr
+	 * the checksum should be computed from getL4ChecksumStart() to the end of the packet and stored at getL4ChecksumStart() +
+	 * getL4ChecksumOffset()
+	 */
+	struct ChecksumOffloadInfo
+	{
+		/** A bitmask of ::ChecksumOffloadFlags describing the offloaded checksums. ::ChecksumOffloadNone if no checksum is offloaded */
+		uint8_t flags;
+		/** True if the IP header is IPv6, false if it's IPv4 */
+		bool isIPv6;
+		/** The offset of the IP header from the beginning of the packet, which is the total length of the L2 headers */
+		uint16_t l2Len;
+		/** The IP header length including IPv4 options or IPv6 extension headers */
+		uint16_t l3Len;
+
+		/**
+		 * @return The offset from the beginning of the packet the offloaded TCP/UDP checksum starts from, which is the beginning of
+		 * the TCP/UDP header
+		 */
+		uint16_t getL4ChecksumStart() const { return l2Len + l3Len; }
+
+		/**
+		 * @return The offset of the TCP/UDP checksum field from the beginning of the TCP/UDP header, or 0 if no TCP/UDP checksum is
+		 * offloaded
+		 */
+		uint16_t getL4ChecksumOffset() const { return (flags & ChecksumOffloadTCP) ? 16 : ((flags & ChecksumOffloadUDP) ? 6 : 0); }
+	};
+
 	/**
 	 * @class RawPacket
 	 * This class holds the packet as raw (not parsed) data. The data is held as byte array. In addition to the data itself
@@ -227,6 +279,7 @@ namespace pcpp
 		bool m_DeleteRawDataAtDestructor;
 		bool m_RawPacketSet;
 		LinkLayerType m_LinkLayerType;
+		ChecksumOffloadInfo m_ChecksumOffloadInfo;
 		void init(bool deleteRawDataAtDestructor = true);
 		void copyDataFrom(const RawPacket& other, bool allocateData = true);
 	public:
@@ -314,6 +367,20 @@ namespace pcpp
 		 */
 		virtual bool setRawData(const uint8_t* pRawData, int rawDataLen, timespec timestamp, LinkLayerType layerType = LINKTYPE_ETHERNET, int frameLength = -1);
 
+		/**
+		 * Set a raw data which this instance doesn't own, meaning it won't be freed by the d'tor, by clear() or when other data is set. This
+		 * allows a RawPacket to point at data that lives elsewhere (for example a memory-mapped file) without copying it. The data must remain
+		 * valid as long as this instance uses it. If this instance owned the data that was set before, this data is freed first
+		 * @param[in] pRawData A pointer to the new raw data
+		 * @param[in] rawDataLen The new raw data length in bytes
+		 * @param[in] timestamp The timestamp packet was received by the NIC (in nsec precision)
+		 * @param[in] layerType The link layer type for this raw data
+		 * @param[in] frameLength When reading from pcap files, sometimes the captured length is different from the actual packet length. This parameter represents the packet
+		 * length. This parameter is optional, if not set or set to -1 it is assumed both lengths are equal
+		 * @return True if raw data was set successfully, false otherwise
+		 */
+		bool initWithRawData(const uint8_t* pRawData, int rawDataLen, timespec timestamp, LinkLayerType layerType = LINKTYPE_ETHERNET, int frameLength = -1);
+
 		/**
 		 * Get raw data pointer
 		 * @return A read-only pointer to the raw data
@@ -373,9 +440,9 @@ namespace pcpp
 		bool isPacketSet() const { return m_RawPacketSet; }
 
 		/**
-		 * Clears all members of this instance, meaning setting raw data to NULL, raw data length to 0, etc. Currently raw data is always freed,
-		 * even if deleteRawDataAtDestructor was set to 'false'
-		 * @todo deleteRawDataAtDestructor was set to 'true', don't free the raw data
+		 * Clears all members of this instance, meaning setting raw data to NULL, raw data length to 0, etc. The raw data is freed only if
+		 * this instance owns it (deleteRawDataAtDestructor was set to 'true'). Afterwards the instance owns the data set to it, as a
+		 * default-constructed instance does
 		 * @todo set timestamp to a default value as well
 		 */
 		virtual void clear();
@@ -416,6 +483,20 @@ namespace pcpp
 		 * @return True if data was reallocated successfully, false otherwise
 		 */
 		virtual bool reallocateData(size_t newBufferLength);
+
+		/**
+		 * Set the checksum offload information of this raw packet, which tells the device sending it which checksums it should compute.
+		 * This is usually done by Packet#computeCalculateFields() and rarely needs to be called directly. The information is reset when
+		 * new raw data is set or the raw packet is cleared
+		 * @param[in] info The checksum offload information to set
+		 */
+		virtual void setChecksumOffloadInfo(const ChecksumOffloadInfo& info) { m_ChecksumOffloadInfo = info; }
+
+		/**
+		 * @return The checksum offload information of this raw packet. Its flags are ::ChecksumOffloadNone if all checksums were
+		 * computed in software
+		 */
+		const ChecksumOffloadInfo& getChecksumOffloadInfo() const { return m_ChecksumOffloadInfo; }
 	};
 
 } // namespace pcpp
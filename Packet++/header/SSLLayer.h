@@ -196,8 +196,10 @@ namespace pcpp
 		 * criteria to identify SSL/TLS packets
 		 * @param[in] data The data to check
 		 * @param[in] dataLen Length (in bytes) of the data
+		 * @param[in] ignorePorts Check only the raw data and don't take the ports into account. Useful when the ports were already
+		 * matched by the caller, e.g by PortDissectorRegistry. Default value is false
 		 */
-		static bool IsSSLMessage(uint16_t srcPort, uint16_t dstPort, uint8_t* data, size_t dataLen);
+		static bool IsSSLMessage(uint16_t srcPort, uint16_t dstPort, uint8_t* data, size_t dataLen, bool ignorePorts = false);
 
 		/**
 		 * A static method that creates SSL/TLS layers by raw data. This method parses the raw data, finds if and which
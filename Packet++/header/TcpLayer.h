@@ -366,6 +366,22 @@ namespace pcpp
 		 */
 		tcphdr* getTcpHeader() const { return (tcphdr*)m_Data; }
 
+		/**
+		 * Set the source port
+		 * @param[in] port The port to set (in host byte order)
+		 * @param[in] updateChecksum If true the TCP checksum is updated incrementally (RFC 1624) to reflect the new port, instead of
+		 * having to recompute it over the whole payload using computeCalculateFields(). Default value is false
+		 */
+		void setSrcPort(uint16_t port, bool updateChecksum = false);
+
+		/**
+		 * Set the destination port
+		 * @param[in] port The port to set (in host byte order)
+		 * @param[in] updateChecksum If true the TCP checksum is updated incrementally (RFC 1624) to reflect the new port, instead of
+		 * having to recompute it over the whole payload using computeCalculateFields(). Default value is false
+		 */
+		void setDstPort(uint16_t port, bool updateChecksum = false);
+
 		/**
 		 * Get a TCP option by type
 		 * @param[in] option TCP option type to retrieve
@@ -435,7 +451,16 @@ namespace pcpp
 		 * @param[in] writeResultToPacket If set to true then checksum result will be written to @ref tcphdr#headerChecksum
 		 * @return The checksum result
 		 */
-		uint16_t calculateChecksum(bool writeResultToPacket);
+		uint16_t calculateChecksum(bool writeResultToPacket) { return calculateChecksum(writeResultToPacket, false); }
+
+		/**
+		 * Calculate the checksum of the pseudo header only (not inverted) and possibly write the result to @ref tcphdr#headerChecksum.
+		 * This is the value devices that compute the checksum (checksum offload) expect to find in the checksum field, see
+		 * Packet#setChecksumOffload()
+		 * @param[in] writeResultToPacket If set to true then checksum result will be written to @ref tcphdr#headerChecksum
+		 * @return The pseudo header checksum
+		 */
+		uint16_t calculatePseudoHeaderChecksum(bool writeResultToPacket) { return calculateChecksum(writeResultToPacket, true); }
 
 		/**
 		 * The static method makes validation of input data
@@ -458,7 +483,8 @@ namespace pcpp
 		size_t getHeaderLen() const { return getTcpHeader()->dataOffset*4 ;}
 
 		/**
-		 * Calculate @ref tcphdr#headerChecksum field
+		 * Calculate @ref tcphdr#headerChecksum field. If the checksum is offloaded (see Packet#setChecksumOffload()) only the pseudo
+		 * header checksum is calculated
 		 */
 		void computeCalculateFields();
 
@@ -466,12 +492,16 @@ namespace pcpp
 
 		OsiModelLayer getOsiModelLayer() const { return OsiModelTransportLayer; }
 
+	protected:
+		void rebindData(uint8_t* data, size_t dataLen);
+
 	private:
 
 		TLVRecordReader<TcpOption> m_OptionReader;
 		int m_NumOfTrailingBytes;
 
 		void initLayer();
+		uint16_t calculateChecksum(bool writeResultToPacket, bool pseudoHeaderOnly);
 		uint8_t* getOptionsBasePtr() const { return m_Data + sizeof(tcphdr); }
 		TcpOption addTcpOptionAt(const TcpOptionBuilder& optionBuilder, int offset);
 		void adjustTcpOptionTrailer(size_t totalOptSize);
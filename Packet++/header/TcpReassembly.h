@@ -4,8 +4,10 @@
 #include "Packet.h"
 #include "IpAddress.h"
 #include "PointerVector.h"
+#include "FlowTable.h"
 #include <map>
 #include <list>
+#include <vector>
 #include <time.h>
 
 
@@ -19,7 +21,7 @@
  * - Support TCP retransmission
  * - Support out-of-order packets
  * - Support missing TCP data
- * - TCP connections can end "naturally" (by FIN/RST packets) or manually by the user
+ * - TCP connections can end "naturally" (by FIN/RST packets), manually by the user or after being idle for a configurable amount of time
  * - Support callbacks for new TCP data, connection start and connection end
  *
  * __Logic Description:__
@@ -37,9 +39,15 @@
  *   (meaning, after the data before arrives)
  * - If the missing data doesn't arrive until a new message from the other side of the connection arrives or until the connection ends - this will be considered as missing data and the
  *   queued data will be sent to the user, but the string "[X bytes missing]" will be added to the message sent in the callback
- * - pcpp#TcpReassembly supports 2 more callbacks - one is invoked when a new TCP connection is first seen and the other when it's ended (either by a FIN/RST packet or manually by the user).
- *   Both of these callbacks contain data about the connection (5-tuple, 4-byte hash key describing the connection, etc.) and also a pointer to a "user cookie", meaning a pointer to a
- *   structure provided by the user during the creation of the pcpp#TcpReassembly instance. The end connection callback also provides the reason for closing it ("naturally" or manually)
+ * - If pcpp#TcpReassemblyConfiguration#deliverSegmentReferences is set, the data isn't copied into a contiguous buffer before it's sent to the user. Instead the callback gets a list of
+ *   segments pointing into the packets that carried the data (out-of-order packets are copied whole while they're queued), and missing data is reported by
+ *   pcpp#TcpStreamData#getMissingDataLength() rather than by a text marker
+ * - pcpp#TcpReassembly supports 2 more callbacks - one is invoked when a new TCP connection is first seen and the other when it's ended (either by a FIN/RST packet, manually by the user
+ *   or by an idle timeout). Both of these callbacks contain data about the connection (5-tuple, 4-byte hash key describing the connection, etc.) and also a pointer to a "user cookie", meaning
+ *   a pointer to a structure provided by the user during the creation of the pcpp#TcpReassembly instance. The end connection callback also provides the reason for closing it ("naturally",
+ *   manually or by timeout)
+ * - If an idle timeout is configured (see pcpp#TcpReassemblyConfiguration#idleTimeout), connections that didn't see any TCP packet for that long are closed. Time is taken from the packet
+ *   timestamps rather than from the wall clock, so replaying a capture file closes the same connections no matter how fast it's replayed
  *
  * __Basic Usage and APIs:__
  * - pcpp#TcpReassembly c'tor - Create an instance, provide the callbacks and the user cookie to the instance
@@ -48,7 +56,7 @@
  * - pcpp#TcpReassembly#closeAllConnections() - Manually close all currently opened connections
  * - pcpp#TcpReassembly#OnTcpMessageReady callback - Invoked when new data arrives on a certain connection. Contains the new data as well as connection data (5-tuple, flow key)
  * - pcpp#TcpReassembly#OnTcpConnectionStart callback - Invoked when a new connection is identified
- * - pcpp#TcpReassembly#OnTcpConnectionEnd callback - Invoked when a connection ends (either by FIN/RST or manually by the user)
+ * - pcpp#TcpReassembly#OnTcpConnectionEnd callback - Invoked when a connection ends (either by FIN/RST, manually by the user or by an idle timeout)
  *
  * __Additional information:__
  * When the connection is closed the information is not being deleted from memory immediately. There is a delay between these moments. Existence of this delay is caused by two reasons:
@@ -77,6 +85,30 @@ namespace pcpp
  */
 struct ConnectionData
 {
+	/**
+	 * @struct SideStatistics
+	 * Counters describing the traffic of one side of a TCP connection. They're only collected if TcpReassemblyConfiguration#collectConnectionStatistics is set
+	 */
+	struct SideStatistics
+	{
+		/** The number of TCP packets seen on this side, including packets without payload such as pure ACKs */
+		uint64_t numOfPackets;
+		/** The number of TCP payload bytes seen on this side, including retransmitted bytes */
+		uint64_t numOfBytes;
+		/** The number of packets that were ignored because all of their data was already seen (retransmissions) */
+		uint64_t numOfRetransmittedPackets;
+		/** The number of out-of-order packets that were buffered */
+		uint64_t numOfOutOfOrderPackets;
+		/** The number of times data was found to be missing (never seen) in the stream */
+		uint64_t numOfGaps;
+		/** The total number of bytes that were missing in the stream */
+		uint64_t numOfMissingBytes;
+		/** The highest number of out-of-order payload bytes buffered for this side at the same time */
+		uint64_t peakOutOfOrderBytes;
+
+		SideStatistics() : numOfPackets(0), numOfBytes(0), numOfRetransmittedPackets(0), numOfOutOfOrderPackets(0), numOfGaps(0), numOfMissingBytes(0), peakOutOfOrderBytes(0) {}
+	};
+
 	/** Source IP address */
 	IPAddress* srcIP;
 	/** Destination IP address */
@@ -91,11 +123,18 @@ struct ConnectionData
 	timeval startTime;
 	/** End TimeStamp of the connection */
 	timeval endTime;
+	/** Start timestamp of the connection in nanosecond precision. ConnectionData#startTime holds the same time in microsecond precision */
+	timespec startTimePrecise;
+	/** End timestamp of the connection in nanosecond precision. ConnectionData#endTime holds the same time in microsecond precision */
+	timespec endTimePrecise;
+	/** Counters of the two sides of the connection, indexed by the side index TcpReassembly#OnTcpMessageReady gets. They're kept up to date in the
+	 * ConnectionData instance passed to the callbacks, but not in the one kept by TcpReassembly#getConnectionInformation() */
+	SideStatistics sideStats[2];
 
 	/**
 	 * A c'tor for this struct that basically zeros all members
 	 */
-	ConnectionData() : srcIP(NULL), dstIP(NULL), srcPort(0), dstPort(0), flowKey(0), startTime(), endTime()  {}
+	ConnectionData() : srcIP(NULL), dstIP(NULL), srcPort(0), dstPort(0), flowKey(0), startTime(), endTime(), startTimePrecise(), endTimePrecise()  {}
 
 	/**
 	 * A d'tor for this strcut. Notice it frees the memory of srcIP and dstIP members
@@ -136,6 +175,18 @@ struct ConnectionData
 	 */
 	void setEndTime(const timeval &endTime) { this->endTime = endTime; }
 
+	/**
+	 * Set the start time of the connection in nanosecond precision. Both ConnectionData#startTimePrecise and ConnectionData#startTime are set
+	 * @param[in] startTime The start time
+	 */
+	void setStartTime(const timespec &startTime);
+
+	/**
+	 * Set the end time of the connection in nanosecond precision. Both ConnectionData#endTimePrecise and ConnectionData#endTime are set
+	 * @param[in] endTime The end time
+	 */
+	void setEndTime(const timespec &endTime);
+
 private:
 
 	void copyData(const ConnectionData& other);
@@ -148,11 +199,27 @@ class TcpReassembly;
 /**
  * @class TcpStreamData
  * When following a TCP connection each packet may contain a piece of the data transferred between the client and the server. This class represents these pieces: each instance of it
- * contains a piece of data, usually extracted from a single packet, as well as information about the connection
+ * contains a piece of data, usually extracted from a single packet, as well as information about the connection.<BR>
+ * If TcpReassemblyConfiguration#deliverSegmentReferences is set, one instance may describe the data of several consecutive packets. The data is then a list of segments, each pointing
+ * into the packet that carried it, and getData() points only to the first segment. The segments and the packets they point to are valid only during the callback
  */
 class TcpStreamData
 {
 public:
+	/**
+	 * @struct Segment
+	 * A piece of TCP data pointing into the packet that carried it
+	 */
+	struct Segment
+	{
+		/** A pointer to the data, inside the raw data of Segment#rawPacket */
+		const uint8_t* data;
+		/** The length of the data */
+		size_t dataLength;
+		/** The packet that carried the data */
+		const RawPacket* rawPacket;
+	};
+
 	/**
 	 * A c'tor for this class that get data from outside and set the internal members
 	 * @param[in] tcpData A pointer to buffer containing the TCP data piece
@@ -160,10 +227,19 @@ public:
 	 * @param[in] connData TCP connection information for this TCP data
 	 */
 	TcpStreamData(const uint8_t* tcpData, size_t tcpDataLength, const ConnectionData& connData)
-		: m_Data(tcpData), m_DataLen(tcpDataLength), m_Connection(connData)
+		: m_Data(tcpData), m_DataLen(tcpDataLength), m_Segments(NULL), m_NumOfSegments(1), m_MissingDataLen(0), m_Connection(connData)
 	{
 	}
 
+	/**
+	 * A c'tor for this class that gets a list of segments
+	 * @param[in] segments An array of segments holding the TCP data piece in stream order. The array isn't copied
+	 * @param[in] numOfSegments The number of segments in the array
+	 * @param[in] missingDataLength The number of bytes missing in the stream right before the first segment
+	 * @param[in] connData TCP connection information for this TCP data
+	 */
+	TcpStreamData(const Segment* segments, size_t numOfSegments, size_t missingDataLength, const ConnectionData& connData);
+
 	/**
 	 * A getter for the data buffer
 	 * @return A pointer to the buffer
@@ -182,9 +258,41 @@ public:
 	 */
 	const ConnectionData& getConnectionData() const { return m_Connection; }
 
+	/**
+	 * @return The number of segments the data consists of. It's always 1 unless TcpReassemblyConfiguration#deliverSegmentReferences is set
+	 */
+	size_t getNumOfSegments() const { return m_NumOfSegments; }
+
+	/**
+	 * @param[in] index The segment index, between 0 and getNumOfSegments()-1
+	 * @return A pointer to the data of the segment
+	 */
+	const uint8_t* getSegmentData(size_t index) const { return (m_Segments != NULL ? m_Segments[index].data : m_Data); }
+
+	/**
+	 * @param[in] index The segment index, between 0 and getNumOfSegments()-1
+	 * @return The length of the data of the segment
+	 */
+	size_t getSegmentLength(size_t index) const { return (m_Segments != NULL ? m_Segments[index].dataLength : m_DataLen); }
+
+	/**
+	 * @param[in] index The segment index, between 0 and getNumOfSegments()-1
+	 * @return The packet that carried the segment or NULL if it's unknown, which is the case unless TcpReassemblyConfiguration#deliverSegmentReferences is set
+	 */
+	const RawPacket* getSegmentRawPacket(size_t index) const { return (m_Segments != NULL ? m_Segments[index].rawPacket : NULL); }
+
+	/**
+	 * @return The number of bytes missing in the stream right before this data, which means they were never seen. It's always 0 unless
+	 * TcpReassemblyConfiguration#deliverSegmentReferences is set, otherwise missing data is reported as a "[X bytes missing]" text at the beginning of the data
+	 */
+	size_t getMissingDataLength() const { return m_MissingDataLen; }
+
 private:
 	const uint8_t* m_Data;
 	size_t m_DataLen;
+	const Segment* m_Segments;
+	size_t m_NumOfSegments;
+	size_t m_MissingDataLen;
 	const ConnectionData& m_Connection;
 };
 
@@ -195,6 +303,20 @@ private:
  */
 struct TcpReassemblyConfiguration
 {
+	/**
+	 * What to do with an out-of-order TCP segment that can't be buffered because one of the out-of-order limits was reached
+	 */
+	enum OutOfOrderLimitPolicy
+	{
+		/** Stop waiting for the missing data on this side of the connection: all data buffered for this side and the new segment are sent to
+		 * TcpReassembly#OnTcpMessageReady in sequence order, with "[X bytes missing]" markers (or TcpStreamData#getMissingDataLength()) in place of the missing data */
+		FlushWithGap,
+		/** Drop the new segment and keep the data that is already buffered */
+		DropNewest,
+		/** Drop the whole connection: all buffered data is discarded and the connection is closed with TcpReassembly#TcpReassemblyConnectionClosedByOutOfOrderLimit */
+		DropConnection
+	};
+
 	/** The flag indicating whether to remove the connection data after a connection is closed */
 	bool removeConnInfo;
 
@@ -208,14 +330,47 @@ struct TcpReassemblyConfiguration
 	 */
 	uint32_t maxNumToClean;
 
+	/** How long a connection may stay without seeing any TCP packet before it's closed with TcpReassembly#TcpReassemblyConnectionClosedByTimeout. The value is expressed in seconds
+	 * and is measured using packet timestamps. Like after a FIN or RST, packets that arrive on a timed-out connection are ignored until the connection is purged. If the value is set to 0
+	 * idle connections are never closed.
+	 */
+	uint32_t idleTimeout;
+
+	/** The maximum number of out-of-order TCP payload bytes buffered by all connections together. If the value is set to 0 (the default) there is no limit */
+	size_t maxOutOfOrderBytes;
+
+	/** The maximum number of out-of-order TCP payload bytes buffered for one side of a connection. If the value is set to 0 (the default) there is no limit */
+	size_t maxOutOfOrderBytesPerSide;
+
+	/** The maximum number of out-of-order TCP segments buffered for one side of a connection. If the value is set to 0 (the default) there is no limit */
+	uint32_t maxOutOfOrderSegmentsPerSide;
+
+	/** What to do with an out-of-order segment that would exceed one of the limits above. The default is FlushWithGap */
+	OutOfOrderLimitPolicy outOfOrderLimitPolicy;
+
+	/** If set, TcpReassembly#OnTcpMessageReady gets the data as a list of segments pointing into the packets that carried it (see TcpStreamData#getSegmentData()): data that
+	 * becomes available together is sent in one callback without being copied to one buffer, and missing data is reported by TcpStreamData#getMissingDataLength() instead of a
+	 * "[X bytes missing]" text. An out-of-order packet is still copied while it waits for its turn, and the whole packet is copied (headers included) rather than only its payload,
+	 * so buffering out-of-order data takes more memory than without this option. The default is false
+	 */
+	bool deliverSegmentReferences;
+
+	/** If set, the per-side counters in ConnectionData#sideStats are collected. Counting packets without payload (such as pure ACKs) requires looking up their
+	 * connection, which TcpReassembly doesn't do otherwise. The default is false
+	 */
+	bool collectConnectionStatistics;
+
 	/**
-	 * A c'tor for this struct
+	 * A c'tor for this struct. The out-of-order limits, the segment references option and the connection statistics option aren't set by the c'tor, they're off unless the relevant fields are set after construction
 	 * @param[in] removeConnInfo The flag indicating whether to remove the connection data after a connection is closed. The default is true
 	 * @param[in] closedConnectionDelay How long the closed connections will not be cleaned up. The value is expressed in seconds. If it's set to 0 the default value will be used. The default is 5.
 	 * @param[in] maxNumToClean The maximum number of items to be cleaned up per one call of purgeClosedConnections. If it's set to 0 the default value will be used. The default is 30.
+	 * @param[in] idleTimeout How long (in seconds, according to packet timestamps) a connection may be idle before it's closed. The default is 0 which means idle connections are never closed
 	 */
-	TcpReassemblyConfiguration(bool removeConnInfo = true, uint32_t closedConnectionDelay = 5, uint32_t maxNumToClean = 30) :
-		removeConnInfo(removeConnInfo), closedConnectionDelay(closedConnectionDelay), maxNumToClean(maxNumToClean)
+	TcpReassemblyConfiguration(bool removeConnInfo = true, uint32_t closedConnectionDelay = 5, uint32_t maxNumToClean = 30, uint32_t idleTimeout = 0) :
+		removeConnInfo(removeConnInfo), closedConnectionDelay(closedConnectionDelay), maxNumToClean(maxNumToClean), idleTimeout(idleTimeout),
+		maxOutOfOrderBytes(0), maxOutOfOrderBytesPerSide(0), maxOutOfOrderSegmentsPerSide(0), outOfOrderLimitPolicy(FlushWithGap),
+		deliverSegmentReferences(false), collectConnectionStatistics(false)
 	{
 	}
 };
@@ -237,7 +392,11 @@ public:
 		/** Connection ended because of FIN or RST packet */
 		TcpReassemblyConnectionClosedByFIN_RST,
 		/** Connection ended manually by the user */
-		TcpReassemblyConnectionClosedManually
+		TcpReassemblyConnectionClosedManually,
+		/** Connection ended because it was idle for longer than TcpReassemblyConfiguration#idleTimeout */
+		TcpReassemblyConnectionClosedByTimeout,
+		/** Connection dropped because an out-of-order limit was reached and the policy is TcpReassemblyConfiguration#DropConnection */
+		TcpReassemblyConnectionClosedByOutOfOrderLimit
 	};
 
 	/**
@@ -300,6 +459,38 @@ public:
 		 * Normally this will be happen.
 		 */
 		Error_PacketDoesNotMatchFlow,
+		/**
+		 * The processed packet is an out-of-order TCP packet which couldn't be buffered because an out-of-order limit was reached (see TcpReassemblyConfiguration).
+		 * Depending on TcpReassemblyConfiguration#outOfOrderLimitPolicy either the packet was dropped or the whole connection was dropped. If the policy is
+		 * TcpReassemblyConfiguration#FlushWithGap the buffered data is sent to `OnTcpMessageReady` instead and `TcpMessageHandled` is returned
+		 */
+		OutOfOrderLimitReached,
+	};
+
+	/**
+	 * @struct OutOfOrderStatistics
+	 * Counters describing the memory used for buffering out-of-order TCP data and what was done when the out-of-order limits were reached
+	 */
+	struct OutOfOrderStatistics
+	{
+		/** The number of out-of-order TCP payload bytes currently buffered by all connections */
+		uint64_t bufferedBytes;
+		/** The number of out-of-order TCP segments currently buffered by all connections */
+		uint64_t bufferedSegments;
+		/** The highest value bufferedBytes ever reached */
+		uint64_t peakBufferedBytes;
+		/** The number of times an out-of-order segment would have exceeded one of the limits */
+		uint64_t numOfLimitsReached;
+		/** The number of times the buffered data of a connection side was flushed because of the TcpReassemblyConfiguration#FlushWithGap policy */
+		uint64_t numOfFlushes;
+		/** The number of segments dropped because of the TcpReassemblyConfiguration#DropNewest policy */
+		uint64_t numOfDroppedSegments;
+		/** The number of TCP payload bytes dropped because of the TcpReassemblyConfiguration#DropNewest or TcpReassemblyConfiguration#DropConnection policies */
+		uint64_t numOfDroppedBytes;
+		/** The number of connections dropped because of the TcpReassemblyConfiguration#DropConnection policy */
+		uint64_t numOfDroppedConnections;
+
+		OutOfOrderStatistics() : bufferedBytes(0), bufferedSegments(0), peakBufferedBytes(0), numOfLimitsReached(0), numOfFlushes(0), numOfDroppedSegments(0), numOfDroppedBytes(0), numOfDroppedConnections(0) {}
 	};
 
 	/**
@@ -326,9 +517,9 @@ public:
 
 	/**
 	 * @typedef OnTcpConnectionEnd
-	 * A callback invoked when a TCP connection is terminated, either by a FIN or RST packet or manually by the user
+	 * A callback invoked when a TCP connection is terminated, either by a FIN or RST packet, manually by the user or by an idle timeout
 	 * @param[in] connectionData Connection information
-	 * @param[in] reason The reason for connection termination: FIN/RST packet or manually by the user
+	 * @param[in] reason The reason for connection termination: FIN/RST packet, manually by the user or idle timeout
 	 * @param[in] userCookie A pointer to the cookie provided by the user in TcpReassembly c'tor (or NULL if no cookie provided)
 	 */
 	typedef void (*OnTcpConnectionEnd)(const ConnectionData& connectionData, ConnectionEndReason reason, void* userCookie);
@@ -338,7 +529,7 @@ public:
 	 * @param[in] onMessageReadyCallback The callback to be invoked when new data arrives
 	 * @param[in] userCookie A pointer to an object provided by the user. This pointer will be returned when invoking the various callbacks. This parameter is optional, default cookie is NULL
 	 * @param[in] onConnectionStartCallback The callback to be invoked when a new connection is identified. This parameter is optional
-	 * @param[in] onConnectionEndCallback The callback to be invoked when a new connection is terminated (either by a FIN/RST packet or manually by the user). This parameter is optional
+	 * @param[in] onConnectionEndCallback The callback to be invoked when a new connection is terminated (either by a FIN/RST packet, manually by the user or by an idle timeout). This parameter is optional
 	 * @param[in] config Optional parameter for defining special configuration parameters. If not set the default parameters will be set
 	 */
 	TcpReassembly(OnTcpMessageReady onMessageReadyCallback, void* userCookie = NULL, OnTcpConnectionStart onConnectionStartCallback = NULL, OnTcpConnectionEnd onConnectionEndCallback = NULL, const TcpReassemblyConfiguration &config = TcpReassemblyConfiguration());
@@ -398,15 +589,22 @@ public:
 	 */
 	uint32_t purgeClosedConnections(uint32_t maxNumToClean = 0);
 
+	/**
+	 * @return The out-of-order buffering counters of this TcpReassembly instance
+	 */
+	const OutOfOrderStatistics& getOutOfOrderStatistics() const { return m_OutOfOrderStats; }
+
 private:
 	struct TcpFragment
 	{
 		uint32_t sequence;
 		size_t dataLength;
 		uint8_t* data;
+		// if segment references are delivered the fragment keeps the whole packet and data points into it, otherwise data is a copy of the payload
+		RawPacket* rawPacket;
 
-		TcpFragment() { sequence = 0; dataLength = 0; data = NULL; }
-		~TcpFragment() { if (data != NULL) delete [] data; }
+		TcpFragment() { sequence = 0; dataLength = 0; data = NULL; rawPacket = NULL; }
+		~TcpFragment() { if (rawPacket != NULL) delete rawPacket; else if (data != NULL) delete [] data; }
 	};
 
 	struct TcpOneSideData
@@ -414,12 +612,14 @@ private:
 		IPAddress* srcIP;
 		uint16_t srcPort;
 		uint32_t sequence;
+		// out-of-order fragments sorted by sequence
 		PointerVector<TcpFragment> tcpFragmentList;
+		size_t outOfOrderBytes;
 		bool gotFinOrRst;
 
 		void setSrcIP(IPAddress* sourrcIP);
 
-		TcpOneSideData() { srcIP = NULL; srcPort = 0; sequence = 0; gotFinOrRst = false; }
+		TcpOneSideData() { srcIP = NULL; srcPort = 0; sequence = 0; outOfOrderBytes = 0; gotFinOrRst = false; }
 
 		~TcpOneSideData() { if (srcIP != NULL) delete srcIP; }
 	};
@@ -430,11 +630,19 @@ private:
 		int prevSide;
 		TcpOneSideData twoSides[2];
 		ConnectionData connData;
-
-		TcpReassemblyData() { numOfSides = 0; prevSide = -1; }
+		// idle timeout bookkeeping: the timestamp (in seconds) of the last packet seen on the connection, and the links of the
+		// timer wheel slot the connection is kept in (timerSlot is -1 if it isn't in the timer wheel)
+		time_t lastActivity;
+		int timerSlot;
+		TcpReassemblyData* timerPrev;
+		TcpReassemblyData* timerNext;
+
+		TcpReassemblyData() { numOfSides = 0; prevSide = -1; lastActivity = 0; timerSlot = -1; timerPrev = NULL; timerNext = NULL; }
 	};
 	
-	typedef std::map<uint32_t, TcpReassemblyData *> ConnectionList;
+	// connections are looked up by flow key in an open-addressing table. A NULL value marks a connection that is already closed but
+	// wasn't purged yet
+	typedef FlowTable<TcpReassemblyData*> ConnectionList;
 	typedef std::map<time_t, std::list<uint32_t> > CleanupList;
 
 	OnTcpMessageReady m_OnMessageReadyCallback;
@@ -448,16 +656,64 @@ private:
 	uint32_t m_ClosedConnectionDelay;
 	uint32_t m_MaxNumToClean;
 	time_t m_PurgeTimepoint;
+	// TcpReassemblyData objects are constructed in slabs of raw memory instead of being allocated one by one. Free slots are
+	// chained in a list through their first bytes
+	std::vector<void*> m_ReassemblyDataSlabs;
+	void* m_FreeReassemblyData;
+	// open connections are kept in a timer wheel with a 1-second slot per second of packet time. A connection is linked into the slot
+	// of its idle deadline and isn't moved when packets arrive, it's only re-checked when the wheel reaches that slot
+	uint32_t m_IdleTimeout;
+	std::vector<TcpReassemblyData*> m_TimerWheel;
+	time_t m_TimerWheelTime;
+	// the flow keys of the connections found idle in a timer wheel slot. They're unlinked from the wheel before any of them is closed, since
+	// the user's callback may close other connections of the same slot
+	std::vector<uint32_t> m_IdleFlowKeys;
+	size_t m_MaxOutOfOrderBytes;
+	size_t m_MaxOutOfOrderBytesPerSide;
+	uint32_t m_MaxOutOfOrderSegmentsPerSide;
+	TcpReassemblyConfiguration::OutOfOrderLimitPolicy m_OutOfOrderLimitPolicy;
+	OutOfOrderStatistics m_OutOfOrderStats;
+	// data that is ready to be sent to the user is collected here when segment references are delivered, so consecutive pieces of data
+	// are sent in one callback. It's sent by flushSegments()
+	bool m_DeliverSegmentReferences;
+	std::vector<TcpStreamData::Segment> m_PendingSegments;
+	size_t m_PendingMissingDataLen;
+	bool m_CollectConnectionStats;
 
 	void checkOutOfOrderFragments(TcpReassemblyData* tcpReassemblyData, int sideIndex, bool cleanWholeFragList);
 
+	void addOutOfOrderFragment(TcpReassemblyData* tcpReassemblyData, int sideIndex, TcpFragment* tcpFragment);
+
+	// remove the first numOfFrags fragments (the ones with the lowest sequence) from the out-of-order list of a side
+	void removeOutOfOrderFragments(TcpReassemblyData* tcpReassemblyData, int sideIndex, size_t numOfFrags);
+
+	void clearOutOfOrderFragments(TcpReassemblyData* tcpReassemblyData, int sideIndex);
+
+	bool isOutOfOrderLimitReached(const TcpReassemblyData* tcpReassemblyData, int sideIndex, size_t dataLength) const;
+
 	std::string prepareMissingDataMessage(uint32_t missingDataLen);
 
+	void sendData(TcpReassemblyData* tcpReassemblyData, int sideIndex, const uint8_t* data, size_t dataLength, const RawPacket* rawPacket, uint32_t missingDataLen);
+
+	void flushSegments(TcpReassemblyData* tcpReassemblyData, int sideIndex);
+
+	void handlePacketWithNoData(Packet& tcpData, Layer* ipLayer, uint16_t srcPort);
+
 	void handleFinOrRst(TcpReassemblyData* tcpReassemblyData, int sideIndex, uint32_t flowKey);
 
 	void closeConnectionInternal(uint32_t flowKey, ConnectionEndReason reason);
 
 	void insertIntoCleanupList(uint32_t flowKey);
+
+	TcpReassemblyData* allocateReassemblyData();
+
+	void freeReassemblyData(TcpReassemblyData* tcpReassemblyData);
+
+	void addToTimerWheel(TcpReassemblyData* tcpReassemblyData);
+
+	void removeFromTimerWheel(TcpReassemblyData* tcpReassemblyData);
+
+	void closeIdleConnections(time_t currentTime);
 };
 
 }
@@ -59,12 +59,39 @@ namespace pcpp
 		 */
 		udphdr* getUdpHeader() const { return (udphdr*)m_Data; }
 
+		/**
+		 * Set the source port
+		 * @param[in] port The port to set (in host byte order)
+		 * @param[in] updateChecksum If true the UDP checksum is updated incrementally (RFC 1624) to reflect the new port, instead of
+		 * having to recompute it over the whole payload using computeCalculateFields(). A zero checksum (meaning no checksum was
+		 * computed) is left as is. Default value is false
+		 */
+		void setSrcPort(uint16_t port, bool updateChecksum = false);
+
+		/**
+		 * Set the destination port
+		 * @param[in] port The port to set (in host byte order)
+		 * @param[in] updateChecksum If true the UDP checksum is updated incrementally (RFC 1624) to reflect the new port, instead of
+		 * having to recompute it over the whole payload using computeCalculateFields(). A zero checksum (meaning no checksum was
+		 * computed) is left as is. Default value is false
+		 */
+		void setDstPort(uint16_t port, bool updateChecksum = false);
+
 		/**
 		 * Calculate the checksum from header and data and possibly write the result to @ref udphdr#headerChecksum
 		 * @param[in] writeResultToPacket If set to true then checksum result will be written to @ref udphdr#headerChecksum
 		 * @return The checksum result
 		 */
-		uint16_t calculateChecksum(bool writeResultToPacket);
+		uint16_t calculateChecksum(bool writeResultToPacket) { return calculateChecksum(writeResultToPacket, false); }
+
+		/**
+		 * Calculate the checksum of the pseudo header only (not inverted) and possibly write the result to @ref udphdr#headerChecksum.
+		 * This is the value devices that compute the checksum (checksum offload) expect to find in the checksum field, see
+		 * Packet#setChecksumOffload()
+		 * @param[in] writeResultToPacket If set to true then checksum result will be written to @ref udphdr#headerChecksum
+		 * @return The pseudo header checksum
+		 */
+		uint16_t calculatePseudoHeaderChecksum(bool writeResultToPacket) { return calculateChecksum(writeResultToPacket, true); }
 
 		// implement abstract methods
 
@@ -80,13 +107,18 @@ namespace pcpp
 		size_t getHeaderLen() const { return sizeof(udphdr); }
 
 		/**
-		 * Calculate @ref udphdr#headerChecksum field
+		 * Calculate @ref udphdr#headerChecksum field. If the checksum is offloaded (see Packet#setChecksumOffload()) only the pseudo
+		 * header checksum is calculated
 		 */
 		void computeCalculateFields();
 
 		std::string toString() const;
 
 		OsiModelLayer getOsiModelLayer() const { return OsiModelTransportLayer; }
+
+	private:
+		uint16_t calculateChecksum(bool writeResultToPacket, bool pseudoHeaderOnly);
+		void updateChecksumForPortChange(uint16_t oldPort, uint16_t newPort);
 	};
 
 } // namespace pcpp
@@ -38,15 +38,15 @@ BgpLayer* BgpLayer::parseBgpLayer(uint8_t* data, size_t dataLen, Layer* prevLaye
   switch (bgpHeader->messageType)
   {
   case 1: // OPEN
-    return new BgpOpenMessageLayer(data, dataLen, prevLayer, packet);
+    return new(packet) BgpOpenMessageLayer(data, dataLen, prevLayer, packet);
   case 2: // UPDATE
-    return new BgpUpdateMessageLayer(data, dataLen, prevLayer, packet);
+    return new(packet) BgpUpdateMessageLayer(data, dataLen, prevLayer, packet);
   case 3: // NOTIFICATION
-    return new BgpNotificationMessageLayer(data, dataLen, prevLayer, packet);
+    return new(packet) BgpNotificationMessageLayer(data, dataLen, prevLayer, packet);
   case 4: // KEEPALIVE
-    return new BgpKeepaliveMessageLayer(data, dataLen, prevLayer, packet);
+    return new(packet) BgpKeepaliveMessageLayer(data, dataLen, prevLayer, packet);
   case 5: // ROUTE-REFRESH
-    return new BgpRouteRefreshMessageLayer(data, dataLen, prevLayer, packet);
+    return new(packet) BgpRouteRefreshMessageLayer(data, dataLen, prevLayer, packet);
   default:
     return NULL;
   }
@@ -28,7 +28,7 @@ void EthDot3Layer::parseNextLayer()
 	uint8_t* payload = m_Data + sizeof(ether_dot3_header);
 	size_t payloadLen = m_DataLen - sizeof(ether_dot3_header);
 
-	m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+	m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 }
 
 std::string EthDot3Layer::toString() const
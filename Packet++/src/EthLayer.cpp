@@ -42,31 +42,31 @@ void EthLayer::parseNextLayer()
 	{
 	case PCPP_ETHERTYPE_IP:
 		m_NextLayer = IPv4Layer::isDataValid(payload, payloadLen)
-			? static_cast<Layer*>(new IPv4Layer(payload, payloadLen, this, m_Packet))
-			: static_cast<Layer*>(new PayloadLayer(payload, payloadLen, this, m_Packet));
+			? static_cast<Layer*>(new(m_Packet) IPv4Layer(payload, payloadLen, this, m_Packet))
+			: static_cast<Layer*>(new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet));
 		break;
 	case PCPP_ETHERTYPE_IPV6:
 		m_NextLayer = IPv6Layer::isDataValid(payload, payloadLen)
-			? static_cast<Layer*>(new IPv6Layer(payload, payloadLen, this, m_Packet))
-			: static_cast<Layer*>(new PayloadLayer(payload, payloadLen, this, m_Packet));
+			? static_cast<Layer*>(new(m_Packet) IPv6Layer(payload, payloadLen, this, m_Packet))
+			: static_cast<Layer*>(new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet));
 		break;
 	case PCPP_ETHERTYPE_ARP:
-		m_NextLayer = new ArpLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) ArpLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PCPP_ETHERTYPE_VLAN:
-		m_NextLayer = new VlanLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) VlanLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PCPP_ETHERTYPE_PPPOES:
-		m_NextLayer = new PPPoESessionLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PPPoESessionLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PCPP_ETHERTYPE_PPPOED:
-		m_NextLayer = new PPPoEDiscoveryLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PPPoEDiscoveryLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PCPP_ETHERTYPE_MPLS:
-		m_NextLayer = new MplsLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) MplsLayer(payload, payloadLen, this, m_Packet);
 		break;
 	default:
-		m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 	}
 }
 
@@ -94,6 +94,28 @@ void EthLayer::computeCalculateFields()
 	}
 }
 
+bool EthLayer::isNextLayerReusable(const Layer* nextLayer) const
+{
+	// must mirror the decisions made in parseNextLayer()
+	if (m_DataLen <= sizeof(ether_header))
+		return false;
+
+	uint8_t* payload = m_Data + sizeof(ether_header);
+	size_t payloadLen = m_DataLen - sizeof(ether_header);
+
+	switch (be16toh(getEthHeader()->etherType))
+	{
+	case PCPP_ETHERTYPE_IP:
+		return nextLayer->getProtocol() == IPv4 && IPv4Layer::isDataValid(payload, payloadLen);
+	case PCPP_ETHERTYPE_IPV6:
+		return nextLayer->getProtocol() == IPv6 && IPv6Layer::isDataValid(payload, payloadLen);
+	case PCPP_ETHERTYPE_VLAN:
+		return nextLayer->getProtocol() == VLAN;
+	default:
+		return false;
+	}
+}
+
 std::string EthLayer::toString() const
 {
 	return "Ethernet II Layer, Src: " + getSourceMac().toString() + ", Dst: " + getDestMac().toString();
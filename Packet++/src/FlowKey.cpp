@@ -0,0 +1,215 @@
+#include "FlowKey.h"
+#include "Packet.h"
+#include "PacketView.h"
+#include "IPv4Layer.h"
+#include "IPv6Layer.h"
+#include "TcpLayer.h"
+#include "UdpLayer.h"
+#include "EndianPortable.h"
+#include <string.h>
+
+namespace pcpp
+{
+
+// XXH64 constants
+#define FLOW_KEY_PRIME64_1 0x9E3779B185EBCA87ULL
+#define FLOW_KEY_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define FLOW_KEY_PRIME64_3 0x165667B19E3779F9ULL
+#define FLOW_KEY_PRIME64_4 0x85EBCA77C2B2AE63ULL
+
+#define FLOW_KEY_NUM_OF_WORDS 5
+
+static inline uint64_t rotateLeft64(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t xxh64Round(uint64_t acc, uint64_t input)
+{
+	acc += input * FLOW_KEY_PRIME64_2;
+	acc = rotateLeft64(acc, 31);
+	return acc * FLOW_KEY_PRIME64_1;
+}
+
+static inline uint64_t xxh64MergeRound(uint64_t acc, uint64_t value)
+{
+	acc ^= xxh64Round(0, value);
+	return acc * FLOW_KEY_PRIME64_1 + FLOW_KEY_PRIME64_4;
+}
+
+FlowKey::FlowKey()
+{
+	clear();
+}
+
+void FlowKey::clear()
+{
+	memset(this, 0, sizeof(FlowKey));
+}
+
+bool FlowKey::set(uint8_t ipVersion, const uint8_t* srcIP, const uint8_t* dstIP, size_t ipAddrLen, uint16_t srcPort, uint16_t dstPort, uint8_t protocol, bool* isReversed)
+{
+	clear();
+
+	// order the endpoints by address and then by port so both directions of a connection produce the same key
+	int cmpResult = memcmp(srcIP, dstIP, ipAddrLen);
+	bool reversed = (cmpResult > 0 || (cmpResult == 0 && srcPort > dstPort));
+	int srcIndex = (reversed ? 1 : 0);
+
+	memcpy(m_IPAddr[srcIndex], srcIP, ipAddrLen);
+	memcpy(m_IPAddr[1 - srcIndex], dstIP, ipAddrLen);
+	m_Port[srcIndex] = srcPort;
+	m_Port[1 - srcIndex] = dstPort;
+	m_IPVersion = ipVersion;
+	m_Protocol = protocol;
+
+	if (isReversed != NULL)
+		*isReversed = reversed;
+
+	return true;
+}
+
+bool FlowKey::fromPacket(const Packet& packet, bool* isReversed)
+{
+	// find the innermost IP layer, the same header PacketView considers the network header
+	Layer* ipLayer = packet.getLastLayer();
+	while (ipLayer != NULL && ipLayer->getProtocol() != IPv4 && ipLayer->getProtocol() != IPv6)
+		ipLayer = ipLayer->getPrevLayer();
+
+	if (ipLayer == NULL)
+	{
+		clear();
+		return false;
+	}
+
+	Layer* transportLayer = ipLayer->getNextLayer();
+	uint16_t srcPort, dstPort;
+	uint8_t protocol;
+	if (transportLayer != NULL && transportLayer->getProtocol() == TCP)
+	{
+		tcphdr* tcpHdr = ((TcpLayer*)transportLayer)->getTcpHeader();
+		srcPort = be16toh(tcpHdr->portSrc);
+		dstPort = be16toh(tcpHdr->portDst);
+		protocol = PACKETPP_IPPROTO_TCP;
+	}
+	else if (transportLayer != NULL && transportLayer->getProtocol() == UDP)
+	{
+		udphdr* udpHdr = ((UdpLayer*)transportLayer)->getUdpHeader();
+		srcPort = be16toh(udpHdr->portSrc);
+		dstPort = be16toh(udpHdr->portDst);
+		protocol = PACKETPP_IPPROTO_UDP;
+	}
+	else
+	{
+		clear();
+		return false;
+	}
+
+	if (ipLayer->getProtocol() == IPv4)
+	{
+		iphdr* ipHdr = ((IPv4Layer*)ipLayer)->getIPv4Header();
+		return set(4, (const uint8_t*)&ipHdr->ipSrc, (const uint8_t*)&ipHdr->ipDst, 4, srcPort, dstPort, protocol, isReversed);
+	}
+
+	ip6_hdr* ip6Hdr = ((IPv6Layer*)ipLayer)->getIPv6Header();
+	return set(6, ip6Hdr->ipSrc, ip6Hdr->ipDst, 16, srcPort, dstPort, protocol, isReversed);
+}
+
+bool FlowKey::fromPacketView(const PacketView& packetView, bool* isReversed)
+{
+	const PacketView::HeaderInfo* networkHeader = packetView.getNetworkHeader();
+	const PacketView::HeaderInfo* transportHeader = packetView.getTransportHeader();
+
+	// the transport header must belong to the innermost IP header
+	if (networkHeader == NULL || transportHeader == NULL || transportHeader != networkHeader + 1)
+	{
+		clear();
+		return false;
+	}
+
+	uint8_t protocol = (transportHeader->protocol == TCP ? PACKETPP_IPPROTO_TCP : PACKETPP_IPPROTO_UDP);
+	const uint8_t* ipData = packetView.getHeaderData(*networkHeader);
+	if (networkHeader->protocol == IPv4)
+	{
+		const iphdr* ipHdr = (const iphdr*)ipData;
+		return set(4, (const uint8_t*)&ipHdr->ipSrc, (const uint8_t*)&ipHdr->ipDst, 4, packetView.getSrcPort(), packetView.getDstPort(), protocol, isReversed);
+	}
+
+	const ip6_hdr* ip6Hdr = (const ip6_hdr*)ipData;
+	return set(6, ip6Hdr->ipSrc, ip6Hdr->ipDst, 16, packetView.getSrcPort(), packetView.getDstPort(), protocol, isReversed);
+}
+
+bool FlowKey::fromRawPacket(RawPacket* rawPacket, bool* isReversed)
+{
+	PacketView packetView;
+	if (!packetView.parse(rawPacket))
+	{
+		clear();
+		return false;
+	}
+
+	return fromPacketView(packetView, isReversed);
+}
+
+IPv4Address FlowKey::getIPv4Address(size_t endpoint) const
+{
+	if (m_IPVersion != 4)
+		return IPv4Address::Zero;
+
+	uint32_t addrAsInt;
+	memcpy(&addrAsInt, m_IPAddr[endpoint], sizeof(addrAsInt));
+	return IPv4Address(addrAsInt);
+}
+
+IPv6Address FlowKey::getIPv6Address(size_t endpoint) const
+{
+	if (m_IPVersion != 6)
+		return IPv6Address::Zero;
+
+	return IPv6Address((uint8_t*)m_IPAddr[endpoint]);
+}
+
+uint64_t FlowKey::hash(uint64_t seed) const
+{
+	uint64_t words[FLOW_KEY_NUM_OF_WORDS];
+	memcpy(words, this, sizeof(words));
+
+	// XXH64 of the 40 key bytes: one 32-byte stripe followed by one 8-byte tail word
+	uint64_t v1 = seed + FLOW_KEY_PRIME64_1 + FLOW_KEY_PRIME64_2;
+	uint64_t v2 = seed + FLOW_KEY_PRIME64_2;
+	uint64_t v3 = seed;
+	uint64_t v4 = seed - FLOW_KEY_PRIME64_1;
+	v1 = xxh64Round(v1, words[0]);
+	v2 = xxh64Round(v2, words[1]);
+	v3 = xxh64Round(v3, words[2]);
+	v4 = xxh64Round(v4, words[3]);
+
+	uint64_t result = rotateLeft64(v1, 1) + rotateLeft64(v2, 7) + rotateLeft64(v3, 12) + rotateLeft64(v4, 18);
+	result = xxh64MergeRound(result, v1);
+	result = xxh64MergeRound(result, v2);
+	result = xxh64MergeRound(result, v3);
+	result = xxh64MergeRound(result, v4);
+	result += sizeof(words);
+
+	result ^= xxh64Round(0, words[4]);
+	result = rotateLeft64(result, 27) * FLOW_KEY_PRIME64_1 + FLOW_KEY_PRIME64_4;
+
+	result ^= result >> 33;
+	result *= FLOW_KEY_PRIME64_2;
+	result ^= result >> 29;
+	result *= FLOW_KEY_PRIME64_3;
+	result ^= result >> 32;
+	return result;
+}
+
+bool FlowKey::operator==(const FlowKey& other) const
+{
+	return memcmp(this, &other, sizeof(FlowKey)) == 0;
+}
+
+bool FlowKey::operator<(const FlowKey& other) const
+{
+	return memcmp(this, &other, sizeof(FlowKey)) < 0;
+}
+
+} // namespace pcpp
@@ -8,6 +8,13 @@
 #include <string.h>
 #include "EndianPortable.h"
 
+// the largest payload an IP packet can have, which is the size of each buffer in pooled buffer mode
+#define MAX_IP_PAYLOAD_SIZE 65535
+// how many buffers the pool allocates at once in pooled buffer mode
+#define REASSEMBLY_BUFFERS_PER_SLAB 16
+// the end of the hole that covers the whole payload before the last fragment arrives
+#define HOLE_END_INFINITY 0xFFFFFFFF
+
 namespace pcpp
 {
 
@@ -54,6 +61,7 @@ public:
 	virtual uint32_t getFragmentId() = 0;
 	virtual uint32_t hashPacket() = 0;
 	virtual IPReassembly::PacketKey* createPacketKey() = 0;
+	virtual IPReassembly::PacketKey* fillPacketKey(IPReassembly::IPv4PacketKey& ipv4Key, IPReassembly::IPv6PacketKey& ipv6Key) = 0;
 
 	virtual uint8_t* getIPLayerPayload() = 0;
 	virtual size_t getIPLayerPayloadSize() = 0;
@@ -119,6 +127,14 @@ public:
 		return new IPReassembly::IPv4PacketKey(be16toh(m_IPLayer->getIPv4Header()->ipId), m_IPLayer->getSrcIpAddress(), m_IPLayer->getDstIpAddress());
 	}
 
+	IPReassembly::PacketKey* fillPacketKey(IPReassembly::IPv4PacketKey& ipv4Key, IPReassembly::IPv6PacketKey& ipv6Key)
+	{
+		ipv4Key.setIpID(be16toh(m_IPLayer->getIPv4Header()->ipId));
+		ipv4Key.setSrcIP(m_IPLayer->getSrcIpAddress());
+		ipv4Key.setDstIP(m_IPLayer->getDstIpAddress());
+		return &ipv4Key;
+	}
+
 	uint8_t* getIPLayerPayload()
 	{
 		return m_IPLayer->getLayerPayload();
@@ -205,6 +221,14 @@ public:
 		return new IPReassembly::IPv6PacketKey(be32toh(m_FragHeader->getFragHeader()->id), m_IPLayer->getSrcIpAddress(), m_IPLayer->getDstIpAddress());
 	}
 
+	IPReassembly::PacketKey* fillPacketKey(IPReassembly::IPv4PacketKey& ipv4Key, IPReassembly::IPv6PacketKey& ipv6Key)
+	{
+		ipv6Key.setFragmentID(be32toh(m_FragHeader->getFragHeader()->id));
+		ipv6Key.setSrcIP(m_IPLayer->getSrcIpAddress());
+		ipv6Key.setDstIP(m_IPLayer->getDstIpAddress());
+		return &ipv6Key;
+	}
+
 	uint8_t* getIPLayerPayload()
 	{
 		return m_IPLayer->getLayerPayload();
@@ -270,12 +294,23 @@ IPReassembly::~IPReassembly()
 		delete m_FragmentMap.begin()->second;
 		m_FragmentMap.erase(m_FragmentMap.begin());
 	}
+
+	// in pooled buffer mode all buffers belong to the slabs, whether they're in use or not
+	for (size_t i = 0; i < m_BufferSlabs.size(); i++)
+	{
+		delete [] m_BufferSlabs[i];
+		delete [] m_PayloadSlabs[i];
+	}
 }
 
 Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
 {
 	status = NON_IP_PACKET;
 
+	// advance the timer wheel to the packet's time, dropping the packets that timed out by then
+	if (m_TimeoutSec > 0)
+		expirePackets(fragment->getRawPacket()->getPacketTimeStamp().tv_sec);
+
 	// packet is not an IP packet
 	if (!fragment->isPacketOfType(IPv4) && !fragment->isPacketOfType(IPv6))
 	{
@@ -307,6 +342,9 @@ Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status,
 	// create a hash from source IP, destination IP and IP/fragment ID
 	uint32_t hash = fragWrapper->hashPacket();
 
+	if (m_UsePooledBuffers)
+		return processPacketPooled(fragment, fragWrapper, hash, status, parseUntil, parseUntilLayer);
+
 	IPFragmentData* fragData = NULL;
 
 	// check whether this packet already exists in the map
@@ -322,6 +360,7 @@ Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status,
 
 		// add the new fragment to the map
 		addNewFragment(hash, fragData);
+		fragData->expiryTime = scheduleExpiry(hash);
 	}
 	else // packet was seen before
 	{
@@ -352,6 +391,7 @@ Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status,
 		else // duplicated first fragment
 		{
 			LOG_DEBUG("[FragID=0x%X] Got duplicated first fragment", fragWrapper->getFragmentId());
+			m_Statistics.numOfOverlappingFragments++;
 			status = FRAGMENT;
 			return NULL;
 		}
@@ -414,6 +454,7 @@ Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status,
 		else
 		{
 			LOG_DEBUG("[FragID=0x%X] Got a fragment with an offset that was already seen: %d (current offset is: %d), probably duplicated fragment", fragWrapper->getFragmentId(), (int)fragOffset, (int)fragData->currentOffset);
+			m_Statistics.numOfOverlappingFragments++;
 		}
 
 	}
@@ -424,38 +465,8 @@ Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status,
 		LOG_DEBUG("[FragID=0x%X] Reassembly process completed, allocating a packet and returning it", fragWrapper->getFragmentId());
 		fragData->deleteData = false;
 
-		// fix IP length field
-		if (fragData->packetKey->getProtocolType() == IPv4)
-		{
-			Packet tempPacket(fragData->data, IPv4);
-			IPv4Layer* ipLayer = tempPacket.getLayerOfType<IPv4Layer>();
-			iphdr* iphdr = ipLayer->getIPv4Header();
-			iphdr->totalLength = htobe16(fragData->currentOffset + ipLayer->getHeaderLen());
-			iphdr->fragmentOffset = 0;
-		}
-		else
-		{
-			Packet tempPacket(fragData->data, IPv6);
-			tempPacket.getLayerOfType<IPv6Layer>()->getIPv6Header()->payloadLength = fragData->currentOffset;
-		}
-
 		// create a new Packet object with the reassembled data as its RawPacket
-		Packet* reassembledPacket = new Packet(fragData->data, true, parseUntil, parseUntilLayer);
-
-		if (fragData->packetKey->getProtocolType() == IPv4)
-		{
-			// re-calculate all IPv4 fields
-			reassembledPacket->getLayerOfType<IPv4Layer>()->computeCalculateFields();
-		}
-		else
-		{
-			// remove fragment extension
-			IPv6Layer* ipLayer = reassembledPacket->getLayerOfType<IPv6Layer>();
-			ipLayer->removeAllExtensions();
-
-			// re-calculate all IPv4 fields
-			ipLayer->computeCalculateFields();
-		}
+		Packet* reassembledPacket = createReassembledPacket(fragData->data, fragData->packetKey->getProtocolType(), fragData->currentOffset, parseUntil, parseUntilLayer);
 
 		LOG_DEBUG("[FragID=0x%X] Deleting fragment data from map", fragWrapper->getFragmentId());
 
@@ -463,6 +474,7 @@ Packet* IPReassembly::processPacket(Packet* fragment, ReassemblyStatus& status,
 		delete fragData;
 		m_FragmentMap.erase(iter);
 		m_PacketLRU.eraseElement(hash);
+		m_Statistics.numOfReassembledPackets++;
 		status = REASSEMBLED;
 		return reassembledPacket;
 	}
@@ -489,6 +501,20 @@ Packet* IPReassembly::getCurrentPacket(const PacketKey& key)
 	// create a hash out of the packet key
 	uint32_t hash = key.getHashValue();
 
+	if (m_UsePooledBuffers)
+	{
+		ReassemblyBuffer** bufferPtr = m_BufferMap.find(hash);
+
+		// the partial packet is built from the first fragment's headers followed by the payload that arrived so far without holes
+		if (bufferPtr != NULL && (*bufferPtr)->gotFirstFragment)
+		{
+			uint32_t payloadLength = getContiguousPayloadLength(*bufferPtr);
+			return createReassembledPacket(copyBufferToRawPacket(*bufferPtr, payloadLength), key.getProtocolType(), payloadLength, UnknownProtocol, OsiModelLayerUnknown);
+		}
+
+		return NULL;
+	}
+
 	// look for this hash value in the map
 	std::map<uint32_t, IPFragmentData*>::iterator iter = m_FragmentMap.find(hash);
 
@@ -500,40 +526,9 @@ Packet* IPReassembly::getCurrentPacket(const PacketKey& key)
 		// some data already exists
 		if (fragData != NULL && fragData->data != NULL)
 		{
-			// create a copy of the RawPacket object
+			// create a copy of the RawPacket object and a packet object wrapping it
 			RawPacket* partialRawPacket = new RawPacket(*(fragData->data));
-
-			// fix IP length field
-			if (fragData->packetKey->getProtocolType() == IPv4)
-			{
-				Packet tempPacket(partialRawPacket, IPv4);
-				IPv4Layer* ipLayer = tempPacket.getLayerOfType<IPv4Layer>();
-				ipLayer->getIPv4Header()->totalLength = htobe16(fragData->currentOffset + ipLayer->getHeaderLen());
-			}
-			else
-			{
-				Packet tempPacket(partialRawPacket, IPv6);
-				tempPacket.getLayerOfType<IPv6Layer>()->getIPv6Header()->payloadLength = fragData->currentOffset;
-			}
-
-			// create a packet object wrapping the RawPacket we've just created
-			Packet* partialDataPacket = new Packet(partialRawPacket, true);
-
-			// prepare the packet and return it
-			if (key.getProtocolType() == IPv4)
-			{
-				IPv4Layer* ipLayer = partialDataPacket->getLayerOfType<IPv4Layer>();
-				ipLayer->getIPv4Header()->fragmentOffset = 0;
-				ipLayer->computeCalculateFields();
-			}
-			else // key.getProtocolType() == IPv6
-			{
-				IPv6Layer* ipLayer = partialDataPacket->getLayerOfType<IPv6Layer>();
-				ipLayer->removeAllExtensions();
-				ipLayer->computeCalculateFields();
-			}
-
-			return partialDataPacket;
+			return createReassembledPacket(partialRawPacket, key.getProtocolType(), fragData->currentOffset, UnknownProtocol, OsiModelLayerUnknown);
 		}
 	}
 
@@ -545,6 +540,18 @@ void IPReassembly::removePacket(const PacketKey& key)
 	// create a hash out of the packet key
 	uint32_t hash = key.getHashValue();
 
+	if (m_UsePooledBuffers)
+	{
+		ReassemblyBuffer** bufferPtr = m_BufferMap.find(hash);
+		if (bufferPtr != NULL)
+		{
+			releaseBuffer(hash, *bufferPtr);
+			m_PacketLRU.eraseElement(hash);
+		}
+
+		return;
+	}
+
 	// look for this hash value in the map
 	std::map<uint32_t, IPFragmentData*>::iterator iter = m_FragmentMap.find(hash);
 
@@ -648,4 +655,354 @@ bool IPReassembly::matchOutOfOrderFragments(IPFragmentData* fragData)
 	return foundLastSgement;
 }
 
+Packet* IPReassembly::processPacketPooled(Packet* fragment, IPFragmentWrapper* fragWrapper, uint32_t hash, ReassemblyStatus& status, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
+{
+	ReassemblyBuffer* buffer = NULL;
+
+	// check whether this packet already exists in the map
+	ReassemblyBuffer** bufferPtr = m_BufferMap.find(hash);
+
+	// this is the first fragment seen for this packet
+	if (bufferPtr == NULL)
+	{
+		LOG_DEBUG("Got new packet with FragID=0x%X, taking a buffer from the pool", fragWrapper->getFragmentId());
+
+		uint32_t packetRemoved;
+		if (m_PacketLRU.put(hash, &packetRemoved) == 1) // this means LRU list was full and the least recently used item was removed
+		{
+			ReassemblyBuffer* bufferRemoved = *m_BufferMap.find(packetRemoved);
+
+			PacketKey* key = NULL;
+			if (m_OnFragmentsCleanCallback != NULL)
+				key = bufferRemoved->packetKey->clone();
+
+			LOG_DEBUG("Reached maximum packet capacity, removing data for FragID=0x%X", bufferRemoved->fragmentID);
+			releaseBuffer(packetRemoved, bufferRemoved);
+
+			// fire callback if not null
+			if (m_OnFragmentsCleanCallback != NULL)
+			{
+				m_OnFragmentsCleanCallback(key, m_CallbackUserCookie);
+				delete key;
+			}
+		}
+
+		buffer = allocateBuffer();
+		buffer->fragmentID = fragWrapper->getFragmentId();
+		buffer->packetKey = fragWrapper->fillPacketKey(buffer->ipv4Key, buffer->ipv6Key);
+		buffer->expiryTime = scheduleExpiry(hash);
+		m_BufferMap.insert(hash, buffer);
+	}
+	else // packet was seen before
+	{
+		buffer = *bufferPtr;
+
+		// mark this packet as used
+		m_PacketLRU.put(hash, NULL);
+	}
+
+	bool isFirstFragment = fragWrapper->isFirstFragment();
+	bool isLastFragment = fragWrapper->isLastFragment();
+	uint32_t fragOffset = fragWrapper->getFragmentOffset();
+	uint32_t fragEnd = fragOffset + (uint32_t)fragWrapper->getIPLayerPayloadSize();
+
+	// malformed fragment which is not the first fragment but its offset is 0, or which doesn't fit the packet
+	if ((!isFirstFragment && fragOffset == 0) || fragEnd > MAX_IP_PAYLOAD_SIZE ||
+			(buffer->gotLastFragment && (fragEnd > buffer->payloadLength || (isLastFragment && fragEnd != buffer->payloadLength))))
+	{
+		LOG_DEBUG("[FragID=0x%X] Fragment is malformed", buffer->fragmentID);
+		status = MALFORMED_FRAGMENT;
+		return NULL;
+	}
+
+	if (isFirstFragment && buffer->gotFirstFragment)
+	{
+		LOG_DEBUG("[FragID=0x%X] Got duplicated first fragment", buffer->fragmentID);
+		m_Statistics.numOfOverlappingFragments++;
+		status = FRAGMENT;
+		return NULL;
+	}
+
+	uint32_t contiguousLength = getContiguousPayloadLength(buffer);
+	if (isFirstFragment)
+		status = FIRST_FRAGMENT;
+	else if (fragOffset > contiguousLength)
+		status = OUT_OF_ORDER_FRAGMENT;
+	else
+		status = FRAGMENT;
+
+	LOG_DEBUG("[FragID=0x%X] Got fragment with offset %d, copying its data to the reassembly buffer", buffer->fragmentID, (int)fragOffset);
+
+	if (isFirstFragment)
+	{
+		// keep everything that comes before the IP payload, it's the beginning of the reassembled packet
+		RawPacket* rawPacket = fragment->getRawPacket();
+		buffer->headers.assign(rawPacket->getRawData(), (const uint8_t*)fragWrapper->getIPLayerPayload());
+		buffer->timestamp = rawPacket->getPacketTimeStamp();
+		buffer->linkLayerType = rawPacket->getLinkLayerType();
+		buffer->gotFirstFragment = true;
+	}
+
+	std::vector<ReassemblyBuffer::Hole>& holes = buffer->holes;
+
+	// now that the payload length is known, remove the holes beyond it
+	if (isLastFragment)
+	{
+		buffer->payloadLength = fragEnd;
+		buffer->gotLastFragment = true;
+
+		size_t i = 0;
+		while (i < holes.size())
+		{
+			if (holes[i].first >= fragEnd)
+			{
+				holes[i] = holes.back();
+				holes.pop_back();
+				continue;
+			}
+
+			if (holes[i].last >= fragEnd)
+				holes[i].last = fragEnd - 1;
+			i++;
+		}
+	}
+
+	memcpy(buffer->payload + fragOffset, fragWrapper->getIPLayerPayload(), fragEnd - fragOffset);
+
+	// remove the holes the fragment fills (RFC 815). Parts of a hole the fragment doesn't cover become new holes
+	uint32_t filledLength = 0;
+	size_t i = 0;
+	while (i < holes.size())
+	{
+		ReassemblyBuffer::Hole hole = holes[i];
+		if (fragOffset > hole.last || fragEnd <= hole.first)
+		{
+			i++;
+			continue;
+		}
+
+		filledLength += (fragEnd <= hole.last ? fragEnd : hole.last + 1) - (fragOffset > hole.first ? fragOffset : hole.first);
+		holes[i] = holes.back();
+		holes.pop_back();
+
+		if (fragOffset > hole.first)
+		{
+			ReassemblyBuffer::Hole before = { hole.first, fragOffset - 1 };
+			holes.push_back(before);
+		}
+
+		if (fragEnd <= hole.last)
+		{
+			ReassemblyBuffer::Hole after = { fragEnd, hole.last };
+			holes.push_back(after);
+		}
+	}
+
+	// the parts of the fragment that didn't fall in holes were already received
+	if (filledLength < fragEnd - fragOffset)
+	{
+		LOG_DEBUG("[FragID=0x%X] Fragment overlaps data that was already received", buffer->fragmentID);
+		m_Statistics.numOfOverlappingFragments++;
+	}
+
+	if (!buffer->gotFirstFragment || !buffer->gotLastFragment || !holes.empty())
+		return NULL;
+
+	LOG_DEBUG("[FragID=0x%X] Reassembly process completed, allocating a packet and returning it", buffer->fragmentID);
+
+	RawPacket* reassembledRawPacket = copyBufferToRawPacket(buffer, buffer->payloadLength);
+	ProtocolType ipProtocol = buffer->packetKey->getProtocolType();
+	uint16_t payloadLength = (uint16_t)buffer->payloadLength;
+
+	// return the buffer to the pool and remove the packet from the map
+	releaseBuffer(hash, buffer);
+	m_PacketLRU.eraseElement(hash);
+
+	m_Statistics.numOfReassembledPackets++;
+	status = REASSEMBLED;
+	return createReassembledPacket(reassembledRawPacket, ipProtocol, payloadLength, parseUntil, parseUntilLayer);
+}
+
+time_t IPReassembly::scheduleExpiry(uint32_t hash)
+{
+	if (m_TimeoutSec == 0)
+		return 0;
+
+	// timestamps are rounded down to seconds, so a packet is dropped only once more than the timeout has passed
+	time_t expiryTime = m_CurrentTime + m_TimeoutSec + 1;
+	m_TimerWheel[expiryTime % m_TimerWheel.size()].push_back(hash);
+	return expiryTime;
+}
+
+void IPReassembly::expirePackets(time_t now)
+{
+	// timestamps that go back in time don't move the wheel
+	if (now <= m_CurrentTime)
+		return;
+
+	time_t firstTick = m_CurrentTime + 1;
+	time_t wheelSize = (time_t)m_TimerWheel.size();
+
+	// after a long time without packets visit each slot once: all packets in the wheel expired by now
+	if (m_CurrentTime == 0 || now - m_CurrentTime > wheelSize)
+		firstTick = now - wheelSize + 1;
+
+	m_CurrentTime = now;
+
+	for (time_t tick = firstTick; tick <= now; tick++)
+	{
+		std::vector<uint32_t>& slot = m_TimerWheel[tick % wheelSize];
+		for (size_t i = 0; i < slot.size(); i++)
+			expirePacket(slot[i], now);
+
+		slot.clear();
+	}
+}
+
+void IPReassembly::expirePacket(uint32_t hash, time_t now)
+{
+	// the packet may have been reassembled or dropped already, or replaced by a newer packet with the same hash which expires later
+	PacketKey* key = NULL;
+	if (m_UsePooledBuffers)
+	{
+		ReassemblyBuffer** bufferPtr = m_BufferMap.find(hash);
+		if (bufferPtr == NULL || (*bufferPtr)->expiryTime > now)
+			return;
+
+		if (m_OnFragmentsCleanCallback != NULL)
+			key = (*bufferPtr)->packetKey->clone();
+
+		LOG_DEBUG("Reassembly timeout expired, removing data for FragID=0x%X", (*bufferPtr)->fragmentID);
+		releaseBuffer(hash, *bufferPtr);
+	}
+	else
+	{
+		std::map<uint32_t, IPFragmentData*>::iterator iter = m_FragmentMap.find(hash);
+		if (iter == m_FragmentMap.end() || iter->second->expiryTime > now)
+			return;
+
+		if (m_OnFragmentsCleanCallback != NULL)
+			key = iter->second->packetKey->clone();
+
+		LOG_DEBUG("Reassembly timeout expired, removing data for FragID=0x%X", iter->second->fragmentID);
+		delete iter->second;
+		m_FragmentMap.erase(iter);
+	}
+
+	m_PacketLRU.eraseElement(hash);
+	m_Statistics.numOfExpiredPackets++;
+
+	// fire callback if not null
+	if (m_OnFragmentsCleanCallback != NULL)
+	{
+		m_OnFragmentsCleanCallback(key, m_CallbackUserCookie);
+		delete key;
+	}
+}
+
+IPReassembly::ReassemblyBuffer* IPReassembly::allocateBuffer()
+{
+	if (m_FreeBuffers == NULL)
+	{
+		ReassemblyBuffer* bufferSlab = new ReassemblyBuffer[REASSEMBLY_BUFFERS_PER_SLAB];
+		uint8_t* payloadSlab = new uint8_t[REASSEMBLY_BUFFERS_PER_SLAB * MAX_IP_PAYLOAD_SIZE];
+		m_BufferSlabs.push_back(bufferSlab);
+		m_PayloadSlabs.push_back(payloadSlab);
+
+		for (int i = 0; i < REASSEMBLY_BUFFERS_PER_SLAB; i++)
+		{
+			bufferSlab[i].payload = payloadSlab + i * MAX_IP_PAYLOAD_SIZE;
+			bufferSlab[i].nextFree = m_FreeBuffers;
+			m_FreeBuffers = &bufferSlab[i];
+		}
+	}
+
+	ReassemblyBuffer* buffer = m_FreeBuffers;
+	m_FreeBuffers = buffer->nextFree;
+
+	// the whole payload is missing until fragments arrive
+	ReassemblyBuffer::Hole wholePayload = { 0, HOLE_END_INFINITY };
+	buffer->headers.clear();
+	buffer->holes.clear();
+	buffer->holes.push_back(wholePayload);
+	buffer->payloadLength = 0;
+	buffer->gotFirstFragment = false;
+	buffer->gotLastFragment = false;
+	buffer->packetKey = NULL;
+	buffer->nextFree = NULL;
+
+	return buffer;
+}
+
+void IPReassembly::releaseBuffer(uint32_t hash, ReassemblyBuffer* buffer)
+{
+	m_BufferMap.erase(hash);
+	buffer->nextFree = m_FreeBuffers;
+	m_FreeBuffers = buffer;
+}
+
+uint32_t IPReassembly::getContiguousPayloadLength(const ReassemblyBuffer* buffer)
+{
+	if (buffer->holes.empty())
+		return buffer->payloadLength;
+
+	uint32_t result = HOLE_END_INFINITY;
+	for (std::vector<ReassemblyBuffer::Hole>::const_iterator iter = buffer->holes.begin(); iter != buffer->holes.end(); ++iter)
+	{
+		if (iter->first < result)
+			result = iter->first;
+	}
+
+	return result;
+}
+
+RawPacket* IPReassembly::copyBufferToRawPacket(const ReassemblyBuffer* buffer, uint32_t payloadLength)
+{
+	size_t headersLength = buffer->headers.size();
+	uint8_t* rawData = new uint8_t[headersLength + payloadLength];
+	if (headersLength > 0)
+		memcpy(rawData, &buffer->headers[0], headersLength);
+	memcpy(rawData + headersLength, buffer->payload, payloadLength);
+
+	return new RawPacket(rawData, (int)(headersLength + payloadLength), buffer->timestamp, true, buffer->linkLayerType);
+}
+
+Packet* IPReassembly::createReassembledPacket(RawPacket* rawPacket, ProtocolType ipProtocol, uint16_t payloadLength, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
+{
+	// fix IP length field
+	if (ipProtocol == IPv4)
+	{
+		Packet tempPacket(rawPacket, IPv4);
+		IPv4Layer* ipLayer = tempPacket.getLayerOfType<IPv4Layer>();
+		iphdr* iphdr = ipLayer->getIPv4Header();
+		iphdr->totalLength = htobe16(payloadLength + ipLayer->getHeaderLen());
+		iphdr->fragmentOffset = 0;
+	}
+	else
+	{
+		Packet tempPacket(rawPacket, IPv6);
+		tempPacket.getLayerOfType<IPv6Layer>()->getIPv6Header()->payloadLength = payloadLength;
+	}
+
+	// create a new Packet object with the reassembled data as its RawPacket
+	Packet* reassembledPacket = new Packet(rawPacket, true, parseUntil, parseUntilLayer);
+
+	if (ipProtocol == IPv4)
+	{
+		// re-calculate all IPv4 fields
+		reassembledPacket->getLayerOfType<IPv4Layer>()->computeCalculateFields();
+	}
+	else
+	{
+		// remove fragment extension
+		IPv6Layer* ipLayer = reassembledPacket->getLayerOfType<IPv6Layer>();
+		ipLayer->removeAllExtensions();
+
+		// re-calculate all IPv6 fields
+		ipLayer->computeCalculateFields();
+	}
+
+	return reassembledPacket;
+}
+
 }
@@ -1,6 +1,7 @@
 #define LOG_MODULE PacketLogModuleIPv4Layer
 
 #include "IPv4Layer.h"
+#include "Packet.h"
 #include "IPv6Layer.h"
 #include "PayloadLayer.h"
 #include "UdpLayer.h"
@@ -255,7 +256,7 @@ void IPv4Layer::parseNextLayer()
 	// TODO: assuming first fragment contains at least L4 header, what if it's not true?
 	if (isFragment())
 	{
-		m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		return;
 	}
 
@@ -263,55 +264,84 @@ void IPv4Layer::parseNextLayer()
 	{
 	case PACKETPP_IPPROTO_UDP:
 		if (payloadLen >= sizeof(udphdr))
-			m_NextLayer = new UdpLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) UdpLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PACKETPP_IPPROTO_TCP:
 		m_NextLayer = TcpLayer::isDataValid(payload, payloadLen)
-			? static_cast<Layer*>(new TcpLayer(payload, payloadLen, this, m_Packet))
-			: static_cast<Layer*>(new PayloadLayer(payload, payloadLen, this, m_Packet));
+			? static_cast<Layer*>(new(m_Packet) TcpLayer(payload, payloadLen, this, m_Packet))
+			: static_cast<Layer*>(new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet));
 		break;
 	case PACKETPP_IPPROTO_ICMP:
-		m_NextLayer = new IcmpLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) IcmpLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PACKETPP_IPPROTO_IPIP:
 		ipVersion = *payload >> 4;
 		if (ipVersion == 4)
-			m_NextLayer = new IPv4Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) IPv4Layer(payload, payloadLen, this, m_Packet);
 		else if (ipVersion == 6)
-			m_NextLayer = new IPv6Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) IPv6Layer(payload, payloadLen, this, m_Packet);
 		else
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PACKETPP_IPPROTO_GRE:
 		greVer = GreLayer::getGREVersion(payload, payloadLen);
 		if (greVer == GREv0)
-			m_NextLayer = new GREv0Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) GREv0Layer(payload, payloadLen, this, m_Packet);
 		else if (greVer == GREv1)
-			m_NextLayer = new GREv1Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) GREv1Layer(payload, payloadLen, this, m_Packet);
 		else
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PACKETPP_IPPROTO_IGMP:
 		igmpVer = IgmpLayer::getIGMPVerFromData(payload, be16toh(getIPv4Header()->totalLength) - hdrLen, igmpQuery);
 		if (igmpVer == IGMPv1)
-			m_NextLayer = new IgmpV1Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) IgmpV1Layer(payload, payloadLen, this, m_Packet);
 		else if (igmpVer == IGMPv2)
-			m_NextLayer = new IgmpV2Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) IgmpV2Layer(payload, payloadLen, this, m_Packet);
 		else if (igmpVer == IGMPv3)
 		{
 			if (igmpQuery)
-				m_NextLayer = new IgmpV3QueryLayer(payload, payloadLen, this, m_Packet);
+				m_NextLayer = new(m_Packet) IgmpV3QueryLayer(payload, payloadLen, this, m_Packet);
 			else
-				m_NextLayer = new IgmpV3ReportLayer(payload, payloadLen, this, m_Packet);
+				m_NextLayer = new(m_Packet) IgmpV3ReportLayer(payload, payloadLen, this, m_Packet);
 		}
 		else
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		break;
 	default:
-		m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 	}
 }
 
+bool IPv4Layer::isNextLayerReusable(const Layer* nextLayer) const
+{
+	// must mirror the decisions made in parseNextLayer()
+	size_t hdrLen = getHeaderLen();
+	if (m_DataLen <= hdrLen || isFragment())
+		return false;
+
+	uint8_t* payload = m_Data + hdrLen;
+	size_t payloadLen = m_DataLen - hdrLen;
+
+	switch (getIPv4Header()->protocol)
+	{
+	case PACKETPP_IPPROTO_UDP:
+		return nextLayer->getProtocol() == UDP && payloadLen >= sizeof(udphdr);
+	case PACKETPP_IPPROTO_TCP:
+		return nextLayer->getProtocol() == TCP && TcpLayer::isDataValid(payload, payloadLen);
+	default:
+		return false;
+	}
+}
+
+void IPv4Layer::rebindData(uint8_t* data, size_t dataLen)
+{
+	m_Data = data;
+	m_DataLen = dataLen;
+	m_OptionReader = TLVRecordReader<IPv4Option>();
+	initLayerInPacket(data, dataLen, m_PrevLayer, m_Packet, true);
+}
+
 void IPv4Layer::computeCalculateFields()
 {
 	iphdr* ipHdr = getIPv4Header();
@@ -346,10 +376,77 @@ void IPv4Layer::computeCalculateFields()
 		}
 	}
 
+	// an offloaded checksum is left 0 for the device to compute
+	if (m_Packet != NULL && m_Packet->isChecksumOffloaded(this))
+		return;
+
 	ScalarBuffer<uint16_t> scalar = { (uint16_t*)ipHdr, (size_t)(ipHdr->internetHeaderLength*4) } ;
 	ipHdr->headerChecksum = htobe16(compute_checksum(&scalar, 1));
 }
 
+void IPv4Layer::setSrcIpAddress(const IPv4Address& ipAddr, bool updateChecksums)
+{
+	uint32_t oldAddr = getIPv4Header()->ipSrc;
+	getIPv4Header()->ipSrc = ipAddr.toInt();
+	if (updateChecksums)
+		updateChecksumsForAddressChange(oldAddr, getIPv4Header()->ipSrc);
+}
+
+void IPv4Layer::setDstIpAddress(const IPv4Address& ipAddr, bool updateChecksums)
+{
+	uint32_t oldAddr = getIPv4Header()->ipDst;
+	getIPv4Header()->ipDst = ipAddr.toInt();
+	if (updateChecksums)
+		updateChecksumsForAddressChange(oldAddr, getIPv4Header()->ipDst);
+}
+
+void IPv4Layer::updateChecksumsForAddressChange(uint32_t oldAddr, uint32_t newAddr)
+{
+	iphdr* ipHdr = getIPv4Header();
+	ipHdr->headerChecksum = update_checksum32(ipHdr->headerChecksum, oldAddr, newAddr);
+
+	// the addresses are part of the TCP/UDP pseudo header. Fragments other than the first one don't contain the L4 header. In a lazily
+	// parsed packet the next layer may not exist yet, getNextLayer() parses it
+	if (getFragmentOffset() != 0)
+		return;
+
+	Layer* nextLayer = getNextLayer();
+	if (nextLayer == NULL)
+		return;
+
+	if (nextLayer->getProtocol() == TCP)
+	{
+		tcphdr* tcpHdr = ((TcpLayer*)nextLayer)->getTcpHeader();
+		tcpHdr->headerChecksum = update_checksum32(tcpHdr->headerChecksum, oldAddr, newAddr);
+	}
+	else if (nextLayer->getProtocol() == UDP)
+	{
+		udphdr* udpHdr = ((UdpLayer*)nextLayer)->getUdpHeader();
+		// a zero UDP checksum means no checksum was computed
+		if (udpHdr->headerChecksum == 0)
+			return;
+
+		udpHdr->headerChecksum = update_checksum32(udpHdr->headerChecksum, oldAddr, newAddr);
+		if (udpHdr->headerChecksum == 0)
+			udpHdr->headerChecksum = 0xffff;
+	}
+}
+
+bool IPv4Layer::decrementTTL()
+{
+	iphdr* ipHdr = getIPv4Header();
+	if (ipHdr->timeToLive == 0)
+		return false;
+
+	// the checksum is computed over 16-bit words, and the TTL shares its word with the protocol field
+	uint16_t oldWord, newWord;
+	memcpy(&oldWord, &ipHdr->timeToLive, sizeof(uint16_t));
+	ipHdr->timeToLive--;
+	memcpy(&newWord, &ipHdr->timeToLive, sizeof(uint16_t));
+	ipHdr->headerChecksum = update_checksum16(ipHdr->headerChecksum, oldWord, newWord);
+	return true;
+}
+
 bool IPv4Layer::isFragment() const
 {
 	return ((getFragmentFlags() & PCPP_IP_MORE_FRAGMENTS) != 0 || getFragmentOffset() != 0);
@@ -204,7 +204,7 @@ void IPv6Layer::parseNextLayer()
 	{
 		if (m_LastExtension->getExtensionType() == IPv6Extension::IPv6Fragmentation)
 		{
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 			return;
 		}
 
@@ -218,41 +218,86 @@ void IPv6Layer::parseNextLayer()
 	switch (nextHdr)
 	{
 	case PACKETPP_IPPROTO_UDP:
-		m_NextLayer = new UdpLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) UdpLayer(payload, payloadLen, this, m_Packet);
 		break;
 	case PACKETPP_IPPROTO_TCP:
 		m_NextLayer = TcpLayer::isDataValid(payload, payloadLen)
-			? static_cast<Layer*>(new TcpLayer(payload, payloadLen, this, m_Packet))
-			: static_cast<Layer*>(new PayloadLayer(payload, payloadLen, this, m_Packet));
+			? static_cast<Layer*>(new(m_Packet) TcpLayer(payload, payloadLen, this, m_Packet))
+			: static_cast<Layer*>(new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet));
 		break;
 	case PACKETPP_IPPROTO_IPIP:
 	{
 		uint8_t ipVersion = *payload >> 4;
 		if (ipVersion == 4 && IPv4Layer::isDataValid(payload, payloadLen))
-			m_NextLayer = new IPv4Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) IPv4Layer(payload, payloadLen, this, m_Packet);
 		else if (ipVersion == 6 && IPv6Layer::isDataValid(payload, payloadLen))
-			m_NextLayer = new IPv6Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) IPv6Layer(payload, payloadLen, this, m_Packet);
 		else
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		break;
 	}
 	case PACKETPP_IPPROTO_GRE:
 	{
 		ProtocolType greVer = GreLayer::getGREVersion(payload, payloadLen);
 		if (greVer == GREv0)
-			m_NextLayer = new GREv0Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) GREv0Layer(payload, payloadLen, this, m_Packet);
 		else if (greVer == GREv1)
-			m_NextLayer = new GREv1Layer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) GREv1Layer(payload, payloadLen, this, m_Packet);
 		else
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		break;
 	}
 	default:
-		m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 		return;
 	}
 }
 
+bool IPv6Layer::isNextLayerReusable(const Layer* nextLayer) const
+{
+	// must mirror the decisions made in parseNextLayer()
+	size_t headerLen = getHeaderLen();
+	if (m_DataLen <= headerLen)
+		return false;
+
+	uint8_t nextHdr;
+	if (m_LastExtension != NULL)
+	{
+		if (m_LastExtension->getExtensionType() == IPv6Extension::IPv6Fragmentation)
+			return false;
+
+		nextHdr = m_LastExtension->getBaseHeader()->nextHeader;
+	}
+	else
+	{
+		nextHdr = getIPv6Header()->nextHeader;
+	}
+
+	switch (nextHdr)
+	{
+	case PACKETPP_IPPROTO_UDP:
+		return nextLayer->getProtocol() == UDP;
+	case PACKETPP_IPPROTO_TCP:
+		return nextLayer->getProtocol() == TCP && TcpLayer::isDataValid(m_Data + headerLen, m_DataLen - headerLen);
+	default:
+		return false;
+	}
+}
+
+void IPv6Layer::rebindData(uint8_t* data, size_t dataLen)
+{
+	deleteExtensions();
+
+	m_Data = data;
+	m_DataLen = dataLen;
+
+	parseExtensions();
+
+	size_t totalLen = be16toh(getIPv6Header()->payloadLength) + getHeaderLen();
+	if (totalLen < m_DataLen)
+		m_DataLen = totalLen;
+}
+
 void IPv6Layer::computeCalculateFields()
 {
 	ip6_hdr* ipHdr = getIPv6Header();
@@ -8,6 +8,38 @@
 namespace pcpp
 {
 
+void* Layer::operator new(size_t size)
+{
+	return LayerArena::allocateFromHeap(size);
+}
+
+void* Layer::operator new(size_t size, Packet* packet)
+{
+	if (packet == NULL)
+		return LayerArena::allocateFromHeap(size);
+
+	return packet->m_LayerArena.allocate(size);
+}
+
+void Layer::operator delete(void* ptr)
+{
+	LayerArena::deallocate(ptr);
+}
+
+void Layer::operator delete(void* ptr, Packet* /*packet*/)
+{
+	LayerArena::deallocate(ptr);
+}
+
+Layer* Layer::parseNextLayerOnDemand() const
+{
+	// if the packet is parsed lazily the layer that comes after the last parsed layer may not have been parsed yet
+	if (m_Packet->m_LastLayer == this)
+		m_Packet->parseNextLayerOnDemand();
+
+	return m_NextLayer;
+}
+
 Layer::~Layer()
 {
 	if (!isAllocatedToPacket())
@@ -0,0 +1,179 @@
+#include "LayerArena.h"
+#include <new>
+
+namespace pcpp
+{
+
+// every allocation is prefixed by a header that points to the block it was carved from (or NULL for heap allocations) and keeps
+// the allocation size. The header size is a multiple of the max alignment so the returned pointer keeps the alignment of the
+// underlying memory
+#define ARENA_ALIGNMENT 16
+#define ARENA_ALIGN(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~((size_t)ARENA_ALIGNMENT - 1))
+#define ARENA_ALLOCATION_HEADER_SIZE ARENA_ALIGNMENT
+
+struct ArenaAllocationHeader
+{
+	void* block;
+	size_t size;
+};
+
+LayerArena::LayerArena(size_t blockSize) :
+	m_FirstBlock(NULL),
+	m_CurBlock(NULL),
+	m_BlockSize(blockSize)
+{
+}
+
+LayerArena::~LayerArena()
+{
+	Block* curBlock = m_FirstBlock;
+	while (curBlock != NULL)
+	{
+		Block* nextBlock = curBlock->next;
+		if (curBlock->liveAllocations == 0)
+			::operator delete(curBlock);
+		else
+			curBlock->orphaned = true;
+		curBlock = nextBlock;
+	}
+}
+
+uint8_t* LayerArena::getBlockData(Block* block)
+{
+	return (uint8_t*)block + ARENA_ALIGN(sizeof(Block));
+}
+
+LayerArena::Block* LayerArena::createBlock(size_t capacity)
+{
+	Block* block = (Block*)::operator new(ARENA_ALIGN(sizeof(Block)) + capacity);
+	block->next = NULL;
+	block->capacity = capacity;
+	block->used = 0;
+	block->liveAllocations = 0;
+	block->orphaned = false;
+	return block;
+}
+
+void* LayerArena::allocate(size_t size)
+{
+	size_t requiredLen = ARENA_ALLOCATION_HEADER_SIZE + ARENA_ALIGN(size);
+
+	if (m_CurBlock == NULL || m_CurBlock->used + requiredLen > m_CurBlock->capacity)
+	{
+		// try to reuse the next block that was allocated in previous rounds, otherwise allocate a new one
+		Block* nextBlock = (m_CurBlock == NULL ? m_FirstBlock : m_CurBlock->next);
+		if (nextBlock == NULL || nextBlock->capacity < requiredLen)
+		{
+			Block* newBlock = createBlock(requiredLen > m_BlockSize ? requiredLen : m_BlockSize);
+			newBlock->next = nextBlock;
+			if (m_CurBlock == NULL)
+				m_FirstBlock = newBlock;
+			else
+				m_CurBlock->next = newBlock;
+			nextBlock = newBlock;
+		}
+
+		m_CurBlock = nextBlock;
+		m_CurBlock->used = 0;
+	}
+
+	uint8_t* chunk = getBlockData(m_CurBlock) + m_CurBlock->used;
+	m_CurBlock->used += requiredLen;
+	m_CurBlock->liveAllocations++;
+	((ArenaAllocationHeader*)chunk)->block = m_CurBlock;
+	((ArenaAllocationHeader*)chunk)->size = size;
+	return chunk + ARENA_ALLOCATION_HEADER_SIZE;
+}
+
+void LayerArena::rewindAfter(const void* ptr)
+{
+	const uint8_t* chunk = (const uint8_t*)ptr - ARENA_ALLOCATION_HEADER_SIZE;
+	const ArenaAllocationHeader* header = (const ArenaAllocationHeader*)chunk;
+	Block* block = (Block*)header->block;
+	if (block == NULL || block->orphaned)
+		return;
+
+	block->used = (size_t)(chunk - getBlockData(block)) + ARENA_ALLOCATION_HEADER_SIZE + ARENA_ALIGN(header->size);
+	m_CurBlock = block;
+}
+
+bool LayerArena::isAllocatedFromArena(const void* ptr) const
+{
+	const void* block = ((const ArenaAllocationHeader*)((const uint8_t*)ptr - ARENA_ALLOCATION_HEADER_SIZE))->block;
+	if (block == NULL)
+		return false;
+
+	for (Block* curBlock = m_FirstBlock; curBlock != NULL; curBlock = curBlock->next)
+	{
+		if (curBlock == block)
+			return true;
+	}
+
+	return false;
+}
+
+size_t LayerArena::getLiveAllocationCount() const
+{
+	size_t result = 0;
+	for (Block* curBlock = m_FirstBlock; curBlock != NULL; curBlock = curBlock->next)
+		result += curBlock->liveAllocations;
+
+	return result;
+}
+
+void LayerArena::reset()
+{
+	Block* prevBlock = NULL;
+	Block* curBlock = m_FirstBlock;
+	while (curBlock != NULL)
+	{
+		Block* nextBlock = curBlock->next;
+		if (curBlock->liveAllocations == 0)
+		{
+			curBlock->used = 0;
+			prevBlock = curBlock;
+		}
+		else
+		{
+			// the block still holds detached layers. Hand it over to them, it'll be freed when the last one is deleted
+			curBlock->orphaned = true;
+			curBlock->next = NULL;
+			if (prevBlock == NULL)
+				m_FirstBlock = nextBlock;
+			else
+				prevBlock->next = nextBlock;
+		}
+
+		curBlock = nextBlock;
+	}
+
+	m_CurBlock = NULL;
+}
+
+void* LayerArena::allocateFromHeap(size_t size)
+{
+	uint8_t* chunk = (uint8_t*)::operator new(ARENA_ALLOCATION_HEADER_SIZE + size);
+	((ArenaAllocationHeader*)chunk)->block = NULL;
+	((ArenaAllocationHeader*)chunk)->size = size;
+	return chunk + ARENA_ALLOCATION_HEADER_SIZE;
+}
+
+void LayerArena::deallocate(void* ptr)
+{
+	if (ptr == NULL)
+		return;
+
+	uint8_t* chunk = (uint8_t*)ptr - ARENA_ALLOCATION_HEADER_SIZE;
+	Block* block = (Block*)((ArenaAllocationHeader*)chunk)->block;
+	if (block == NULL)
+	{
+		::operator delete(chunk);
+		return;
+	}
+
+	block->liveAllocations--;
+	if (block->orphaned && block->liveAllocations == 0)
+		::operator delete(block);
+}
+
+} // namespace pcpp
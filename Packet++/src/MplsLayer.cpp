@@ -111,7 +111,7 @@ void MplsLayer::parseNextLayer()
 
 	if (!isBottomOfStack())
 	{
-		m_NextLayer = new MplsLayer(payload, payloadLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) MplsLayer(payload, payloadLen, this, m_Packet);
 		return;
 	}
 
@@ -120,16 +120,16 @@ void MplsLayer::parseNextLayer()
 	{
 		case 4:
 			m_NextLayer = IPv4Layer::isDataValid(payload, payloadLen)
-				? static_cast<Layer*>(new IPv4Layer(payload, payloadLen, this, m_Packet))
-				: static_cast<Layer*>(new PayloadLayer(payload, payloadLen, this, m_Packet));
+				? static_cast<Layer*>(new(m_Packet) IPv4Layer(payload, payloadLen, this, m_Packet))
+				: static_cast<Layer*>(new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet));
 			break;
 		case 6:
 			m_NextLayer = IPv6Layer::isDataValid(payload, payloadLen)
-				? static_cast<Layer*>(new IPv6Layer(payload, payloadLen, this, m_Packet))
-				: static_cast<Layer*>(new PayloadLayer(payload, payloadLen, this, m_Packet));
+				? static_cast<Layer*>(new(m_Packet) IPv6Layer(payload, payloadLen, this, m_Packet))
+				: static_cast<Layer*>(new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet));
 			break;
 		default:
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+			m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
 	}
 }
 
@@ -19,17 +19,37 @@
 #include "SystemUtils.h"
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define PACKET_PREFETCH(addr) __builtin_prefetch((const void*)(addr))
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define PACKET_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define PACKET_PREFETCH(addr)
+#endif
+
+#define PACKET_PREFETCH_CACHE_LINE_SIZE 64
+#define PACKET_BATCH_PREFETCH_DISTANCE 4
+
 
 namespace pcpp
 {
 
+static ProtocolType defaultEnabledProtocols = AllProtocols;
+
 Packet::Packet(size_t maxPacketLen) :
 	m_RawPacket(NULL),
 	m_FirstLayer(NULL),
 	m_LastLayer(NULL),
 	m_ProtocolTypes(UnknownProtocol),
 	m_MaxPacketLen(maxPacketLen),
-	m_FreeRawPacket(true)
+	m_FreeRawPacket(true),
+	m_LazyParsing(false),
+	m_AllLayersParsed(true),
+	m_ParseUntil(UnknownProtocol),
+	m_ParseUntilLayer(OsiModelLayerUnknown),
+	m_EnabledProtocols(defaultEnabledProtocols),
+	m_ChecksumOffloadFlags(ChecksumOffloadNone)
 {
 	timeval time;
 	gettimeofday(&time, NULL);
@@ -41,10 +61,12 @@ Packet::Packet(size_t maxPacketLen) :
 void Packet::setRawPacket(RawPacket* rawPacket, bool freeRawPacket, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
 {
 	destructPacketData();
+	m_LayerArena.reset();
 
 	m_FirstLayer = NULL;
 	m_LastLayer = NULL;
 	m_ProtocolTypes = UnknownProtocol;
+	m_AllLayersParsed = true;
 	m_MaxPacketLen = rawPacket->getRawDataLen();
 	m_FreeRawPacket = freeRawPacket;
 	m_RawPacket = rawPacket;
@@ -55,39 +77,195 @@ void Packet::setRawPacket(RawPacket* rawPacket, bool freeRawPacket, ProtocolType
 
 	m_FirstLayer = createFirstLayer(linkType);
 
-	m_LastLayer = m_FirstLayer;
+	parseLayers(m_FirstLayer, parseUntil, parseUntilLayer);
+}
+
+void Packet::reparse(RawPacket* rawPacket, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
+{
+	// keep owning the raw packet if it's the one this packet already owns
+	bool freeRawPacket = (m_FreeRawPacket && m_RawPacket == rawPacket);
+
+	if (rawPacket == NULL || !isFirstLayerReusable(rawPacket) || !areLayersReusable())
+	{
+		if (freeRawPacket)
+			m_FreeRawPacket = false;
+		setRawPacket(rawPacket, freeRawPacket, parseUntil, parseUntilLayer);
+		return;
+	}
+
+	if (m_FreeRawPacket && m_RawPacket != rawPacket)
+		delete m_RawPacket;
+
+	m_RawPacket = rawPacket;
+	m_FreeRawPacket = freeRawPacket;
+	m_MaxPacketLen = rawPacket->getRawDataLen();
+	m_ProtocolTypes = UnknownProtocol;
+
 	Layer* curLayer = m_FirstLayer;
-	while (curLayer != NULL && (curLayer->getProtocol() & parseUntil) == 0 && curLayer->getOsiModelLayer() <= parseUntilLayer)
+	curLayer->rebindData((uint8_t*)rawPacket->getRawData(), rawPacket->getRawDataLen());
+
+	// re-bind existing layers to the new data as long as the new packet has the same protocol stack as the previous one. If the
+	// previous packet was parsed lazily only the layers that were already parsed are re-used
+	Layer* nextLayer = curLayer->m_NextLayer;
+	while (nextLayer != NULL && (curLayer->getProtocol() & parseUntil) == 0 && curLayer->getOsiModelLayer() <= parseUntilLayer
+			&& nextLayer->getOsiModelLayer() <= parseUntilLayer && curLayer->isNextLayerReusable(nextLayer))
 	{
 		m_ProtocolTypes |= curLayer->getProtocol();
-		curLayer->parseNextLayer();
-		curLayer->m_IsAllocatedInPacket = true;
-		curLayer = curLayer->getNextLayer();
-		if (curLayer != NULL)
-			m_LastLayer = curLayer;
+		nextLayer->rebindData(curLayer->getLayerPayload(), curLayer->getLayerPayloadSize());
+		curLayer = nextLayer;
+		nextLayer = curLayer->m_NextLayer;
 	}
 
-	if (curLayer != NULL && (curLayer->getProtocol() & parseUntil) != 0)
+	// free the remaining layers of the previous packet and let the arena hand out their memory again
+	while (nextLayer != NULL)
 	{
-		m_ProtocolTypes |= curLayer->getProtocol();
-		curLayer->m_IsAllocatedInPacket = true;
+		Layer* tmpLayer = nextLayer->m_NextLayer;
+		delete nextLayer;
+		nextLayer = tmpLayer;
+	}
+
+	curLayer->m_NextLayer = NULL;
+	m_LayerArena.rewindAfter(curLayer);
+
+	parseLayers(curLayer, parseUntil, parseUntilLayer);
+}
+
+void Packet::parseBatch(RawPacket** rawPackets, Packet* packets, size_t count, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
+{
+	// warm up the pipeline: bring in the first raw packet objects and the headers of the first frames
+	for (size_t i = 0; i < count && i < 2 * PACKET_BATCH_PREFETCH_DISTANCE; i++)
+		PACKET_PREFETCH(rawPackets[i]);
+	for (size_t i = 0; i < count && i < PACKET_BATCH_PREFETCH_DISTANCE; i++)
+		prefetchRawPacketHeaders(rawPackets[i]);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		// the raw packet object is needed before its data address is known, so it's prefetched one step ahead of the data
+		if (i + 2 * PACKET_BATCH_PREFETCH_DISTANCE < count)
+			PACKET_PREFETCH(rawPackets[i + 2 * PACKET_BATCH_PREFETCH_DISTANCE]);
+		if (i + PACKET_BATCH_PREFETCH_DISTANCE < count)
+			prefetchRawPacketHeaders(rawPackets[i + PACKET_BATCH_PREFETCH_DISTANCE]);
+
+		packets[i].reparse(rawPackets[i], parseUntil, parseUntilLayer);
 	}
+}
+
+void Packet::prefetchRawPacketHeaders(const RawPacket* rawPacket)
+{
+	const uint8_t* data = rawPacket->getRawData();
+	if (data == NULL)
+		return;
+
+	// the first two cache lines hold the L2-L4 headers of almost every packet
+	PACKET_PREFETCH(data);
+	if (rawPacket->getRawDataLen() > PACKET_PREFETCH_CACHE_LINE_SIZE)
+		PACKET_PREFETCH(data + PACKET_PREFETCH_CACHE_LINE_SIZE);
+}
+
+bool Packet::isFirstLayerReusable(const RawPacket* rawPacket) const
+{
+	if (m_FirstLayer == NULL)
+		return false;
+
+	size_t rawDataLen = (size_t)rawPacket->getRawDataLen();
+	const uint8_t* rawData = rawPacket->getRawData();
+	LinkLayerType linkType = rawPacket->getLinkLayerType();
 
-	if (curLayer != NULL &&  curLayer->getOsiModelLayer() > parseUntilLayer)
+	// must mirror the decisions made in createFirstLayer()
+	if (linkType == LINKTYPE_ETHERNET)
 	{
-		m_LastLayer = curLayer->getPrevLayer();
-		delete curLayer;
-		m_LastLayer->m_NextLayer = NULL;
+		if (rawDataLen < sizeof(ether_header))
+			return false;
+
+		uint16_t ethTypeOrLength = be16toh(*(uint16_t*)(rawData + 12));
+		if (ethTypeOrLength <= (uint16_t)0x5dc && ethTypeOrLength != 0)
+			return false;
+
+		return m_FirstLayer->getProtocol() == Ethernet;
 	}
+	else if (linkType == LINKTYPE_RAW || linkType == LINKTYPE_DLT_RAW1 || linkType == LINKTYPE_DLT_RAW2)
+	{
+		if (rawDataLen == 0)
+			return false;
 
-	if (m_LastLayer != NULL && parseUntil == UnknownProtocol && parseUntilLayer == OsiModelLayerUnknown)
+		uint8_t ipVer = rawData[0] & 0xf0;
+		if (ipVer == 0x40)
+			return m_FirstLayer->getProtocol() == IPv4 && IPv4Layer::isDataValid(rawData, rawDataLen);
+		else if (ipVer == 0x60)
+			return m_FirstLayer->getProtocol() == IPv6 && IPv6Layer::isDataValid(rawData, rawDataLen);
+	}
+
+	return false;
+}
+
+bool Packet::areLayersReusable() const
+{
+	// layers can be re-used only if all of them were created while parsing and no layer was detached from the packet
+	size_t layerCount = 0;
+	for (Layer* curLayer = m_FirstLayer; curLayer != NULL; curLayer = curLayer->m_NextLayer)
+	{
+		if (!curLayer->m_IsAllocatedInPacket || !m_LayerArena.isAllocatedFromArena(curLayer))
+			return false;
+
+		layerCount++;
+	}
+
+	return layerCount == m_LayerArena.getLiveAllocationCount();
+}
+
+void Packet::parseLayers(Layer* startLayer, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
+{
+	m_ParseUntil = parseUntil;
+	m_ParseUntilLayer = parseUntilLayer;
+	m_LastLayer = startLayer;
+	m_AllLayersParsed = (startLayer == NULL);
+	if (startLayer == NULL)
+		return;
+
+	startLayer->m_IsAllocatedInPacket = true;
+	m_ProtocolTypes |= startLayer->getProtocol();
+
+	// in lazy mode the rest of the layers are parsed only when they're first accessed
+	if (!m_LazyParsing)
+		parseRemainingLayers();
+}
+
+bool Packet::parseNextLayerOnDemand()
+{
+	if (m_AllLayersParsed)
+		return false;
+
+	Layer* curLayer = m_LastLayer;
+	if ((curLayer->getProtocol() & m_ParseUntil) == 0 && curLayer->getOsiModelLayer() <= m_ParseUntilLayer)
+	{
+		curLayer->parseNextLayer();
+		Layer* nextLayer = curLayer->m_NextLayer;
+		if (nextLayer != NULL)
+		{
+			if (nextLayer->getOsiModelLayer() <= m_ParseUntilLayer)
+			{
+				nextLayer->m_IsAllocatedInPacket = true;
+				m_ProtocolTypes |= nextLayer->getProtocol();
+				m_LastLayer = nextLayer;
+				return true;
+			}
+
+			// the new layer is above the OSI model layer the user asked to parse until
+			delete nextLayer;
+			curLayer->m_NextLayer = NULL;
+		}
+	}
+
+	m_AllLayersParsed = true;
+
+	if (m_ParseUntil == UnknownProtocol && m_ParseUntilLayer == OsiModelLayerUnknown)
 	{
 		// find if there is data left in the raw packet that doesn't belong to any layer. In that case it's probably a packet trailer.
 		// create a PacketTrailerLayer layer and add it at the end of the packet
 		int trailerLen = (int)((m_RawPacket->getRawData() + m_RawPacket->getRawDataLen()) - (m_LastLayer->getData() + m_LastLayer->getDataLen()));
 		if (trailerLen > 0)
 		{
-			PacketTrailerLayer* trailerLayer = new PacketTrailerLayer(
+			PacketTrailerLayer* trailerLayer = new(this) PacketTrailerLayer(
 					(uint8_t*)(m_LastLayer->getData() + m_LastLayer->getDataLen()),
 					trailerLen,
 					m_LastLayer,
@@ -97,8 +275,51 @@ void Packet::setRawPacket(RawPacket* rawPacket, bool freeRawPacket, ProtocolType
 			m_LastLayer->setNextLayer(trailerLayer);
 			m_LastLayer = trailerLayer;
 			m_ProtocolTypes |= trailerLayer->getProtocol();
+			return true;
 		}
 	}
+
+	return false;
+}
+
+void Packet::parseRemainingLayers()
+{
+	while (!m_AllLayersParsed)
+		parseNextLayerOnDemand();
+}
+
+Layer* Packet::parseAllLayersAndGetLast() const
+{
+	// lazy parsing doesn't change the packet's content, only materializes its layers
+	const_cast<Packet*>(this)->parseRemainingLayers();
+	return m_LastLayer;
+}
+
+bool Packet::parseUntilProtocolFound(ProtocolType protocolType) const
+{
+	Packet* packet = const_cast<Packet*>(this);
+	while (packet->parseNextLayerOnDemand())
+	{
+		if (m_ProtocolTypes & protocolType)
+			return true;
+	}
+
+	return false;
+}
+
+void Packet::setLazyParsing(bool lazyParsing)
+{
+	m_LazyParsing = lazyParsing;
+}
+
+void Packet::setDefaultEnabledProtocols(ProtocolType enabledProtocols)
+{
+	defaultEnabledProtocols = enabledProtocols;
+}
+
+ProtocolType Packet::getDefaultEnabledProtocols()
+{
+	return defaultEnabledProtocols;
 }
 
 Packet::Packet(RawPacket* rawPacket, bool freeRawPacket, ProtocolType parseUntil, OsiModelLayer parseUntilLayer)
@@ -106,6 +327,9 @@ Packet::Packet(RawPacket* rawPacket, bool freeRawPacket, ProtocolType parseUntil
 	m_FreeRawPacket = false;
 	m_RawPacket = NULL;
 	m_FirstLayer = NULL;
+	m_LazyParsing = false;
+	m_EnabledProtocols = defaultEnabledProtocols;
+	m_ChecksumOffloadFlags = ChecksumOffloadNone;
 	setRawPacket(rawPacket, freeRawPacket, parseUntil, parseUntilLayer);
 }
 
@@ -114,6 +338,9 @@ Packet::Packet(RawPacket* rawPacket, ProtocolType parseUntil)
 	m_FreeRawPacket = false;
 	m_RawPacket = NULL;
 	m_FirstLayer = NULL;
+	m_LazyParsing = false;
+	m_EnabledProtocols = defaultEnabledProtocols;
+	m_ChecksumOffloadFlags = ChecksumOffloadNone;
 	setRawPacket(rawPacket, false, parseUntil, OsiModelLayerUnknown);
 }
 
@@ -122,6 +349,9 @@ Packet::Packet(RawPacket* rawPacket, OsiModelLayer parseUntilLayer)
 	m_FreeRawPacket = false;
 	m_RawPacket = NULL;
 	m_FirstLayer = NULL;
+	m_LazyParsing = false;
+	m_EnabledProtocols = defaultEnabledProtocols;
+	m_ChecksumOffloadFlags = ChecksumOffloadNone;
 	setRawPacket(rawPacket, false, UnknownProtocol, parseUntilLayer);
 }
 
@@ -130,7 +360,7 @@ void Packet::destructPacketData()
 	Layer* curLayer = m_FirstLayer;
 	while (curLayer != NULL)
 	{
-		Layer* nextLayer = curLayer->getNextLayer();
+		Layer* nextLayer = curLayer->m_NextLayer;
 		if (curLayer->m_IsAllocatedInPacket)
 			delete curLayer;
 		curLayer = nextLayer;
@@ -145,6 +375,7 @@ void Packet::destructPacketData()
 Packet& Packet::operator=(const Packet& other)
 {
 	destructPacketData();
+	m_LayerArena.reset();
 
 	copyDataFrom(other);
 
@@ -157,6 +388,12 @@ void Packet::copyDataFrom(const Packet& other)
 	m_FreeRawPacket = true;
 	m_MaxPacketLen = other.m_MaxPacketLen;
 	m_ProtocolTypes = other.m_ProtocolTypes;
+	m_LazyParsing = other.m_LazyParsing;
+	m_EnabledProtocols = other.m_EnabledProtocols;
+	m_ChecksumOffloadFlags = other.m_ChecksumOffloadFlags;
+	m_AllLayersParsed = true;
+	m_ParseUntil = UnknownProtocol;
+	m_ParseUntilLayer = OsiModelLayerUnknown;
 	m_FirstLayer = createFirstLayer(m_RawPacket->getLinkLayerType());
 	m_LastLayer = m_FirstLayer;
 	Layer* curLayer = m_FirstLayer;
@@ -164,7 +401,9 @@ void Packet::copyDataFrom(const Packet& other)
 	{
 		curLayer->parseNextLayer();
 		curLayer->m_IsAllocatedInPacket = true;
-		curLayer = curLayer->getNextLayer();
+		// the other packet may have been parsed lazily, so protocols of layers it didn't parse yet are added here
+		m_ProtocolTypes |= curLayer->getProtocol();
+		curLayer = curLayer->m_NextLayer;
 		if (curLayer != NULL)
 			m_LastLayer = curLayer;
 	}
@@ -199,6 +438,9 @@ void Packet::reallocateRawData(size_t newSize)
 
 bool Packet::insertLayer(Layer* prevLayer, Layer* newLayer, bool ownInPacket)
 {
+	// the data of all layers is re-arranged below, so layers that weren't parsed yet (lazy parsing) must be parsed first
+	parseRemainingLayers();
+
 	if (newLayer == NULL)
 	{
 		LOG_ERROR("Layer to add is NULL");
@@ -375,6 +617,8 @@ Layer* Packet::detachLayer(ProtocolType layerType, int index)
 
 bool Packet::removeLayer(Layer* layer, bool tryToDelete)
 {
+	parseRemainingLayers();
+
 	if (layer == NULL)
 	{
 		LOG_ERROR("Layer is NULL");
@@ -512,6 +756,8 @@ Layer* Packet::getLayerOfType(ProtocolType layerType, int index) const
 
 bool Packet::extendLayer(Layer* layer, int offsetInLayer, size_t numOfBytesToExtend)
 {
+	parseRemainingLayers();
+
 	if (layer == NULL)
 	{
 		LOG_ERROR("Layer is NULL");
@@ -572,6 +818,8 @@ bool Packet::extendLayer(Layer* layer, int offsetInLayer, size_t numOfBytesToExt
 
 bool Packet::shortenLayer(Layer* layer, int offsetInLayer, size_t numOfBytesToShorten)
 {
+	parseRemainingLayers();
+
 	if (layer == NULL)
 	{
 		LOG_ERROR("Layer is NULL");
@@ -625,12 +873,83 @@ void Packet::computeCalculateFields()
 {
 	// calculated fields should be calculated from top layer to bottom layer
 
-	Layer* curLayer = m_LastLayer;
+	Layer* curLayer = getLastLayer();
 	while (curLayer != NULL)
 	{
 		curLayer->computeCalculateFields();
 		curLayer = curLayer->getPrevLayer();
 	}
+
+	// describe the checksums the layers left for the device to compute
+	ChecksumOffloadInfo offloadInfo;
+	memset(&offloadInfo, 0, sizeof(offloadInfo));
+	if (m_ChecksumOffloadFlags != ChecksumOffloadNone)
+	{
+		Layer* ipLayer = m_FirstLayer;
+		while (ipLayer != NULL && ipLayer->getProtocol() != IPv4 && ipLayer->getProtocol() != IPv6)
+			ipLayer = ipLayer->getNextLayer();
+
+		if (ipLayer != NULL)
+		{
+			if (isChecksumOffloaded(ipLayer))
+				offloadInfo.flags |= ChecksumOffloadIPv4;
+
+			Layer* transportLayer = ipLayer->getNextLayer();
+			if (transportLayer != NULL && isChecksumOffloaded(transportLayer))
+				offloadInfo.flags |= (transportLayer->getProtocol() == TCP ? ChecksumOffloadTCP : ChecksumOffloadUDP);
+
+			if (offloadInfo.flags != ChecksumOffloadNone)
+			{
+				offloadInfo.isIPv6 = (ipLayer->getProtocol() == IPv6);
+				offloadInfo.l2Len = (uint16_t)(ipLayer->getData() - m_RawPacket->getRawData());
+				offloadInfo.l3Len = (uint16_t)ipLayer->getHeaderLen();
+			}
+		}
+	}
+
+	m_RawPacket->setChecksumOffloadInfo(offloadInfo);
+}
+
+bool Packet::isOutermostIPLayer(const Layer* layer)
+{
+	if (layer->getProtocol() != IPv4 && layer->getProtocol() != IPv6)
+		return false;
+
+	for (const Layer* prevLayer = layer->getPrevLayer(); prevLayer != NULL; prevLayer = prevLayer->getPrevLayer())
+	{
+		if (prevLayer->getProtocol() == IPv4 || prevLayer->getProtocol() == IPv6)
+			return false;
+	}
+
+	return true;
+}
+
+bool Packet::isChecksumOffloaded(const Layer* layer) const
+{
+	if (m_ChecksumOffloadFlags == ChecksumOffloadNone || layer == NULL)
+		return false;
+
+	switch (layer->getProtocol())
+	{
+	case IPv4:
+		return (m_ChecksumOffloadFlags & ChecksumOffloadIPv4) && isOutermostIPLayer(layer);
+	case TCP:
+	case UDP:
+	{
+		if ((m_ChecksumOffloadFlags & (layer->getProtocol() == TCP ? ChecksumOffloadTCP : ChecksumOffloadUDP)) == 0)
+			return false;
+
+		// devices compute the checksum over the whole IP payload, so it can't be offloaded for fragments
+		const Layer* ipLayer = layer->getPrevLayer();
+		if (ipLayer == NULL || !isOutermostIPLayer(ipLayer))
+			return false;
+		if (ipLayer->getProtocol() == IPv4)
+			return !((const IPv4Layer*)ipLayer)->isFragment();
+		return !((const IPv6Layer*)ipLayer)->isFragment();
+	}
+	default:
+		return false;
+	}
 }
 
 std::string Packet::printPacketInfo(bool timeAsLocalTime) const
@@ -697,19 +1016,19 @@ Layer* Packet::createFirstLayer(LinkLayerType linkType)
 			uint16_t ethTypeOrLength = be16toh(*(uint16_t*)(rawData + 12));
 			if (ethTypeOrLength <= (uint16_t)0x5dc && ethTypeOrLength != 0)
 			{
-				return new EthDot3Layer((uint8_t*)rawData, rawDataLen, this);
+				return new(this) EthDot3Layer((uint8_t*)rawData, rawDataLen, this);
 			}
 		}
 		
-		return new EthLayer((uint8_t*)rawData, rawDataLen, this);
+		return new(this) EthLayer((uint8_t*)rawData, rawDataLen, this);
 	}
 	else if (linkType == LINKTYPE_LINUX_SLL)
 	{
-		return new SllLayer((uint8_t*)rawData, rawDataLen, this);
+		return new(this) SllLayer((uint8_t*)rawData, rawDataLen, this);
 	}
 	else if (linkType == LINKTYPE_NULL)
 	{
-		return new NullLoopbackLayer((uint8_t*)rawData, rawDataLen, this);
+		return new(this) NullLoopbackLayer((uint8_t*)rawData, rawDataLen, this);
 	}
 	else if (linkType == LINKTYPE_RAW || linkType == LINKTYPE_DLT_RAW1 || linkType == LINKTYPE_DLT_RAW2)
 	{
@@ -717,23 +1036,23 @@ Layer* Packet::createFirstLayer(LinkLayerType linkType)
 		if (ipVer == 0x40)
 		{
 			return IPv4Layer::isDataValid(rawData, rawDataLen)
-				? static_cast<Layer*>(new IPv4Layer((uint8_t*)rawData, rawDataLen, NULL, this))
-				: static_cast<Layer*>(new PayloadLayer((uint8_t*)rawData, rawDataLen, NULL, this));
+				? static_cast<Layer*>(new(this) IPv4Layer((uint8_t*)rawData, rawDataLen, NULL, this))
+				: static_cast<Layer*>(new(this) PayloadLayer((uint8_t*)rawData, rawDataLen, NULL, this));
 		}
 		else if (ipVer == 0x60)
 		{
 			return IPv6Layer::isDataValid(rawData, rawDataLen)
-				? static_cast<Layer*>(new IPv6Layer((uint8_t*)rawData, rawDataLen, NULL, this))
-				: static_cast<Layer*>(new PayloadLayer((uint8_t*)rawData, rawDataLen, NULL, this));
+				? static_cast<Layer*>(new(this) IPv6Layer((uint8_t*)rawData, rawDataLen, NULL, this))
+				: static_cast<Layer*>(new(this) PayloadLayer((uint8_t*)rawData, rawDataLen, NULL, this));
 		}
 		else
 		{
-			return new PayloadLayer((uint8_t*)rawData, rawDataLen, NULL, this);
+			return new(this) PayloadLayer((uint8_t*)rawData, rawDataLen, NULL, this);
 		}
 	}
 
 	// unknown link type
-	return new EthLayer((uint8_t*)rawData, rawDataLen, this);
+	return new(this) EthLayer((uint8_t*)rawData, rawDataLen, this);
 }
 
 std::string Packet::toString(bool timeAsLocalTime)
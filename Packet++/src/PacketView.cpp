@@ -0,0 +1,490 @@
+#include "PacketView.h"
+#include "Packet.h"
+#include "EthLayer.h"
+#include "SllLayer.h"
+#include "VlanLayer.h"
+#include "IPv4Layer.h"
+#include "IPv6Layer.h"
+#include "IPv6Extensions.h"
+#include "TcpLayer.h"
+#include "UdpLayer.h"
+#include "GreLayer.h"
+#include "VxlanLayer.h"
+#include "GtpLayer.h"
+#include "EndianPortable.h"
+#include <string.h>
+
+namespace pcpp
+{
+
+#define PACKET_VIEW_MPLS_HEADER_LEN 4
+#define PACKET_VIEW_GTP_GPDU_MESSAGE_TYPE 0xff
+#define PACKET_VIEW_GTP_HEADER_EXTRA_LEN 4
+
+PacketView::PacketView()
+{
+	clear();
+}
+
+PacketView::PacketView(RawPacket* rawPacket)
+{
+	parse(rawPacket);
+}
+
+void PacketView::clear()
+{
+	m_RawPacket = NULL;
+	m_HeaderCount = 0;
+	m_ProtocolTypes = UnknownProtocol;
+	m_NetworkHeaderIndex = -1;
+	m_TransportHeaderIndex = -1;
+	m_NetworkEnd = 0;
+	m_IsFragment = false;
+}
+
+bool PacketView::addHeader(ProtocolType protocol, size_t offset, size_t length)
+{
+	// offsets are kept in 16 bits, headers beyond that aren't decoded
+	if (m_HeaderCount >= MaxHeaders || offset + length > 0xffff)
+		return false;
+
+	HeaderInfo& header = m_Headers[m_HeaderCount++];
+	header.protocol = protocol;
+	header.offset = (uint16_t)offset;
+	header.length = (uint16_t)length;
+	m_ProtocolTypes |= protocol;
+	return true;
+}
+
+ProtocolType PacketView::getProtocolByEtherType(uint16_t etherType, const uint8_t* payload, size_t payloadLen)
+{
+	switch (etherType)
+	{
+	case PCPP_ETHERTYPE_IP:
+		return IPv4Layer::isDataValid(payload, payloadLen) ? IPv4 : UnknownProtocol;
+	case PCPP_ETHERTYPE_IPV6:
+		return IPv6Layer::isDataValid(payload, payloadLen) ? IPv6 : UnknownProtocol;
+	case PCPP_ETHERTYPE_VLAN:
+		return VLAN;
+	case PCPP_ETHERTYPE_MPLS:
+		return MPLS;
+	default:
+		return UnknownProtocol;
+	}
+}
+
+ProtocolType PacketView::getProtocolByIPVersion(const uint8_t* payload, size_t payloadLen)
+{
+	if (payloadLen == 0)
+		return UnknownProtocol;
+
+	uint8_t ipVersion = payload[0] >> 4;
+	if (ipVersion == 4)
+		return IPv4Layer::isDataValid(payload, payloadLen) ? IPv4 : UnknownProtocol;
+	else if (ipVersion == 6)
+		return IPv6Layer::isDataValid(payload, payloadLen) ? IPv6 : UnknownProtocol;
+
+	return UnknownProtocol;
+}
+
+ProtocolType PacketView::getProtocolByIPProtocol(uint8_t ipProtocol, const uint8_t* payload, size_t payloadLen)
+{
+	switch (ipProtocol)
+	{
+	case PACKETPP_IPPROTO_UDP:
+		return payloadLen >= sizeof(udphdr) ? UDP : UnknownProtocol;
+	case PACKETPP_IPPROTO_TCP:
+		return TcpLayer::isDataValid(payload, payloadLen) ? TCP : UnknownProtocol;
+	case PACKETPP_IPPROTO_IPIP:
+		return getProtocolByIPVersion(payload, payloadLen);
+	case PACKETPP_IPPROTO_GRE:
+		return GreLayer::getGREVersion((uint8_t*)payload, payloadLen);
+	default:
+		return UnknownProtocol;
+	}
+}
+
+bool PacketView::parse(RawPacket* rawPacket)
+{
+	clear();
+
+	if (rawPacket == NULL || rawPacket->getRawDataLen() <= 0)
+		return false;
+
+	m_RawPacket = rawPacket;
+
+	const uint8_t* data = rawPacket->getRawData();
+	size_t dataLen = (size_t)rawPacket->getRawDataLen();
+
+	// identify the first header the same way Packet does
+	ProtocolType nextProtocol = UnknownProtocol;
+	LinkLayerType linkType = rawPacket->getLinkLayerType();
+	if (linkType == LINKTYPE_ETHERNET)
+	{
+		if (dataLen < sizeof(ether_header))
+			return false;
+
+		uint16_t ethTypeOrLength = be16toh(((ether_header*)data)->etherType);
+		if (ethTypeOrLength <= (uint16_t)0x5dc && ethTypeOrLength != 0)
+		{
+			// IEEE 802.3 Ethernet is followed by LLC which isn't decoded
+			return addHeader(EthernetDot3, 0, sizeof(ether_header));
+		}
+
+		nextProtocol = Ethernet;
+	}
+	else if (linkType == LINKTYPE_LINUX_SLL)
+		nextProtocol = SLL;
+	else if (linkType == LINKTYPE_RAW || linkType == LINKTYPE_DLT_RAW1 || linkType == LINKTYPE_DLT_RAW2)
+		nextProtocol = getProtocolByIPVersion(data, dataLen);
+
+	// a single pass over the headers. In each iteration the current header is recorded and the protocol of the next header is
+	// determined, until reaching a protocol that isn't decoded or the end of the data
+	size_t offset = 0;
+	size_t endOffset = dataLen;
+	while (nextProtocol != UnknownProtocol && offset < endOffset)
+	{
+		const uint8_t* curData = data + offset;
+		size_t curDataLen = endOffset - offset;
+		ProtocolType curProtocol = nextProtocol;
+		size_t headerLen = 0;
+		nextProtocol = UnknownProtocol;
+		// the network and transport header indices are updated only once the header is recorded
+		bool isNetworkHeader = false;
+		bool isTransportHeader = false;
+		bool isFragment = false;
+
+		switch (curProtocol)
+		{
+		case Ethernet:
+		{
+			headerLen = sizeof(ether_header);
+			if (curDataLen > headerLen)
+				nextProtocol = getProtocolByEtherType(be16toh(((ether_header*)curData)->etherType), curData + headerLen, curDataLen - headerLen);
+			break;
+		}
+
+		case SLL:
+		{
+			headerLen = sizeof(sll_header);
+			if (curDataLen > headerLen)
+				nextProtocol = getProtocolByEtherType(be16toh(((sll_header*)curData)->protocol_type), curData + headerLen, curDataLen - headerLen);
+			break;
+		}
+
+		case VLAN:
+		{
+			headerLen = sizeof(vlan_header);
+			if (curDataLen > headerLen)
+				nextProtocol = getProtocolByEtherType(be16toh(((vlan_header*)curData)->etherType), curData + headerLen, curDataLen - headerLen);
+			break;
+		}
+
+		case MPLS:
+		{
+			headerLen = PACKET_VIEW_MPLS_HEADER_LEN;
+			if (curDataLen <= headerLen)
+				break;
+
+			// the bottom-of-stack bit is the lowest bit of the 3rd byte. The protocol after the last label is guessed by its first nibble
+			bool bottomOfStack = (curData[2] & 0x01) != 0;
+			nextProtocol = bottomOfStack ? getProtocolByIPVersion(curData + headerLen, curDataLen - headerLen) : MPLS;
+			break;
+		}
+
+		case IPv4:
+		{
+			const iphdr* ipHdr = (const iphdr*)curData;
+			headerLen = ipHdr->internetHeaderLength * 4;
+
+			// exclude padding and trailer bytes that don't belong to the IP packet. A total length of 0 usually means TCP segmentation offload
+			size_t totalLen = be16toh(ipHdr->totalLength);
+			if (totalLen < curDataLen && totalLen != 0)
+				endOffset = offset + totalLen;
+
+			isNetworkHeader = true;
+			isFragment = (be16toh(ipHdr->fragmentOffset) & 0x3fff) != 0;
+
+			if (endOffset - offset > headerLen && !isFragment)
+				nextProtocol = getProtocolByIPProtocol(ipHdr->protocol, curData + headerLen, endOffset - offset - headerLen);
+			break;
+		}
+
+		case IPv6:
+		{
+			const ip6_hdr* ipHdr = (const ip6_hdr*)curData;
+
+			size_t totalLen = sizeof(ip6_hdr) + be16toh(ipHdr->payloadLength);
+			if (totalLen < curDataLen && ipHdr->payloadLength != 0)
+			{
+				endOffset = offset + totalLen;
+				curDataLen = totalLen;
+			}
+
+			isNetworkHeader = true;
+
+			// walk over the extension headers, they're counted as part of the IPv6 header like in IPv6Layer
+			headerLen = sizeof(ip6_hdr);
+			uint8_t nextHeader = ipHdr->nextHeader;
+			bool isExtension = true;
+			// each extension header starts with the next header type and the extension length
+			while (headerLen + 2 * sizeof(uint8_t) <= curDataLen)
+			{
+				const uint8_t* extData = curData + headerLen;
+				size_t extLen = 0;
+				switch (nextHeader)
+				{
+				case PACKETPP_IPPROTO_HOPOPTS:
+				case PACKETPP_IPPROTO_DSTOPTS:
+				case PACKETPP_IPPROTO_ROUTING:
+					extLen = 8 * ((size_t)extData[1] + 1);
+					break;
+				case PACKETPP_IPPROTO_AH:
+					extLen = 4 * ((size_t)extData[1] + 2);
+					break;
+				case PACKETPP_IPPROTO_FRAGMENT:
+					extLen = sizeof(IPv6FragmentationHeader::ipv6_frag_header);
+					isFragment = true;
+					break;
+				default:
+					isExtension = false;
+					break;
+				}
+
+				if (!isExtension)
+					break;
+
+				if (headerLen + extLen > curDataLen)
+				{
+					// truncated extension header, don't decode beyond it
+					nextHeader = PACKETPP_IPPROTO_NONE;
+					headerLen = curDataLen;
+					break;
+				}
+
+				nextHeader = extData[0];
+				headerLen += extLen;
+			}
+
+			if (curDataLen > headerLen && !isFragment)
+				nextProtocol = getProtocolByIPProtocol(nextHeader, curData + headerLen, curDataLen - headerLen);
+			break;
+		}
+
+		case TCP:
+		{
+			headerLen = ((const tcphdr*)curData)->dataOffset * 4;
+			isTransportHeader = true;
+			break;
+		}
+
+		case UDP:
+		{
+			headerLen = sizeof(udphdr);
+			isTransportHeader = true;
+			if (curDataLen <= headerLen)
+				break;
+
+			const udphdr* udpHdr = (const udphdr*)curData;
+			uint16_t portSrc = be16toh(udpHdr->portSrc);
+			uint16_t portDst = be16toh(udpHdr->portDst);
+			if (VxlanLayer::isVxlanPort(portDst))
+				nextProtocol = VXLAN;
+			else if ((GtpV1Layer::isGTPv1Port(portDst) || GtpV1Layer::isGTPv1Port(portSrc)) && GtpV1Layer::isGTPv1(curData + headerLen, curDataLen - headerLen))
+				nextProtocol = GTPv1;
+			break;
+		}
+
+		case GREv0:
+		case GREv1:
+		{
+			const gre_basic_header* greHdr = (const gre_basic_header*)curData;
+			headerLen = sizeof(gre_basic_header);
+			if (greHdr->checksumBit == 1 || greHdr->routingBit == 1)
+				headerLen += sizeof(uint32_t);
+			if (greHdr->keyBit == 1)
+				headerLen += sizeof(uint32_t);
+			if (greHdr->sequenceNumBit == 1)
+				headerLen += sizeof(uint32_t);
+			if (greHdr->ackSequenceNumBit == 1)
+				headerLen += sizeof(uint32_t);
+
+			if (curDataLen > headerLen)
+				nextProtocol = getProtocolByEtherType(be16toh(greHdr->protocol), curData + headerLen, curDataLen - headerLen);
+			break;
+		}
+
+		case VXLAN:
+		{
+			headerLen = sizeof(vxlan_header);
+			if (curDataLen > headerLen)
+				nextProtocol = (curDataLen - headerLen >= sizeof(ether_header) ? Ethernet : UnknownProtocol);
+			break;
+		}
+
+		case GTPv1:
+		{
+			const gtpv1_header* gtpHdr = (const gtpv1_header*)curData;
+			headerLen = sizeof(gtpv1_header);
+			if (curDataLen < headerLen || gtpHdr->messageType != PACKET_VIEW_GTP_GPDU_MESSAGE_TYPE)
+			{
+				// GTP-C messages aren't followed by other protocols
+				break;
+			}
+
+			if (gtpHdr->extensionHeaderFlag == 1 || gtpHdr->sequenceNumberFlag == 1 || gtpHdr->npduNumberFlag == 1)
+			{
+				if (curDataLen < headerLen + PACKET_VIEW_GTP_HEADER_EXTRA_LEN)
+					break;
+
+				// the last byte of the optional fields is the type of the first extension header. Each extension header starts with its
+				// length in 4-byte units and ends with the type of the next one
+				uint8_t nextExtType = (gtpHdr->extensionHeaderFlag == 1 ? curData[headerLen + PACKET_VIEW_GTP_HEADER_EXTRA_LEN - 1] : 0);
+				headerLen += PACKET_VIEW_GTP_HEADER_EXTRA_LEN;
+				while (nextExtType != 0 && headerLen < curDataLen)
+				{
+					size_t extLen = 4 * (size_t)curData[headerLen];
+					if (extLen == 0 || headerLen + extLen > curDataLen)
+					{
+						headerLen = curDataLen;
+						break;
+					}
+
+					nextExtType = curData[headerLen + extLen - 1];
+					headerLen += extLen;
+				}
+			}
+
+			if (curDataLen > headerLen)
+			{
+				uint8_t firstByte = curData[headerLen];
+				if ((firstByte >= 0x45 && firstByte <= 0x4e) || (firstByte & 0xf0) == 0x60)
+					nextProtocol = getProtocolByIPVersion(curData + headerLen, curDataLen - headerLen);
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		if (headerLen > curDataLen)
+			headerLen = curDataLen;
+
+		if (!addHeader(curProtocol, offset, headerLen))
+			break;
+
+		if (isNetworkHeader)
+		{
+			m_NetworkHeaderIndex = (int)m_HeaderCount - 1;
+			m_TransportHeaderIndex = -1;
+			m_NetworkEnd = endOffset;
+			m_IsFragment = isFragment;
+		}
+		else if (isTransportHeader)
+			m_TransportHeaderIndex = (int)m_HeaderCount - 1;
+
+		offset += headerLen;
+	}
+
+	return m_HeaderCount > 0;
+}
+
+const PacketView::HeaderInfo* PacketView::getHeaderOfType(ProtocolType protocolType, bool innermost) const
+{
+	if ((m_ProtocolTypes & protocolType) == 0)
+		return NULL;
+
+	for (size_t i = 0; i < m_HeaderCount; i++)
+	{
+		const HeaderInfo& header = m_Headers[innermost ? m_HeaderCount - 1 - i : i];
+		if ((header.protocol & protocolType) != 0)
+			return &header;
+	}
+
+	return NULL;
+}
+
+IPv4Address PacketView::getSrcIPv4Address() const
+{
+	const HeaderInfo* ipHeader = getNetworkHeader();
+	if (ipHeader == NULL || ipHeader->protocol != IPv4)
+		return IPv4Address::Zero;
+
+	return IPv4Address(((const iphdr*)getHeaderData(*ipHeader))->ipSrc);
+}
+
+IPv4Address PacketView::getDstIPv4Address() const
+{
+	const HeaderInfo* ipHeader = getNetworkHeader();
+	if (ipHeader == NULL || ipHeader->protocol != IPv4)
+		return IPv4Address::Zero;
+
+	return IPv4Address(((const iphdr*)getHeaderData(*ipHeader))->ipDst);
+}
+
+IPv6Address PacketView::getSrcIPv6Address() const
+{
+	const HeaderInfo* ipHeader = getNetworkHeader();
+	if (ipHeader == NULL || ipHeader->protocol != IPv6)
+		return IPv6Address::Zero;
+
+	return IPv6Address(((ip6_hdr*)getHeaderData(*ipHeader))->ipSrc);
+}
+
+IPv6Address PacketView::getDstIPv6Address() const
+{
+	const HeaderInfo* ipHeader = getNetworkHeader();
+	if (ipHeader == NULL || ipHeader->protocol != IPv6)
+		return IPv6Address::Zero;
+
+	return IPv6Address(((ip6_hdr*)getHeaderData(*ipHeader))->ipDst);
+}
+
+uint16_t PacketView::getSrcPort() const
+{
+	// the source port is the first field of both TCP and UDP headers
+	const HeaderInfo* l4Header = getTransportHeader();
+	if (l4Header == NULL || l4Header->length < sizeof(uint16_t) * 2)
+		return 0;
+
+	return be16toh(((const udphdr*)getHeaderData(*l4Header))->portSrc);
+}
+
+uint16_t PacketView::getDstPort() const
+{
+	const HeaderInfo* l4Header = getTransportHeader();
+	if (l4Header == NULL || l4Header->length < sizeof(uint16_t) * 2)
+		return 0;
+
+	return be16toh(((const udphdr*)getHeaderData(*l4Header))->portDst);
+}
+
+size_t PacketView::getTransportPayloadOffset() const
+{
+	const HeaderInfo* l4Header = getTransportHeader();
+	if (l4Header == NULL)
+		return 0;
+
+	return (size_t)l4Header->offset + l4Header->length;
+}
+
+size_t PacketView::getTransportPayloadLen() const
+{
+	size_t payloadOffset = getTransportPayloadOffset();
+	if (payloadOffset == 0 || payloadOffset >= m_NetworkEnd)
+		return 0;
+
+	return m_NetworkEnd - payloadOffset;
+}
+
+bool PacketView::toPacket(Packet& packet, ProtocolType parseUntil, OsiModelLayer parseUntilLayer) const
+{
+	if (m_RawPacket == NULL)
+		return false;
+
+	packet.reparse(m_RawPacket, parseUntil, parseUntilLayer);
+	return true;
+}
+
+} // namespace pcpp
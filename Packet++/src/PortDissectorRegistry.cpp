@@ -0,0 +1,450 @@
+#define LOG_MODULE PacketLogModulePortDissectorRegistry
+
+#include "PortDissectorRegistry.h"
+#include "Packet.h"
+#include "PayloadLayer.h"
+#include "HttpLayer.h"
+#include "SSLLayer.h"
+#include "SipLayer.h"
+#include "BgpLayer.h"
+#include "DnsLayer.h"
+#include "DhcpLayer.h"
+#include "VxlanLayer.h"
+#include "RadiusLayer.h"
+#include "GtpLayer.h"
+#include "Logger.h"
+#include <string.h>
+
+namespace pcpp
+{
+
+// ~~~~~~~~~~~~~~~~~~~
+// Built-in dissectors
+// ~~~~~~~~~~~~~~~~~~~
+
+static Layer* dissectHttpRequest(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (HttpRequestFirstLine::parseMethod((char*)data, dataLen) == HttpRequestLayer::HttpMethodUnknown)
+		return NULL;
+
+	return new(packet) HttpRequestLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectHttpResponse(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (HttpResponseFirstLine::parseStatusCode((char*)data, dataLen) == HttpResponseLayer::HttpStatusCodeUnknown)
+		return NULL;
+
+	return new(packet) HttpResponseLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectSSL(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t srcPort, uint16_t dstPort)
+{
+	if (!SSLLayer::IsSSLMessage(srcPort, dstPort, data, dataLen, true))
+		return NULL;
+
+	return SSLLayer::createSSLMessage(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectTcpSip(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (SipRequestFirstLine::parseMethod((char*)data, dataLen) != SipRequestLayer::SipMethodUnknown)
+		return new(packet) SipRequestLayer(data, dataLen, prevLayer, packet);
+	else if (SipResponseFirstLine::parseStatusCode((char*)data, dataLen) != SipResponseLayer::SipStatusCodeUnknown)
+		return new(packet) SipResponseLayer(data, dataLen, prevLayer, packet);
+
+	// data on SIP ports that isn't SIP isn't checked against lower priority dissectors
+	return new(packet) PayloadLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectBgp(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	return BgpLayer::parseBgpLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectDhcp(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t srcPort, uint16_t dstPort)
+{
+	// DHCP messages are sent from client (68) to server (67), from server to client or between relay agents (67)
+	if ((srcPort == 68 && dstPort == 67) || (srcPort == 67 && dstPort == 68) || (srcPort == 67 && dstPort == 67))
+		return new(packet) DhcpLayer(data, dataLen, prevLayer, packet);
+
+	return NULL;
+}
+
+static Layer* dissectVxlan(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	return new(packet) VxlanLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectDns(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (dataLen < sizeof(dnshdr))
+		return NULL;
+
+	return new(packet) DnsLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectUdpSip(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (SipRequestFirstLine::parseMethod((char*)data, dataLen) != SipRequestLayer::SipMethodUnknown)
+		return new(packet) SipRequestLayer(data, dataLen, prevLayer, packet);
+	else if (SipResponseFirstLine::parseStatusCode((char*)data, dataLen) != SipResponseLayer::SipStatusCodeUnknown
+					&& SipResponseFirstLine::parseVersion((char*)data, dataLen) != "")
+		return new(packet) SipResponseLayer(data, dataLen, prevLayer, packet);
+
+	// data on SIP ports that isn't SIP isn't checked against lower priority dissectors
+	return new(packet) PayloadLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectRadius(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (!RadiusLayer::isDataValid(data, dataLen))
+		return NULL;
+
+	return new(packet) RadiusLayer(data, dataLen, prevLayer, packet);
+}
+
+static Layer* dissectGtpV1(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	if (!GtpV1Layer::isGTPv1(data, dataLen))
+		return NULL;
+
+	return new(packet) GtpV1Layer(data, dataLen, prevLayer, packet);
+}
+
+static bool isBgpPort(uint16_t port)
+{
+	return BgpLayer::isBgpPort(port, port);
+}
+
+static bool isDhcpPort(uint16_t port)
+{
+	return port == 67 || port == 68;
+}
+
+static bool isSSLPort(uint16_t port)
+{
+	return SSLLayer::isSSLPort(port);
+}
+
+static bool isDnsPort(uint16_t port)
+{
+	return DnsLayer::isDnsPort(port);
+}
+
+static bool isRadiusPort(uint16_t port)
+{
+	return RadiusLayer::isRadiusPort(port);
+}
+
+
+// remove bit number index from a value and shift the bits above it one place down
+static uint32_t removeBit(uint32_t value, size_t index)
+{
+	uint32_t lowBits = value & (((uint32_t)1 << index) - 1);
+	uint32_t highBits = (uint32_t)(((uint64_t)value >> (index + 1)) << index);
+	return lowBits | highBits;
+}
+
+// insert a bit at position index of a value and shift the bits above it one place up
+static uint32_t insertBit(uint32_t value, size_t index, bool bitSet)
+{
+	uint32_t lowBits = value & (((uint32_t)1 << index) - 1);
+	uint32_t highBits = (uint32_t)(((uint64_t)value >> index) << (index + 1));
+	return lowBits | (bitSet ? (uint32_t)1 << index : 0) | highBits;
+}
+
+
+// ~~~~~~~~~~~~~~~~~~~~~
+// PortDissectorRegistry
+// ~~~~~~~~~~~~~~~~~~~~~
+
+PortDissectorRegistry::PortDissectorRegistry()
+{
+	resetToDefaults();
+}
+
+void PortDissectorRegistry::resetToDefaults()
+{
+	m_TcpDissectors.numOfDissectors = 0;
+	memset(m_TcpDissectors.portTable, 0, sizeof(m_TcpDissectors.portTable));
+	addDissector(m_TcpDissectors, HTTPRequest, dissectHttpRequest, MatchDstPort, HttpMessage::isHttpPort);
+	addDissector(m_TcpDissectors, HTTPResponse, dissectHttpResponse, MatchSrcPort, HttpMessage::isHttpPort);
+	addDissector(m_TcpDissectors, SSL, dissectSSL, MatchAnyPort, isSSLPort);
+	addDissector(m_TcpDissectors, SIP, dissectTcpSip, MatchDstPort, SipLayer::isSipPort);
+	addDissector(m_TcpDissectors, BGP, dissectBgp, MatchAnyPort, isBgpPort);
+	updatePortMasks(m_TcpDissectors);
+
+	m_UdpDissectors.numOfDissectors = 0;
+	memset(m_UdpDissectors.portTable, 0, sizeof(m_UdpDissectors.portTable));
+	addDissector(m_UdpDissectors, DHCP, dissectDhcp, MatchAnyPort, isDhcpPort);
+	addDissector(m_UdpDissectors, VXLAN, dissectVxlan, MatchDstPort, VxlanLayer::isVxlanPort);
+	addDissector(m_UdpDissectors, DNS, dissectDns, MatchAnyPort, isDnsPort);
+	addDissector(m_UdpDissectors, SIP, dissectUdpSip, MatchAnyPort, SipLayer::isSipPort);
+	addDissector(m_UdpDissectors, Radius, dissectRadius, MatchAnyPort, isRadiusPort);
+	addDissector(m_UdpDissectors, GTPv1, dissectGtpV1, MatchAnyPort, GtpV1Layer::isGTPv1Port);
+	updatePortMasks(m_UdpDissectors);
+}
+
+void PortDissectorRegistry::addDissector(TransportDissectors& transportDissectors, ProtocolType protocol, DissectorFunc dissector, PortDirection portDirection, bool (*isDefaultPort)(uint16_t))
+{
+	size_t index = transportDissectors.numOfDissectors++;
+	Dissector& newDissector = transportDissectors.dissectors[index];
+	newDissector.protocol = protocol;
+	newDissector.func = dissector;
+	newDissector.portDirection = portDirection;
+	newDissector.enabled = true;
+
+	if (isDefaultPort == NULL)
+		return;
+
+	uint32_t dissectorBit = (uint32_t)1 << index;
+	for (size_t port = 0; port < NumOfPorts; port++)
+	{
+		if (isDefaultPort((uint16_t)port))
+			transportDissectors.portTable[port] |= dissectorBit;
+	}
+}
+
+void PortDissectorRegistry::removeDissector(TransportDissectors& transportDissectors, size_t index)
+{
+	for (size_t port = 0; port < NumOfPorts; port++)
+		transportDissectors.portTable[port] = removeBit(transportDissectors.portTable[port], index);
+
+	for (size_t i = index + 1; i < transportDissectors.numOfDissectors; i++)
+		transportDissectors.dissectors[i - 1] = transportDissectors.dissectors[i];
+
+	transportDissectors.numOfDissectors--;
+}
+
+void PortDissectorRegistry::updatePortMasks(TransportDissectors& transportDissectors)
+{
+	transportDissectors.srcPortMask = 0;
+	transportDissectors.dstPortMask = 0;
+
+	for (size_t i = 0; i < transportDissectors.numOfDissectors; i++)
+	{
+		const Dissector& dissector = transportDissectors.dissectors[i];
+		if (!dissector.enabled)
+			continue;
+
+		if (dissector.portDirection & MatchSrcPort)
+			transportDissectors.srcPortMask |= (uint32_t)1 << i;
+		if (dissector.portDirection & MatchDstPort)
+			transportDissectors.dstPortMask |= (uint32_t)1 << i;
+	}
+}
+
+PortDissectorRegistry::TransportDissectors* PortDissectorRegistry::getTransportDissectors(ProtocolType transport)
+{
+	if (transport == TCP)
+		return &m_TcpDissectors;
+	if (transport == UDP)
+		return &m_UdpDissectors;
+
+	LOG_ERROR("Dissectors can be registered only for TCP or UDP");
+	return NULL;
+}
+
+const PortDissectorRegistry::TransportDissectors* PortDissectorRegistry::getTransportDissectors(ProtocolType transport) const
+{
+	if (transport == TCP)
+		return &m_TcpDissectors;
+	if (transport == UDP)
+		return &m_UdpDissectors;
+
+	return NULL;
+}
+
+int PortDissectorRegistry::findDissectorIndex(const TransportDissectors& transportDissectors, ProtocolType protocol)
+{
+	for (size_t i = 0; i < transportDissectors.numOfDissectors; i++)
+	{
+		if (transportDissectors.dissectors[i].protocol == protocol)
+			return (int)i;
+	}
+
+	return -1;
+}
+
+bool PortDissectorRegistry::registerDissector(ProtocolType transport, ProtocolType protocol, DissectorFunc dissector, PortDirection portDirection)
+{
+	TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	if (dissector == NULL)
+	{
+		LOG_ERROR("Dissector function is NULL");
+		return false;
+	}
+
+	if (findDissectorIndex(*transportDissectors, protocol) >= 0)
+	{
+		LOG_ERROR("A dissector for protocol 0x%llX is already registered", (unsigned long long)protocol);
+		return false;
+	}
+
+	if (transportDissectors->numOfDissectors >= MaxDissectors)
+	{
+		LOG_ERROR("Cannot register more than %d dissectors per transport protocol", (int)MaxDissectors);
+		return false;
+	}
+
+	addDissector(*transportDissectors, protocol, dissector, portDirection, NULL);
+	updatePortMasks(*transportDissectors);
+	return true;
+}
+
+bool PortDissectorRegistry::unregisterDissector(ProtocolType transport, ProtocolType protocol)
+{
+	TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	if (index < 0)
+		return false;
+
+	removeDissector(*transportDissectors, (size_t)index);
+	updatePortMasks(*transportDissectors);
+	return true;
+}
+
+bool PortDissectorRegistry::addPort(ProtocolType transport, ProtocolType protocol, uint16_t port)
+{
+	TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	if (index < 0)
+		return false;
+
+	transportDissectors->portTable[port] |= (uint32_t)1 << index;
+	return true;
+}
+
+bool PortDissectorRegistry::removePort(ProtocolType transport, ProtocolType protocol, uint16_t port)
+{
+	TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	if (index < 0 || (transportDissectors->portTable[port] & ((uint32_t)1 << index)) == 0)
+		return false;
+
+	transportDissectors->portTable[port] &= ~((uint32_t)1 << index);
+	return true;
+}
+
+bool PortDissectorRegistry::isPortRegistered(ProtocolType transport, ProtocolType protocol, uint16_t port) const
+{
+	const TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	return index >= 0 && (transportDissectors->portTable[port] & ((uint32_t)1 << index)) != 0;
+}
+
+bool PortDissectorRegistry::setDissectorEnabled(ProtocolType transport, ProtocolType protocol, bool enabled)
+{
+	TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	if (index < 0)
+		return false;
+
+	transportDissectors->dissectors[index].enabled = enabled;
+	updatePortMasks(*transportDissectors);
+	return true;
+}
+
+bool PortDissectorRegistry::isDissectorEnabled(ProtocolType transport, ProtocolType protocol) const
+{
+	const TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	return index >= 0 && transportDissectors->dissectors[index].enabled;
+}
+
+bool PortDissectorRegistry::setDissectorPriority(ProtocolType transport, ProtocolType protocol, size_t priority)
+{
+	TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return false;
+
+	int index = findDissectorIndex(*transportDissectors, protocol);
+	if (index < 0)
+		return false;
+
+	if (priority >= transportDissectors->numOfDissectors)
+		priority = transportDissectors->numOfDissectors - 1;
+
+	if (priority == (size_t)index)
+		return true;
+
+	// move the dissector's bit in every port table entry to its new position
+	uint32_t dissectorBit = (uint32_t)1 << index;
+	for (size_t port = 0; port < NumOfPorts; port++)
+	{
+		uint32_t entry = transportDissectors->portTable[port];
+		transportDissectors->portTable[port] = insertBit(removeBit(entry, index), priority, (entry & dissectorBit) != 0);
+	}
+
+	Dissector dissector = transportDissectors->dissectors[index];
+	if (priority < (size_t)index)
+	{
+		for (size_t i = index; i > priority; i--)
+			transportDissectors->dissectors[i] = transportDissectors->dissectors[i - 1];
+	}
+	else
+	{
+		for (size_t i = index; i < priority; i++)
+			transportDissectors->dissectors[i] = transportDissectors->dissectors[i + 1];
+	}
+	transportDissectors->dissectors[priority] = dissector;
+
+	updatePortMasks(*transportDissectors);
+	return true;
+}
+
+int PortDissectorRegistry::getDissectorPriority(ProtocolType transport, ProtocolType protocol) const
+{
+	const TransportDissectors* transportDissectors = getTransportDissectors(transport);
+	if (transportDissectors == NULL)
+		return -1;
+
+	return findDissectorIndex(*transportDissectors, protocol);
+}
+
+Layer* PortDissectorRegistry::dissect(ProtocolType transport, uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* packet, uint16_t srcPort, uint16_t dstPort) const
+{
+	const TransportDissectors& transportDissectors = (transport == TCP ? m_TcpDissectors : m_UdpDissectors);
+
+	// candidate dissectors ordered by priority: the lowest bit belongs to the highest priority dissector
+	uint32_t candidates = (transportDissectors.portTable[dstPort] & transportDissectors.dstPortMask) |
+			(transportDissectors.portTable[srcPort] & transportDissectors.srcPortMask);
+	ProtocolType enabledProtocols = (packet != NULL ? packet->getEnabledProtocols() : AllProtocols);
+
+	for (size_t i = 0; candidates != 0; i++, candidates >>= 1)
+	{
+		// dissectors of protocols that are disabled in this packet are skipped (see Packet#setEnabledProtocols())
+		if ((candidates & 1) == 0 || (transportDissectors.dissectors[i].protocol & enabledProtocols) == 0)
+			continue;
+
+		Layer* layer = transportDissectors.dissectors[i].func(data, dataLen, prevLayer, packet, srcPort, dstPort);
+		if (layer != NULL)
+			return layer;
+	}
+
+	return NULL;
+}
+
+} // namespace pcpp
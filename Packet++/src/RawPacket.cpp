@@ -16,6 +16,7 @@ void RawPacket::init(bool deleteRawDataAtDestructor)
 	m_DeleteRawDataAtDestructor = deleteRawDataAtDestructor;
 	m_RawPacketSet = false;
 	m_LinkLayerType = LINKTYPE_ETHERNET;
+	memset(&m_ChecksumOffloadInfo, 0, sizeof(m_ChecksumOffloadInfo));
 }
 
 RawPacket::RawPacket(const uint8_t* pRawData, int rawDataLen, timeval timestamp, bool deleteRawDataAtDestructor, LinkLayerType layerType)
@@ -48,6 +49,7 @@ RawPacket::~RawPacket()
 RawPacket::RawPacket(const RawPacket& other)
 {
 	m_RawData = NULL;
+	memset(&m_ChecksumOffloadInfo, 0, sizeof(m_ChecksumOffloadInfo));
 	copyDataFrom(other, true);
 }
 
@@ -84,6 +86,7 @@ void RawPacket::copyDataFrom(const RawPacket& other, bool allocateData)
 	memcpy(m_RawData, other.m_RawData, other.m_RawDataLen);
 	m_LinkLayerType = other.m_LinkLayerType;
 	m_FrameLength = other.m_FrameLength;
+	m_ChecksumOffloadInfo = other.m_ChecksumOffloadInfo;
 	m_RawPacketSet = true;
 }
 
@@ -109,18 +112,31 @@ bool RawPacket::setRawData(const uint8_t* pRawData, int rawDataLen, timespec tim
 	m_TimeStamp = timestamp;
 	m_RawPacketSet = true;
 	m_LinkLayerType = layerType;
+	memset(&m_ChecksumOffloadInfo, 0, sizeof(m_ChecksumOffloadInfo));
 	return true;
 }
 
+bool RawPacket::initWithRawData(const uint8_t* pRawData, int rawDataLen, timespec timestamp, LinkLayerType layerType, int frameLength)
+{
+	if (m_RawData != 0 && m_DeleteRawDataAtDestructor)
+		delete[] m_RawData;
+
+	m_RawData = 0;
+	m_DeleteRawDataAtDestructor = false;
+	return setRawData(pRawData, rawDataLen, timestamp, layerType, frameLength);
+}
+
 void RawPacket::clear()
 {
-	if (m_RawData != 0)
+	if (m_RawData != 0 && m_DeleteRawDataAtDestructor)
 		delete[] m_RawData;
 
 	m_RawData = 0;
+	m_DeleteRawDataAtDestructor = true;
 	m_RawDataLen = 0;
 	m_FrameLength = 0;
 	m_RawPacketSet = false;
+	memset(&m_ChecksumOffloadInfo, 0, sizeof(m_ChecksumOffloadInfo));
 }
 
 void RawPacket::appendData(const uint8_t* dataToAppend, size_t dataToAppendLen)
@@ -13,10 +13,10 @@ namespace pcpp
 // SSLLayer methods
 // ----------------
 
-bool SSLLayer::IsSSLMessage(uint16_t srcPort, uint16_t dstPort, uint8_t* data, size_t dataLen)
+bool SSLLayer::IsSSLMessage(uint16_t srcPort, uint16_t dstPort, uint8_t* data, size_t dataLen, bool ignorePorts)
 {
 	// check the port map first
-	if (!isSSLPort(srcPort) && !isSSLPort(dstPort))
+	if (!ignorePorts && !isSSLPort(srcPort) && !isSSLPort(dstPort))
 		return false;
 
 	if (dataLen < sizeof(ssl_tls_record_layer))
@@ -49,22 +49,22 @@ SSLLayer* SSLLayer::createSSLMessage(uint8_t* data, size_t dataLen, Layer* prevL
 	{
 		case SSL_HANDSHAKE:
 		{
-			return new SSLHandshakeLayer(data, dataLen, prevLayer, packet);
+			return new(packet) SSLHandshakeLayer(data, dataLen, prevLayer, packet);
 		}
 
 		case SSL_ALERT:
 		{
-			return new SSLAlertLayer(data, dataLen, prevLayer, packet);
+			return new(packet) SSLAlertLayer(data, dataLen, prevLayer, packet);
 		}
 
 		case SSL_CHANGE_CIPHER_SPEC:
 		{
-			return new SSLChangeCipherSpecLayer(data, dataLen, prevLayer, packet);
+			return new(packet) SSLChangeCipherSpecLayer(data, dataLen, prevLayer, packet);
 		}
 
 		case SSL_APPLICATION_DATA:
 		{
-			return new SSLApplicationDataLayer(data, dataLen, prevLayer, packet);
+			return new(packet) SSLApplicationDataLayer(data, dataLen, prevLayer, packet);
 		}
 
 		default:
@@ -3,6 +3,7 @@
 #include "SipLayer.h"
 #include "SdpLayer.h"
 #include "PayloadLayer.h"
+#include "Packet.h"
 #include "Logger.h"
 #include <string.h>
 #include <algorithm>
@@ -67,13 +68,13 @@ void SipLayer::parseNextLayer()
 		return;
 
 	size_t headerLen = getHeaderLen();
-	if (getContentLength() > 0)
+	if (getContentLength() > 0 && (m_Packet == NULL || m_Packet->isProtocolEnabled(SDP)))
 	{
-		m_NextLayer = new SdpLayer(m_Data + headerLen, m_DataLen - headerLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) SdpLayer(m_Data + headerLen, m_DataLen - headerLen, this, m_Packet);
 	}
 	else
 	{
-		m_NextLayer = new PayloadLayer(m_Data + headerLen, m_DataLen - headerLen, this, m_Packet);
+		m_NextLayer = new(m_Packet) PayloadLayer(m_Data + headerLen, m_DataLen - headerLen, this, m_Packet);
 	}
 }
 
@@ -2,13 +2,11 @@
 
 #include "EndianPortable.h"
 #include "TcpLayer.h"
+#include "Packet.h"
 #include "IPv4Layer.h"
 #include "IPv6Layer.h"
 #include "PayloadLayer.h"
-#include "HttpLayer.h"
-#include "SSLLayer.h"
-#include "SipLayer.h"
-#include "BgpLayer.h"
+#include "PortDissectorRegistry.h"
 #include "IpUtils.h"
 #include "Logger.h"
 #include <string.h>
@@ -227,7 +225,7 @@ void TcpLayer::adjustTcpOptionTrailer(size_t totalOptSize)
 	getTcpHeader()->dataOffset = (sizeof(tcphdr) + totalOptSize + m_NumOfTrailingBytes)/4;
 }
 
-uint16_t TcpLayer::calculateChecksum(bool writeResultToPacket)
+uint16_t TcpLayer::calculateChecksum(bool writeResultToPacket, bool pseudoHeaderOnly)
 {
 	tcphdr* tcpHdr = getTcpHeader();
 	uint16_t checksumRes = 0;
@@ -239,7 +237,8 @@ uint16_t TcpLayer::calculateChecksum(bool writeResultToPacket)
 		ScalarBuffer<uint16_t> vec[2];
 		LOG_DEBUG("data len =  %d", (int)m_DataLen);
 		vec[0].buffer = (uint16_t*)m_Data;
-		vec[0].len = m_DataLen;
+		// leaving the header and data out of the sum makes compute_checksum() return the inverted sum of the pseudo header
+		vec[0].len = (pseudoHeaderOnly ? 0 : m_DataLen);
 
 		if (m_PrevLayer->getProtocol() == IPv4)
 		{
@@ -255,6 +254,8 @@ uint16_t TcpLayer::calculateChecksum(bool writeResultToPacket)
 			vec[1].buffer = pseudoHeader;
 			vec[1].len = 12;
 			checksumRes = compute_checksum(vec, 2);
+			if (pseudoHeaderOnly)
+				checksumRes = ~checksumRes;
 			LOG_DEBUG("calculated checksum = 0x%4X", checksumRes);
 
 
@@ -269,6 +270,8 @@ uint16_t TcpLayer::calculateChecksum(bool writeResultToPacket)
 			vec[1].buffer = pseudoHeader;
 			vec[1].len = 36;
 			checksumRes = compute_checksum(vec, 2);
+			if (pseudoHeaderOnly)
+				checksumRes = ~checksumRes;
 			LOG_DEBUG("calculated checksum = 0x%4X", checksumRes);
 		}
 	}
@@ -297,6 +300,14 @@ TcpLayer::TcpLayer(uint8_t* data, size_t dataLen, Layer* prevLayer, Packet* pack
 	m_NumOfTrailingBytes = 0;
 }
 
+void TcpLayer::rebindData(uint8_t* data, size_t dataLen)
+{
+	m_Data = data;
+	m_DataLen = dataLen;
+	m_NumOfTrailingBytes = 0;
+	m_OptionReader = TLVRecordReader<TcpOption>();
+}
+
 TcpLayer::TcpLayer()
 {
 	initLayer();
@@ -341,25 +352,28 @@ void TcpLayer::parseNextLayer()
 	uint16_t portDst = be16toh(tcpHder->portDst);
 	uint16_t portSrc = be16toh(tcpHder->portSrc);
 
-	if (HttpMessage::isHttpPort(portDst) && HttpRequestFirstLine::parseMethod((char*)payload, payloadLen) != HttpRequestLayer::HttpMethodUnknown)
-		m_NextLayer = new HttpRequestLayer(payload, payloadLen, this, m_Packet);
-	else if (HttpMessage::isHttpPort(portSrc) && HttpResponseFirstLine::parseStatusCode((char*)payload, payloadLen) != HttpResponseLayer::HttpStatusCodeUnknown)
-		m_NextLayer = new HttpResponseLayer(payload, payloadLen, this, m_Packet);
-	else if (SSLLayer::IsSSLMessage(portSrc, portDst, payload, payloadLen))
-		m_NextLayer = SSLLayer::createSSLMessage(payload, payloadLen, this, m_Packet);
-	else if (SipLayer::isSipPort(portDst))
-	{
-		if (SipRequestFirstLine::parseMethod((char*)payload, payloadLen) != SipRequestLayer::SipMethodUnknown)
-			m_NextLayer = new SipRequestLayer(payload, payloadLen, this, m_Packet);
-		else if (SipResponseFirstLine::parseStatusCode((char*)payload, payloadLen) != SipResponseLayer::SipStatusCodeUnknown)
-			m_NextLayer = new SipResponseLayer(payload, payloadLen, this, m_Packet);
-		else
-			m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
-	}
-	else if (BgpLayer::isBgpPort(portSrc, portDst))
-		m_NextLayer = BgpLayer::parseBgpLayer(payload, payloadLen, this, m_Packet);
-	else
-		m_NextLayer = new PayloadLayer(payload, payloadLen, this, m_Packet);
+	// only the dissectors registered on the packet's ports are tried (see PortDissectorRegistry)
+	m_NextLayer = PortDissectorRegistry::getInstance().dissect(TCP, payload, payloadLen, this, m_Packet, portSrc, portDst);
+	if (m_NextLayer == NULL)
+		m_NextLayer = new(m_Packet) PayloadLayer(payload, payloadLen, this, m_Packet);
+}
+
+void TcpLayer::setSrcPort(uint16_t port, bool updateChecksum)
+{
+	tcphdr* tcpHdr = getTcpHeader();
+	uint16_t oldPort = tcpHdr->portSrc;
+	tcpHdr->portSrc = htobe16(port);
+	if (updateChecksum)
+		tcpHdr->headerChecksum = update_checksum16(tcpHdr->headerChecksum, oldPort, tcpHdr->portSrc);
+}
+
+void TcpLayer::setDstPort(uint16_t port, bool updateChecksum)
+{
+	tcphdr* tcpHdr = getTcpHeader();
+	uint16_t oldPort = tcpHdr->portDst;
+	tcpHdr->portDst = htobe16(port);
+	if (updateChecksum)
+		tcpHdr->headerChecksum = update_checksum16(tcpHdr->headerChecksum, oldPort, tcpHdr->portDst);
 }
 
 void TcpLayer::computeCalculateFields()
@@ -367,7 +381,7 @@ void TcpLayer::computeCalculateFields()
 	tcphdr* tcpHdr = getTcpHeader();
 
 	tcpHdr->dataOffset = getHeaderLen() >> 2;
-	calculateChecksum(true);
+	calculateChecksum(true, m_Packet != NULL && m_Packet->isChecksumOffloaded(this));
 }
 
 std::string TcpLayer::toString() const
@@ -9,6 +9,8 @@
 #include "Logger.h"
 #include <sstream>
 #include <vector>
+#include <new>
+#include <stdlib.h>
 #include "EndianPortable.h"
 #include "TimespecTimeval.h"
 #ifdef _MSC_VER
@@ -17,21 +19,16 @@
 
 #define PURGE_FREQ_SECS 1
 
+#define REASSEMBLY_DATA_PER_SLAB 256
+
+// number of 1-second slots in the idle timeout timer wheel, must be a power of 2
+#define TIMER_WHEEL_SIZE 256
+
 #define SEQ_LT(a,b)  ((int32_t)((a)-(b)) < 0)
 #define SEQ_LEQ(a,b) ((int32_t)((a)-(b)) <= 0)
 #define SEQ_GT(a,b)  ((int32_t)((a)-(b)) > 0)
 #define SEQ_GEQ(a,b) ((int32_t)((a)-(b)) >= 0)
 
-namespace
-{
-	timeval timespec_to_timeval(const timespec &in)
-	{
-		timeval out;
-		TIMESPEC_TO_TIMEVAL(&out, &in);
-		return out;
-	}
-}
-
 namespace pcpp
 {
 
@@ -79,6 +76,33 @@ void ConnectionData::copyData(const ConnectionData& other)
 	dstPort = other.dstPort;
 	startTime = other.startTime;
 	endTime = other.endTime;
+	startTimePrecise = other.startTimePrecise;
+	endTimePrecise = other.endTimePrecise;
+	sideStats[0] = other.sideStats[0];
+	sideStats[1] = other.sideStats[1];
+}
+
+void ConnectionData::setStartTime(const timespec &startTime)
+{
+	startTimePrecise = startTime;
+	TIMESPEC_TO_TIMEVAL(&this->startTime, &startTime);
+}
+
+void ConnectionData::setEndTime(const timespec &endTime)
+{
+	endTimePrecise = endTime;
+	TIMESPEC_TO_TIMEVAL(&this->endTime, &endTime);
+}
+
+
+TcpStreamData::TcpStreamData(const Segment* segments, size_t numOfSegments, size_t missingDataLength, const ConnectionData& connData)
+	: m_Data(NULL), m_DataLen(0), m_Segments(segments), m_NumOfSegments(numOfSegments), m_MissingDataLen(missingDataLength), m_Connection(connData)
+{
+	if (numOfSegments > 0)
+		m_Data = segments[0].data;
+
+	for (size_t i = 0; i < numOfSegments; i++)
+		m_DataLen += segments[i].dataLength;
 }
 
 
@@ -101,16 +125,30 @@ TcpReassembly::TcpReassembly(OnTcpMessageReady onMessageReadyCallback, void* use
 	m_RemoveConnInfo = config.removeConnInfo;
 	m_MaxNumToClean = (config.removeConnInfo == true && config.maxNumToClean == 0) ? 30 : config.maxNumToClean;
 	m_PurgeTimepoint = time(NULL) + PURGE_FREQ_SECS;
+	m_FreeReassemblyData = NULL;
+	m_IdleTimeout = config.idleTimeout;
+	m_MaxOutOfOrderBytes = config.maxOutOfOrderBytes;
+	m_MaxOutOfOrderBytesPerSide = config.maxOutOfOrderBytesPerSide;
+	m_MaxOutOfOrderSegmentsPerSide = config.maxOutOfOrderSegmentsPerSide;
+	m_OutOfOrderLimitPolicy = config.outOfOrderLimitPolicy;
+	m_DeliverSegmentReferences = config.deliverSegmentReferences;
+	m_PendingMissingDataLen = 0;
+	m_CollectConnectionStats = config.collectConnectionStatistics;
+	m_TimerWheelTime = 0;
+	if (m_IdleTimeout > 0)
+		m_TimerWheel.resize(TIMER_WHEEL_SIZE, NULL);
 }
 
 TcpReassembly::~TcpReassembly()
 {
-	while (!m_ConnectionList.empty())
+	for (size_t slot = 0; slot < m_ConnectionList.getCapacity(); slot++)
 	{
-		if(m_ConnectionList.begin()->second != NULL)
-			delete m_ConnectionList.begin()->second;
-		m_ConnectionList.erase(m_ConnectionList.begin());
+		if (m_ConnectionList.isSlotUsed(slot) && m_ConnectionList.getValueAt(slot) != NULL)
+			freeReassemblyData(m_ConnectionList.getValueAt(slot));
 	}
+
+	for (std::vector<void*>::iterator iter = m_ReassemblyDataSlabs.begin(); iter != m_ReassemblyDataSlabs.end(); ++iter)
+		free(*iter);
 }
 
 TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
@@ -154,6 +192,10 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 		return NonTcpPacket;
 	}
 
+	// close connections that didn't see any packet for too long. Any TCP packet advances the clock, including those ignored below
+	if (m_IdleTimeout > 0)
+		closeIdleConnections(tcpData.getRawPacket()->getPacketTimeStamp().tv_sec);
+
 	ReassemblyStatus status = TcpMessageHandled;
 
 	// set the TCP payload size
@@ -164,9 +206,13 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 	bool isRst = (tcpLayer->getTcpHeader()->rstFlag == 1);
 	bool isFinOrRst = isFin || isRst;
 
-	// ignore ACK packets or TCP packets with no payload (except for SYN, FIN or RST packets which we'll later need)
+	// ignore ACK packets or TCP packets with no payload (except for SYN, FIN or RST packets which we'll later need). They still keep their
+	// connection from being closed as idle, and if connection statistics are collected they're counted as packets of their connection
 	if (tcpPayloadSize == 0 && tcpLayer->getTcpHeader()->synFlag == 0 && !isFinOrRst)
 	{
+		if (m_CollectConnectionStats || m_IdleTimeout > 0)
+			handlePacketWithNoData(tcpData, ipLayer, tcpLayer->getTcpHeader()->portSrc);
+
 		return Ignore_PacketWithNoData;
 	}
 
@@ -175,12 +221,12 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 	// calculate flow key for this packet
 	uint32_t flowKey = hash5Tuple(&tcpData);
 
-	// find the connection in the connection map
-	ConnectionList::iterator iter = m_ConnectionList.find(flowKey);
+	// find the connection in the connection table
+	TcpReassemblyData** connEntry = m_ConnectionList.find(flowKey);
 
 	// if this packet belongs to a connection that was already closed (for example: data packet that comes after FIN), ignore it.
 	// the connection is already closed when the value of mapped type is NULL
-	if (iter != m_ConnectionList.end() && iter->second == NULL)
+	if (connEntry != NULL && *connEntry == NULL)
 	{
 		LOG_DEBUG("Ignoring packet of already closed flow [0x%X]", flowKey);
 		return Ignore_PacketOfClosedFlow;
@@ -208,19 +254,22 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 		dstIP = &dstIP6Addr;
 	}
 
-	if (iter == m_ConnectionList.end())
+	if (connEntry == NULL)
 	{
 		// if it's a packet of a new connection, create a TcpReassemblyData object and add it to the active connection list
-		tcpReassemblyData = new TcpReassemblyData();
+		tcpReassemblyData = allocateReassemblyData();
 		tcpReassemblyData->connData.setSrcIpAddress(srcIP);
 		tcpReassemblyData->connData.setDstIpAddress(dstIP);
 		tcpReassemblyData->connData.srcPort = be16toh(tcpLayer->getTcpHeader()->portSrc);
 		tcpReassemblyData->connData.dstPort = be16toh(tcpLayer->getTcpHeader()->portDst);
 		tcpReassemblyData->connData.flowKey = flowKey;
-		timeval ts = timespec_to_timeval(tcpData.getRawPacket()->getPacketTimeStamp());
+		const timespec& ts = tcpData.getRawPacket()->getPacketTimeStamp();
 		tcpReassemblyData->connData.setStartTime(ts);
+		tcpReassemblyData->lastActivity = ts.tv_sec;
+		if (m_IdleTimeout > 0)
+			addToTimerWheel(tcpReassemblyData);
 
-		m_ConnectionList[flowKey] = tcpReassemblyData;
+		m_ConnectionList.insert(flowKey, tcpReassemblyData);
 		m_ConnectionInfo[flowKey] = tcpReassemblyData->connData;
 
 		// fire connection start callback
@@ -229,15 +278,18 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 	}
 	else // connection already exists
 	{
-		tcpReassemblyData = iter->second;
-		timeval currTime = timespec_to_timeval(tcpData.getRawPacket()->getPacketTimeStamp());
-		if (currTime.tv_sec > tcpReassemblyData->connData.endTime.tv_sec)
+		tcpReassemblyData = *connEntry;
+		const timespec& currTime = tcpData.getRawPacket()->getPacketTimeStamp();
+		// the connection stays in its current timer wheel slot, the new deadline is picked up when that slot is reached
+		if (currTime.tv_sec > tcpReassemblyData->lastActivity)
+			tcpReassemblyData->lastActivity = currTime.tv_sec;
+		if (currTime.tv_sec > tcpReassemblyData->connData.endTimePrecise.tv_sec)
 		{
-			tcpReassemblyData->connData.setEndTime(currTime); 
+			tcpReassemblyData->connData.setEndTime(currTime);
 		}
-		else if (currTime.tv_sec == tcpReassemblyData->connData.endTime.tv_sec)
+		else if (currTime.tv_sec == tcpReassemblyData->connData.endTimePrecise.tv_sec)
 		{
-			if (currTime.tv_usec > tcpReassemblyData->connData.endTime.tv_usec)
+			if (currTime.tv_nsec > tcpReassemblyData->connData.endTimePrecise.tv_nsec)
 			{
 				tcpReassemblyData->connData.setEndTime(currTime);
 			}
@@ -308,6 +360,13 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 		return Error_PacketDoesNotMatchFlow;
 	}
 
+	if (m_CollectConnectionStats)
+	{
+		ConnectionData::SideStatistics& sideStats = tcpReassemblyData->connData.sideStats[sideIndex];
+		sideStats.numOfPackets++;
+		sideStats.numOfBytes += tcpPayloadSize;
+	}
+
 	// if this side already got FIN or RST packet before, ignore this packet as this side is considered closed
 	if (tcpReassemblyData->twoSides[sideIndex].gotFinOrRst)
 	{
@@ -356,10 +415,10 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 			tcpReassemblyData->twoSides[sideIndex].sequence++;
 
 		// send data to the callback
-		if (tcpPayloadSize != 0 && m_OnMessageReadyCallback != NULL)
+		if (tcpPayloadSize != 0)
 		{
-			TcpStreamData streamData(tcpLayer->getLayerPayload(), tcpPayloadSize, tcpReassemblyData->connData);
-			m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
+			sendData(tcpReassemblyData, sideIndex, tcpLayer->getLayerPayload(), tcpPayloadSize, tcpData.getRawPacket(), 0);
+			flushSegments(tcpReassemblyData, sideIndex);
 		}
 		status = TcpMessageHandled;
 
@@ -391,15 +450,14 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 			tcpReassemblyData->twoSides[sideIndex].sequence += tcpPayloadSize - newLength;
 
 			// send only the new data to the callback
-			if (m_OnMessageReadyCallback != NULL)
-			{
-				TcpStreamData streamData(tcpLayer->getLayerPayload() + newLength, tcpPayloadSize - newLength, tcpReassemblyData->connData);
-				m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
-			}
+			sendData(tcpReassemblyData, sideIndex, tcpLayer->getLayerPayload() + newLength, tcpPayloadSize - newLength, tcpData.getRawPacket(), 0);
+			flushSegments(tcpReassemblyData, sideIndex);
 			status = TcpMessageHandled;
 		}
 		else {
 			status = Ignore_Retransimission;
+			if (m_CollectConnectionStats)
+				tcpReassemblyData->connData.sideStats[sideIndex].numOfRetransmittedPackets++;
 		}
 
 		// handle case where this packet is FIN or RST
@@ -441,12 +499,9 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 		if (tcpLayer->getTcpHeader()->synFlag != 0)
 			tcpReassemblyData->twoSides[sideIndex].sequence++;
 
-		// send the data to the callback
-		if (m_OnMessageReadyCallback != NULL)
-		{
-			TcpStreamData streamData(tcpLayer->getLayerPayload(), tcpPayloadSize, tcpReassemblyData->connData);
-			m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
-		}
+		// send the data to the callback. If segment references are delivered, the data is sent together with the out-of-order data that
+		// follows it by checkOutOfOrderFragments()
+		sendData(tcpReassemblyData, sideIndex, tcpLayer->getLayerPayload(), tcpPayloadSize, tcpData.getRawPacket(), 0);
 		status = TcpMessageHandled;
 
 		//while (checkOutOfOrderFragments(tcpReassemblyData, sideIndex)) {}
@@ -485,17 +540,70 @@ TcpReassembly::ReassemblyStatus TcpReassembly::reassemblePacket(Packet& tcpData)
 			return status;
 		}
 
-		// create a new TcpFragment, copy the TCP data to it and add this packet to the the out-of-order packet list
+		// check if buffering this packet exceeds one of the out-of-order limits. If so, act according to the configured policy
+		bool flushAfterBuffering = false;
+		if (isOutOfOrderLimitReached(tcpReassemblyData, sideIndex, tcpPayloadSize))
+		{
+			m_OutOfOrderStats.numOfLimitsReached++;
+
+			if (m_OutOfOrderLimitPolicy == TcpReassemblyConfiguration::DropNewest)
+			{
+				LOG_DEBUG("Out-of-order limit reached on side %d, dropping TCP fragment with size %d", sideIndex, (int)tcpPayloadSize);
+				m_OutOfOrderStats.numOfDroppedSegments++;
+				m_OutOfOrderStats.numOfDroppedBytes += tcpPayloadSize;
+
+				if (isFinOrRst)
+					handleFinOrRst(tcpReassemblyData, sideIndex, flowKey);
+
+				return OutOfOrderLimitReached;
+			}
+
+			if (m_OutOfOrderLimitPolicy == TcpReassemblyConfiguration::DropConnection)
+			{
+				LOG_DEBUG("Out-of-order limit reached on side %d, dropping connection with flow key 0x%X", sideIndex, flowKey);
+				m_OutOfOrderStats.numOfDroppedConnections++;
+				m_OutOfOrderStats.numOfDroppedBytes += tcpPayloadSize + tcpReassemblyData->twoSides[0].outOfOrderBytes + tcpReassemblyData->twoSides[1].outOfOrderBytes;
+
+				// discard the buffered data so closing the connection doesn't send it to the user
+				clearOutOfOrderFragments(tcpReassemblyData, 0);
+				clearOutOfOrderFragments(tcpReassemblyData, 1);
+				closeConnectionInternal(flowKey, TcpReassemblyConnectionClosedByOutOfOrderLimit);
+				return OutOfOrderLimitReached;
+			}
+
+			// FlushWithGap: buffer the packet like any out-of-order packet and then stop waiting for the missing data
+			flushAfterBuffering = true;
+		}
+
+		// create a new TcpFragment, copy the TCP data to it and add this packet to the the out-of-order packet list. If segment references are
+		// delivered copy the whole packet instead, so the data can be sent to the user as a reference into a packet
 		TcpFragment* newTcpFrag = new TcpFragment();
-		newTcpFrag->data = new uint8_t[tcpPayloadSize];
 		newTcpFrag->dataLength = tcpPayloadSize;
 		newTcpFrag->sequence = sequence;
-		memcpy(newTcpFrag->data, tcpLayer->getLayerPayload(), tcpPayloadSize);
-		tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.pushBack(newTcpFrag);
+		if (m_DeliverSegmentReferences)
+		{
+			RawPacket* rawPacket = tcpData.getRawPacket();
+			newTcpFrag->rawPacket = new RawPacket(*rawPacket);
+			newTcpFrag->data = (uint8_t*)newTcpFrag->rawPacket->getRawData() + (tcpLayer->getLayerPayload() - rawPacket->getRawData());
+		}
+		else
+		{
+			newTcpFrag->data = new uint8_t[tcpPayloadSize];
+			memcpy(newTcpFrag->data, tcpLayer->getLayerPayload(), tcpPayloadSize);
+		}
+		addOutOfOrderFragment(tcpReassemblyData, sideIndex, newTcpFrag);
 
 		LOG_DEBUG("Found out-of-order packet and added a new TCP fragment with size %d to the out-of-order list of side %d", (int)tcpPayloadSize, sideIndex);
 		status = OutOfOrderTcpMessageBuffered;
 
+		if (flushAfterBuffering)
+		{
+			LOG_DEBUG("Out-of-order limit reached on side %d, flushing the out-of-order list", sideIndex);
+			m_OutOfOrderStats.numOfFlushes++;
+			checkOutOfOrderFragments(tcpReassemblyData, sideIndex, true);
+			status = TcpMessageHandled;
+		}
+
 		// handle case where this packet is FIN or RST
 		if (isFinOrRst)
 		{
@@ -519,6 +627,99 @@ std::string TcpReassembly::prepareMissingDataMessage(uint32_t missingDataLen)
 	return missingDataTextStream.str();
 }
 
+void TcpReassembly::sendData(TcpReassemblyData* tcpReassemblyData, int sideIndex, const uint8_t* data, size_t dataLength, const RawPacket* rawPacket, uint32_t missingDataLen)
+{
+	if (m_OnMessageReadyCallback == NULL)
+		return;
+
+	if (m_DeliverSegmentReferences)
+	{
+		// data that comes after missing data starts a new callback, as the missing data length refers to the beginning of the data
+		if (missingDataLen > 0)
+		{
+			flushSegments(tcpReassemblyData, sideIndex);
+			m_PendingMissingDataLen = missingDataLen;
+		}
+
+		TcpStreamData::Segment segment;
+		segment.data = data;
+		segment.dataLength = dataLength;
+		segment.rawPacket = rawPacket;
+		m_PendingSegments.push_back(segment);
+		return;
+	}
+
+	if (missingDataLen == 0)
+	{
+		TcpStreamData streamData(data, dataLength, tcpReassemblyData->connData);
+		m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
+		return;
+	}
+
+	// add missing data text to the data that will be sent to the callback. This means that the data will look something like:
+	// "[xx bytes missing]<original_data>"
+	std::string missingDataTextStr = prepareMissingDataMessage(missingDataLen);
+	std::vector<uint8_t> dataWithMissingDataText;
+	dataWithMissingDataText.reserve(missingDataTextStr.length() + dataLength);
+	dataWithMissingDataText.insert(dataWithMissingDataText.end(), missingDataTextStr.begin(), missingDataTextStr.end());
+	dataWithMissingDataText.insert(dataWithMissingDataText.end(), data, data + dataLength);
+
+	TcpStreamData streamData(&dataWithMissingDataText[0], dataWithMissingDataText.size(), tcpReassemblyData->connData);
+	m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
+}
+
+void TcpReassembly::flushSegments(TcpReassemblyData* tcpReassemblyData, int sideIndex)
+{
+	if (m_PendingSegments.empty())
+		return;
+
+	TcpStreamData streamData(&m_PendingSegments[0], m_PendingSegments.size(), m_PendingMissingDataLen, tcpReassemblyData->connData);
+	m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
+
+	m_PendingSegments.clear();
+	m_PendingMissingDataLen = 0;
+}
+
+void TcpReassembly::handlePacketWithNoData(Packet& tcpData, Layer* ipLayer, uint16_t srcPort)
+{
+	TcpReassemblyData** connEntry = m_ConnectionList.find(hash5Tuple(&tcpData));
+	if (connEntry == NULL || *connEntry == NULL)
+		return;
+
+	TcpReassemblyData* tcpReassemblyData = *connEntry;
+	time_t currTime = tcpData.getRawPacket()->getPacketTimeStamp().tv_sec;
+	if (currTime > tcpReassemblyData->lastActivity)
+		tcpReassemblyData->lastActivity = currTime;
+
+	if (!m_CollectConnectionStats)
+		return;
+
+	for (int sideIndex = 0; sideIndex < tcpReassemblyData->numOfSides; sideIndex++)
+	{
+		TcpOneSideData& side = tcpReassemblyData->twoSides[sideIndex];
+		if (side.srcPort != srcPort)
+			continue;
+
+		bool sameSrcIP = false;
+		if (ipLayer->getProtocol() == IPv4)
+		{
+			IPv4Address srcIP = ((IPv4Layer*)ipLayer)->getSrcIpAddress();
+			sameSrcIP = side.srcIP->equals(&srcIP);
+		}
+		else
+		{
+			IPv6Address srcIP = ((IPv6Layer*)ipLayer)->getSrcIpAddress();
+			sameSrcIP = side.srcIP->equals(&srcIP);
+		}
+
+		if (sameSrcIP)
+		{
+			tcpReassemblyData->connData.sideStats[sideIndex].numOfPackets++;
+			return;
+		}
+	}
+}
+
 void TcpReassembly::handleFinOrRst(TcpReassemblyData* tcpReassemblyData, int sideIndex, uint32_t flowKey)
 {
 	// if this side already saw a FIN or RST packet, do nothing and return
@@ -540,176 +741,171 @@ void TcpReassembly::handleFinOrRst(TcpReassemblyData* tcpReassemblyData, int sid
 
 void TcpReassembly::checkOutOfOrderFragments(TcpReassemblyData* tcpReassemblyData, int sideIndex, bool cleanWholeFragList)
 {
-	bool foundSomething = false;
+	TcpOneSideData& side = tcpReassemblyData->twoSides[sideIndex];
 
-	do
-	{
-		LOG_DEBUG("Starting first iteration of checkOutOfOrderFragments - looking for fragments that match the current sequence or have smaller sequence");
+	LOG_DEBUG("Going over the out-of-order list of side %d looking for fragments that match the current sequence or have smaller sequence", sideIndex);
 
-		int index = 0;
-		foundSomething = false;
+	// the out-of-order list is sorted by sequence, so it's handled in a single pass from its start: each fragment either continues the
+	// data sent so far, overlaps it or starts after a gap. All handled fragments are removed from the list together at the end
+	size_t numOfHandledFrags = 0;
+	while (numOfHandledFrags < side.tcpFragmentList.size())
+	{
+		TcpFragment* curTcpFrag = side.tcpFragmentList.at((int)numOfHandledFrags);
 
-		do
+		// if fragment sequence matches the current sequence
+		if (curTcpFrag->sequence == side.sequence)
 		{
-			index = 0;
-			foundSomething = false;
-
-			// first fragment list iteration - go over the whole fragment list and see if can find fragments that match the current sequence
-			// or have smaller sequence but have big enough payload to get new data
-			while (index < (int)tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.size())
+			// update sequence
+			side.sequence += curTcpFrag->dataLength;
+			if (curTcpFrag->data != NULL)
 			{
-				TcpFragment* curTcpFrag = tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.at(index);
-
-				// if fragment sequence matches the current sequence
-				if (curTcpFrag->sequence == tcpReassemblyData->twoSides[sideIndex].sequence)
-				{
-					// update sequence
-					tcpReassemblyData->twoSides[sideIndex].sequence += curTcpFrag->dataLength;
-					if (curTcpFrag->data != NULL)
-					{
-						LOG_DEBUG("Found an out-of-order packet matching to the current sequence with size %d on side %d. Pulling it out of the list and sending the data to the callback", (int)curTcpFrag->dataLength, sideIndex);
-
-						// send new data to callback
-
-						if (m_OnMessageReadyCallback != NULL)
-						{
-							TcpStreamData streamData(curTcpFrag->data, curTcpFrag->dataLength, tcpReassemblyData->connData);
-							m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
-						}
-					}
-
-
-					// remove fragment from list
-					tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.erase(tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.begin() + index);
-
-					foundSomething = true;
-
-					continue;
-				}
-
-				// if fragment sequence has lower sequence than the current sequence
-				if (SEQ_LT(curTcpFrag->sequence, tcpReassemblyData->twoSides[sideIndex].sequence))
-				{
-					// check if it still has new data
-					uint32_t newSequence = curTcpFrag->sequence + curTcpFrag->dataLength;
-
-					// it has new data
-					if (SEQ_GT(newSequence, tcpReassemblyData->twoSides[sideIndex].sequence))
-					{
-						// calculate the delta new data size
-						uint32_t newLength = tcpReassemblyData->twoSides[sideIndex].sequence - curTcpFrag->sequence;
-
-						LOG_DEBUG("Found a fragment in the out-of-order list which its sequence is lower than expected but its payload is long enough to contain new data. "
-							"Calling the callback with the new data. Fragment size is %d on side %d, new data size is %d", (int)curTcpFrag->dataLength, sideIndex, (int)(curTcpFrag->dataLength - newLength));
-
-						// update current sequence with the delta new data size
-						tcpReassemblyData->twoSides[sideIndex].sequence += curTcpFrag->dataLength - newLength;
-
-						// send only the new data to the callback
-						if (m_OnMessageReadyCallback != NULL)
-						{
-							TcpStreamData streamData(curTcpFrag->data + newLength, curTcpFrag->dataLength - newLength, tcpReassemblyData->connData);
-							m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
-						}
-
-						foundSomething = true;
-					}
-					else
-					{
-						LOG_DEBUG("Found a fragment in the out-of-order list which doesn't contain any new data, ignoring it. Fragment size is %d on side %d", (int)curTcpFrag->dataLength, sideIndex);
-					}
-
-					// delete fragment from list
-					tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.erase(tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.begin() + index);
-
-					continue;
-				}
-
-				//if got to here it means the fragment has higher sequence than current sequence, increment index and continue
-				index++;
-			}
-
-			// if managed to find new segment, do the search all over again
-		} while (foundSomething);
+				LOG_DEBUG("Found an out-of-order packet matching to the current sequence with size %d on side %d. Pulling it out of the list and sending the data to the callback", (int)curTcpFrag->dataLength, sideIndex);
 
+				// send new data to callback
+				sendData(tcpReassemblyData, sideIndex, curTcpFrag->data, curTcpFrag->dataLength, curTcpFrag->rawPacket, 0);
+			}
 
-		// if got here it means we're left only with fragments that have higher sequence than current sequence. This means out-of-order packets or
-		// missing data. If we don't want to clear the frag list yet, assume it's out-of-order and return
-		if (!cleanWholeFragList)
-			return;
+			numOfHandledFrags++;
+			continue;
+		}
 
-		LOG_DEBUG("Starting second  iteration of checkOutOfOrderFragments - handle missing data");
+		// if fragment sequence has lower sequence than the current sequence
+		if (SEQ_LT(curTcpFrag->sequence, side.sequence))
+		{
+			// check if it still has new data
+			uint32_t newSequence = curTcpFrag->sequence + curTcpFrag->dataLength;
 
-		// second fragment list iteration - now we're left only with fragments that have higher sequence than current sequence. This means missing data.
-		// Search for the fragment with the closest sequence to the current one
+			// it has new data
+			if (SEQ_GT(newSequence, side.sequence))
+			{
+				// calculate the delta new data size
+				uint32_t newLength = side.sequence - curTcpFrag->sequence;
 
-		uint32_t closestSequence = 0xffffffff;
-		bool closestSequenceDefined = false;
-		int closestSequenceFragIndex = -1;
-		index = 0;
+				LOG_DEBUG("Found a fragment in the out-of-order list which its sequence is lower than expected but its payload is long enough to contain new data. "
+					"Calling the callback with the new data. Fragment size is %d on side %d, new data size is %d", (int)curTcpFrag->dataLength, sideIndex, (int)(curTcpFrag->dataLength - newLength));
 
-		while (index < (int)tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.size())
-		{
-			// extract segment at current index
-			TcpFragment* curTcpFrag = tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.at(index);
+				// update current sequence with the delta new data size
+				side.sequence += curTcpFrag->dataLength - newLength;
 
-			// check if its sequence is closer than current closest sequence
-			if (!closestSequenceDefined || SEQ_LT(curTcpFrag->sequence, closestSequence))
+				// send only the new data to the callback
+				sendData(tcpReassemblyData, sideIndex, curTcpFrag->data + newLength, curTcpFrag->dataLength - newLength, curTcpFrag->rawPacket, 0);
+			}
+			else
 			{
-				closestSequence = curTcpFrag->sequence;
-				closestSequenceFragIndex = index;
-				closestSequenceDefined = true;
+				LOG_DEBUG("Found a fragment in the out-of-order list which doesn't contain any new data, ignoring it. Fragment size is %d on side %d", (int)curTcpFrag->dataLength, sideIndex);
 			}
 
-			index++;
+			numOfHandledFrags++;
+			continue;
 		}
 
-		// this means fragment list is not empty at this stage
-		if (closestSequenceFragIndex > -1)
+		// if got to here it means the fragment has higher sequence than current sequence, so there is a gap before it. This means out-of-order
+		// packets or missing data. If we don't want to clear the frag list yet, assume it's out-of-order and stop
+		if (!cleanWholeFragList)
+			break;
+
+		// calculate number of missing bytes
+		uint32_t missingDataLen = curTcpFrag->sequence - side.sequence;
+		if (m_CollectConnectionStats)
 		{
-			// get the fragment with the closest sequence
-			TcpFragment* curTcpFrag = tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.at(closestSequenceFragIndex);
+			tcpReassemblyData->connData.sideStats[sideIndex].numOfGaps++;
+			tcpReassemblyData->connData.sideStats[sideIndex].numOfMissingBytes += missingDataLen;
+		}
 
-			// calculate number of missing bytes
-			uint32_t missingDataLen = curTcpFrag->sequence - tcpReassemblyData->twoSides[sideIndex].sequence;
+		// update sequence
+		side.sequence = curTcpFrag->sequence + curTcpFrag->dataLength;
+		if (curTcpFrag->data != NULL)
+		{
+			LOG_DEBUG("Found missing data on side %d: %d byte are missing. Sending the closest fragment which is in size %d", sideIndex, missingDataLen, (int)curTcpFrag->dataLength);
 
-			// update sequence
-			tcpReassemblyData->twoSides[sideIndex].sequence = curTcpFrag->sequence + curTcpFrag->dataLength;
-			if (curTcpFrag->data != NULL)
-			{
-				// send new data to callback
-				if (m_OnMessageReadyCallback != NULL)
-				{
-					// prepare missing data text
-					std::string missingDataTextStr = prepareMissingDataMessage(missingDataLen);
-
-					// add missing data text to the data that will be sent to the callback. This means that the data will look something like:
-					// "[xx bytes missing]<original_data>"
-					std::vector<uint8_t> dataWithMissingDataText;
-					dataWithMissingDataText.reserve(missingDataTextStr.length() + curTcpFrag->dataLength);
-					dataWithMissingDataText.insert(dataWithMissingDataText.end(), missingDataTextStr.begin(), missingDataTextStr.end());
-					dataWithMissingDataText.insert(dataWithMissingDataText.end(), curTcpFrag->data, curTcpFrag->data + curTcpFrag->dataLength);
-
-					//TcpStreamData streamData(curTcpFrag->data, curTcpFrag->dataLength, tcpReassemblyData->connData);
-					TcpStreamData streamData(&dataWithMissingDataText[0], dataWithMissingDataText.size(), tcpReassemblyData->connData);
-					m_OnMessageReadyCallback(sideIndex, streamData, m_UserCookie);
-
-					LOG_DEBUG("Found missing data on side %d: %d byte are missing. Sending the closest fragment which is in size %d + missing text message which size is %d",
-						sideIndex, missingDataLen, (int)curTcpFrag->dataLength, (int)missingDataTextStr.length());
-				}
-			}
+			// send new data to callback together with the missing data indication
+			sendData(tcpReassemblyData, sideIndex, curTcpFrag->data, curTcpFrag->dataLength, curTcpFrag->rawPacket, missingDataLen);
+		}
 
-			// remove fragment from list
-			tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.erase(tcpReassemblyData->twoSides[sideIndex].tcpFragmentList.begin() + closestSequenceFragIndex);
+		numOfHandledFrags++;
+	}
 
-			LOG_DEBUG("Calling checkOutOfOrderFragments again from the start");
+	// the fragments are removed only after the collected segments are sent, as the segments point into them
+	flushSegments(tcpReassemblyData, sideIndex);
+	removeOutOfOrderFragments(tcpReassemblyData, sideIndex, numOfHandledFrags);
+}
 
-			// call the method again from the start to do the whole search again (both iterations). 
-			// the stop condition is when the list is empty (so closestSequenceFragIndex == -1)
-			foundSomething = true;
-		}
+void TcpReassembly::addOutOfOrderFragment(TcpReassemblyData* tcpReassemblyData, int sideIndex, TcpFragment* tcpFragment)
+{
+	PointerVector<TcpFragment>& fragList = tcpReassemblyData->twoSides[sideIndex].tcpFragmentList;
+
+	// keep the list sorted by sequence (taking wraparound into account): binary search for the first fragment with a higher sequence, so
+	// fragments with the same sequence stay in arrival order. Fragments usually arrive in increasing order, so check the end of the list first
+	size_t low = 0, high = fragList.size();
+	if (high > 0 && !SEQ_LT(tcpFragment->sequence, fragList.at((int)high - 1)->sequence))
+		low = high;
+
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2;
+		if (SEQ_LT(tcpFragment->sequence, fragList.at((int)mid)->sequence))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	fragList.insert(fragList.begin() + low, tcpFragment);
+	tcpReassemblyData->twoSides[sideIndex].outOfOrderBytes += tcpFragment->dataLength;
+
+	if (m_CollectConnectionStats)
+	{
+		ConnectionData::SideStatistics& sideStats = tcpReassemblyData->connData.sideStats[sideIndex];
+		sideStats.numOfOutOfOrderPackets++;
+		if (tcpReassemblyData->twoSides[sideIndex].outOfOrderBytes > sideStats.peakOutOfOrderBytes)
+			sideStats.peakOutOfOrderBytes = tcpReassemblyData->twoSides[sideIndex].outOfOrderBytes;
+	}
+
+	m_OutOfOrderStats.bufferedSegments++;
+	m_OutOfOrderStats.bufferedBytes += tcpFragment->dataLength;
+	if (m_OutOfOrderStats.bufferedBytes > m_OutOfOrderStats.peakBufferedBytes)
+		m_OutOfOrderStats.peakBufferedBytes = m_OutOfOrderStats.bufferedBytes;
+}
+
+void TcpReassembly::removeOutOfOrderFragments(TcpReassemblyData* tcpReassemblyData, int sideIndex, size_t numOfFrags)
+{
+	if (numOfFrags == 0)
+		return;
 
-	} while (foundSomething);
+	PointerVector<TcpFragment>& fragList = tcpReassemblyData->twoSides[sideIndex].tcpFragmentList;
+	size_t dataLength = 0;
+	for (size_t i = 0; i < numOfFrags; i++)
+		dataLength += fragList.at((int)i)->dataLength;
+
+	fragList.erase(fragList.begin(), fragList.begin() + numOfFrags);
+
+	tcpReassemblyData->twoSides[sideIndex].outOfOrderBytes -= dataLength;
+	m_OutOfOrderStats.bufferedSegments -= numOfFrags;
+	m_OutOfOrderStats.bufferedBytes -= dataLength;
+}
+
+void TcpReassembly::clearOutOfOrderFragments(TcpReassemblyData* tcpReassemblyData, int sideIndex)
+{
+	TcpOneSideData& side = tcpReassemblyData->twoSides[sideIndex];
+	m_OutOfOrderStats.bufferedSegments -= side.tcpFragmentList.size();
+	m_OutOfOrderStats.bufferedBytes -= side.outOfOrderBytes;
+	side.tcpFragmentList.clear();
+	side.outOfOrderBytes = 0;
+}
+
+bool TcpReassembly::isOutOfOrderLimitReached(const TcpReassemblyData* tcpReassemblyData, int sideIndex, size_t dataLength) const
+{
+	const TcpOneSideData& side = tcpReassemblyData->twoSides[sideIndex];
+
+	if (m_MaxOutOfOrderBytes > 0 && m_OutOfOrderStats.bufferedBytes + dataLength > m_MaxOutOfOrderBytes)
+		return true;
+
+	if (m_MaxOutOfOrderBytesPerSide > 0 && side.outOfOrderBytes + dataLength > m_MaxOutOfOrderBytesPerSide)
+		return true;
+
+	if (m_MaxOutOfOrderSegmentsPerSide > 0 && side.tcpFragmentList.size() + 1 > m_MaxOutOfOrderSegmentsPerSide)
+		return true;
+
+	return false;
 }
 
 void TcpReassembly::closeConnection(uint32_t flowKey)
@@ -720,19 +916,19 @@ void TcpReassembly::closeConnection(uint32_t flowKey)
 void TcpReassembly::closeConnectionInternal(uint32_t flowKey, ConnectionEndReason reason)
 {
 	TcpReassemblyData* tcpReassemblyData = NULL;
-	ConnectionList::iterator iter = m_ConnectionList.find(flowKey);
-	if (iter == m_ConnectionList.end())
+	TcpReassemblyData** connEntry = m_ConnectionList.find(flowKey);
+	if (connEntry == NULL)
 	{
 		LOG_ERROR("Cannot close flow with key 0x%X: cannot find flow", flowKey);
 		return;
 	}
 
-	if (iter->second == NULL) // the connection is already closed
+	if (*connEntry == NULL) // the connection is already closed
 		return;
 
 	LOG_DEBUG("Closing connection with flow key 0x%X", flowKey);
 
-	tcpReassemblyData = iter->second;
+	tcpReassemblyData = *connEntry;
 
 	LOG_DEBUG("Calling checkOutOfOrderFragments on side 0");
 	checkOutOfOrderFragments(tcpReassemblyData, 0, true);
@@ -743,8 +939,8 @@ void TcpReassembly::closeConnectionInternal(uint32_t flowKey, ConnectionEndReaso
 	if (m_OnConnEnd != NULL)
 		m_OnConnEnd(tcpReassemblyData->connData, reason, m_UserCookie);
 
-	delete tcpReassemblyData;
-	iter->second = NULL; // mark the connection as closed
+	freeReassemblyData(tcpReassemblyData);
+	*connEntry = NULL; // mark the connection as closed
 	insertIntoCleanupList(flowKey);
 
 	LOG_DEBUG("Connection with flow key 0x%X is closed", flowKey);
@@ -754,13 +950,12 @@ void TcpReassembly::closeAllConnections()
 {
 	LOG_DEBUG("Closing all flows");
 
-	ConnectionList::iterator iter = m_ConnectionList.begin(), iterEnd = m_ConnectionList.end();
-	for (; iter != iterEnd; ++iter)
+	for (size_t slot = 0; slot < m_ConnectionList.getCapacity(); slot++)
 	{
-		if (iter->second == NULL) // the connection is already closed, skip it
+		if (!m_ConnectionList.isSlotUsed(slot) || m_ConnectionList.getValueAt(slot) == NULL) // the connection is already closed, skip it
 			continue;
 
-		TcpReassemblyData* tcpReassemblyData = iter->second;
+		TcpReassemblyData* tcpReassemblyData = m_ConnectionList.getValueAt(slot);
 
 		uint32_t flowKey = tcpReassemblyData->connData.flowKey;
 		LOG_DEBUG("Closing connection with flow key 0x%X", flowKey);
@@ -774,8 +969,8 @@ void TcpReassembly::closeAllConnections()
 		if (m_OnConnEnd != NULL)
 			m_OnConnEnd(tcpReassemblyData->connData, TcpReassemblyConnectionClosedManually, m_UserCookie);
 
-		delete tcpReassemblyData;
-		iter->second = NULL; // mark the connection as closed
+		freeReassemblyData(tcpReassemblyData);
+		m_ConnectionList.getValueAt(slot) = NULL; // mark the connection as closed
 		insertIntoCleanupList(flowKey);
 
 		LOG_DEBUG("Connection with flow key 0x%X is closed", flowKey);
@@ -784,9 +979,9 @@ void TcpReassembly::closeAllConnections()
 
 int TcpReassembly::isConnectionOpen(const ConnectionData& connection) const
 {
-	ConnectionList::const_iterator iter = m_ConnectionList.find(connection.flowKey);
-	if (iter != m_ConnectionList.end())
-		return iter->second != NULL; // If the value of mapped type is NULL then this connection is closed
+	TcpReassemblyData* const* connEntry = m_ConnectionList.find(connection.flowKey);
+	if (connEntry != NULL)
+		return *connEntry != NULL; // If the value of mapped type is NULL then this connection is closed
 
 	return -1;
 }
@@ -832,4 +1027,119 @@ uint32_t TcpReassembly::purgeClosedConnections(uint32_t maxNumToClean)
 	return count;
 }
 
+TcpReassembly::TcpReassemblyData* TcpReassembly::allocateReassemblyData()
+{
+	if (m_FreeReassemblyData == NULL)
+	{
+		// all slabs are full, add a new one and chain its slots into the free list
+		uint8_t* slab = (uint8_t*)malloc(sizeof(TcpReassemblyData) * REASSEMBLY_DATA_PER_SLAB);
+		m_ReassemblyDataSlabs.push_back(slab);
+		for (int i = REASSEMBLY_DATA_PER_SLAB - 1; i >= 0; i--)
+		{
+			void* slot = slab + i * sizeof(TcpReassemblyData);
+			*(void**)slot = m_FreeReassemblyData;
+			m_FreeReassemblyData = slot;
+		}
+	}
+
+	void* slot = m_FreeReassemblyData;
+	m_FreeReassemblyData = *(void**)slot;
+	return new (slot) TcpReassemblyData();
+}
+
+void TcpReassembly::freeReassemblyData(TcpReassemblyData* tcpReassemblyData)
+{
+	if (tcpReassemblyData->timerSlot >= 0)
+		removeFromTimerWheel(tcpReassemblyData);
+
+	// out-of-order data that is still buffered (only possible when the whole TcpReassembly instance is destroyed) is freed with the object
+	clearOutOfOrderFragments(tcpReassemblyData, 0);
+	clearOutOfOrderFragments(tcpReassemblyData, 1);
+
+	tcpReassemblyData->~TcpReassemblyData();
+	*(void**)tcpReassemblyData = m_FreeReassemblyData;
+	m_FreeReassemblyData = tcpReassemblyData;
+}
+
+void TcpReassembly::addToTimerWheel(TcpReassemblyData* tcpReassemblyData)
+{
+	// deadlines that already passed (packets with older timestamps than the current time) are handled in the next slot
+	time_t deadline = tcpReassemblyData->lastActivity + m_IdleTimeout;
+	if (deadline <= m_TimerWheelTime)
+		deadline = m_TimerWheelTime + 1;
+
+	int slot = (int)(deadline & (TIMER_WHEEL_SIZE - 1));
+	tcpReassemblyData->timerSlot = slot;
+	tcpReassemblyData->timerPrev = NULL;
+	tcpReassemblyData->timerNext = m_TimerWheel[slot];
+	if (m_TimerWheel[slot] != NULL)
+		m_TimerWheel[slot]->timerPrev = tcpReassemblyData;
+	m_TimerWheel[slot] = tcpReassemblyData;
+}
+
+void TcpReassembly::removeFromTimerWheel(TcpReassemblyData* tcpReassemblyData)
+{
+	if (tcpReassemblyData->timerPrev != NULL)
+		tcpReassemblyData->timerPrev->timerNext = tcpReassemblyData->timerNext;
+	else
+		m_TimerWheel[tcpReassemblyData->timerSlot] = tcpReassemblyData->timerNext;
+
+	if (tcpReassemblyData->timerNext != NULL)
+		tcpReassemblyData->timerNext->timerPrev = tcpReassemblyData->timerPrev;
+
+	tcpReassemblyData->timerSlot = -1;
+	tcpReassemblyData->timerPrev = NULL;
+	tcpReassemblyData->timerNext = NULL;
+}
+
+void TcpReassembly::closeIdleConnections(time_t currentTime)
+{
+	// the wheel starts turning at the timestamp of the first packet. Packets with older timestamps than the current time don't move it
+	if (m_TimerWheelTime == 0)
+		m_TimerWheelTime = currentTime;
+
+	if (currentTime <= m_TimerWheelTime)
+		return;
+
+	// visit the slots of every second that passed since the last call. If more time than a whole round of the wheel passed (for
+	// example a long gap in a capture file) it's enough to visit every slot once
+	time_t firstTick = m_TimerWheelTime + 1;
+	if (currentTime - m_TimerWheelTime > TIMER_WHEEL_SIZE)
+		firstTick = currentTime - TIMER_WHEEL_SIZE + 1;
+
+	m_TimerWheelTime = currentTime;
+
+	for (time_t tick = firstTick; tick <= currentTime; tick++)
+	{
+		int slot = (int)(tick & (TIMER_WHEEL_SIZE - 1));
+		m_IdleFlowKeys.clear();
+		TcpReassemblyData* tcpReassemblyData = m_TimerWheel[slot];
+		while (tcpReassemblyData != NULL)
+		{
+			TcpReassemblyData* next = tcpReassemblyData->timerNext;
+			time_t deadline = tcpReassemblyData->lastActivity + m_IdleTimeout;
+			if (deadline <= currentTime)
+			{
+				removeFromTimerWheel(tcpReassemblyData);
+				m_IdleFlowKeys.push_back(tcpReassemblyData->connData.flowKey);
+			}
+			else if ((int)(deadline & (TIMER_WHEEL_SIZE - 1)) != slot)
+			{
+				// packets arrived since the connection was put in this slot, move it to the slot of its current deadline
+				removeFromTimerWheel(tcpReassemblyData);
+				addToTimerWheel(tcpReassemblyData);
+			}
+
+			tcpReassemblyData = next;
+		}
+
+		// the connections are closed by flow key only now, since the user's callback may close any connection, including other idle ones
+		for (std::vector<uint32_t>::iterator iter = m_IdleFlowKeys.begin(); iter != m_IdleFlowKeys.end(); ++iter)
+		{
+			LOG_DEBUG("Connection with flow key 0x%X was idle, closing it", *iter);
+			closeConnectionInternal(*iter, TcpReassemblyConnectionClosedByTimeout);
+		}
+	}
+}
+
 }
@@ -415,7 +415,7 @@ void TextBasedProtocolMessage::parseNextLayer()
 	if (m_DataLen <= headerLen)
 		return;
 
-	m_NextLayer = new PayloadLayer(m_Data + headerLen, m_DataLen - headerLen, this, m_Packet);
+	m_NextLayer = new(m_Packet) PayloadLayer(m_Data + headerLen, m_DataLen - headerLen, this, m_Packet);
 }
 
 size_t TextBasedProtocolMessage::getHeaderLen() const
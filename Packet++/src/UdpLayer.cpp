@@ -2,16 +2,12 @@
 
 #include "EndianPortable.h"
 #include "UdpLayer.h"
+#include "Packet.h"
 #include "IpUtils.h"
 #include "PayloadLayer.h"
 #include "IPv4Layer.h"
 #include "IPv6Layer.h"
-#include "DnsLayer.h"
-#include "DhcpLayer.h"
-#include "VxlanLayer.h"
-#include "SipLayer.h"
-#include "RadiusLayer.h"
-#include "GtpLayer.h"
+#include "PortDissectorRegistry.h"
 #include "Logger.h"
 #include <string.h>
 #include <sstream>
@@ -31,7 +27,7 @@ UdpLayer::UdpLayer(uint16_t portSrc, uint16_t portDst)
 	m_Protocol = UDP;
 }
 
-uint16_t UdpLayer::calculateChecksum(bool writeResultToPacket)
+uint16_t UdpLayer::calculateChecksum(bool writeResultToPacket, bool pseudoHeaderOnly)
 {
 	udphdr* udpHdr = (udphdr*)m_Data;
 	uint16_t checksumRes = 0;
@@ -43,7 +39,8 @@ uint16_t UdpLayer::calculateChecksum(bool writeResultToPacket)
 		ScalarBuffer<uint16_t> vec[2];
 		LOG_DEBUG("data len =  %d", (int)m_DataLen);
 		vec[0].buffer = (uint16_t*)m_Data;
-		vec[0].len = m_DataLen;
+		// leaving the header and data out of the sum makes compute_checksum() return the inverted sum of the pseudo header
+		vec[0].len = (pseudoHeaderOnly ? 0 : m_DataLen);
 
 		if (m_PrevLayer->getProtocol() == IPv4)
 		{
@@ -59,6 +56,8 @@ uint16_t UdpLayer::calculateChecksum(bool writeResultToPacket)
 			vec[1].buffer = pseudoHeader;
 			vec[1].len = 12;
 			checksumRes = compute_checksum(vec, 2);
+			if (pseudoHeaderOnly)
+				checksumRes = ~checksumRes;
 			LOG_DEBUG("calculated checksum = 0x%4X", checksumRes);
 		}
 		else if (m_PrevLayer->getProtocol() == IPv6)
@@ -71,6 +70,8 @@ uint16_t UdpLayer::calculateChecksum(bool writeResultToPacket)
 			vec[1].buffer = pseudoHeader;
 			vec[1].len = 36;
 			checksumRes = compute_checksum(vec, 2);
+			if (pseudoHeaderOnly)
+				checksumRes = ~checksumRes;
 			LOG_DEBUG("calculated checksum = 0x%4X", checksumRes);
 		}
 	}
@@ -83,6 +84,36 @@ uint16_t UdpLayer::calculateChecksum(bool writeResultToPacket)
 	return checksumRes;
 }
 
+void UdpLayer::setSrcPort(uint16_t port, bool updateChecksum)
+{
+	udphdr* udpHdr = getUdpHeader();
+	uint16_t oldPort = udpHdr->portSrc;
+	udpHdr->portSrc = htobe16(port);
+	if (updateChecksum)
+		updateChecksumForPortChange(oldPort, udpHdr->portSrc);
+}
+
+void UdpLayer::setDstPort(uint16_t port, bool updateChecksum)
+{
+	udphdr* udpHdr = getUdpHeader();
+	uint16_t oldPort = udpHdr->portDst;
+	udpHdr->portDst = htobe16(port);
+	if (updateChecksum)
+		updateChecksumForPortChange(oldPort, udpHdr->portDst);
+}
+
+void UdpLayer::updateChecksumForPortChange(uint16_t oldPort, uint16_t newPort)
+{
+	udphdr* udpHdr = getUdpHeader();
+	// a zero UDP checksum means no checksum was computed
+	if (udpHdr->headerChecksum == 0)
+		return;
+
+	udpHdr->headerChecksum = update_checksum16(udpHdr->headerChecksum, oldPort, newPort);
+	if (udpHdr->headerChecksum == 0)
+		udpHdr->headerChecksum = 0xffff;
+}
+
 void UdpLayer::parseNextLayer()
 {
 	if (m_DataLen <= sizeof(udphdr))
@@ -95,35 +126,17 @@ void UdpLayer::parseNextLayer()
 	uint8_t* udpData = m_Data + sizeof(udphdr);
 	size_t udpDataLen = m_DataLen - sizeof(udphdr);
 
-	if ((portSrc == 68 && portDst == 67) || (portSrc == 67 && portDst == 68) || (portSrc == 67 && portDst == 67))
-		m_NextLayer = new DhcpLayer(udpData, udpDataLen, this, m_Packet);
-	else if (VxlanLayer::isVxlanPort(portDst))
-		m_NextLayer = new VxlanLayer(udpData, udpDataLen, this, m_Packet);
-	else if ((udpDataLen >= sizeof(dnshdr)) && (DnsLayer::isDnsPort(portDst) || DnsLayer::isDnsPort(portSrc)))
-		m_NextLayer = new DnsLayer(udpData, udpDataLen, this, m_Packet);
-	else if(SipLayer::isSipPort(portDst) || SipLayer::isSipPort(portSrc))
-	{
-		if (SipRequestFirstLine::parseMethod((char*)udpData, udpDataLen) != SipRequestLayer::SipMethodUnknown)
-			m_NextLayer = new SipRequestLayer(udpData, udpDataLen, this, m_Packet);
-		else if (SipResponseFirstLine::parseStatusCode((char*)udpData, udpDataLen) != SipResponseLayer::SipStatusCodeUnknown
-						&& SipResponseFirstLine::parseVersion((char*)udpData, udpDataLen) != "")
-			m_NextLayer = new SipResponseLayer(udpData, udpDataLen, this, m_Packet);
-		else
-			m_NextLayer = new PayloadLayer(udpData, udpDataLen, this, m_Packet);
-	}
-	else if ((RadiusLayer::isRadiusPort(portDst) || RadiusLayer::isRadiusPort(portSrc)) && RadiusLayer::isDataValid(udpData, udpDataLen))
-		m_NextLayer = new RadiusLayer(udpData, udpDataLen, this, m_Packet);
-	else if ((GtpV1Layer::isGTPv1Port(portDst) || GtpV1Layer::isGTPv1Port(portSrc)) && GtpV1Layer::isGTPv1(udpData, udpDataLen))
-		m_NextLayer = new GtpV1Layer(udpData, udpDataLen, this, m_Packet);
-	else
-		m_NextLayer = new PayloadLayer(udpData, udpDataLen, this, m_Packet);
+	// only the dissectors registered on the packet's ports are tried (see PortDissectorRegistry)
+	m_NextLayer = PortDissectorRegistry::getInstance().dissect(UDP, udpData, udpDataLen, this, m_Packet, portSrc, portDst);
+	if (m_NextLayer == NULL)
+		m_NextLayer = new(m_Packet) PayloadLayer(udpData, udpDataLen, this, m_Packet);
 }
 
 void UdpLayer::computeCalculateFields()
 {
 	udphdr* udpHdr = (udphdr*)m_Data;
 	udpHdr->length = htobe16(m_DataLen);
-	calculateChecksum(true);
+	calculateChecksum(true, m_Packet != NULL && m_Packet->isChecksumOffloaded(this));
 }
 
 std::string UdpLayer::toString() const
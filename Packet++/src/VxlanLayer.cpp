@@ -52,7 +52,7 @@ void VxlanLayer::parseNextLayer()
 	if (m_DataLen <= sizeof(vxlan_header))
 		return;
 
-	m_NextLayer = new EthLayer(m_Data + sizeof(vxlan_header), m_DataLen - sizeof(vxlan_header), this, m_Packet);
+	m_NextLayer = new(m_Packet) EthLayer(m_Data + sizeof(vxlan_header), m_DataLen - sizeof(vxlan_header), this, m_Packet);
 }
 
 }
@@ -261,6 +261,13 @@ namespace pcpp
 			 */
 			uint64_t rssHashFunction;
 
+			/**
+			 * Enable IPv4, TCP and UDP checksum offload on the TX queues, so checksums of packets whose checksum offload information
+			 * is set (see Packet#setChecksumOffload() and RawPacket#getChecksumOffloadInfo()) are computed by the NIC. Opening the
+			 * device fails if the PMD doesn't support it. Requires DPDK 17.11 or newer
+			 */
+			bool txChecksumOffload;
+
 			/**
 			 * A c'tor for this struct
 			 * @param[in] receiveDescriptorsNumber An optional parameter for defining the number of RX descriptors that will be allocated for each RX queue.
@@ -273,13 +280,15 @@ namespace pcpp
 			 * @param[in] rssKey A pointer to an array holding the RSS key to use for hashing specific header of received packets. If not
 			 * specified, there is a default key defined inside DpdkDevice
 			 * @param[in] rssKeyLength The length in bytes of the array pointed by rssKey. Default value is the length of default rssKey
+			 * @param[in] txChecksumOffload Enable TX checksum offload. Default value is false
 			 */
 			DpdkDeviceConfiguration(uint16_t receiveDescriptorsNumber = 128,
 					uint16_t transmitDescriptorsNumber = 512,
 					uint16_t flushTxBufferTimeout = 100,
 					uint64_t rssHashFunction = RSS_IPV4 | RSS_IPV6,
 					uint8_t* rssKey = DpdkDevice::m_RSSKey,
-					uint8_t rssKeyLength = 40)
+					uint8_t rssKeyLength = 40,
+					bool txChecksumOffload = false)
 			{
 				this->receiveDescriptorsNumber = receiveDescriptorsNumber;
 				this->transmitDescriptorsNumber = transmitDescriptorsNumber;
@@ -287,6 +296,7 @@ namespace pcpp
 				this->rssKey = rssKey;
 				this->rssKeyLength = rssKeyLength;
 				this->rssHashFunction = rssHashFunction;
+				this->txChecksumOffload = txChecksumOffload;
 			}
 		};
 
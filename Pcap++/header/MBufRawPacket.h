@@ -199,6 +199,15 @@ namespace pcpp
 		 */
 		bool reallocateData(size_t newBufferLength);
 
+		/**
+		 * Set the checksum offload information of this raw packet (see RawPacket#setChecksumOffloadInfo()) and translate it to the
+		 * offload flags and header lengths of the mbuf, so the checksums are computed by the NIC when the packet is sent. Notice the
+		 * DpdkDevice the packet is sent through should be opened with TX checksum offload enabled (see
+		 * DpdkDevice#DpdkDeviceConfiguration#txChecksumOffload)
+		 * @param[in] info The checksum offload information to set
+		 */
+		void setChecksumOffloadInfo(const ChecksumOffloadInfo& info);
+
 		/**
 		 * Set an indication whether to free the mbuf when done using it or not ("done using it" means setting another mbuf or class d'tor).
 		 * Default value is true.
@@ -3,6 +3,9 @@
 
 #include "PcapDevice.h"
 #include "RawPacket.h"
+#include "SystemUtils.h"
+#include <vector>
+#include <string>
 
 /// @file
 
@@ -13,6 +16,9 @@
 namespace pcpp
 {
 
+	// the io_uring queue used by the buffered file devices, defined in PcapFileDevice.cpp
+	class IoUringQueue;
+
 	/**
 	 * @class IFileDevice
 	 * An abstract class (cannot be instantiated, has a private c'tor) which is the parent class for all file devices
@@ -42,6 +48,99 @@ namespace pcpp
 	};
 
 
+	/**
+	 * @class RawPacketBatch
+	 * A reusable array of RawPacket objects whose packet data is kept in one contiguous buffer owned by the batch. It's meant for reading
+	 * packets in batches using IFileReaderDevice#getNextPackets(RawPacketBatch&): each packet added to the batch is copied into the buffer
+	 * right after the previous one, so once the buffer is big enough for a full batch, filling the same instance again doesn't allocate
+	 * memory. Please notice:
+	 * - The packets in the batch point at the batch buffer, so they're valid only until the batch is filled again, cleared or destroyed.
+	 *   Packets that should live longer have to be copied
+	 * - If a batch doesn't fit in the buffer the buffer grows (and the packets already in the batch are moved to the new buffer), so the
+	 *   buffer size given in the c'tor is only the initial size
+	 */
+	class RawPacketBatch
+	{
+	private:
+		RawPacket* m_Packets;
+		size_t m_MaxNumOfPackets;
+		size_t m_NumOfPackets;
+		uint8_t* m_Buffer;
+		size_t m_BufferSize;
+		size_t m_BufferUsed;
+
+		// private copy c'tor
+		RawPacketBatch(const RawPacketBatch& other);
+		RawPacketBatch& operator=(const RawPacketBatch& other);
+
+		void growBuffer(size_t minSize);
+
+	public:
+		/**
+		 * A constructor for this class. All memory the batch needs is allocated here
+		 * @param[in] maxNumOfPackets The max number of packets the batch can hold
+		 * @param[in] bufferSize The initial size in bytes of the buffer holding the packet data. If the value is set to 0 (the default)
+		 * 2048 bytes per packet are allocated, which is enough for full size Ethernet frames
+		 */
+		RawPacketBatch(size_t maxNumOfPackets, size_t bufferSize = 0);
+
+		/**
+		 * A destructor for this class. Frees the packets and their buffer
+		 */
+		~RawPacketBatch();
+
+		/**
+		 * @return The max number of packets the batch can hold
+		 */
+		size_t getMaxNumOfPackets() const { return m_MaxNumOfPackets; }
+
+		/**
+		 * @return The number of packets currently in the batch
+		 */
+		size_t size() const { return m_NumOfPackets; }
+
+		/**
+		 * @return True if the batch holds its max number of packets, false otherwise
+		 */
+		bool isFull() const { return m_NumOfPackets >= m_MaxNumOfPackets; }
+
+		/**
+		 * @return The current size in bytes of the buffer holding the packet data
+		 */
+		size_t getBufferSize() const { return m_BufferSize; }
+
+		/**
+		 * Get a packet in the batch
+		 * @param[in] index The index of the packet, must be smaller than size()
+		 * @return A reference to the packet
+		 */
+		RawPacket& at(size_t index) { return m_Packets[index]; }
+
+		/**
+		 * Get a packet in the batch
+		 * @param[in] index The index of the packet, must be smaller than size()
+		 * @return A const reference to the packet
+		 */
+		const RawPacket& at(size_t index) const { return m_Packets[index]; }
+
+		/**
+		 * Copy packet data to the end of the batch
+		 * @param[in] pRawData A pointer to the packet data
+		 * @param[in] rawDataLen The packet data length in bytes
+		 * @param[in] timestamp The packet timestamp
+		 * @param[in] layerType The link layer type of the packet
+		 * @param[in] frameLength The length of the frame on the wire. If the value is set to -1 (the default) it's the same as rawDataLen
+		 * @return True if the packet was added, false if the batch is full or rawDataLen is negative
+		 */
+		bool add(const uint8_t* pRawData, int rawDataLen, timespec timestamp, LinkLayerType layerType, int frameLength = -1);
+
+		/**
+		 * Remove all packets from the batch. The memory of the batch is kept for the next packets
+		 */
+		void clear();
+	};
+
+
 	/**
 	 * @class IFileReaderDevice
 	 * An abstract class (cannot be instantiated, has a private c'tor) which is the parent class for file reader devices
@@ -51,6 +150,8 @@ namespace pcpp
 	protected:
 		uint32_t m_NumOfPacketsRead;
 		uint32_t m_NumOfPacketsNotParsed;
+		// the packet the default getNextPacketData() reads into, so the data it returns stays valid until the next read
+		RawPacket m_PacketDataReadBuffer;
 
 		/**
 		 * A constructor for this class that gets the pcap full path file name to open. Notice that after calling this constructor the file
@@ -59,6 +160,20 @@ namespace pcpp
 		 */
 		IFileReaderDevice(const char* fileName);
 
+		/**
+		 * Read the next packet from the file without copying its data. This is what the batch read in getNextPackets(RawPacketBatch&) is
+		 * built on. The in-tree readers implement it with their own way of reading records, while the default implementation reads the
+		 * packet with getNextPacket() into an internal RawPacket, so readers that implement only getNextPacket() support batch reads too
+		 * @param[out] pRawData A pointer to the packet data. It's valid only until the next read or until the file is closed
+		 * @param[out] rawDataLen The packet data length in bytes
+		 * @param[out] frameLength The length of the frame on the wire
+		 * @param[out] timestamp The packet timestamp
+		 * @param[out] layerType The link layer type of the packet
+		 * @return True if a packet was read successfully, false if the file isn't opened (also, an error log will be printed) or if reached
+		 * end-of-file
+		 */
+		virtual bool getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType);
+
 	public:
 
 		/**
@@ -82,6 +197,15 @@ namespace pcpp
 		 */
 		int getNextPackets(RawPacketVector& packetVec, int numOfPacketsToRead = -1);
 
+		/**
+		 * Read the next packets into a batch, replacing the packets it held before. Packets are read until the batch is full or the end of
+		 * the file is reached. Unlike getNextPackets(RawPacketVector&, int) no RawPacket objects are created: the packet data is copied into
+		 * the batch buffer, so reading batch after batch into the same RawPacketBatch instance doesn't allocate memory
+		 * @param[in,out] batch The batch to read packets into
+		 * @return The number of packets read, 0 if the file isn't opened or if reached end-of-file
+		 */
+		int getNextPackets(RawPacketBatch& batch);
+
 		/**
 		 * A static method that creates an instance of the reader best fit to read the file. It decides by the file extension: for .pcapng
 		 * files it returns an instance of PcapNgFileReaderDevice and for all other extensions it returns an instance of PcapFileReaderDevice
@@ -105,6 +229,9 @@ namespace pcpp
 		PcapFileReaderDevice(const PcapFileReaderDevice& other);
 		PcapFileReaderDevice& operator=(const PcapFileReaderDevice& other);
 
+	protected:
+		bool getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType);
+
 	public:
 		/**
 		 * A constructor for this class that gets the pcap full path file name to open. Notice that after calling this constructor the file
@@ -149,6 +276,435 @@ namespace pcpp
 	};
 
 
+	/**
+	 * @class MmapPcapFileReaderDevice
+	 * A class for reading a pcap file by mapping it to memory instead of reading it through libpcap. The record headers are parsed directly
+	 * from the mapped file and the packets returned point at the mapped file instead of copies of the packet data, which makes reading large
+	 * files much cheaper. Please notice:
+	 * - Packets read by this class are valid only until the file is closed (or the device is destroyed). Packets that should live longer
+	 *   have to be copied
+	 * - The file is mapped copy-on-write, so changing the data of packets read by this class doesn't change the file, and only the changed
+	 *   memory pages are copied
+	 * - Only pcap files are supported (with microsecond or nanosecond timestamps, in either byte order), not pcap-ng files. Filters aren't
+	 *   supported
+	 * - Memory-mapping files is supported on Linux, MacOS and FreeBSD only
+	 */
+	class MmapPcapFileReaderDevice : public IFileReaderDevice
+	{
+	private:
+		uint8_t* m_MappedFile;
+		uint64_t m_MappedFileSize;
+		uint64_t m_NextRecordOffset;
+		LinkLayerType m_PcapLinkLayerType;
+		bool m_SwapByteOrder;
+		bool m_NanosecPrecision;
+		uint32_t m_SnapshotLength;
+
+		// private copy c'tor
+		MmapPcapFileReaderDevice(const MmapPcapFileReaderDevice& other);
+		MmapPcapFileReaderDevice& operator=(const MmapPcapFileReaderDevice& other);
+
+	protected:
+		bool getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType);
+
+	public:
+		/**
+		 * A constructor for this class that gets the pcap full path file name to open. Notice that after calling this constructor the file
+		 * isn't opened yet, so reading packets will fail. For opening the file call open()
+		 * @param[in] fileName The full path of the file to read
+		 */
+		MmapPcapFileReaderDevice(const char* fileName);
+
+		/**
+		 * A destructor for this class. Notice packets read from the file are no longer valid once the device is destroyed
+		 */
+		virtual ~MmapPcapFileReaderDevice() { close(); }
+
+		/**
+		* @return The link layer type of this file
+		*/
+		LinkLayerType getLinkLayerType() const { return m_PcapLinkLayerType; }
+
+		/**
+		 * @return The snapshot length written in the file header
+		 */
+		uint32_t getSnapshotLength() const { return m_SnapshotLength; }
+
+
+		//overridden methods
+
+		/**
+		 * Read the next packet from the file. Before using this method please verify the file is opened using open(). No data is copied: the
+		 * raw packet points at the packet data inside the mapped file, and is valid until the file is closed
+		 * @param[out] rawPacket A reference for a RawPacket where the packet will be set. Data this RawPacket owned before is freed
+		 * @return True if a packet was read successfully. False will be returned if the file isn't opened (also, an error log will be printed),
+		 * if reached end-of-file or if the next record is truncated or malformed
+		 */
+		bool getNextPacket(RawPacket& rawPacket);
+
+		/**
+		 * Map the file which path was specified in the constructor to memory and verify it's a pcap file
+		 * @return True if file was opened successfully or if file is already opened. False if opening the file failed for some reason (for example:
+		 * file path does not exist, the file isn't a pcap file or the platform doesn't support memory-mapping files)
+		 */
+		bool open();
+
+		/**
+		 * Unmap the file. Packets read from the file are no longer valid afterwards
+		 */
+		void close();
+
+		/**
+		 * Get statistics of packets read so far. In the pcap_stat struct, only ps_recv member is relevant. The rest of the members will contain 0
+		 * @param[out] stats The stats struct where stats are returned
+		 */
+		void getStatistics(pcap_stat& stats) const;
+	};
+
+
+	/**
+	 * @struct BufferedPcapFileReaderConfiguration
+	 * A structure for configuring the BufferedPcapFileReaderDevice class
+	 */
+	struct BufferedPcapFileReaderConfiguration
+	{
+		/** The size in bytes of each read buffer, rounded up to a multiple of 4KB. Values below 1MB are raised to 1MB. If the value is set to 0
+		 * the default value (4MB) is used */
+		size_t bufferSize;
+
+		/** The number of read buffers. When io_uring is used all buffers but the one being parsed are read ahead. Values below 2 are raised
+		 * to 2. If the value is set to 0 the default value (4) is used */
+		size_t numOfBuffers;
+
+		/** Read ahead asynchronously using io_uring, so parsing packets doesn't wait for the disk unless it's faster than the disk. If
+		 * PcapPlusPlus isn't built with io_uring support (see the --use-io-uring configure switch) or the kernel doesn't support it, each
+		 * buffer is read with a blocking read when it's needed. The default is false */
+		bool useIoUring;
+
+		/**
+		 * A c'tor for this struct
+		 * @param[in] bufferSize The size of each read buffer. The default is 0 which means 4MB
+		 * @param[in] numOfBuffers The number of read buffers. The default is 0 which means 4
+		 * @param[in] useIoUring Whether to read ahead asynchronously using io_uring. The default is false
+		 */
+		BufferedPcapFileReaderConfiguration(size_t bufferSize = 0, size_t numOfBuffers = 0, bool useIoUring = false) :
+			bufferSize(bufferSize), numOfBuffers(numOfBuffers), useIoUring(useIoUring)
+		{
+		}
+	};
+
+
+	/**
+	 * @class BufferedPcapFileReaderDevice
+	 * A class for reading a pcap file in large chunks instead of reading it through libpcap. The file is read into several large buffers,
+	 * optionally ahead of the packet being parsed using io_uring (see BufferedPcapFileReaderConfiguration), and the record headers are parsed
+	 * directly from the buffers. Please notice:
+	 * - Only pcap files are supported (with microsecond or nanosecond timestamps, in either byte order), not pcap-ng files. Filters aren't
+	 *   supported
+	 * - Records longer than 262144 bytes are considered corrupt
+	 * - This class isn't supported on Windows
+	 */
+	class BufferedPcapFileReaderDevice : public IFileReaderDevice
+	{
+	private:
+		struct ReadBuffer
+		{
+			uint8_t* data;
+			// the number of bytes in the buffer, valid once ready is set
+			size_t length;
+			uint64_t offset;
+			bool ready;
+		};
+
+		BufferedPcapFileReaderConfiguration m_Config;
+		int m_Fd;
+		uint64_t m_FileSize;
+		std::vector<ReadBuffer> m_Buffers;
+		size_t m_BufferSize;
+		// the file is read in chunks of the buffer size, chunk i is read into buffer i % (number of buffers)
+		uint64_t m_CurrentChunk;
+		size_t m_ChunkOffset;
+		uint64_t m_NextChunkToRead;
+		// holds records (and record headers) that cross the border between two chunks
+		uint8_t* m_SpanBuffer;
+		bool m_EndOfFile;
+		LinkLayerType m_PcapLinkLayerType;
+		bool m_SwapByteOrder;
+		bool m_NanosecPrecision;
+		uint32_t m_SnapshotLength;
+		IoUringQueue* m_IoUring;
+
+		// private copy c'tor
+		BufferedPcapFileReaderDevice(const BufferedPcapFileReaderDevice& other);
+		BufferedPcapFileReaderDevice& operator=(const BufferedPcapFileReaderDevice& other);
+
+		void readNextChunk(size_t bufferIndex);
+		void waitForBuffer(size_t bufferIndex);
+		bool advanceChunk();
+		const uint8_t* readBytes(size_t count);
+
+	protected:
+		bool getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType);
+
+	public:
+		/**
+		 * A constructor for this class that gets the pcap full path file name to open. Notice that after calling this constructor the file
+		 * isn't opened yet, so reading packets will fail. For opening the file call open()
+		 * @param[in] fileName The full path of the file to read
+		 * @param[in] config Optional parameter for defining the buffer size, the number of buffers and whether to use io_uring. If not set
+		 * the default parameters will be set
+		 */
+		BufferedPcapFileReaderDevice(const char* fileName, const BufferedPcapFileReaderConfiguration& config = BufferedPcapFileReaderConfiguration());
+
+		/**
+		 * A destructor for this class. Closes the file if it's opened and frees the buffers
+		 */
+		virtual ~BufferedPcapFileReaderDevice();
+
+		/**
+		* @return The link layer type of this file
+		*/
+		LinkLayerType getLinkLayerType() const { return m_PcapLinkLayerType; }
+
+		/**
+		 * @return The snapshot length written in the file header
+		 */
+		uint32_t getSnapshotLength() const { return m_SnapshotLength; }
+
+		/**
+		 * @return The size in bytes of each read buffer, after rounding the size in the configuration
+		 */
+		size_t getBufferSize() const { return m_BufferSize; }
+
+		/**
+		 * @return True if the file is read using io_uring, false otherwise (also when io_uring was requested but isn't available)
+		 */
+		bool isUsingIoUring() const { return m_IoUring != NULL; }
+
+
+		//overridden methods
+
+		/**
+		 * Read the next packet from the file. Before using this method please verify the file is opened using open()
+		 * @param[out] rawPacket A reference for an empty RawPacket where the packet will be written
+		 * @return True if a packet was read successfully. False will be returned if the file isn't opened (also, an error log will be printed),
+		 * if reached end-of-file or if the next record is truncated or malformed
+		 */
+		bool getNextPacket(RawPacket& rawPacket);
+
+		/**
+		 * Open the file which path was specified in the constructor, start reading it and verify it's a pcap file
+		 * @return True if file was opened successfully or if file is already opened. False if opening the file failed for some reason (for example:
+		 * file path does not exist or the file isn't a pcap file)
+		 */
+		bool open();
+
+		/**
+		 * Close the file, after waiting for reads that are still in progress
+		 */
+		void close();
+
+		/**
+		 * Get statistics of packets read so far. In the pcap_stat struct, only ps_recv member is relevant. The rest of the members will contain 0
+		 * @param[out] stats The stats struct where stats are returned
+		 */
+		void getStatistics(pcap_stat& stats) const;
+	};
+
+
+	/**
+	 * @struct ParallelPcapFileReaderConfiguration
+	 * A structure for configuring the ParallelPcapFileReader class
+	 */
+	struct ParallelPcapFileReaderConfiguration
+	{
+		/** The number of worker threads. If the value is set to 0 the number of cores of the machine is used */
+		size_t numOfWorkers;
+
+		/** The size in bytes of the chunks the file is split into. Each chunk is read by one worker, so there should be several chunks per
+		 * worker for balancing the work between them. Values below 1MB are raised to 1MB. If the value is set to 0 the default value (64MB)
+		 * is used */
+		size_t chunkSize;
+
+		/** If set, the packets are delivered on the thread calling ParallelPcapFileReader#readPackets() in the order they're written in the
+		 * file, which for a capture file is timestamp order, while the workers parse the chunks ahead of it. Otherwise the packets are delivered
+		 * on the worker threads, each chunk in order but the chunks in no particular order. The default is false */
+		bool preserveOrder;
+
+		/** The cores to run the worker threads on. Worker i runs on the i-th core in the mask. If the value is 0 (the default) the threads aren't
+		 * bound to cores. Binding threads to cores is supported on Linux only */
+		CoreMask coreMask;
+
+		/**
+		 * A c'tor for this struct
+		 * @param[in] numOfWorkers The number of worker threads. The default is 0 which means the number of cores of the machine
+		 * @param[in] chunkSize The size of the chunks the file is split into. The default is 0 which means 64MB
+		 * @param[in] preserveOrder Whether to deliver the packets in file order on the calling thread. The default is false
+		 */
+		ParallelPcapFileReaderConfiguration(size_t numOfWorkers = 0, size_t chunkSize = 0, bool preserveOrder = false) :
+			numOfWorkers(numOfWorkers), chunkSize(chunkSize), preserveOrder(preserveOrder), coreMask(0)
+		{
+		}
+	};
+
+
+	/**
+	 * @class ParallelPcapFileReader
+	 * A class for reading one pcap file with several worker threads. The file is mapped to memory (as in MmapPcapFileReaderDevice) and split
+	 * into chunks which the workers take one after the other, so large files are read and processed on all cores instead of one:
+	 * - A chunk has to start at a record header, but a pcap file has no index of its records. By default the border of each chunk is found by
+	 *   scanning forward from its nominal offset for a place where several consecutive record headers look valid. Such a border is only a
+	 *   guess (a captured pcap file inside a packet looks just like records), so no packet of a chunk is delivered before the walk of the
+	 *   chunk before it ends exactly at the border. If it doesn't, the borders of the rest of the file are found by walking its record
+	 *   headers, and reading goes on from there. buildIndex() walks all record headers up front instead, and the index it builds can be saved
+	 *   with getIndex() and given to setIndex() for reading the same file again
+	 * - The packets are delivered to a callback together with the id of the worker that read them. By default the callback is invoked on the
+	 *   worker threads, so callbacks of different workers may run at the same time. With ParallelPcapFileReaderConfiguration#preserveOrder set
+	 *   the callback is invoked on the calling thread in file order (see ParallelPcapFileReaderConfiguration)
+	 * - No data is copied: the packets point at the mapped file and are valid only until the callback returns. The file is mapped
+	 *   copy-on-write, so the callback may change the packet data without changing the file
+	 * - Only pcap files are supported (with microsecond or nanosecond timestamps, in either byte order), not pcap-ng files. Filters aren't
+	 *   supported
+	 * - Memory-mapping files is supported on Linux, MacOS and FreeBSD only
+	 */
+	class ParallelPcapFileReader
+	{
+	public:
+		/**
+		 * @typedef OnPacketArrives
+		 * A callback invoked for each packet read from the file
+		 * @param[in] workerId The id of the worker that read the packet, between 0 and getNumOfWorkers()-1
+		 * @param[in] packet The packet. It points at the mapped file and is valid only until the callback returns
+		 * @param[in] userCookie A pointer to the cookie provided by the user in readPackets() (or NULL if no cookie provided)
+		 */
+		typedef void (*OnPacketArrives)(size_t workerId, RawPacket& packet, void* userCookie);
+
+		/**
+		 * A c'tor for this class. Notice that after calling this c'tor the file isn't opened yet. For opening the file call open()
+		 * @param[in] fileName The full path of the file to read
+		 * @param[in] config Optional parameter for defining the number of workers, the chunk size and the delivery order. If not set the default
+		 * parameters will be set
+		 */
+		ParallelPcapFileReader(const char* fileName, const ParallelPcapFileReaderConfiguration& config = ParallelPcapFileReaderConfiguration());
+
+		/**
+		 * A d'tor for this class. Closes the file if it's opened
+		 */
+		~ParallelPcapFileReader();
+
+		/**
+		 * Map the file which path was specified in the c'tor to memory and verify it's a pcap file. The index of the file is cleared
+		 * @return True if file was opened successfully or if file is already opened. False if opening the file failed for some reason (for example:
+		 * file path does not exist, the file isn't a pcap file or the platform doesn't support memory-mapping files)
+		 */
+		bool open();
+
+		/**
+		 * Unmap the file and clear its index
+		 */
+		void close();
+
+		/**
+		 * @return True if the file is opened, false otherwise
+		 */
+		bool isOpened() const { return m_MappedFile != NULL; }
+
+		/**
+		 * @return The file name that was specified in the c'tor
+		 */
+		const char* getFileName() const { return m_FileName.c_str(); }
+
+		/**
+		* @return The link layer type of this file
+		*/
+		LinkLayerType getLinkLayerType() const { return m_PcapLinkLayerType; }
+
+		/**
+		 * @return The number of worker threads
+		 */
+		size_t getNumOfWorkers() const { return m_NumOfWorkers; }
+
+		/**
+		 * @return The nominal size of the chunks in bytes, after applying the limits in the configuration
+		 */
+		size_t getChunkSize() const { return m_ChunkSize; }
+
+		/**
+		 * Find the chunk borders by walking the record headers of the whole file from its start. This reads all record headers once, which is
+		 * slower than scanning for the borders but doesn't rely on guessing
+		 * @return True if the index was built, false if the file isn't opened or has a corrupt record
+		 */
+		bool buildIndex();
+
+		/**
+		 * Set the chunk borders to an index built for this file before (see getIndex()). Like the borders found by scanning, they're confirmed
+		 * while reading before any packet after them is delivered
+		 * @param[in] chunkOffsets The file offsets where the chunks start. The first offset must be the end of the file header (24) and the
+		 * offsets must be increasing and inside the file
+		 * @return True if the index was set, false if the file isn't opened or the index isn't valid for it
+		 */
+		bool setIndex(const std::vector<uint64_t>& chunkOffsets);
+
+		/**
+		 * @return The file offsets where the chunks start: the index built by buildIndex(), set by setIndex() or found by scanning in
+		 * readPackets(). readPackets() replaces the borders that turn out not to be at a record by the ones found by walking the records. Empty if none of them has been called since the file was opened
+		 */
+		const std::vector<uint64_t>& getIndex() const { return m_ChunkOffsets; }
+
+		/**
+		 * Read all packets of the file and deliver them to a callback. If there is no index yet the chunk borders are found by scanning the
+		 * file first. This method returns when all packets have been delivered, and can be called again to read the file again
+		 * @param[in] onPacketArrives The callback to invoke for each packet
+		 * @param[in] userCookie A pointer to an object provided by the user which is passed to the callback. This parameter is optional, default
+		 * cookie is NULL
+		 * @return True if the whole file was read. False if the file isn't opened, the worker threads couldn't be started or the file has a
+		 * corrupt record. Packets delivered before the failure aren't taken back
+		 */
+		bool readPackets(OnPacketArrives onPacketArrives, void* userCookie = NULL);
+
+		/**
+		 * @return The number of packets read in the last call to readPackets()
+		 */
+		uint64_t getNumOfPacketsRead() const;
+
+		/**
+		 * @param[in] workerId The worker id
+		 * @return The number of packets the worker read in the last call to readPackets()
+		 */
+		uint64_t getNumOfPacketsRead(size_t workerId) const;
+
+	private:
+		struct ReadContext;
+
+		std::string m_FileName;
+		ParallelPcapFileReaderConfiguration m_Config;
+		size_t m_NumOfWorkers;
+		size_t m_ChunkSize;
+		uint8_t* m_MappedFile;
+		uint64_t m_MappedFileSize;
+		LinkLayerType m_PcapLinkLayerType;
+		bool m_SwapByteOrder;
+		bool m_NanosecPrecision;
+		uint32_t m_SnapshotLength;
+		std::vector<uint64_t> m_ChunkOffsets;
+		// true if the chunk borders are known to be at records: they were found by walking the records or confirmed by reading the file
+		bool m_ChunkOffsetsVerified;
+		std::vector<uint64_t> m_NumOfPacketsReadPerWorker;
+
+		// the object owns a file mapping and isn't meant to be copied
+		ParallelPcapFileReader(const ParallelPcapFileReader&);
+		ParallelPcapFileReader& operator=(const ParallelPcapFileReader&);
+
+		bool buildIndexFrom(size_t firstChunk, uint64_t offset);
+		bool isRecordBorder(uint64_t offset) const;
+		void findChunkBorders();
+		bool readChunks(size_t firstChunk, OnPacketArrives onPacketArrives, void* userCookie, size_t& wrongBorder, uint64_t& resumeOffset);
+		bool readChunk(size_t chunkIndex, size_t workerId, ReadContext* context);
+		void confirmChunkBorders(ReadContext* context) const;
+		static void* workerThreadMain(void* workerPtr);
+	};
+
+
 	/**
 	 * @class PcapNgFileReaderDevice
 	 * A class for opening a pcap-ng file in read-only mode. This class enable to open the file and read all packets, packet-by-packet
@@ -168,6 +724,9 @@ namespace pcpp
 
 		bool matchPacketWithFilter(const uint8_t* packetData, size_t packetLen, timespec packetTimestamp, uint16_t linkType);
 
+	protected:
+		bool getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType);
+
 	public:
 		/**
 		 * A constructor for this class that gets the pcap-ng full path file name to open. Notice that after calling this constructor the file
@@ -381,6 +940,207 @@ namespace pcpp
 	};
 
 
+	/**
+	 * @struct BufferedPcapFileWriterConfiguration
+	 * A structure for configuring the BufferedPcapFileWriterDevice class
+	 */
+	struct BufferedPcapFileWriterConfiguration
+	{
+		/** The size in bytes of each write buffer, rounded up to a multiple of 4KB. Values below 1MB are raised to 1MB. If the value is set to 0
+		 * the default value (8MB) is used */
+		size_t bufferSize;
+
+		/** Open the file with O_DIRECT so written data bypasses the page cache. If the file system doesn't support it the file is written
+		 * through the page cache. Supported on Linux only. The default is false */
+		bool directIO;
+
+		/** Write full buffers to the file on a background thread while the next buffer is filled. Two buffers are allocated in this mode.
+		 * The default is false */
+		bool backgroundFlush;
+
+		/** Write full buffers asynchronously using io_uring while the next buffer is filled. Four buffers are allocated in this mode, and
+		 * writePacket() waits only when all of them are being written. If PcapPlusPlus isn't built with io_uring support (see the
+		 * --use-io-uring configure switch) or the kernel doesn't support it, the file is written as if this flag wasn't set. When io_uring
+		 * is used backgroundFlush is ignored. The default is false */
+		bool useIoUring;
+
+		/**
+		 * A c'tor for this struct
+		 * @param[in] bufferSize The size of each write buffer. The default is 0 which means 8MB
+		 * @param[in] directIO Whether to open the file with O_DIRECT. The default is false
+		 * @param[in] backgroundFlush Whether to write full buffers on a background thread. The default is false
+		 * @param[in] useIoUring Whether to write full buffers asynchronously using io_uring. The default is false
+		 */
+		BufferedPcapFileWriterConfiguration(size_t bufferSize = 0, bool directIO = false, bool backgroundFlush = false, bool useIoUring = false) :
+			bufferSize(bufferSize), directIO(directIO), backgroundFlush(backgroundFlush), useIoUring(useIoUring)
+		{
+		}
+	};
+
+
+	/**
+	 * @class BufferedPcapFileWriterDevice
+	 * A class for writing pcap files at high rates. Instead of writing each packet through libpcap (or stdio in append mode) as
+	 * PcapFileWriterDevice does, record headers and packet data are serialized into a large page-aligned buffer which is written to the file
+	 * with a single system call once it's full. Optionally the file can be opened with O_DIRECT and full buffers can be written on a
+	 * background thread or asynchronously using io_uring (see BufferedPcapFileWriterConfiguration). Please notice:
+	 * - Packets are written to the file only when a buffer is full, when flush() is called or when the file is closed, so the file isn't
+	 *   complete before that
+	 * - The statistics count packets copied to the buffer. If writing a buffer to the file fails, an error is printed to log and all
+	 *   following writes fail. The packets of that buffer and the ones buffered after it are then moved from the written packets to the
+	 *   dropped ones
+	 * - Timestamps are written in microsecond precision, as in PcapFileWriterDevice
+	 * - This class isn't supported on Windows
+	 */
+	class BufferedPcapFileWriterDevice : public IFileWriterDevice
+	{
+	private:
+		struct FlushThread;
+
+		struct WriteBuffer
+		{
+			uint8_t* data;
+			// set while io_uring writes the buffer. length, offset and numOfPackets describe that write
+			bool inFlight;
+			size_t length;
+			uint64_t offset;
+			// the number of packets whose records end in the written part of the buffer
+			uint32_t numOfPackets;
+		};
+
+		LinkLayerType m_PcapLinkLayerType;
+		BufferedPcapFileWriterConfiguration m_Config;
+		int m_Fd;
+		bool m_DirectIO;
+		std::vector<WriteBuffer> m_Buffers;
+		size_t m_BufferSize;
+		size_t m_ActiveBuffer;
+		size_t m_BufferUsed;
+		// the offset in the file where the data in the active buffer starts
+		uint64_t m_FileOffset;
+		// the number of packets whose records end in the active buffer
+		uint32_t m_NumOfPacketsInActiveBuffer;
+		// the start of the last record crossing a block boundary in the active buffer. In direct I/O mode the records from it onward are
+		// the ones moved to the next buffer with the partial block
+		size_t m_BoundaryRecordStart;
+		// accessed only by the thread writing packets. The flush thread reports its failures through FlushThread
+		bool m_WriteFailed;
+		FlushThread* m_FlushThread;
+		IoUringQueue* m_IoUring;
+
+		// private copy c'tor
+		BufferedPcapFileWriterDevice(const BufferedPcapFileWriterDevice& other);
+		BufferedPcapFileWriterDevice& operator=(const BufferedPcapFileWriterDevice& other);
+
+		bool bufferPacket(const RawPacket& packet);
+		bool flushActiveBuffer();
+		void dropPackets(uint32_t numOfPackets);
+		void dropActiveBuffer();
+		bool writeToFile(const uint8_t* data, size_t dataLen, uint64_t offset);
+		void waitForFlushThread();
+		void stopFlushThread();
+		static void* flushThreadMain(void* device);
+		void waitForBuffer(size_t bufferIndex);
+		void waitForAllBuffers();
+
+	public:
+		/**
+		 * A constructor for this class that gets the pcap full path file name to open for writing or create. Notice that after calling this
+		 * constructor the file isn't opened yet, so writing packets will fail. For opening the file call open()
+		 * @param[in] fileName The full path of the file
+		 * @param[in] linkLayerType The link layer type all packet in this file will be based on. The default is Ethernet
+		 * @param[in] config Optional parameter for defining the buffer size, direct I/O and background flushing. If not set the default
+		 * parameters will be set
+		 */
+		BufferedPcapFileWriterDevice(const char* fileName, LinkLayerType linkLayerType = LINKTYPE_ETHERNET,
+			const BufferedPcapFileWriterConfiguration& config = BufferedPcapFileWriterConfiguration());
+
+		/**
+		 * A destructor for this class. Closes the file if it's opened and frees the buffers
+		 */
+		~BufferedPcapFileWriterDevice();
+
+		/**
+		 * @return The link layer type of this file
+		 */
+		LinkLayerType getLinkLayerType() const { return m_PcapLinkLayerType; }
+
+		/**
+		 * @return The size in bytes of each write buffer, after rounding the size in the configuration
+		 */
+		size_t getBufferSize() const { return m_BufferSize; }
+
+		/**
+		 * @return True if the file is opened with O_DIRECT, false otherwise (also when direct I/O was requested but isn't supported by the
+		 * file system)
+		 */
+		bool isUsingDirectIO() const { return m_DirectIO; }
+
+		/**
+		 * @return True if the file is written using io_uring, false otherwise (also when io_uring was requested but isn't available)
+		 */
+		bool isUsingIoUring() const { return m_IoUring != NULL; }
+
+		/**
+		 * Copy a RawPacket to the write buffer. If the buffer is full it's written to the file first (or handed to the background thread).
+		 * This method won't change the written packet
+		 * @param[in] packet A reference for an existing RawPcket to write to the file
+		 * @return True if a packet was written successfully. False will be returned if the file isn't opened, if the packet link layer type
+		 * is different than the one defined for the file, if the packet is longer than 262144 bytes or if writing a previous buffer to the
+		 * file failed (in all cases, an error will be printed to log)
+		 */
+		bool writePacket(RawPacket const& packet);
+
+		/**
+		 * Write multiple RawPacket to the file. Before using this method please verify the file is opened using open(). This method won't change
+		 * the written packets or the RawPacketVector instance
+		 * @param[in] packets A reference for an existing RawPcketVector, all of its packets will be written to the file
+		 * @return True if all packets were written successfully to the file. False will be returned if the file isn't opened (also, an error
+		 * log will be printed) or if at least one of the packets wasn't written successfully to the file
+		 */
+		bool writePackets(const RawPacketVector& packets);
+
+		//override methods
+
+		/**
+		 * Open the file in a write mode. If file doesn't exist, it will be created. If it does exist it will be
+		 * overwritten, meaning all its current content will be deleted
+		 * @return True if file was opened/created successfully or if file is already opened. False if opening the file failed for some reason
+		 * (an error will be printed to log)
+		 */
+		virtual bool open();
+
+		/**
+		 * Same as open(), but enables to open the file in append mode in which packets will be appended to the file
+		 * instead of overwrite its current content. In append mode file must exist, otherwise opening will fail
+		 * @param[in] appendMode A boolean indicating whether to open the file in append mode or not. If set to false
+		 * this method will act exactly like open(). If set to true, file will be opened in append mode
+		 * @return True of managed to open the file successfully. In case appendMode is set to true, false will be returned
+		 * if file wasn't found or couldn't be read, if file isn't a pcap file written in the byte order of this machine with
+		 * microsecond timestamps, or if link type specified in c'tor is different from current file link type. In case appendMode
+		 * is set to false, please refer to open() for return values
+		 */
+		bool open(bool appendMode);
+
+		/**
+		 * Write all buffered packets to the file, stop the background thread and close the file
+		 */
+		virtual void close();
+
+		/**
+		 * Write all buffered packets to the file and wait until they're written. The data is written to the operating system, not
+		 * necessarily to the disk
+		 */
+		void flush();
+
+		/**
+		 * Get statistics of packets written so far. In the pcap_stat struct, only ps_recv member is relevant. The rest of the members will contain 0
+		 * @param[out] stats The stats struct where stats are returned
+		 */
+		virtual void getStatistics(pcap_stat& stats) const;
+	};
+
+
 	/**
 	 * @class PcapNgFileWriterDevice
 	 * A class for opening a pcap-ng file for writing or creating a new pcap-ng file and write packets to it. This class adds
@@ -0,0 +1,209 @@
+#ifndef PACKETPP_SHARDED_TCP_REASSEMBLY
+#define PACKETPP_SHARDED_TCP_REASSEMBLY
+
+#include "TcpReassembly.h"
+#include "SystemUtils.h"
+#include <vector>
+
+/**
+ * @file
+ * A multi-threaded front end for pcpp#TcpReassembly.<BR>
+ * pcpp#TcpReassembly keeps all of its state in one instance and has to be fed from one thread, so it's limited to the throughput of a
+ * single core. pcpp#ShardedTcpReassembly splits the work between several worker threads (shards), each running its own pcpp#TcpReassembly
+ * instance:
+ * - The capture thread calls pcpp#ShardedTcpReassembly#reassemblePacket() for each packet
+ * - The packet's 5-tuple is hashed in a direction-independent way (see pcpp#FlowKey), so both sides of a TCP connection always go to the
+ *   same shard
+ * - The packet is copied into a single-producer single-consumer ring connecting the capture thread with that shard. No locks are taken
+ * - Each worker thread takes the packets from its ring and feeds them to its pcpp#TcpReassembly instance
+ * - The callbacks are invoked on the worker threads, together with the id of the shard that invokes them. Callbacks of different shards
+ *   may run at the same time, so data shared between shards must be protected by the user, while data kept per shard needs no protection
+ *
+ * __Basic Usage:__
+ * - Create an instance with the callbacks and a pcpp#ShardedTcpReassemblyConfiguration
+ * - Call pcpp#ShardedTcpReassembly#start() to start the worker threads
+ * - Feed packets using pcpp#ShardedTcpReassembly#reassemblePacket(). This method must always be called from the same thread
+ * - Call pcpp#ShardedTcpReassembly#stop() which waits for the workers to handle all queued packets, closes all connections and stops the
+ *   worker threads
+ */
+
+/**
+ * \namespace pcpp
+ * \brief The main namespace for the PcapPlusPlus lib
+ */
+namespace pcpp
+{
+
+	/**
+	 * @struct ShardedTcpReassemblyConfiguration
+	 * A structure for configuring the ShardedTcpReassembly class
+	 */
+	struct ShardedTcpReassemblyConfiguration
+	{
+		/** The number of shards (worker threads). If the value is set to 0 the number of cores of the machine is used */
+		size_t numOfShards;
+
+		/** The number of packets each ring can hold, rounded up to a power of 2. If the value is set to 0 the default value (4096) is used */
+		size_t ringCapacity;
+
+		/** What to do when a packet goes to a shard whose ring is full: if set, ShardedTcpReassembly#reassemblePacket() waits until there is room
+		 * in the ring (which suits reading files), otherwise the packet is dropped and counted (which suits live capture). The default is false */
+		bool waitWhenRingIsFull;
+
+		/** The cores to run the worker threads on. Shard i runs on the i-th core in the mask. If the value is 0 (the default) the threads aren't
+		 * bound to cores. Binding threads to cores is supported on Linux only */
+		CoreMask coreMask;
+
+		/** The configuration of the TcpReassembly instance of each shard. Limits such as TcpReassemblyConfiguration#maxOutOfOrderBytes apply to each
+		 * shard separately */
+		TcpReassemblyConfiguration reassemblyConfig;
+
+		/**
+		 * A c'tor for this struct
+		 * @param[in] numOfShards The number of shards. The default is 0 which means the number of cores of the machine
+		 * @param[in] ringCapacity The number of packets each ring can hold. The default is 0 which means 4096
+		 * @param[in] waitWhenRingIsFull Whether to wait when a ring is full instead of dropping the packet. The default is false
+		 */
+		ShardedTcpReassemblyConfiguration(size_t numOfShards = 0, size_t ringCapacity = 0, bool waitWhenRingIsFull = false) :
+			numOfShards(numOfShards), ringCapacity(ringCapacity), waitWhenRingIsFull(waitWhenRingIsFull), coreMask(0)
+		{
+		}
+	};
+
+
+	/**
+	 * @class ShardedTcpReassembly
+	 * TCP reassembly spread over several worker threads. Please refer to the documentation at the top of ShardedTcpReassembly.h for
+	 * understanding how to use this class
+	 */
+	class ShardedTcpReassembly
+	{
+	public:
+		/**
+		 * @typedef OnTcpMessageReady
+		 * A callback invoked on a worker thread when new data arrives on a connection
+		 * @param[in] shardId The id of the shard handling the connection, between 0 and getNumOfShards()-1
+		 * @param[in] side The side this data belongs to, see TcpReassembly#OnTcpMessageReady
+		 * @param[in] tcpData The TCP data itself + connection information
+		 * @param[in] userCookie A pointer to the cookie provided by the user in the c'tor (or NULL if no cookie provided)
+		 */
+		typedef void (*OnTcpMessageReady)(size_t shardId, int side, const TcpStreamData& tcpData, void* userCookie);
+
+		/**
+		 * @typedef OnTcpConnectionStart
+		 * A callback invoked on a worker thread when a new TCP connection is identified
+		 * @param[in] shardId The id of the shard handling the connection, between 0 and getNumOfShards()-1
+		 * @param[in] connectionData Connection information
+		 * @param[in] userCookie A pointer to the cookie provided by the user in the c'tor (or NULL if no cookie provided)
+		 */
+		typedef void (*OnTcpConnectionStart)(size_t shardId, const ConnectionData& connectionData, void* userCookie);
+
+		/**
+		 * @typedef OnTcpConnectionEnd
+		 * A callback invoked on a worker thread when a TCP connection is terminated
+		 * @param[in] shardId The id of the shard handling the connection, between 0 and getNumOfShards()-1
+		 * @param[in] connectionData Connection information
+		 * @param[in] reason The reason for connection termination
+		 * @param[in] userCookie A pointer to the cookie provided by the user in the c'tor (or NULL if no cookie provided)
+		 */
+		typedef void (*OnTcpConnectionEnd)(size_t shardId, const ConnectionData& connectionData, TcpReassembly::ConnectionEndReason reason, void* userCookie);
+
+		/**
+		 * A c'tor for this class. The worker threads aren't started until start() is called
+		 * @param[in] onMessageReadyCallback The callback to be invoked when new data arrives
+		 * @param[in] userCookie A pointer to an object provided by the user which is passed to all callbacks. This parameter is optional, default cookie is NULL
+		 * @param[in] onConnectionStartCallback The callback to be invoked when a new connection is identified. This parameter is optional
+		 * @param[in] onConnectionEndCallback The callback to be invoked when a connection is terminated. This parameter is optional
+		 * @param[in] config Optional parameter for defining special configuration parameters. If not set the default parameters will be set
+		 */
+		ShardedTcpReassembly(OnTcpMessageReady onMessageReadyCallback, void* userCookie = NULL, OnTcpConnectionStart onConnectionStartCallback = NULL,
+			OnTcpConnectionEnd onConnectionEndCallback = NULL, const ShardedTcpReassemblyConfiguration& config = ShardedTcpReassemblyConfiguration());
+
+		/**
+		 * A d'tor for this class. If the worker threads are running they are stopped as in stop()
+		 */
+		~ShardedTcpReassembly();
+
+		/**
+		 * Start the worker threads
+		 * @return True if all threads were started, false if they are already running or one of them couldn't be started (or bound to its core),
+		 * in which case none of them is left running
+		 */
+		bool start();
+
+		/**
+		 * Wait for the workers to handle all queued packets, close all connections that are still open (TcpReassembly#closeAllConnections()) and
+		 * stop the worker threads. The threads can be started again with start(). Notice packets of connections closed by stop() are ignored
+		 * until the connections are purged (see TcpReassemblyConfiguration#closedConnectionDelay)
+		 */
+		void stop();
+
+		/**
+		 * @return True if the worker threads are running, false otherwise
+		 */
+		bool isRunning() const { return m_Running; }
+
+		/**
+		 * Queue a packet for reassembly by the shard its connection belongs to. The packet is copied, so it can be reused right after the call.
+		 * This method must always be called from the same thread
+		 * @param[in] rawPacket The packet to queue
+		 * @return True if the packet was queued. False if it isn't an IPv4 or IPv6 TCP packet, if the workers aren't running or if the ring of
+		 * the shard was full and ShardedTcpReassemblyConfiguration#waitWhenRingIsFull isn't set
+		 */
+		bool reassemblePacket(RawPacket* rawPacket);
+
+		/**
+		 * @return The number of shards (worker threads)
+		 */
+		size_t getNumOfShards() const { return m_Shards.size(); }
+
+		/**
+		 * @param[in] rawPacket A packet
+		 * @return The id of the shard that handles the connection of the packet, or -1 if the packet isn't an IPv4 or IPv6 TCP packet
+		 */
+		int getShardId(RawPacket* rawPacket) const;
+
+		/**
+		 * @param[in] shardId The shard id
+		 * @return The number of packets the shard has handled so far
+		 */
+		uint64_t getNumOfHandledPackets(size_t shardId) const;
+
+		/**
+		 * @param[in] shardId The shard id
+		 * @return The number of packets that were dropped because the ring of the shard was full
+		 */
+		uint64_t getNumOfDroppedPackets(size_t shardId) const;
+
+		/**
+		 * @param[in] shardId The shard id
+		 * @return The out-of-order buffering counters of the shard's TcpReassembly instance. They should be read only when the workers are stopped
+		 */
+		const TcpReassembly::OutOfOrderStatistics& getOutOfOrderStatistics(size_t shardId) const;
+
+	private:
+		struct Shard;
+
+		OnTcpMessageReady m_OnMessageReadyCallback;
+		OnTcpConnectionStart m_OnConnStart;
+		OnTcpConnectionEnd m_OnConnEnd;
+		void* m_UserCookie;
+		bool m_WaitWhenRingIsFull;
+		CoreMask m_CoreMask;
+		uint64_t m_HashSeed;
+		bool m_Running;
+		std::vector<Shard*> m_Shards;
+
+		// the object owns threads and rings and isn't meant to be copied
+		ShardedTcpReassembly(const ShardedTcpReassembly&);
+		ShardedTcpReassembly& operator=(const ShardedTcpReassembly&);
+
+		static void* workerThreadMain(void* shardPtr);
+		static void onShardMessageReady(int side, const TcpStreamData& tcpData, void* shardPtr);
+		static void onShardConnectionStart(const ConnectionData& connectionData, void* shardPtr);
+		static void onShardConnectionEnd(const ConnectionData& connectionData, TcpReassembly::ConnectionEndReason reason, void* shardPtr);
+	};
+
+} // namespace pcpp
+
+#endif /* PACKETPP_SHARDED_TCP_REASSEMBLY */
@@ -249,6 +249,24 @@ bool DpdkDevice::configurePort(uint8_t numOfRxQueues, uint8_t numOfTxQueues)
 	portConf.rx_adv_conf.rss_conf.rss_key_len = m_Config.rssKeyLength;
 	portConf.rx_adv_conf.rss_conf.rss_hf = convertRssHfToDpdkRssHf(m_Config.rssHashFunction);
 
+	if (m_Config.txChecksumOffload)
+	{
+#if (RTE_VER_YEAR > 17) || (RTE_VER_YEAR == 17 && RTE_VER_MONTH >= 11)
+		uint64_t txOffloads = DEV_TX_OFFLOAD_IPV4_CKSUM | DEV_TX_OFFLOAD_TCP_CKSUM | DEV_TX_OFFLOAD_UDP_CKSUM;
+		rte_eth_dev_info devInfo;
+		rte_eth_dev_info_get(m_Id, &devInfo);
+		if ((devInfo.tx_offload_capa & txOffloads) != txOffloads)
+		{
+			LOG_ERROR("PMD '%s' doesn't support IPv4/TCP/UDP TX checksum offload", m_PMDName.c_str());
+			return false;
+		}
+		portConf.txmode.offloads = txOffloads;
+#else
+		LOG_ERROR("TX checksum offload requires DPDK 17.11 or newer");
+		return false;
+#endif
+	}
+
 	int res = rte_eth_dev_configure((uint8_t) m_Id, numOfRxQueues, numOfTxQueues, &portConf);
 	if (res < 0)
 	{
@@ -15,6 +15,7 @@
 #include "KniDevice.h"
 
 #include <string>
+#include <string.h>
 #include <stdint.h>
 #include <unistd.h>
 
@@ -94,6 +95,7 @@ bool MBufRawPacket::initFromRawPacket(const RawPacket* rawPacket, struct rte_mem
 	m_RawDataLen = rte_pktmbuf_pkt_len(m_MBuf);
 
 	copyDataFrom(*rawPacket, false);
+	setChecksumOffloadInfo(m_ChecksumOffloadInfo);
 
 	return true;
 }
@@ -136,6 +138,7 @@ MBufRawPacket::MBufRawPacket(const MBufRawPacket& other)
 	m_RawPacketSet = false;
 
 	copyDataFrom(other, false);
+	setChecksumOffloadInfo(m_ChecksumOffloadInfo);
 }
 
 MBufRawPacket& MBufRawPacket::operator=(const MBufRawPacket& other)
@@ -167,6 +170,7 @@ MBufRawPacket& MBufRawPacket::operator=(const MBufRawPacket& other)
 	m_RawPacketSet = false;
 
 	copyDataFrom(other, false);
+	setChecksumOffloadInfo(m_ChecksumOffloadInfo);
 
 	return *this;
 }
@@ -213,6 +217,11 @@ bool MBufRawPacket::setRawData(const uint8_t* pRawData, int rawDataLen, timespec
 	m_TimeStamp = timestamp;
 	m_RawPacketSet = true;
 	m_FrameLength = frameLength;
+
+	// offload information describes the previous data
+	ChecksumOffloadInfo noOffloadInfo;
+	memset(&noOffloadInfo, 0, sizeof(noOffloadInfo));
+	setChecksumOffloadInfo(noOffloadInfo);
 	m_LinkLayerType = layerType;
 
 	return true;
@@ -313,6 +322,29 @@ bool MBufRawPacket::reallocateData(size_t newBufferLength)
 	return true;
 }
 
+void MBufRawPacket::setChecksumOffloadInfo(const ChecksumOffloadInfo& info)
+{
+	RawPacket::setChecksumOffloadInfo(info);
+
+	if (m_MBuf == NULL)
+		return;
+
+	m_MBuf->ol_flags &= ~(PKT_TX_IPV4 | PKT_TX_IPV6 | PKT_TX_IP_CKSUM | PKT_TX_L4_MASK);
+	if (info.flags == ChecksumOffloadNone)
+		return;
+
+	m_MBuf->ol_flags |= (info.isIPv6 ? PKT_TX_IPV6 : PKT_TX_IPV4);
+	if (info.flags & ChecksumOffloadIPv4)
+		m_MBuf->ol_flags |= PKT_TX_IP_CKSUM;
+	if (info.flags & ChecksumOffloadTCP)
+		m_MBuf->ol_flags |= PKT_TX_TCP_CKSUM;
+	else if (info.flags & ChecksumOffloadUDP)
+		m_MBuf->ol_flags |= PKT_TX_UDP_CKSUM;
+
+	m_MBuf->l2_len = info.l2Len;
+	m_MBuf->l3_len = info.l3Len;
+}
+
 void MBufRawPacket::setMBuf(struct rte_mbuf* mBuf, timespec timestamp)
 {
 	if (m_MBuf != NULL && m_FreeMbuf)
@@ -7,7 +7,23 @@
 #include "Logger.h"
 #include "TimespecTimeval.h"
 #include <string.h>
+#include <stdlib.h>
 #include <fstream>
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#endif
+#if defined(USE_IO_URING) && defined(LINUX)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+// reads and writes at explicit offsets (IORING_OP_READ/IORING_OP_WRITE) need Linux 5.6, which is also the first version reporting this feature
+#ifdef IORING_FEAT_RW_CUR_POS
+#define PCAPPP_IO_URING_SUPPORTED
+#endif
+#endif
 
 namespace pcpp
 {
@@ -31,6 +47,463 @@ struct packet_header
 	uint32_t len;
 };
 
+// pcap file magic numbers, as read in the byte order of the machine that wrote the file
+#define PCAP_MAGIC_MICROSEC 0xa1b2c3d4
+#define PCAP_MAGIC_NANOSEC 0xa1b23c4d
+#define PCAP_MAGIC_MICROSEC_SWAPPED 0xd4c3b2a1
+#define PCAP_MAGIC_NANOSEC_SWAPPED 0x4d3cb2a1
+
+// records with a captured length above both this value and the snapshot length are considered corrupt, as libpcap does
+#define PCAP_MAX_RECORD_LENGTH 262144
+
+// O_DIRECT needs the buffer address, the write length and the file offset aligned to the block size of the file system. 4KB covers
+// the common file systems and is the page size, which is good for the buffers of the buffered devices anyway
+#define BUFFERED_DEVICE_ALIGNMENT 4096
+// big enough for the largest record plus the partial block carried over between buffers in direct I/O mode, and makes a record span two
+// read buffers at most
+#define BUFFERED_DEVICE_MIN_BUFFER_SIZE (1024 * 1024)
+
+static inline uint32_t swapUint32(uint32_t value)
+{
+	return ((value & 0x000000ff) << 24) | ((value & 0x0000ff00) << 8) | ((value & 0x00ff0000) >> 8) | ((value & 0xff000000) >> 24);
+}
+
+// the buffer size of the buffered devices: at least the min size and rounded up to whole blocks
+static size_t getBufferedDeviceBufferSize(size_t requestedSize, size_t defaultSize)
+{
+	size_t bufferSize = (requestedSize > 0 ? requestedSize : defaultSize);
+	if (bufferSize < BUFFERED_DEVICE_MIN_BUFFER_SIZE)
+		bufferSize = BUFFERED_DEVICE_MIN_BUFFER_SIZE;
+	return (bufferSize + BUFFERED_DEVICE_ALIGNMENT - 1) / BUFFERED_DEVICE_ALIGNMENT * BUFFERED_DEVICE_ALIGNMENT;
+}
+
+// read from a file with blocking reads until all bytes are read, the end of the file is reached or an error occurs
+static size_t readFromFile(int fd, const char* fileName, uint8_t* buffer, size_t length, uint64_t offset)
+{
+	size_t bytesRead = 0;
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	while (bytesRead < length)
+	{
+		ssize_t result = pread(fd, buffer + bytesRead, length - bytesRead, (off_t)(offset + bytesRead));
+		if (result < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			LOG_ERROR("Error while reading file '%s': %s", fileName, strerror(errno));
+			break;
+		}
+
+		if (result == 0)
+			break;
+
+		bytesRead += (size_t)result;
+	}
+#endif
+
+	return bytesRead;
+}
+
+// parse the file header of a pcap file read without libpcap
+static bool parsePcapFileHeader(const uint8_t* data, const char* fileName, bool& swapByteOrder, bool& nanosecPrecision, uint32_t& snapshotLength, LinkLayerType& linkLayerType)
+{
+	pcap_file_header fileHeader;
+	memcpy(&fileHeader, data, sizeof(fileHeader));
+
+	switch (fileHeader.magic)
+	{
+	case PCAP_MAGIC_MICROSEC:
+		swapByteOrder = false;
+		nanosecPrecision = false;
+		break;
+	case PCAP_MAGIC_NANOSEC:
+		swapByteOrder = false;
+		nanosecPrecision = true;
+		break;
+	case PCAP_MAGIC_MICROSEC_SWAPPED:
+		swapByteOrder = true;
+		nanosecPrecision = false;
+		break;
+	case PCAP_MAGIC_NANOSEC_SWAPPED:
+		swapByteOrder = true;
+		nanosecPrecision = true;
+		break;
+	default:
+		LOG_ERROR("File '%s' isn't a pcap file (unknown magic number 0x%X)", fileName, fileHeader.magic);
+		return false;
+	}
+
+	uint32_t linkType = (swapByteOrder ? swapUint32(fileHeader.linktype) : fileHeader.linktype);
+	snapshotLength = (swapByteOrder ? swapUint32(fileHeader.snaplen) : fileHeader.snaplen);
+
+	// the upper bits of the link type field may hold FCS information which isn't part of the link type
+	int linkLayer = (int)(linkType & 0x03FFFFFF);
+	if (!RawPacket::isLinkTypeValid(linkLayer))
+	{
+		LOG_ERROR("Invalid link layer (%d) for reader device filename '%s'", linkLayer, fileName);
+		return false;
+	}
+
+	linkLayerType = static_cast<LinkLayerType>(linkLayer);
+	return true;
+}
+
+// parse a record header of a pcap file read without libpcap. Record headers aren't necessarily aligned inside the file, so they're copied
+// out rather than accessed in place
+static void parseRecordHeader(const uint8_t* data, bool swapByteOrder, packet_header& recordHeader)
+{
+	memcpy(&recordHeader, data, sizeof(recordHeader));
+	if (swapByteOrder)
+	{
+		recordHeader.tv_sec = swapUint32(recordHeader.tv_sec);
+		recordHeader.tv_usec = swapUint32(recordHeader.tv_usec);
+		recordHeader.caplen = swapUint32(recordHeader.caplen);
+		recordHeader.len = swapUint32(recordHeader.len);
+	}
+}
+
+// ~~~~~~~~~~~~~~~~~~~~
+// IoUringQueue members
+// ~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A minimal io_uring submission and completion queue, built directly on the system calls so no library is needed. It's used by the
+ * buffered file devices to read and write whole buffers at explicit file offsets. If PcapPlusPlus isn't built with io_uring support or the
+ * kernel doesn't allow it, init() fails and the devices use blocking reads and writes instead
+ */
+class IoUringQueue
+{
+public:
+	IoUringQueue();
+	~IoUringQueue();
+
+	/**
+	 * Create the ring
+	 * @param[in] numOfEntries The max number of requests in flight
+	 * @return True if the ring was created, false if io_uring isn't available
+	 */
+	bool init(unsigned int numOfEntries);
+
+	/**
+	 * Queue a read request. It's sent to the kernel by the next call to submit()
+	 * @return False if the submission queue is full
+	 */
+	bool queueRead(int fd, void* buffer, size_t length, uint64_t offset, uint64_t userData);
+
+	/**
+	 * Queue a write request. It's sent to the kernel by the next call to submit()
+	 * @return False if the submission queue is full
+	 */
+	bool queueWrite(int fd, const void* buffer, size_t length, uint64_t offset, uint64_t userData);
+
+	/**
+	 * Send the queued requests to the kernel
+	 * @return False if io_uring_enter failed. The requests that weren't sent are removed from the queue then, so they're never executed
+	 * and their buffers may be reused right away
+	 */
+	bool submit();
+
+	/**
+	 * Get the result of a request, waiting for one to complete if none has. Requests complete in any order
+	 * @param[out] userData The user data of the completed request
+	 * @param[out] result The number of bytes read or written, or a negative errno value
+	 * @return False if io_uring_enter failed
+	 */
+	bool waitForCompletion(uint64_t& userData, int& result);
+
+private:
+#ifdef PCAPPP_IO_URING_SUPPORTED
+	int m_RingFd;
+	void* m_SqRing;
+	size_t m_SqRingSize;
+	void* m_CqRing;
+	size_t m_CqRingSize;
+	io_uring_sqe* m_Sqes;
+	size_t m_SqesSize;
+	unsigned* m_SqHead;
+	unsigned* m_SqTail;
+	unsigned* m_SqMask;
+	unsigned* m_SqArray;
+	unsigned m_SqEntries;
+	unsigned* m_CqHead;
+	unsigned* m_CqTail;
+	unsigned* m_CqMask;
+	io_uring_cqe* m_Cqes;
+	unsigned m_NumOfQueued;
+
+	bool queueRequest(uint8_t opcode, int fd, const void* buffer, size_t length, uint64_t offset, uint64_t userData);
+#endif
+};
+
+#ifdef PCAPPP_IO_URING_SUPPORTED
+
+IoUringQueue::IoUringQueue()
+{
+	m_RingFd = -1;
+	m_SqRing = MAP_FAILED;
+	m_SqRingSize = 0;
+	m_CqRing = MAP_FAILED;
+	m_CqRingSize = 0;
+	m_Sqes = (io_uring_sqe*)MAP_FAILED;
+	m_SqesSize = 0;
+	m_NumOfQueued = 0;
+}
+
+IoUringQueue::~IoUringQueue()
+{
+	if (m_Sqes != MAP_FAILED)
+		munmap(m_Sqes, m_SqesSize);
+	if (m_CqRing != MAP_FAILED && m_CqRing != m_SqRing)
+		munmap(m_CqRing, m_CqRingSize);
+	if (m_SqRing != MAP_FAILED)
+		munmap(m_SqRing, m_SqRingSize);
+	if (m_RingFd >= 0)
+		::close(m_RingFd);
+}
+
+bool IoUringQueue::init(unsigned int numOfEntries)
+{
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	m_RingFd = (int)syscall(__NR_io_uring_setup, numOfEntries, &params);
+	if (m_RingFd < 0)
+	{
+		LOG_DEBUG("io_uring_setup failed: %s", strerror(errno));
+		return false;
+	}
+
+	if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+	{
+		LOG_DEBUG("The kernel doesn't support io_uring reads and writes");
+		return false;
+	}
+
+	m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (m_CqRingSize > m_SqRingSize)
+			m_SqRingSize = m_CqRingSize;
+		m_CqRingSize = m_SqRingSize;
+	}
+
+	m_SqRing = mmap(NULL, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+	if (m_SqRing == MAP_FAILED)
+	{
+		LOG_DEBUG("Cannot map the io_uring submission queue: %s", strerror(errno));
+		return false;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		m_CqRing = m_SqRing;
+	else
+	{
+		m_CqRing = mmap(NULL, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+		if (m_CqRing == MAP_FAILED)
+		{
+			LOG_DEBUG("Cannot map the io_uring completion queue: %s", strerror(errno));
+			return false;
+		}
+	}
+
+	m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	m_Sqes = (io_uring_sqe*)mmap(NULL, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+	if (m_Sqes == MAP_FAILED)
+	{
+		LOG_DEBUG("Cannot map the io_uring submission queue entries: %s", strerror(errno));
+		return false;
+	}
+
+	uint8_t* sqRing = (uint8_t*)m_SqRing;
+	m_SqHead = (unsigned*)(sqRing + params.sq_off.head);
+	m_SqTail = (unsigned*)(sqRing + params.sq_off.tail);
+	m_SqMask = (unsigned*)(sqRing + params.sq_off.ring_mask);
+	m_SqArray = (unsigned*)(sqRing + params.sq_off.array);
+	m_SqEntries = params.sq_entries;
+
+	uint8_t* cqRing = (uint8_t*)m_CqRing;
+	m_CqHead = (unsigned*)(cqRing + params.cq_off.head);
+	m_CqTail = (unsigned*)(cqRing + params.cq_off.tail);
+	m_CqMask = (unsigned*)(cqRing + params.cq_off.ring_mask);
+	m_Cqes = (io_uring_cqe*)(cqRing + params.cq_off.cqes);
+
+	return true;
+}
+
+bool IoUringQueue::queueRequest(uint8_t opcode, int fd, const void* buffer, size_t length, uint64_t offset, uint64_t userData)
+{
+	// the kernel moves the submission queue head and the completion queue tail, so they're read with acquire semantics, and the indices
+	// this side moves are published with release semantics once the entries they cover are written
+	unsigned tail = *m_SqTail;
+	if (tail - __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE) >= m_SqEntries)
+		return false;
+
+	unsigned index = tail & *m_SqMask;
+	io_uring_sqe* sqe = &m_Sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t)(uintptr_t)buffer;
+	sqe->len = (uint32_t)length;
+	sqe->off = offset;
+	sqe->user_data = userData;
+	m_SqArray[index] = index;
+
+	__atomic_store_n(m_SqTail, tail + 1, __ATOMIC_RELEASE);
+	m_NumOfQueued++;
+	return true;
+}
+
+bool IoUringQueue::queueRead(int fd, void* buffer, size_t length, uint64_t offset, uint64_t userData)
+{
+	return queueRequest(IORING_OP_READ, fd, buffer, length, offset, userData);
+}
+
+bool IoUringQueue::queueWrite(int fd, const void* buffer, size_t length, uint64_t offset, uint64_t userData)
+{
+	return queueRequest(IORING_OP_WRITE, fd, buffer, length, offset, userData);
+}
+
+bool IoUringQueue::submit()
+{
+	while (m_NumOfQueued > 0)
+	{
+		int submitted = (int)syscall(__NR_io_uring_enter, m_RingFd, m_NumOfQueued, 0, 0, NULL, 0);
+		if (submitted < 0)
+		{
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+
+			LOG_ERROR("io_uring_enter failed: %s", strerror(errno));
+
+			// the kernel reads the submission queue only in io_uring_enter, so the entries it didn't consume can be taken back. Otherwise
+			// the next io_uring_enter, for example the one waiting for completions, would submit them after the caller gave up on them
+			__atomic_store_n(m_SqTail, *m_SqTail - m_NumOfQueued, __ATOMIC_RELEASE);
+			m_NumOfQueued = 0;
+			return false;
+		}
+
+		m_NumOfQueued -= (unsigned)submitted;
+	}
+
+	return true;
+}
+
+bool IoUringQueue::waitForCompletion(uint64_t& userData, int& result)
+{
+	unsigned head = *m_CqHead;
+	while (head == __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE))
+	{
+		// requests that weren't submitted yet are submitted with the wait
+		int submitted = (int)syscall(__NR_io_uring_enter, m_RingFd, m_NumOfQueued, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (submitted < 0)
+		{
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+
+			LOG_ERROR("io_uring_enter failed: %s", strerror(errno));
+			return false;
+		}
+
+		m_NumOfQueued -= (unsigned)submitted;
+	}
+
+	io_uring_cqe* cqe = &m_Cqes[head & *m_CqMask];
+	userData = cqe->user_data;
+	result = cqe->res;
+	__atomic_store_n(m_CqHead, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+#else
+
+IoUringQueue::IoUringQueue() {}
+IoUringQueue::~IoUringQueue() {}
+
+bool IoUringQueue::init(unsigned int numOfEntries)
+{
+	LOG_DEBUG("PcapPlusPlus isn't built with io_uring support");
+	return false;
+}
+
+bool IoUringQueue::queueRead(int fd, void* buffer, size_t length, uint64_t offset, uint64_t userData) { return false; }
+bool IoUringQueue::queueWrite(int fd, const void* buffer, size_t length, uint64_t offset, uint64_t userData) { return false; }
+bool IoUringQueue::submit() { return false; }
+bool IoUringQueue::waitForCompletion(uint64_t& userData, int& result) { return false; }
+
+#endif // PCAPPP_IO_URING_SUPPORTED
+
+// the initial batch buffer size per packet when the user doesn't set one, enough for full size Ethernet frames
+#define DEFAULT_BATCH_BYTES_PER_PACKET 2048
+
+// ~~~~~~~~~~~~~~~~~~~~~~
+// RawPacketBatch members
+// ~~~~~~~~~~~~~~~~~~~~~~
+
+RawPacketBatch::RawPacketBatch(size_t maxNumOfPackets, size_t bufferSize)
+{
+	m_MaxNumOfPackets = maxNumOfPackets;
+	m_NumOfPackets = 0;
+	m_Packets = new RawPacket[maxNumOfPackets > 0 ? maxNumOfPackets : 1];
+	m_BufferSize = (bufferSize > 0 ? bufferSize : maxNumOfPackets * DEFAULT_BATCH_BYTES_PER_PACKET);
+	if (m_BufferSize == 0)
+		m_BufferSize = DEFAULT_BATCH_BYTES_PER_PACKET;
+	m_Buffer = new uint8_t[m_BufferSize];
+	m_BufferUsed = 0;
+}
+
+RawPacketBatch::~RawPacketBatch()
+{
+	// the packets don't own the batch buffer, so they don't free it
+	delete [] m_Packets;
+	delete [] m_Buffer;
+}
+
+void RawPacketBatch::growBuffer(size_t minSize)
+{
+	size_t newSize = m_BufferSize * 2;
+	if (newSize < minSize)
+		newSize = minSize;
+
+	uint8_t* newBuffer = new uint8_t[newSize];
+	memcpy(newBuffer, m_Buffer, m_BufferUsed);
+
+	// the packets already in the batch are moved to the new buffer
+	for (size_t i = 0; i < m_NumOfPackets; i++)
+	{
+		RawPacket& packet = m_Packets[i];
+		size_t offset = (size_t)(packet.getRawData() - m_Buffer);
+		packet.initWithRawData(newBuffer + offset, packet.getRawDataLen(), packet.getPacketTimeStamp(), packet.getLinkLayerType(), packet.getFrameLength());
+	}
+
+	delete [] m_Buffer;
+	m_Buffer = newBuffer;
+	m_BufferSize = newSize;
+	LOG_DEBUG("Batch buffer grew to %d bytes", (int)newSize);
+}
+
+bool RawPacketBatch::add(const uint8_t* pRawData, int rawDataLen, timespec timestamp, LinkLayerType layerType, int frameLength)
+{
+	if (isFull() || rawDataLen < 0)
+		return false;
+
+	if (m_BufferSize - m_BufferUsed < (size_t)rawDataLen)
+		growBuffer(m_BufferUsed + rawDataLen);
+
+	uint8_t* packetData = m_Buffer + m_BufferUsed;
+	memcpy(packetData, pRawData, rawDataLen);
+	m_Packets[m_NumOfPackets].initWithRawData(packetData, rawDataLen, timestamp, layerType, frameLength);
+	m_BufferUsed += rawDataLen;
+	m_NumOfPackets++;
+	return true;
+}
+
+void RawPacketBatch::clear()
+{
+	m_NumOfPackets = 0;
+	m_BufferUsed = 0;
+}
+
 // ~~~~~~~~~~~~~~~~~~~
 // IFileDevice members
 // ~~~~~~~~~~~~~~~~~~~
@@ -113,6 +586,36 @@ int IFileReaderDevice::getNextPackets(RawPacketVector& packetVec, int numOfPacke
 	return numOfPacketsRead;
 }
 
+bool IFileReaderDevice::getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType)
+{
+	if (!getNextPacket(m_PacketDataReadBuffer))
+		return false;
+
+	pRawData = m_PacketDataReadBuffer.getRawData();
+	rawDataLen = m_PacketDataReadBuffer.getRawDataLen();
+	frameLength = m_PacketDataReadBuffer.getFrameLength();
+	timestamp = m_PacketDataReadBuffer.getPacketTimeStamp();
+	layerType = m_PacketDataReadBuffer.getLinkLayerType();
+	return true;
+}
+
+int IFileReaderDevice::getNextPackets(RawPacketBatch& batch)
+{
+	batch.clear();
+
+	const uint8_t* pRawData = NULL;
+	int rawDataLen = 0;
+	int frameLength = 0;
+	timespec timestamp;
+	LinkLayerType layerType = LINKTYPE_ETHERNET;
+	while (!batch.isFull() && getNextPacketData(pRawData, rawDataLen, frameLength, timestamp, layerType))
+	{
+		batch.add(pRawData, rawDataLen, timestamp, layerType, frameLength);
+	}
+
+	return (int)batch.size();
+}
+
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // PcapFileReaderDevice members
@@ -164,9 +667,8 @@ void PcapFileReaderDevice::getStatistics(pcap_stat& stats) const
 	LOG_DEBUG("Statistics received for reader device for filename '%s'", m_FileName);
 }
 
-bool PcapFileReaderDevice::getNextPacket(RawPacket& rawPacket)
+bool PcapFileReaderDevice::getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType)
 {
-	rawPacket.clear();
 	if (m_PcapDescriptor == NULL)
 	{
 		LOG_ERROR("File device '%s' not opened", m_FileName);
@@ -180,476 +682,2375 @@ bool PcapFileReaderDevice::getNextPacket(RawPacket& rawPacket)
 		return false;
 	}
 
-	uint8_t* pMyPacketData = new uint8_t[pkthdr.caplen];
-	memcpy(pMyPacketData, pPacketData, pkthdr.caplen);
-	if (!rawPacket.setRawData(pMyPacketData, pkthdr.caplen, pkthdr.ts, static_cast<LinkLayerType>(m_PcapLinkLayerType), pkthdr.len))
-	{
-		LOG_ERROR("Couldn't set data to raw packet");
-		return false;
-	}
+	pRawData = pPacketData;
+	rawDataLen = (int)pkthdr.caplen;
+	frameLength = (int)pkthdr.len;
+	TIMEVAL_TO_TIMESPEC(&pkthdr.ts, &timestamp);
+	layerType = m_PcapLinkLayerType;
 	m_NumOfPacketsRead++;
 	return true;
 }
 
-
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-// PcapNgFileReaderDevice members
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
-PcapNgFileReaderDevice::PcapNgFileReaderDevice(const char* fileName) : IFileReaderDevice(fileName)
-{
-	m_LightPcapNg = NULL;
-	m_CurFilter = "";
-	m_BpfLinkType = -1;
-	m_BpfInitialized = false;
-}
-
-bool PcapNgFileReaderDevice::matchPacketWithFilter(const uint8_t* packetData, size_t packetLen, timespec packetTimestamp, uint16_t linkType)
+bool PcapFileReaderDevice::getNextPacket(RawPacket& rawPacket)
 {
-	if (m_CurFilter == "")
-		return true;
+	rawPacket.clear();
 
-	int linkTypeAsInt = (int)linkType;
+	const uint8_t* pPacketData = NULL;
+	int packetDataLen = 0;
+	int frameLength = 0;
+	timespec timestamp;
+	LinkLayerType layerType = LINKTYPE_ETHERNET;
+	if (!getNextPacketData(pPacketData, packetDataLen, frameLength, timestamp, layerType))
+		return false;
 
-	if (m_BpfLinkType != linkTypeAsInt)
+	uint8_t* pMyPacketData = new uint8_t[packetDataLen];
+	memcpy(pMyPacketData, pPacketData, packetDataLen);
+	if (!rawPacket.setRawData(pMyPacketData, packetDataLen, timestamp, layerType, frameLength))
 	{
-		LOG_DEBUG("Compiling the filter '%s' for link type %d", m_CurFilter.c_str(), linkTypeAsInt);
-		if (m_BpfInitialized)
-			pcap_freecode(&m_Bpf);
-		if (pcap_compile_nopcap(9000, linkTypeAsInt, &m_Bpf, m_CurFilter.c_str(), 1, 0) < 0)
-		{
-			m_BpfInitialized = false;
-			return false;
-		}
-
-		m_BpfLinkType = linkTypeAsInt;
-		m_BpfInitialized = true;
+		LOG_ERROR("Couldn't set data to raw packet");
+		return false;
 	}
+	return true;
+}
 
-	struct pcap_pkthdr pktHdr;
-	pktHdr.caplen = packetLen;
-	pktHdr.len = packetLen;
-	TIMESPEC_TO_TIMEVAL(&pktHdr.ts, &packetTimestamp);
-	return (pcap_offline_filter(&m_Bpf, &pktHdr, packetData) != 0);
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// MmapPcapFileReaderDevice members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+MmapPcapFileReaderDevice::MmapPcapFileReaderDevice(const char* fileName) : IFileReaderDevice(fileName)
+{
+	m_MappedFile = NULL;
+	m_MappedFileSize = 0;
+	m_NextRecordOffset = 0;
+	m_PcapLinkLayerType = LINKTYPE_ETHERNET;
+	m_SwapByteOrder = false;
+	m_NanosecPrecision = false;
+	m_SnapshotLength = 0;
 }
 
-bool PcapNgFileReaderDevice::open()
+bool MmapPcapFileReaderDevice::open()
 {
 	m_NumOfPacketsRead = 0;
 	m_NumOfPacketsNotParsed = 0;
 
-	if (m_LightPcapNg != NULL)
+	if (m_MappedFile != NULL)
 	{
-		LOG_DEBUG("pcapng descriptor already opened. Nothing to do");
+		LOG_DEBUG("File already mapped. Nothing to do");
 		return true;
 	}
 
-	m_LightPcapNg = light_pcapng_open_read(m_FileName, LIGHT_FALSE);
-	if (m_LightPcapNg == NULL)
+#if defined(WIN32) || defined(WINx64) || defined(PCAPPP_MINGW_ENV)
+	LOG_ERROR("Memory-mapping pcap files isn't supported on this platform");
+	return false;
+#else
+	int fd = ::open(m_FileName, O_RDONLY);
+	if (fd < 0)
 	{
-		LOG_ERROR("Cannot open pcapng reader device for filename '%s'", m_FileName);
-		m_DeviceOpened = false;
+		LOG_ERROR("Cannot open file reader device for filename '%s': %s", m_FileName, strerror(errno));
 		return false;
 	}
 
-	LOG_DEBUG("Successfully opened pcapng reader device for filename '%s'", m_FileName);
-	m_DeviceOpened = true;
-	return true;
-}
-
-bool PcapNgFileReaderDevice::getNextPacket(RawPacket& rawPacket, std::string& packetComment)
-{
-	rawPacket.clear();
-	packetComment = "";
-
-	if (m_LightPcapNg == NULL)
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
 	{
-		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		LOG_ERROR("Cannot get the size of file '%s': %s", m_FileName, strerror(errno));
+		::close(fd);
 		return false;
 	}
 
-	light_packet_header pktHeader;
-	const uint8_t* pktData = NULL;
-
-	if (!light_get_next_packet((light_pcapng_t*)m_LightPcapNg, &pktHeader, &pktData))
+	if ((uint64_t)fileStat.st_size < sizeof(pcap_file_header))
 	{
-		LOG_DEBUG("Packet could not be read. Probably end-of-file");
+		LOG_ERROR("File '%s' is too short to be a pcap file", m_FileName);
+		::close(fd);
 		return false;
 	}
 
-	while (!matchPacketWithFilter(pktData, pktHeader.captured_length, pktHeader.timestamp, pktHeader.data_link))
+	// the mapping is private and writable so users can change packet data as with any other RawPacket; pages are copied only when written
+	void* mappedFile = mmap(NULL, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mappedFile == MAP_FAILED)
 	{
-		if (!light_get_next_packet((light_pcapng_t*)m_LightPcapNg, &pktHeader, &pktData))
-		{
-			LOG_DEBUG("Packet could not be read. Probably end-of-file");
-			return false;
-		}
+		LOG_ERROR("Cannot map file '%s' to memory: %s", m_FileName, strerror(errno));
+		return false;
 	}
 
-	uint8_t* myPacketData = new uint8_t[pktHeader.captured_length];
-	memcpy(myPacketData, pktData, pktHeader.captured_length);
-	if (!rawPacket.setRawData(myPacketData, pktHeader.captured_length, pktHeader.timestamp, static_cast<LinkLayerType>(pktHeader.data_link), pktHeader.original_length))
+	// the file is read from start to end once, so the kernel can read ahead aggressively and drop pages behind. Huge pages are only a hint,
+	// they're used if the kernel supports them for file mappings
+	madvise(mappedFile, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+	madvise(mappedFile, (size_t)fileStat.st_size, MADV_HUGEPAGE);
+#endif
+
+	m_MappedFile = (uint8_t*)mappedFile;
+	m_MappedFileSize = (uint64_t)fileStat.st_size;
+
+	if (!parsePcapFileHeader(m_MappedFile, m_FileName, m_SwapByteOrder, m_NanosecPrecision, m_SnapshotLength, m_PcapLinkLayerType))
 	{
-		LOG_ERROR("Couldn't set data to raw packet");
+		close();
 		return false;
 	}
 
-	if (pktHeader.comment != NULL && pktHeader.comment_length > 0)
-		packetComment = std::string(pktHeader.comment, pktHeader.comment_length);
+	m_NextRecordOffset = sizeof(pcap_file_header);
 
-	m_NumOfPacketsRead++;
+	LOG_DEBUG("Successfully mapped file reader device for filename '%s'", m_FileName);
+	m_DeviceOpened = true;
 	return true;
+#endif
 }
 
-bool PcapNgFileReaderDevice::getNextPacket(RawPacket& rawPacket)
+void MmapPcapFileReaderDevice::close()
 {
-	std::string temp;
-	return getNextPacket(rawPacket, temp);
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	if (m_MappedFile != NULL)
+	{
+		munmap(m_MappedFile, (size_t)m_MappedFileSize);
+		LOG_DEBUG("Successfully unmapped file reader device for filename '%s'", m_FileName);
+	}
+#endif
+
+	m_MappedFile = NULL;
+	m_MappedFileSize = 0;
+	m_NextRecordOffset = 0;
+	m_DeviceOpened = false;
 }
 
-void PcapNgFileReaderDevice::getStatistics(pcap_stat& stats) const
+void MmapPcapFileReaderDevice::getStatistics(pcap_stat& stats) const
 {
 	stats.ps_recv = m_NumOfPacketsRead;
 	stats.ps_drop = m_NumOfPacketsNotParsed;
 	stats.ps_ifdrop = 0;
-	LOG_DEBUG("Statistics received for pcapng reader device for filename '%s'", m_FileName);
+	LOG_DEBUG("Statistics received for reader device for filename '%s'", m_FileName);
 }
 
-bool PcapNgFileReaderDevice::setFilter(std::string filterAsString)
+bool MmapPcapFileReaderDevice::getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType)
 {
-	struct bpf_program prog;
-	if (pcap_compile_nopcap(9000, 1, &prog, filterAsString.c_str(), 1, 0) < 0)
+	if (m_MappedFile == NULL)
 	{
+		LOG_ERROR("File device '%s' not opened", m_FileName);
 		return false;
 	}
-	pcap_freecode(&prog);
-
-	m_CurFilter = filterAsString;
-	m_BpfLinkType = -1;
-	return true;
-}
 
-void PcapNgFileReaderDevice::close()
-{
-	if (m_LightPcapNg == NULL)
-		return;
-
-	light_pcapng_close((light_pcapng_t*)m_LightPcapNg);
-	if (m_BpfInitialized)
-		pcap_freecode(&m_Bpf);
-	m_LightPcapNg = NULL;
-	m_DeviceOpened = false;
-	LOG_DEBUG("File reader closed for file '%s'", m_FileName);
-}
-
-
-std::string PcapNgFileReaderDevice::getOS() const
-{
-	if (m_LightPcapNg == NULL)
+	if (m_MappedFileSize - m_NextRecordOffset < sizeof(packet_header))
 	{
-		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
-		return "";
+		if (m_NextRecordOffset != m_MappedFileSize)
+			LOG_DEBUG("File '%s' ends with a truncated record header", m_FileName);
+		else
+			LOG_DEBUG("Packet could not be read. Probably end-of-file");
+		return false;
 	}
 
-	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
-	char* res = fileInfo->os_desc;
-	size_t len = fileInfo->os_desc_size;
-	if (len == 0 || res == NULL)
-		return "";
-
-	return std::string(res, len);
-}
+	packet_header recordHeader;
+	parseRecordHeader(m_MappedFile + m_NextRecordOffset, m_SwapByteOrder, recordHeader);
 
-std::string PcapNgFileReaderDevice::getHardware() const
-{
-	if (m_LightPcapNg == NULL)
+	if (recordHeader.caplen > PCAP_MAX_RECORD_LENGTH && recordHeader.caplen > m_SnapshotLength)
 	{
-		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
-		return "";
+		LOG_ERROR("File '%s' has a corrupt record with captured length %u", m_FileName, recordHeader.caplen);
+		return false;
 	}
 
-	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
-	char* res = fileInfo->hardware_desc;
-	size_t len = fileInfo->hardware_desc_size;
-	if (len == 0 || res == NULL)
-		return "";
-
-	return std::string(res, len);
-}
-
-std::string PcapNgFileReaderDevice::getCaptureApplication() const
-{
-	if (m_LightPcapNg == NULL)
+	uint64_t packetDataOffset = m_NextRecordOffset + sizeof(packet_header);
+	if (m_MappedFileSize - packetDataOffset < recordHeader.caplen)
 	{
-		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
-		return "";
+		LOG_DEBUG("File '%s' ends with a truncated record", m_FileName);
+		return false;
 	}
 
-	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
-	char* res = fileInfo->user_app_desc;
-	size_t len = fileInfo->user_app_desc_size;
-	if (len == 0 || res == NULL)
-		return "";
+	pRawData = m_MappedFile + packetDataOffset;
+	rawDataLen = (int)recordHeader.caplen;
+	frameLength = (int)recordHeader.len;
+	timestamp.tv_sec = recordHeader.tv_sec;
+	timestamp.tv_nsec = (m_NanosecPrecision ? recordHeader.tv_usec : recordHeader.tv_usec * 1000);
+	layerType = m_PcapLinkLayerType;
 
-	return std::string(res, len);
+	m_NextRecordOffset = packetDataOffset + recordHeader.caplen;
+	m_NumOfPacketsRead++;
+	return true;
 }
 
-std::string PcapNgFileReaderDevice::getCaptureFileComment() const
+bool MmapPcapFileReaderDevice::getNextPacket(RawPacket& rawPacket)
 {
-	if (m_LightPcapNg == NULL)
+	const uint8_t* pPacketData = NULL;
+	int packetDataLen = 0;
+	int frameLength = 0;
+	timespec timestamp;
+	LinkLayerType layerType = LINKTYPE_ETHERNET;
+	if (!getNextPacketData(pPacketData, packetDataLen, frameLength, timestamp, layerType))
+		return false;
+
+	if (!rawPacket.initWithRawData(pPacketData, packetDataLen, timestamp, layerType, frameLength))
 	{
-		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
-		return "";
+		LOG_ERROR("Couldn't set data to raw packet");
+		return false;
 	}
 
-	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
-	char* res = fileInfo->file_comment;
-	size_t len = fileInfo->file_comment_size;
-	if (len == 0 || res == NULL)
-		return "";
-
-	return std::string(res, len);
+	return true;
 }
 
 
-// ~~~~~~~~~~~~~~~~~~~~~~~~~
-// IFileWriterDevice members
-// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// BufferedPcapFileReaderDevice members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-IFileWriterDevice:: IFileWriterDevice(const char* fileName) : IFileDevice(fileName)
+#define BUFFERED_READER_DEFAULT_BUFFER_SIZE (4 * 1024 * 1024)
+#define BUFFERED_READER_DEFAULT_NUM_OF_BUFFERS 4
+
+BufferedPcapFileReaderDevice::BufferedPcapFileReaderDevice(const char* fileName, const BufferedPcapFileReaderConfiguration& config) :
+	IFileReaderDevice(fileName), m_Config(config)
 {
-	m_NumOfPacketsNotWritten = 0;
-	m_NumOfPacketsWritten = 0;
+	m_Fd = -1;
+	m_FileSize = 0;
+	m_BufferSize = getBufferedDeviceBufferSize(config.bufferSize, BUFFERED_READER_DEFAULT_BUFFER_SIZE);
+
+	size_t numOfBuffers = (config.numOfBuffers > 0 ? config.numOfBuffers : BUFFERED_READER_DEFAULT_NUM_OF_BUFFERS);
+	if (numOfBuffers < 2)
+		numOfBuffers = 2;
+	ReadBuffer emptyBuffer;
+	memset(&emptyBuffer, 0, sizeof(emptyBuffer));
+	m_Buffers.assign(numOfBuffers, emptyBuffer);
+
+	m_CurrentChunk = 0;
+	m_ChunkOffset = 0;
+	m_NextChunkToRead = 0;
+	m_SpanBuffer = NULL;
+	m_EndOfFile = false;
+	m_PcapLinkLayerType = LINKTYPE_ETHERNET;
+	m_SwapByteOrder = false;
+	m_NanosecPrecision = false;
+	m_SnapshotLength = 0;
+	m_IoUring = NULL;
 }
 
-
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-// PcapFileWriterDevice members
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
-PcapFileWriterDevice::PcapFileWriterDevice(const char* fileName, LinkLayerType linkLayerType) : IFileWriterDevice(fileName)
+BufferedPcapFileReaderDevice::~BufferedPcapFileReaderDevice()
 {
-	m_PcapDumpHandler = NULL;
-	m_NumOfPacketsNotWritten = 0;
-	m_NumOfPacketsWritten = 0;
-	m_PcapLinkLayerType = linkLayerType;
-	m_AppendMode = false;
-	m_File = NULL;
+	close();
+
+	for (std::vector<ReadBuffer>::iterator iter = m_Buffers.begin(); iter != m_Buffers.end(); ++iter)
+		free(iter->data);
+	delete [] m_SpanBuffer;
 }
 
-void PcapFileWriterDevice::closeFile()
+bool BufferedPcapFileReaderDevice::open()
 {
-	if (m_AppendMode && m_File != NULL)
+	if (m_Fd >= 0)
 	{
-		fclose(m_File);
-		m_File = NULL;
+		LOG_DEBUG("File already opened. Nothing to do");
+		return true;
 	}
-}
 
-bool PcapFileWriterDevice::writePacket(RawPacket const& packet)
-{
-	if ((!m_AppendMode && m_PcapDescriptor == NULL) || (m_PcapDumpHandler == NULL))
+#if defined(WIN32) || defined(WINx64) || defined(PCAPPP_MINGW_ENV)
+	LOG_ERROR("Buffered pcap file reading isn't supported on this platform");
+	return false;
+#else
+	m_NumOfPacketsRead = 0;
+	m_NumOfPacketsNotParsed = 0;
+
+	for (std::vector<ReadBuffer>::iterator iter = m_Buffers.begin(); iter != m_Buffers.end(); ++iter)
 	{
-		LOG_ERROR("Device not opened");
-		m_NumOfPacketsNotWritten++;
-		return false;
+		if (iter->data == NULL && posix_memalign((void**)&iter->data, BUFFERED_DEVICE_ALIGNMENT, m_BufferSize) != 0)
+		{
+			iter->data = NULL;
+			LOG_ERROR("Cannot allocate a read buffer of %d bytes", (int)m_BufferSize);
+			return false;
+		}
 	}
 
-	if (packet.getLinkLayerType() != m_PcapLinkLayerType)
+	if (m_SpanBuffer == NULL)
+		m_SpanBuffer = new uint8_t[sizeof(packet_header) + PCAP_MAX_RECORD_LENGTH];
+
+	m_Fd = ::open(m_FileName, O_RDONLY);
+	if (m_Fd < 0)
 	{
-		LOG_ERROR("Cannot write a packet with a different link layer type");
-		m_NumOfPacketsNotWritten++;
+		LOG_ERROR("Cannot open file reader device for filename '%s': %s", m_FileName, strerror(errno));
 		return false;
 	}
 
-	pcap_pkthdr pktHdr;
-	pktHdr.caplen = ((RawPacket&)packet).getRawDataLen();
-	pktHdr.len = ((RawPacket&)packet).getFrameLength();
-	timespec packet_timestamp = ((RawPacket&)packet).getPacketTimeStamp();
-	TIMESPEC_TO_TIMEVAL(&pktHdr.ts, &packet_timestamp);
-	if (!m_AppendMode)
-		pcap_dump((uint8_t*)m_PcapDumpHandler, &pktHdr, ((RawPacket&)packet).getRawData());
-	else
+	struct stat fileStat;
+	if (fstat(m_Fd, &fileStat) != 0)
 	{
-		// Below are actually the lines run by pcap_dump. The reason I had to put them instead pcap_dump is that on Windows using WinPcap/Npcap
-		// you can't pass pointers between libraries compiled with different compilers. In this case - PcapPlusPlus and WinPcap/Npcap weren't
-		// compiled with the same compiler so it's impossible to fopen a file in PcapPlusPlus, pass the pointer to WinPcap/Npcap and use the
-		// FILE* pointer there. Doing this throws an exception. So the only option when implementing append to pcap is to write all relevant
-		// WinPcap/Npcap code that handles opening/closing/writing to pcap files inside PcapPlusPlus code
-
-		// the reason to create this packet_header struct is timeval has different sizes in 32-bit and 64-bit systems,
-		// but pcap format uses the 32-bit timeval version, so we need to align timeval to that
-		packet_header pktHdrTemp;
-		pktHdrTemp.tv_sec = pktHdr.ts.tv_sec;
-		pktHdrTemp.tv_usec = pktHdr.ts.tv_usec;
-		pktHdrTemp.caplen = pktHdr.caplen;
-		pktHdrTemp.len = pktHdr.len;
-		fwrite(&pktHdrTemp, sizeof(pktHdrTemp), 1, m_File);
-		fwrite(((RawPacket&)packet).getRawData(), pktHdrTemp.caplen, 1, m_File);
+		LOG_ERROR("Cannot get the size of file '%s': %s", m_FileName, strerror(errno));
+		close();
+		return false;
 	}
-	LOG_DEBUG("Packet written successfully to '%s'", m_FileName);
-	m_NumOfPacketsWritten++;
-	return true;
-}
 
-bool PcapFileWriterDevice::writePackets(const RawPacketVector& packets)
-{
-	for (RawPacketVector::ConstVectorIterator iter = packets.begin(); iter != packets.end(); iter++)
+	m_FileSize = (uint64_t)fileStat.st_size;
+	if (m_FileSize < sizeof(pcap_file_header))
 	{
-		if (!writePacket(**iter))
-			return false;
+		LOG_ERROR("File '%s' is too short to be a pcap file", m_FileName);
+		close();
+		return false;
 	}
 
-	return true;
-}
-
-bool PcapFileWriterDevice::open()
-{
-	if (m_PcapDescriptor != NULL)
-	{
-		LOG_DEBUG("Pcap descriptor already opened. Nothing to do");
-		return true;
-	}
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(m_Fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 
-	switch(m_PcapLinkLayerType)
+	if (m_Config.useIoUring)
 	{
-		case LINKTYPE_RAW:
-		case LINKTYPE_DLT_RAW2:
-			LOG_ERROR("The only Raw IP link type supported in libpcap/WinPcap/Npcap is LINKTYPE_DLT_RAW1, please use that instead");
-			return false;
-		default:
-			break;
+		m_IoUring = new IoUringQueue();
+		if (!m_IoUring->init((unsigned int)m_Buffers.size()))
+		{
+			LOG_DEBUG("io_uring isn't available, reading file '%s' with blocking reads", m_FileName);
+			delete m_IoUring;
+			m_IoUring = NULL;
+		}
 	}
 
-	m_NumOfPacketsNotWritten = 0;
-	m_NumOfPacketsWritten = 0;
-
-	m_PcapDescriptor = pcap_open_dead(m_PcapLinkLayerType, PCPP_MAX_PACKET_SIZE);
-	if (m_PcapDescriptor == NULL)
+	// all buffers are read ahead, the first chunk is parsed as soon as it's read
+	m_CurrentChunk = 0;
+	m_ChunkOffset = 0;
+	m_NextChunkToRead = 0;
+	m_EndOfFile = false;
+	for (size_t i = 0; i < m_Buffers.size(); i++)
+		readNextChunk(i);
+	waitForBuffer(0);
+
+	const uint8_t* fileHeader = readBytes(sizeof(pcap_file_header));
+	if (fileHeader == NULL)
 	{
-		LOG_ERROR("Error opening file writer device for file '%s': pcap_open_dead returned NULL", m_FileName);
-		m_DeviceOpened = false;
+		LOG_ERROR("Cannot read pcap header from file '%s'", m_FileName);
+		close();
 		return false;
 	}
 
-
-	m_PcapDumpHandler = pcap_dump_open(m_PcapDescriptor, m_FileName);
-	if (m_PcapDumpHandler == NULL)
+	if (!parsePcapFileHeader(fileHeader, m_FileName, m_SwapByteOrder, m_NanosecPrecision, m_SnapshotLength, m_PcapLinkLayerType))
 	{
-		LOG_ERROR("Error opening file writer device for file '%s': pcap_dump_open returned NULL with error: '%s'",
-				m_FileName, pcap_geterr(m_PcapDescriptor));
-		m_DeviceOpened = false;
+		close();
 		return false;
 	}
 
+	LOG_DEBUG("Successfully opened buffered file reader device for filename '%s'%s", m_FileName, (m_IoUring != NULL ? " using io_uring" : ""));
 	m_DeviceOpened = true;
-	LOG_DEBUG("File writer device for file '%s' opened successfully", m_FileName);
 	return true;
+#endif
 }
 
-void PcapFileWriterDevice::flush()
+void BufferedPcapFileReaderDevice::close()
 {
-	if (!m_DeviceOpened)
+	if (m_Fd < 0)
 		return;
 
-	if (!m_AppendMode && pcap_dump_flush(m_PcapDumpHandler) == -1)
-	{
-		LOG_ERROR("Error while flushing the packets to file");
-	}
-	// in append mode it's impossible to use pcap_dump_flush, see comment above pcap_dump
-	else if (m_AppendMode && fflush(m_File) == EOF)
+	// the kernel may still be reading into the buffers
+	if (m_IoUring != NULL)
 	{
-		LOG_ERROR("Error while flushing the packets to file");
+		for (size_t i = 0; i < m_Buffers.size(); i++)
+			waitForBuffer(i);
+
+		delete m_IoUring;
+		m_IoUring = NULL;
 	}
 
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	::close(m_Fd);
+#endif
+	m_Fd = -1;
+	m_FileSize = 0;
+	m_DeviceOpened = false;
+	LOG_DEBUG("File reader closed for file '%s'", m_FileName);
 }
 
-void PcapFileWriterDevice::close()
+void BufferedPcapFileReaderDevice::getStatistics(pcap_stat& stats) const
 {
-	if (!m_DeviceOpened)
-		return;
-
-	flush();
+	stats.ps_recv = m_NumOfPacketsRead;
+	stats.ps_drop = m_NumOfPacketsNotParsed;
+	stats.ps_ifdrop = 0;
+	LOG_DEBUG("Statistics received for reader device for filename '%s'", m_FileName);
+}
 
-	IFileDevice::close();
+void BufferedPcapFileReaderDevice::readNextChunk(size_t bufferIndex)
+{
+	ReadBuffer& buffer = m_Buffers[bufferIndex];
+	buffer.offset = m_NextChunkToRead * m_BufferSize;
+	buffer.length = 0;
+	buffer.ready = true;
+	m_NextChunkToRead++;
+
+	// chunks past the end of the file are left empty
+	if (buffer.offset >= m_FileSize)
+		return;
 
-	if (!m_AppendMode && m_PcapDumpHandler != NULL)
-	{
-		pcap_dump_close(m_PcapDumpHandler);
-	}
-	else if (m_AppendMode && m_File != NULL)
+	buffer.length = (m_FileSize - buffer.offset < m_BufferSize ? (size_t)(m_FileSize - buffer.offset) : m_BufferSize);
+	// each read is submitted on its own, so if submitting fails it's known to be this one which is then read with a blocking read
+	if (m_IoUring != NULL && m_IoUring->queueRead(m_Fd, buffer.data, buffer.length, buffer.offset, bufferIndex) && m_IoUring->submit())
 	{
-		// in append mode it's impossible to use pcap_dump_close, see comment above pcap_dump
-		fclose(m_File);
+		buffer.ready = false;
+		return;
 	}
 
-	m_PcapDumpHandler = NULL;
-	m_File = NULL;
-	LOG_DEBUG("File writer closed for file '%s'", m_FileName);
+	buffer.length = readFromFile(m_Fd, m_FileName, buffer.data, buffer.length, buffer.offset);
+}
+
+void BufferedPcapFileReaderDevice::waitForBuffer(size_t bufferIndex)
+{
+	while (!m_Buffers[bufferIndex].ready)
+	{
+		uint64_t completedIndex = 0;
+		int result = 0;
+		if (!m_IoUring->waitForCompletion(completedIndex, result))
+		{
+			// the ring is broken, the buffer is considered empty which ends reading the file
+			m_Buffers[bufferIndex].ready = true;
+			m_Buffers[bufferIndex].length = 0;
+			return;
+		}
+
+		ReadBuffer& buffer = m_Buffers[completedIndex];
+		buffer.ready = true;
+		if (result < 0)
+		{
+			LOG_ERROR("Error while reading file '%s': %s", m_FileName, strerror(-result));
+			buffer.length = 0;
+		}
+		else if ((size_t)result < buffer.length)
+		{
+			// the rest of a short read is read with a blocking read
+			buffer.length = (size_t)result + readFromFile(m_Fd, m_FileName, buffer.data + result, buffer.length - result, buffer.offset + result);
+		}
+	}
+}
+
+bool BufferedPcapFileReaderDevice::advanceChunk()
+{
+	// the buffer of the chunk that was just parsed is reused for reading ahead
+	size_t numOfBuffers = m_Buffers.size();
+	readNextChunk((size_t)(m_CurrentChunk % numOfBuffers));
+
+	m_CurrentChunk++;
+	m_ChunkOffset = 0;
+
+	size_t bufferIndex = (size_t)(m_CurrentChunk % numOfBuffers);
+	waitForBuffer(bufferIndex);
+	return m_Buffers[bufferIndex].length > 0;
+}
+
+const uint8_t* BufferedPcapFileReaderDevice::readBytes(size_t count)
+{
+	const ReadBuffer* buffer = &m_Buffers[m_CurrentChunk % m_Buffers.size()];
+	size_t available = buffer->length - m_ChunkOffset;
+	if (count <= available)
+	{
+		const uint8_t* result = buffer->data + m_ChunkOffset;
+		m_ChunkOffset += count;
+		return result;
+	}
+
+	// a chunk shorter than the buffer is the last one
+	if (buffer->length < m_BufferSize)
+		return NULL;
+
+	// the bytes continue in the next chunk. The part in this chunk is copied before its buffer is reused
+	memcpy(m_SpanBuffer, buffer->data + m_ChunkOffset, available);
+	if (!advanceChunk())
+		return NULL;
+
+	buffer = &m_Buffers[m_CurrentChunk % m_Buffers.size()];
+	size_t rest = count - available;
+	if (rest > buffer->length)
+		return NULL;
+
+	m_ChunkOffset = rest;
+	if (available == 0)
+		return buffer->data;
+
+	memcpy(m_SpanBuffer + available, buffer->data, rest);
+	return m_SpanBuffer;
+}
+
+bool BufferedPcapFileReaderDevice::getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType)
+{
+	if (m_Fd < 0)
+	{
+		LOG_ERROR("File device '%s' not opened", m_FileName);
+		return false;
+	}
+
+	if (m_EndOfFile || m_CurrentChunk * m_BufferSize + m_ChunkOffset >= m_FileSize)
+	{
+		m_EndOfFile = true;
+		LOG_DEBUG("Packet could not be read. Probably end-of-file");
+		return false;
+	}
+
+	const uint8_t* recordHeaderData = readBytes(sizeof(packet_header));
+	if (recordHeaderData == NULL)
+	{
+		m_EndOfFile = true;
+		LOG_DEBUG("File '%s' ends with a truncated record header", m_FileName);
+		return false;
+	}
+
+	packet_header recordHeader;
+	parseRecordHeader(recordHeaderData, m_SwapByteOrder, recordHeader);
+
+	// records that long can't be held while they cross from one buffer to the next, and are almost always a sign of a corrupt file
+	if (recordHeader.caplen > PCAP_MAX_RECORD_LENGTH)
+	{
+		m_EndOfFile = true;
+		LOG_ERROR("File '%s' has a corrupt record with captured length %u", m_FileName, recordHeader.caplen);
+		return false;
+	}
+
+	const uint8_t* packetData = readBytes(recordHeader.caplen);
+	if (packetData == NULL)
+	{
+		m_EndOfFile = true;
+		LOG_DEBUG("File '%s' ends with a truncated record", m_FileName);
+		return false;
+	}
+
+	pRawData = packetData;
+	rawDataLen = (int)recordHeader.caplen;
+	frameLength = (int)recordHeader.len;
+	timestamp.tv_sec = recordHeader.tv_sec;
+	timestamp.tv_nsec = (m_NanosecPrecision ? recordHeader.tv_usec : recordHeader.tv_usec * 1000);
+	layerType = m_PcapLinkLayerType;
+	m_NumOfPacketsRead++;
+	return true;
+}
+
+bool BufferedPcapFileReaderDevice::getNextPacket(RawPacket& rawPacket)
+{
+	rawPacket.clear();
+
+	const uint8_t* pPacketData = NULL;
+	int packetDataLen = 0;
+	int frameLength = 0;
+	timespec timestamp;
+	LinkLayerType layerType = LINKTYPE_ETHERNET;
+	if (!getNextPacketData(pPacketData, packetDataLen, frameLength, timestamp, layerType))
+		return false;
+
+	// the buffers are reused, so the packet gets its own copy of the data
+	uint8_t* pMyPacketData = new uint8_t[packetDataLen];
+	memcpy(pMyPacketData, pPacketData, packetDataLen);
+	if (!rawPacket.setRawData(pMyPacketData, packetDataLen, timestamp, layerType, frameLength))
+	{
+		LOG_ERROR("Couldn't set data to raw packet");
+		return false;
+	}
+
+	return true;
+}
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// ParallelPcapFileReader members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define PARALLEL_READER_DEFAULT_CHUNK_SIZE (64 * 1024 * 1024)
+#define PARALLEL_READER_MIN_CHUNK_SIZE (1024 * 1024)
+// a chunk border found by scanning is accepted only if this many consecutive record headers starting there look valid (or the records
+// reach the end of the file exactly)
+#define PARALLEL_READER_RESYNC_NUM_OF_RECORDS 8
+// consecutive records of a capture are expected to be less than a day apart
+#define PARALLEL_READER_RESYNC_MAX_TIME_GAP 86400
+// the end offset of a chunk that wasn't walked yet
+#define PARALLEL_READER_CHUNK_NOT_WALKED ((uint64_t)-1)
+
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+
+struct ParallelPcapFileReader::ReadContext
+{
+	// a record parsed by a worker, waiting to be delivered on the calling thread in preserve-order mode or until the border of its chunk is
+	// confirmed otherwise
+	struct ParsedRecord
+	{
+		uint64_t dataOffset;
+		uint32_t caplen;
+		uint32_t len;
+		timespec timestamp;
+	};
+
+	// the records of a chunk in preserve-order mode. The slots are reused for the chunks in turn, and the record vectors keep their capacity
+	struct ChunkSlot
+	{
+		std::vector<ParsedRecord> records;
+		// the chunk whose records are ready in the slot
+		size_t chunkIndex;
+		size_t workerId;
+		bool failed;
+	};
+
+	struct Worker
+	{
+		ReadContext* context;
+		size_t id;
+		pthread_t thread;
+		// the records of the chunk the worker parsed, if its border isn't confirmed yet
+		std::vector<ParsedRecord> records;
+	};
+
+	ParallelPcapFileReader* reader;
+	OnPacketArrives onPacketArrives;
+	void* userCookie;
+	size_t numOfChunks;
+	// the next chunk a worker takes, incremented atomically
+	size_t nextChunk;
+	volatile bool stopRequested;
+	volatile bool readFailed;
+	std::vector<Worker> workers;
+
+	// the borders that aren't verified are confirmed in turn as the chunks are walked: a chunk starts at a record if the chunk before it
+	// does, and the walk of that chunk ended exactly where this one starts
+	bool bordersVerified;
+	std::vector<uint64_t> chunkEnds;
+	std::vector<uint8_t> chunkCorrupt;
+	size_t numOfConfirmedChunks;
+	// the first chunk found not to start at a record, or 0 if none was found
+	size_t wrongBorder;
+
+	// used in preserve-order mode only: a worker may parse a chunk only when its slot was delivered, so the workers are at most one slot
+	// per worker ahead of the calling thread
+	std::vector<ChunkSlot> slots;
+	size_t numOfChunksDelivered;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+};
+
+#endif
+
+ParallelPcapFileReader::ParallelPcapFileReader(const char* fileName, const ParallelPcapFileReaderConfiguration& config) : m_FileName(fileName), m_Config(config)
+{
+	m_NumOfWorkers = config.numOfWorkers;
+	if (m_NumOfWorkers == 0)
+		m_NumOfWorkers = (size_t)getNumOfCores();
+	if (m_NumOfWorkers == 0)
+		m_NumOfWorkers = 1;
+
+	m_ChunkSize = (config.chunkSize > 0 ? config.chunkSize : PARALLEL_READER_DEFAULT_CHUNK_SIZE);
+	if (m_ChunkSize < PARALLEL_READER_MIN_CHUNK_SIZE)
+		m_ChunkSize = PARALLEL_READER_MIN_CHUNK_SIZE;
+
+	m_MappedFile = NULL;
+	m_MappedFileSize = 0;
+	m_PcapLinkLayerType = LINKTYPE_ETHERNET;
+	m_SwapByteOrder = false;
+	m_NanosecPrecision = false;
+	m_SnapshotLength = 0;
+	m_ChunkOffsetsVerified = false;
+	m_NumOfPacketsReadPerWorker.assign(m_NumOfWorkers, 0);
+}
+
+ParallelPcapFileReader::~ParallelPcapFileReader()
+{
+	close();
+}
+
+bool ParallelPcapFileReader::open()
+{
+	if (m_MappedFile != NULL)
+	{
+		LOG_DEBUG("File already mapped. Nothing to do");
+		return true;
+	}
+
+	m_ChunkOffsets.clear();
+	m_ChunkOffsetsVerified = false;
+
+#if defined(WIN32) || defined(WINx64) || defined(PCAPPP_MINGW_ENV)
+	LOG_ERROR("Memory-mapping pcap files isn't supported on this platform");
+	return false;
+#else
+	int fd = ::open(m_FileName.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		LOG_ERROR("Cannot open parallel file reader for filename '%s': %s", m_FileName.c_str(), strerror(errno));
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		LOG_ERROR("Cannot get the size of file '%s': %s", m_FileName.c_str(), strerror(errno));
+		::close(fd);
+		return false;
+	}
+
+	if ((uint64_t)fileStat.st_size < sizeof(pcap_file_header))
+	{
+		LOG_ERROR("File '%s' is too short to be a pcap file", m_FileName.c_str());
+		::close(fd);
+		return false;
+	}
+
+	void* mappedFile = mmap(NULL, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mappedFile == MAP_FAILED)
+	{
+		LOG_ERROR("Cannot map file '%s' to memory: %s", m_FileName.c_str(), strerror(errno));
+		return false;
+	}
+
+	m_MappedFile = (uint8_t*)mappedFile;
+	m_MappedFileSize = (uint64_t)fileStat.st_size;
+
+	if (!parsePcapFileHeader(m_MappedFile, m_FileName.c_str(), m_SwapByteOrder, m_NanosecPrecision, m_SnapshotLength, m_PcapLinkLayerType))
+	{
+		close();
+		return false;
+	}
+
+	LOG_DEBUG("Successfully mapped parallel file reader for filename '%s'", m_FileName.c_str());
+	return true;
+#endif
+}
+
+void ParallelPcapFileReader::close()
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	if (m_MappedFile != NULL)
+	{
+		munmap(m_MappedFile, (size_t)m_MappedFileSize);
+		LOG_DEBUG("Successfully unmapped parallel file reader for filename '%s'", m_FileName.c_str());
+	}
+#endif
+
+	m_MappedFile = NULL;
+	m_MappedFileSize = 0;
+	m_ChunkOffsets.clear();
+	m_ChunkOffsetsVerified = false;
+}
+
+bool ParallelPcapFileReader::buildIndex()
+{
+	if (m_MappedFile == NULL)
+	{
+		LOG_ERROR("File '%s' not opened", m_FileName.c_str());
+		return false;
+	}
+
+	return buildIndexFrom(0, sizeof(pcap_file_header));
+}
+
+bool ParallelPcapFileReader::buildIndexFrom(size_t firstChunk, uint64_t offset)
+{
+	// the borders before the first chunk are kept, and the first chunk starts at the given offset which must be at a record
+	m_ChunkOffsets.resize(firstChunk);
+	if (firstChunk == 0 || offset < m_MappedFileSize)
+		m_ChunkOffsets.push_back(offset);
+
+	// a chunk starts at the first record at or after each multiple of the chunk size, as when the borders are found by scanning
+	uint64_t nominalOffset = sizeof(pcap_file_header) + ((offset - sizeof(pcap_file_header)) / m_ChunkSize + 1) * m_ChunkSize;
+	while (offset < m_MappedFileSize && m_MappedFileSize - offset >= sizeof(packet_header))
+	{
+		packet_header recordHeader;
+		parseRecordHeader(m_MappedFile + offset, m_SwapByteOrder, recordHeader);
+		if (recordHeader.caplen > PCAP_MAX_RECORD_LENGTH && recordHeader.caplen > m_SnapshotLength)
+		{
+			LOG_ERROR("File '%s' has a corrupt record with captured length %u at offset %llu", m_FileName.c_str(), recordHeader.caplen, (unsigned long long)offset);
+			m_ChunkOffsets.clear();
+			m_ChunkOffsetsVerified = false;
+			return false;
+		}
+
+		offset += sizeof(packet_header) + recordHeader.caplen;
+		if (offset >= nominalOffset && offset < m_MappedFileSize)
+			m_ChunkOffsets.push_back(offset);
+		while (nominalOffset <= offset)
+			nominalOffset += m_ChunkSize;
+	}
+
+	m_ChunkOffsetsVerified = true;
+	LOG_DEBUG("Built an index of %d chunks for file '%s'", (int)m_ChunkOffsets.size(), m_FileName.c_str());
+	return true;
+}
+
+bool ParallelPcapFileReader::setIndex(const std::vector<uint64_t>& chunkOffsets)
+{
+	if (m_MappedFile == NULL)
+	{
+		LOG_ERROR("File '%s' not opened", m_FileName.c_str());
+		return false;
+	}
+
+	if (chunkOffsets.empty() || chunkOffsets.front() != sizeof(pcap_file_header))
+	{
+		LOG_ERROR("The index of file '%s' must start at the end of the file header", m_FileName.c_str());
+		return false;
+	}
+
+	for (size_t i = 1; i < chunkOffsets.size(); i++)
+	{
+		if (chunkOffsets[i] <= chunkOffsets[i - 1] || chunkOffsets[i] >= m_MappedFileSize)
+		{
+			LOG_ERROR("The index of file '%s' has an invalid offset %llu", m_FileName.c_str(), (unsigned long long)chunkOffsets[i]);
+			return false;
+		}
+	}
+
+	m_ChunkOffsets = chunkOffsets;
+	m_ChunkOffsetsVerified = false;
+	return true;
+}
+
+uint64_t ParallelPcapFileReader::getNumOfPacketsRead() const
+{
+	uint64_t numOfPacketsRead = 0;
+	for (std::vector<uint64_t>::const_iterator iter = m_NumOfPacketsReadPerWorker.begin(); iter != m_NumOfPacketsReadPerWorker.end(); ++iter)
+		numOfPacketsRead += *iter;
+
+	return numOfPacketsRead;
+}
+
+uint64_t ParallelPcapFileReader::getNumOfPacketsRead(size_t workerId) const
+{
+	return m_NumOfPacketsReadPerWorker[workerId];
+}
+
+bool ParallelPcapFileReader::isRecordBorder(uint64_t offset) const
+{
+	uint32_t maxCaptureLength = (m_SnapshotLength > PCAP_MAX_RECORD_LENGTH ? m_SnapshotLength : PCAP_MAX_RECORD_LENGTH);
+	uint32_t maxFraction = (m_NanosecPrecision ? 1000000000 : 1000000);
+	uint32_t firstTimestamp = 0;
+
+	for (int i = 0; i < PARALLEL_READER_RESYNC_NUM_OF_RECORDS; i++)
+	{
+		if (offset == m_MappedFileSize)
+			return (i > 0);
+
+		if (m_MappedFileSize - offset < sizeof(packet_header))
+			return false;
+
+		// a frame is never empty, which also rules out runs of zeros inside packet data
+		packet_header recordHeader;
+		parseRecordHeader(m_MappedFile + offset, m_SwapByteOrder, recordHeader);
+		if (recordHeader.len == 0 || recordHeader.caplen > recordHeader.len || recordHeader.caplen > maxCaptureLength || recordHeader.tv_usec >= maxFraction)
+			return false;
+
+		if (i == 0)
+			firstTimestamp = recordHeader.tv_sec;
+		else if ((recordHeader.tv_sec > firstTimestamp ? recordHeader.tv_sec - firstTimestamp : firstTimestamp - recordHeader.tv_sec) > PARALLEL_READER_RESYNC_MAX_TIME_GAP)
+			return false;
+
+		offset += sizeof(packet_header) + recordHeader.caplen;
+		if (offset > m_MappedFileSize)
+			return false;
+	}
+
+	return true;
+}
+
+void ParallelPcapFileReader::findChunkBorders()
+{
+	m_ChunkOffsets.clear();
+	m_ChunkOffsets.push_back(sizeof(pcap_file_header));
+	m_ChunkOffsetsVerified = false;
+
+	for (uint64_t nominalOffset = sizeof(pcap_file_header) + m_ChunkSize; nominalOffset < m_MappedFileSize; nominalOffset += m_ChunkSize)
+	{
+		// a record is much shorter than a chunk, so a border is normally found right after the nominal offset. If none is found the chunk
+		// is merged with the previous one
+		uint64_t scanLimit = (m_MappedFileSize - nominalOffset > m_ChunkSize ? nominalOffset + m_ChunkSize : m_MappedFileSize);
+		for (uint64_t offset = nominalOffset; offset < scanLimit; offset++)
+		{
+			if (isRecordBorder(offset))
+			{
+				m_ChunkOffsets.push_back(offset);
+				break;
+			}
+		}
+	}
+
+	LOG_DEBUG("Found %d chunks in file '%s'", (int)m_ChunkOffsets.size(), m_FileName.c_str());
+}
+
+bool ParallelPcapFileReader::readChunk(size_t chunkIndex, size_t workerId, ReadContext* context)
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	uint64_t offset = m_ChunkOffsets[chunkIndex];
+	uint64_t endOffset = (chunkIndex + 1 < m_ChunkOffsets.size() ? m_ChunkOffsets[chunkIndex + 1] : m_MappedFileSize);
+
+	// start reading the whole chunk from the disk, instead of page by page as the records are parsed
+	uint64_t adviseOffset = offset / BUFFERED_DEVICE_ALIGNMENT * BUFFERED_DEVICE_ALIGNMENT;
+	madvise(m_MappedFile + adviseOffset, (size_t)(endOffset - adviseOffset), MADV_WILLNEED);
+
+	// the packets are delivered right away only if the chunk is known to start at a record. Otherwise they wait until the chunk before it
+	// confirms that, and in preserve-order mode they wait for the calling thread anyway
+	std::vector<ReadContext::ParsedRecord>* parsedRecords = NULL;
+	if (m_Config.preserveOrder)
+		parsedRecords = &context->slots[chunkIndex % context->slots.size()].records;
+	else if (!context->bordersVerified)
+		parsedRecords = &context->workers[workerId].records;
+
+	if (parsedRecords != NULL)
+		parsedRecords->clear();
+
+	RawPacket rawPacket;
+	uint64_t numOfPacketsRead = 0;
+	bool result = true;
+	while (offset < endOffset)
+	{
+		// a truncated record can only be at the end of the file, so the walk ends at the end of the file as the last chunk does
+		if (m_MappedFileSize - offset < sizeof(packet_header))
+		{
+			LOG_DEBUG("File '%s' ends with a truncated record header", m_FileName.c_str());
+			offset = m_MappedFileSize;
+			break;
+		}
+
+		packet_header recordHeader;
+		parseRecordHeader(m_MappedFile + offset, m_SwapByteOrder, recordHeader);
+		if (recordHeader.caplen > PCAP_MAX_RECORD_LENGTH && recordHeader.caplen > m_SnapshotLength)
+		{
+			LOG_DEBUG("File '%s' has a corrupt record with captured length %u at offset %llu", m_FileName.c_str(), recordHeader.caplen, (unsigned long long)offset);
+			result = false;
+			break;
+		}
+
+		uint64_t dataOffset = offset + sizeof(packet_header);
+		if (m_MappedFileSize - dataOffset < recordHeader.caplen)
+		{
+			LOG_DEBUG("File '%s' ends with a truncated record", m_FileName.c_str());
+			offset = m_MappedFileSize;
+			break;
+		}
+
+		timespec timestamp;
+		timestamp.tv_sec = recordHeader.tv_sec;
+		timestamp.tv_nsec = (m_NanosecPrecision ? recordHeader.tv_usec : recordHeader.tv_usec * 1000);
+
+		if (parsedRecords != NULL)
+		{
+			ReadContext::ParsedRecord parsedRecord;
+			parsedRecord.dataOffset = dataOffset;
+			parsedRecord.caplen = recordHeader.caplen;
+			parsedRecord.len = recordHeader.len;
+			parsedRecord.timestamp = timestamp;
+			parsedRecords->push_back(parsedRecord);
+		}
+		else
+		{
+			rawPacket.initWithRawData(m_MappedFile + dataOffset, (int)recordHeader.caplen, timestamp, m_PcapLinkLayerType, (int)recordHeader.len);
+			context->onPacketArrives(workerId, rawPacket, context->userCookie);
+			numOfPacketsRead++;
+		}
+
+		offset = dataOffset + recordHeader.caplen;
+	}
+
+	context->chunkEnds[chunkIndex] = offset;
+	context->chunkCorrupt[chunkIndex] = (result ? 0 : 1);
+	// the parsed records are counted when they're delivered
+	if (parsedRecords == NULL)
+		m_NumOfPacketsReadPerWorker[workerId] += numOfPacketsRead;
+	return result;
+#else
+	return false;
+#endif
+}
+
+void ParallelPcapFileReader::confirmChunkBorders(ReadContext* context) const
+{
+	// a chunk starts at a record if the chunk before it does, and the walk of that chunk ended exactly where this one starts
+	while (context->numOfConfirmedChunks < context->numOfChunks && context->wrongBorder == 0)
+	{
+		size_t prevChunk = context->numOfConfirmedChunks - 1;
+		if (context->chunkEnds[prevChunk] == PARALLEL_READER_CHUNK_NOT_WALKED || context->chunkCorrupt[prevChunk])
+			break;
+
+		if (context->chunkEnds[prevChunk] != m_ChunkOffsets[context->numOfConfirmedChunks])
+		{
+			context->wrongBorder = context->numOfConfirmedChunks;
+			break;
+		}
+
+		context->numOfConfirmedChunks++;
+	}
+}
+
+void* ParallelPcapFileReader::workerThreadMain(void* workerPtr)
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	ReadContext::Worker* worker = (ReadContext::Worker*)workerPtr;
+	ReadContext* context = worker->context;
+	ParallelPcapFileReader* reader = context->reader;
+	bool preserveOrder = reader->m_Config.preserveOrder;
+
+	while (!context->stopRequested)
+	{
+		size_t chunkIndex = __sync_fetch_and_add(&context->nextChunk, 1);
+		if (chunkIndex >= context->numOfChunks)
+			break;
+
+		if (!preserveOrder && context->bordersVerified)
+		{
+			bool chunkRead = reader->readChunk(chunkIndex, worker->id, context);
+			uint64_t endOffset = (chunkIndex + 1 < context->numOfChunks ? reader->m_ChunkOffsets[chunkIndex + 1] : reader->m_MappedFileSize);
+			if (!chunkRead)
+				LOG_ERROR("Chunk #%d of file '%s' has a corrupt record", (int)chunkIndex, reader->m_FileName.c_str());
+			else if (context->chunkEnds[chunkIndex] != endOffset)
+				LOG_ERROR("Chunk #%d of file '%s' doesn't end where the next chunk starts, the index doesn't fit the file", (int)chunkIndex, reader->m_FileName.c_str());
+
+			if (!chunkRead || context->chunkEnds[chunkIndex] != endOffset)
+			{
+				context->readFailed = true;
+				context->stopRequested = true;
+			}
+
+			continue;
+		}
+
+		if (!preserveOrder)
+		{
+			// the chunk is parsed right away, but its packets are delivered only once it's known to start at a record
+			bool chunkRead = reader->readChunk(chunkIndex, worker->id, context);
+
+			pthread_mutex_lock(&context->mutex);
+			reader->confirmChunkBorders(context);
+			pthread_cond_broadcast(&context->cond);
+			while (!context->stopRequested && chunkIndex >= context->numOfConfirmedChunks && (context->wrongBorder == 0 || chunkIndex < context->wrongBorder))
+				pthread_cond_wait(&context->cond, &context->mutex);
+			bool confirmed = (!context->stopRequested && chunkIndex < context->numOfConfirmedChunks);
+			pthread_mutex_unlock(&context->mutex);
+
+			// the chunks from a wrong border onward are read again once the borders are found by walking the records
+			if (!confirmed)
+				break;
+
+			RawPacket rawPacket;
+			for (std::vector<ReadContext::ParsedRecord>::iterator iter = worker->records.begin(); iter != worker->records.end(); ++iter)
+			{
+				rawPacket.initWithRawData(reader->m_MappedFile + iter->dataOffset, (int)iter->caplen, iter->timestamp, reader->m_PcapLinkLayerType, (int)iter->len);
+				context->onPacketArrives(worker->id, rawPacket, context->userCookie);
+			}
+			reader->m_NumOfPacketsReadPerWorker[worker->id] += worker->records.size();
+
+			if (!chunkRead)
+			{
+				LOG_ERROR("Chunk #%d of file '%s' has a corrupt record", (int)chunkIndex, reader->m_FileName.c_str());
+				pthread_mutex_lock(&context->mutex);
+				context->readFailed = true;
+				context->stopRequested = true;
+				pthread_cond_broadcast(&context->cond);
+				pthread_mutex_unlock(&context->mutex);
+			}
+
+			continue;
+		}
+
+		// wait until the chunk that used the slot before was delivered
+		ReadContext::ChunkSlot& slot = context->slots[chunkIndex % context->slots.size()];
+		pthread_mutex_lock(&context->mutex);
+		while (!context->stopRequested && chunkIndex >= context->numOfChunksDelivered + context->slots.size())
+			pthread_cond_wait(&context->cond, &context->mutex);
+		pthread_mutex_unlock(&context->mutex);
+
+		if (context->stopRequested)
+			break;
+
+		bool chunkRead = reader->readChunk(chunkIndex, worker->id, context);
+
+		pthread_mutex_lock(&context->mutex);
+		slot.workerId = worker->id;
+		slot.failed = !chunkRead;
+		slot.chunkIndex = chunkIndex;
+		pthread_cond_broadcast(&context->cond);
+		pthread_mutex_unlock(&context->mutex);
+	}
+#endif
+
+	return NULL;
+}
+
+bool ParallelPcapFileReader::readPackets(OnPacketArrives onPacketArrives, void* userCookie)
+{
+	if (m_MappedFile == NULL)
+	{
+		LOG_ERROR("File '%s' not opened", m_FileName.c_str());
+		return false;
+	}
+
+	if (m_ChunkOffsets.empty())
+		findChunkBorders();
+
+	m_NumOfPacketsReadPerWorker.assign(m_NumOfWorkers, 0);
+
+	// if a border turns out not to be at a record, the packets before it were delivered and the borders of the rest of the file are found
+	// by walking its records, starting where the last delivered record ends
+	size_t firstChunk = 0;
+	while (true)
+	{
+		size_t wrongBorder = 0;
+		uint64_t resumeOffset = 0;
+		if (!readChunks(firstChunk, onPacketArrives, userCookie, wrongBorder, resumeOffset))
+			return false;
+
+		if (wrongBorder == 0)
+			break;
+
+		LOG_DEBUG("Chunk #%d of file '%s' doesn't start at a record, walking the records from offset %llu to find the rest of the borders",
+			(int)wrongBorder, m_FileName.c_str(), (unsigned long long)resumeOffset);
+		if (!buildIndexFrom(wrongBorder, resumeOffset))
+			return false;
+
+		firstChunk = wrongBorder;
+	}
+
+	// all borders were confirmed by the records of the chunks before them
+	m_ChunkOffsetsVerified = true;
+	LOG_DEBUG("Read %llu packets from file '%s' with %d workers", (unsigned long long)getNumOfPacketsRead(), m_FileName.c_str(), (int)m_NumOfWorkers);
+	return true;
+}
+
+bool ParallelPcapFileReader::readChunks(size_t firstChunk, OnPacketArrives onPacketArrives, void* userCookie, size_t& wrongBorder, uint64_t& resumeOffset)
+{
+#if defined(WIN32) || defined(WINx64) || defined(PCAPPP_MINGW_ENV)
+	return false;
+#else
+	std::vector<SystemCore> cores;
+	if (m_Config.coreMask != 0)
+	{
+		createCoreVectorFromCoreMask(m_Config.coreMask, cores);
+		if (cores.size() < m_NumOfWorkers)
+		{
+			LOG_ERROR("Core mask contains %d cores but there are %d workers", (int)cores.size(), (int)m_NumOfWorkers);
+			return false;
+		}
+	}
+
+	ReadContext context;
+	context.reader = this;
+	context.onPacketArrives = onPacketArrives;
+	context.userCookie = userCookie;
+	context.numOfChunks = m_ChunkOffsets.size();
+	context.nextChunk = firstChunk;
+	context.stopRequested = false;
+	context.readFailed = false;
+	context.bordersVerified = m_ChunkOffsetsVerified;
+	context.chunkEnds.assign(context.numOfChunks, PARALLEL_READER_CHUNK_NOT_WALKED);
+	context.chunkCorrupt.assign(context.numOfChunks, 0);
+	context.numOfConfirmedChunks = firstChunk + 1;
+	context.wrongBorder = 0;
+	context.numOfChunksDelivered = firstChunk;
+	if (m_Config.preserveOrder)
+	{
+		ReadContext::ChunkSlot emptySlot;
+		emptySlot.chunkIndex = (size_t)-1;
+		emptySlot.workerId = 0;
+		emptySlot.failed = false;
+		context.slots.assign(2 * m_NumOfWorkers, emptySlot);
+	}
+	pthread_mutex_init(&context.mutex, NULL);
+	pthread_cond_init(&context.cond, NULL);
+
+	context.workers.resize(m_NumOfWorkers);
+	size_t numOfWorkersStarted = 0;
+	for (; numOfWorkersStarted < m_NumOfWorkers; numOfWorkersStarted++)
+	{
+		ReadContext::Worker& worker = context.workers[numOfWorkersStarted];
+		worker.context = &context;
+		worker.id = numOfWorkersStarted;
+
+		int err = pthread_create(&worker.thread, NULL, workerThreadMain, &worker);
+		if (err != 0)
+		{
+			LOG_ERROR("Cannot create worker thread #%d: [%s]", (int)numOfWorkersStarted, strerror(err));
+			context.readFailed = true;
+			break;
+		}
+#ifdef LINUX
+		if (m_Config.coreMask != 0)
+		{
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			CPU_SET(cores[numOfWorkersStarted].Id, &cpuset);
+			if ((err = pthread_setaffinity_np(worker.thread, sizeof(cpu_set_t), &cpuset)) != 0)
+			{
+				LOG_ERROR("Error while binding worker thread #%d to core %d: errno=%i", (int)numOfWorkersStarted, (int)cores[numOfWorkersStarted].Id, err);
+				context.readFailed = true;
+				numOfWorkersStarted++;
+				break;
+			}
+		}
+#endif
+	}
+
+#ifndef LINUX
+	if (m_Config.coreMask != 0)
+		LOG_DEBUG("Binding worker threads to cores is supported on Linux only, the core mask is ignored");
+#endif
+
+	if (m_Config.preserveOrder && !context.readFailed)
+	{
+		// deliver the chunks in order as the workers finish parsing them
+		RawPacket rawPacket;
+		for (size_t chunkIndex = firstChunk; chunkIndex < context.numOfChunks; chunkIndex++)
+		{
+			ReadContext::ChunkSlot& slot = context.slots[chunkIndex % context.slots.size()];
+			pthread_mutex_lock(&context.mutex);
+			while (slot.chunkIndex != chunkIndex)
+				pthread_cond_wait(&context.cond, &context.mutex);
+			pthread_mutex_unlock(&context.mutex);
+
+			// the chunk before this one was delivered, so it's known whether this chunk starts at a record
+			if (chunkIndex > firstChunk && context.chunkEnds[chunkIndex - 1] != m_ChunkOffsets[chunkIndex])
+			{
+				context.wrongBorder = chunkIndex;
+				break;
+			}
+
+			for (std::vector<ReadContext::ParsedRecord>::iterator iter = slot.records.begin(); iter != slot.records.end(); ++iter)
+			{
+				rawPacket.initWithRawData(m_MappedFile + iter->dataOffset, (int)iter->caplen, iter->timestamp, m_PcapLinkLayerType, (int)iter->len);
+				onPacketArrives(slot.workerId, rawPacket, userCookie);
+			}
+			m_NumOfPacketsReadPerWorker[slot.workerId] += slot.records.size();
+
+			if (slot.failed)
+			{
+				LOG_ERROR("Chunk #%d of file '%s' has a corrupt record", (int)chunkIndex, m_FileName.c_str());
+				context.readFailed = true;
+				break;
+			}
+
+			pthread_mutex_lock(&context.mutex);
+			context.numOfChunksDelivered = chunkIndex + 1;
+			pthread_cond_broadcast(&context.cond);
+			pthread_mutex_unlock(&context.mutex);
+		}
+	}
+
+	// a failure before all workers were started stops the ones that were, and a wrong border in preserve-order mode stops the workers
+	// parsing the chunks after it
+	if (context.readFailed || (m_Config.preserveOrder && context.wrongBorder != 0))
+	{
+		pthread_mutex_lock(&context.mutex);
+		context.stopRequested = true;
+		pthread_cond_broadcast(&context.cond);
+		pthread_mutex_unlock(&context.mutex);
+	}
+
+	for (size_t i = 0; i < numOfWorkersStarted; i++)
+		pthread_join(context.workers[i].thread, NULL);
+
+	pthread_cond_destroy(&context.cond);
+	pthread_mutex_destroy(&context.mutex);
+
+	wrongBorder = context.wrongBorder;
+	if (wrongBorder != 0)
+		resumeOffset = context.chunkEnds[wrongBorder - 1];
+
+	return !context.readFailed;
+#endif
+}
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// PcapNgFileReaderDevice members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+PcapNgFileReaderDevice::PcapNgFileReaderDevice(const char* fileName) : IFileReaderDevice(fileName)
+{
+	m_LightPcapNg = NULL;
+	m_CurFilter = "";
+	m_BpfLinkType = -1;
+	m_BpfInitialized = false;
+}
+
+bool PcapNgFileReaderDevice::matchPacketWithFilter(const uint8_t* packetData, size_t packetLen, timespec packetTimestamp, uint16_t linkType)
+{
+	if (m_CurFilter == "")
+		return true;
+
+	int linkTypeAsInt = (int)linkType;
+
+	if (m_BpfLinkType != linkTypeAsInt)
+	{
+		LOG_DEBUG("Compiling the filter '%s' for link type %d", m_CurFilter.c_str(), linkTypeAsInt);
+		if (m_BpfInitialized)
+			pcap_freecode(&m_Bpf);
+		if (pcap_compile_nopcap(9000, linkTypeAsInt, &m_Bpf, m_CurFilter.c_str(), 1, 0) < 0)
+		{
+			m_BpfInitialized = false;
+			return false;
+		}
+
+		m_BpfLinkType = linkTypeAsInt;
+		m_BpfInitialized = true;
+	}
+
+	struct pcap_pkthdr pktHdr;
+	pktHdr.caplen = packetLen;
+	pktHdr.len = packetLen;
+	TIMESPEC_TO_TIMEVAL(&pktHdr.ts, &packetTimestamp);
+	return (pcap_offline_filter(&m_Bpf, &pktHdr, packetData) != 0);
+}
+
+bool PcapNgFileReaderDevice::open()
+{
+	m_NumOfPacketsRead = 0;
+	m_NumOfPacketsNotParsed = 0;
+
+	if (m_LightPcapNg != NULL)
+	{
+		LOG_DEBUG("pcapng descriptor already opened. Nothing to do");
+		return true;
+	}
+
+	m_LightPcapNg = light_pcapng_open_read(m_FileName, LIGHT_FALSE);
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Cannot open pcapng reader device for filename '%s'", m_FileName);
+		m_DeviceOpened = false;
+		return false;
+	}
+
+	LOG_DEBUG("Successfully opened pcapng reader device for filename '%s'", m_FileName);
+	m_DeviceOpened = true;
+	return true;
+}
+
+bool PcapNgFileReaderDevice::getNextPacket(RawPacket& rawPacket, std::string& packetComment)
+{
+	rawPacket.clear();
+	packetComment = "";
+
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		return false;
+	}
+
+	light_packet_header pktHeader;
+	const uint8_t* pktData = NULL;
+
+	if (!light_get_next_packet((light_pcapng_t*)m_LightPcapNg, &pktHeader, &pktData))
+	{
+		LOG_DEBUG("Packet could not be read. Probably end-of-file");
+		return false;
+	}
+
+	while (!matchPacketWithFilter(pktData, pktHeader.captured_length, pktHeader.timestamp, pktHeader.data_link))
+	{
+		if (!light_get_next_packet((light_pcapng_t*)m_LightPcapNg, &pktHeader, &pktData))
+		{
+			LOG_DEBUG("Packet could not be read. Probably end-of-file");
+			return false;
+		}
+	}
+
+	uint8_t* myPacketData = new uint8_t[pktHeader.captured_length];
+	memcpy(myPacketData, pktData, pktHeader.captured_length);
+	if (!rawPacket.setRawData(myPacketData, pktHeader.captured_length, pktHeader.timestamp, static_cast<LinkLayerType>(pktHeader.data_link), pktHeader.original_length))
+	{
+		LOG_ERROR("Couldn't set data to raw packet");
+		return false;
+	}
+
+	if (pktHeader.comment != NULL && pktHeader.comment_length > 0)
+		packetComment = std::string(pktHeader.comment, pktHeader.comment_length);
+
+	m_NumOfPacketsRead++;
+	return true;
+}
+
+bool PcapNgFileReaderDevice::getNextPacket(RawPacket& rawPacket)
+{
+	std::string temp;
+	return getNextPacket(rawPacket, temp);
+}
+
+bool PcapNgFileReaderDevice::getNextPacketData(const uint8_t*& pRawData, int& rawDataLen, int& frameLength, timespec& timestamp, LinkLayerType& layerType)
+{
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		return false;
+	}
+
+	light_packet_header pktHeader;
+	const uint8_t* pktData = NULL;
+
+	do
+	{
+		if (!light_get_next_packet((light_pcapng_t*)m_LightPcapNg, &pktHeader, &pktData))
+		{
+			LOG_DEBUG("Packet could not be read. Probably end-of-file");
+			return false;
+		}
+	} while (!matchPacketWithFilter(pktData, pktHeader.captured_length, pktHeader.timestamp, pktHeader.data_link));
+
+	pRawData = pktData;
+	rawDataLen = (int)pktHeader.captured_length;
+	frameLength = (int)pktHeader.original_length;
+	timestamp = pktHeader.timestamp;
+	layerType = static_cast<LinkLayerType>(pktHeader.data_link);
+	m_NumOfPacketsRead++;
+	return true;
+}
+
+void PcapNgFileReaderDevice::getStatistics(pcap_stat& stats) const
+{
+	stats.ps_recv = m_NumOfPacketsRead;
+	stats.ps_drop = m_NumOfPacketsNotParsed;
+	stats.ps_ifdrop = 0;
+	LOG_DEBUG("Statistics received for pcapng reader device for filename '%s'", m_FileName);
+}
+
+bool PcapNgFileReaderDevice::setFilter(std::string filterAsString)
+{
+	struct bpf_program prog;
+	if (pcap_compile_nopcap(9000, 1, &prog, filterAsString.c_str(), 1, 0) < 0)
+	{
+		return false;
+	}
+	pcap_freecode(&prog);
+
+	m_CurFilter = filterAsString;
+	m_BpfLinkType = -1;
+	return true;
+}
+
+void PcapNgFileReaderDevice::close()
+{
+	if (m_LightPcapNg == NULL)
+		return;
+
+	light_pcapng_close((light_pcapng_t*)m_LightPcapNg);
+	if (m_BpfInitialized)
+		pcap_freecode(&m_Bpf);
+	m_LightPcapNg = NULL;
+	m_DeviceOpened = false;
+	LOG_DEBUG("File reader closed for file '%s'", m_FileName);
+}
+
+
+std::string PcapNgFileReaderDevice::getOS() const
+{
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		return "";
+	}
+
+	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
+	char* res = fileInfo->os_desc;
+	size_t len = fileInfo->os_desc_size;
+	if (len == 0 || res == NULL)
+		return "";
+
+	return std::string(res, len);
+}
+
+std::string PcapNgFileReaderDevice::getHardware() const
+{
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		return "";
+	}
+
+	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
+	char* res = fileInfo->hardware_desc;
+	size_t len = fileInfo->hardware_desc_size;
+	if (len == 0 || res == NULL)
+		return "";
+
+	return std::string(res, len);
+}
+
+std::string PcapNgFileReaderDevice::getCaptureApplication() const
+{
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		return "";
+	}
+
+	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
+	char* res = fileInfo->user_app_desc;
+	size_t len = fileInfo->user_app_desc_size;
+	if (len == 0 || res == NULL)
+		return "";
+
+	return std::string(res, len);
+}
+
+std::string PcapNgFileReaderDevice::getCaptureFileComment() const
+{
+	if (m_LightPcapNg == NULL)
+	{
+		LOG_ERROR("Pcapng file device '%s' not opened", m_FileName);
+		return "";
+	}
+
+	light_pcapng_file_info* fileInfo = light_pcang_get_file_info((light_pcapng_t*)m_LightPcapNg);
+	char* res = fileInfo->file_comment;
+	size_t len = fileInfo->file_comment_size;
+	if (len == 0 || res == NULL)
+		return "";
+
+	return std::string(res, len);
+}
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// IFileWriterDevice members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+
+IFileWriterDevice:: IFileWriterDevice(const char* fileName) : IFileDevice(fileName)
+{
+	m_NumOfPacketsNotWritten = 0;
+	m_NumOfPacketsWritten = 0;
+}
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// PcapFileWriterDevice members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+PcapFileWriterDevice::PcapFileWriterDevice(const char* fileName, LinkLayerType linkLayerType) : IFileWriterDevice(fileName)
+{
+	m_PcapDumpHandler = NULL;
+	m_NumOfPacketsNotWritten = 0;
+	m_NumOfPacketsWritten = 0;
+	m_PcapLinkLayerType = linkLayerType;
+	m_AppendMode = false;
+	m_File = NULL;
+}
+
+void PcapFileWriterDevice::closeFile()
+{
+	if (m_AppendMode && m_File != NULL)
+	{
+		fclose(m_File);
+		m_File = NULL;
+	}
+}
+
+bool PcapFileWriterDevice::writePacket(RawPacket const& packet)
+{
+	if ((!m_AppendMode && m_PcapDescriptor == NULL) || (m_PcapDumpHandler == NULL))
+	{
+		LOG_ERROR("Device not opened");
+		m_NumOfPacketsNotWritten++;
+		return false;
+	}
+
+	if (packet.getLinkLayerType() != m_PcapLinkLayerType)
+	{
+		LOG_ERROR("Cannot write a packet with a different link layer type");
+		m_NumOfPacketsNotWritten++;
+		return false;
+	}
+
+	pcap_pkthdr pktHdr;
+	pktHdr.caplen = ((RawPacket&)packet).getRawDataLen();
+	pktHdr.len = ((RawPacket&)packet).getFrameLength();
+	timespec packet_timestamp = ((RawPacket&)packet).getPacketTimeStamp();
+	TIMESPEC_TO_TIMEVAL(&pktHdr.ts, &packet_timestamp);
+	if (!m_AppendMode)
+		pcap_dump((uint8_t*)m_PcapDumpHandler, &pktHdr, ((RawPacket&)packet).getRawData());
+	else
+	{
+		// Below are actually the lines run by pcap_dump. The reason I had to put them instead pcap_dump is that on Windows using WinPcap/Npcap
+		// you can't pass pointers between libraries compiled with different compilers. In this case - PcapPlusPlus and WinPcap/Npcap weren't
+		// compiled with the same compiler so it's impossible to fopen a file in PcapPlusPlus, pass the pointer to WinPcap/Npcap and use the
+		// FILE* pointer there. Doing this throws an exception. So the only option when implementing append to pcap is to write all relevant
+		// WinPcap/Npcap code that handles opening/closing/writing to pcap files inside PcapPlusPlus code
+
+		// the reason to create this packet_header struct is timeval has different sizes in 32-bit and 64-bit systems,
+		// but pcap format uses the 32-bit timeval version, so we need to align timeval to that
+		packet_header pktHdrTemp;
+		pktHdrTemp.tv_sec = pktHdr.ts.tv_sec;
+		pktHdrTemp.tv_usec = pktHdr.ts.tv_usec;
+		pktHdrTemp.caplen = pktHdr.caplen;
+		pktHdrTemp.len = pktHdr.len;
+		fwrite(&pktHdrTemp, sizeof(pktHdrTemp), 1, m_File);
+		fwrite(((RawPacket&)packet).getRawData(), pktHdrTemp.caplen, 1, m_File);
+	}
+	LOG_DEBUG("Packet written successfully to '%s'", m_FileName);
+	m_NumOfPacketsWritten++;
+	return true;
+}
+
+bool PcapFileWriterDevice::writePackets(const RawPacketVector& packets)
+{
+	for (RawPacketVector::ConstVectorIterator iter = packets.begin(); iter != packets.end(); iter++)
+	{
+		if (!writePacket(**iter))
+			return false;
+	}
+
+	return true;
+}
+
+bool PcapFileWriterDevice::open()
+{
+	if (m_PcapDescriptor != NULL)
+	{
+		LOG_DEBUG("Pcap descriptor already opened. Nothing to do");
+		return true;
+	}
+
+	switch(m_PcapLinkLayerType)
+	{
+		case LINKTYPE_RAW:
+		case LINKTYPE_DLT_RAW2:
+			LOG_ERROR("The only Raw IP link type supported in libpcap/WinPcap/Npcap is LINKTYPE_DLT_RAW1, please use that instead");
+			return false;
+		default:
+			break;
+	}
+
+	m_NumOfPacketsNotWritten = 0;
+	m_NumOfPacketsWritten = 0;
+
+	m_PcapDescriptor = pcap_open_dead(m_PcapLinkLayerType, PCPP_MAX_PACKET_SIZE);
+	if (m_PcapDescriptor == NULL)
+	{
+		LOG_ERROR("Error opening file writer device for file '%s': pcap_open_dead returned NULL", m_FileName);
+		m_DeviceOpened = false;
+		return false;
+	}
+
+
+	m_PcapDumpHandler = pcap_dump_open(m_PcapDescriptor, m_FileName);
+	if (m_PcapDumpHandler == NULL)
+	{
+		LOG_ERROR("Error opening file writer device for file '%s': pcap_dump_open returned NULL with error: '%s'",
+				m_FileName, pcap_geterr(m_PcapDescriptor));
+		m_DeviceOpened = false;
+		return false;
+	}
+
+	m_DeviceOpened = true;
+	LOG_DEBUG("File writer device for file '%s' opened successfully", m_FileName);
+	return true;
+}
+
+void PcapFileWriterDevice::flush()
+{
+	if (!m_DeviceOpened)
+		return;
+
+	if (!m_AppendMode && pcap_dump_flush(m_PcapDumpHandler) == -1)
+	{
+		LOG_ERROR("Error while flushing the packets to file");
+	}
+	// in append mode it's impossible to use pcap_dump_flush, see comment above pcap_dump
+	else if (m_AppendMode && fflush(m_File) == EOF)
+	{
+		LOG_ERROR("Error while flushing the packets to file");
+	}
+
+}
+
+void PcapFileWriterDevice::close()
+{
+	if (!m_DeviceOpened)
+		return;
+
+	flush();
+
+	IFileDevice::close();
+
+	if (!m_AppendMode && m_PcapDumpHandler != NULL)
+	{
+		pcap_dump_close(m_PcapDumpHandler);
+	}
+	else if (m_AppendMode && m_File != NULL)
+	{
+		// in append mode it's impossible to use pcap_dump_close, see comment above pcap_dump
+		fclose(m_File);
+	}
+
+	m_PcapDumpHandler = NULL;
+	m_File = NULL;
+	LOG_DEBUG("File writer closed for file '%s'", m_FileName);
 }
 
 void PcapFileWriterDevice::getStatistics(pcap_stat& stats) const
 {
-	stats.ps_recv = m_NumOfPacketsWritten;
-	stats.ps_drop = m_NumOfPacketsNotWritten;
-	stats.ps_ifdrop = 0;
-	LOG_DEBUG("Statistics received for writer device for filename '%s'", m_FileName);
+	stats.ps_recv = m_NumOfPacketsWritten;
+	stats.ps_drop = m_NumOfPacketsNotWritten;
+	stats.ps_ifdrop = 0;
+	LOG_DEBUG("Statistics received for writer device for filename '%s'", m_FileName);
+}
+
+bool PcapFileWriterDevice::open(bool appendMode)
+{
+	if (!appendMode)
+		return open();
+
+	m_AppendMode = appendMode;
+
+#if !defined(WIN32) && !defined(WINx64)
+	m_File = fopen(m_FileName, "r+");
+#else
+	m_File = fopen(m_FileName, "rb+");
+#endif
+
+	if (m_File == NULL)
+	{
+		LOG_ERROR("Cannot open '%s' for reading and writing", m_FileName);
+		return false;
+	}
+
+	pcap_file_header pcapFileHeader;
+	int amountRead = fread(&pcapFileHeader, 1, sizeof(pcapFileHeader), m_File);
+	if (amountRead != sizeof(pcap_file_header))
+	{
+		if (ferror(m_File))
+			LOG_ERROR("Cannot read pcap header from file '%s', error was: %d", m_FileName, errno);
+		else
+			LOG_ERROR("Cannot read pcap header from file '%s', unknown error", m_FileName);
+
+		closeFile();
+		return false;
+	}
+
+	LinkLayerType linkLayerType = static_cast<LinkLayerType>(pcapFileHeader.linktype);
+	if (linkLayerType != m_PcapLinkLayerType)
+	{
+		LOG_ERROR("Pcap file has a different link layer type than the one chosen in PcapFileWriterDevice c'tor, %d, %d", linkLayerType, m_PcapLinkLayerType);
+		closeFile();
+		return false;
+	}
+
+	if (fseek(m_File, 0, SEEK_END) == -1)
+	{
+		LOG_ERROR("Cannot read pcap file '%s' to it's end, error was: %d", m_FileName, errno);
+		closeFile();
+		return false;
+	}
+
+	m_PcapDumpHandler = ((pcap_dumper_t *)m_File);
+
+	m_DeviceOpened = true;
+	LOG_DEBUG("File writer device for file '%s' opened successfully in append mode", m_FileName);
+	return true;
+}
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// BufferedPcapFileWriterDevice members
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define BUFFERED_WRITER_DEFAULT_BUFFER_SIZE (8 * 1024 * 1024)
+// io_uring writes all buffers but the one being filled in the background
+#define BUFFERED_WRITER_IO_URING_BUFFERS 4
+
+struct BufferedPcapFileWriterDevice::FlushThread
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+#endif
+	BufferedPcapFileWriterDevice* device;
+	// the buffer the thread should write, NULL when the thread is idle
+	const uint8_t* pendingBuffer;
+	size_t pendingLength;
+	uint64_t pendingOffset;
+	uint32_t pendingNumOfPackets;
+	bool stopRequested;
+	// set when writing a buffer fails. The packets of the failed writes are reported to the device in waitForFlushThread()
+	bool writeFailed;
+	uint32_t numOfPacketsLost;
+};
+
+BufferedPcapFileWriterDevice::BufferedPcapFileWriterDevice(const char* fileName, LinkLayerType linkLayerType, const BufferedPcapFileWriterConfiguration& config) :
+	IFileWriterDevice(fileName), m_Config(config)
+{
+	m_NumOfPacketsNotWritten = 0;
+	m_NumOfPacketsWritten = 0;
+	m_PcapLinkLayerType = linkLayerType;
+	m_Fd = -1;
+	m_DirectIO = false;
+	m_ActiveBuffer = 0;
+	m_BufferUsed = 0;
+	m_FileOffset = 0;
+	m_NumOfPacketsInActiveBuffer = 0;
+	m_BoundaryRecordStart = 0;
+	m_WriteFailed = false;
+	m_FlushThread = NULL;
+	m_IoUring = NULL;
+
+	WriteBuffer emptyBuffer;
+	memset(&emptyBuffer, 0, sizeof(emptyBuffer));
+	m_Buffers.assign(config.useIoUring ? BUFFERED_WRITER_IO_URING_BUFFERS : (config.backgroundFlush ? 2 : 1), emptyBuffer);
+
+	m_BufferSize = getBufferedDeviceBufferSize(config.bufferSize, BUFFERED_WRITER_DEFAULT_BUFFER_SIZE);
+}
+
+BufferedPcapFileWriterDevice::~BufferedPcapFileWriterDevice()
+{
+	close();
+
+	for (std::vector<WriteBuffer>::iterator iter = m_Buffers.begin(); iter != m_Buffers.end(); ++iter)
+		free(iter->data);
 }
 
-bool PcapFileWriterDevice::open(bool appendMode)
+bool BufferedPcapFileWriterDevice::open()
+{
+	return open(false);
+}
+
+bool BufferedPcapFileWriterDevice::open(bool appendMode)
 {
+	if (m_Fd >= 0)
+	{
+		LOG_DEBUG("File already opened. Nothing to do");
+		return true;
+	}
+
+#if defined(WIN32) || defined(WINx64) || defined(PCAPPP_MINGW_ENV)
+	LOG_ERROR("Buffered pcap file writing isn't supported on this platform");
+	return false;
+#else
+	m_NumOfPacketsNotWritten = 0;
+	m_NumOfPacketsWritten = 0;
+	m_WriteFailed = false;
+
+	// the extra buffers io_uring needs are allocated once it's known to be available
+	for (size_t i = 0; i < (m_Config.backgroundFlush ? 2 : 1); i++)
+	{
+		if (m_Buffers[i].data == NULL && posix_memalign((void**)&m_Buffers[i].data, BUFFERED_DEVICE_ALIGNMENT, m_BufferSize) != 0)
+		{
+			m_Buffers[i].data = NULL;
+			LOG_ERROR("Cannot allocate a write buffer of %d bytes", (int)m_BufferSize);
+			return false;
+		}
+	}
+
+	m_ActiveBuffer = 0;
+	m_BufferUsed = 0;
+	m_FileOffset = 0;
+	m_NumOfPacketsInActiveBuffer = 0;
+	m_BoundaryRecordStart = 0;
+
+	uint64_t fileSize = 0;
+	if (appendMode)
+	{
+		int readFd = ::open(m_FileName, O_RDONLY);
+		if (readFd < 0)
+		{
+			LOG_ERROR("Cannot open '%s' for reading and writing", m_FileName);
+			return false;
+		}
+
+		pcap_file_header fileHeader;
+		struct stat fileStat;
+		bool headerRead = (pread(readFd, &fileHeader, sizeof(fileHeader), 0) == (ssize_t)sizeof(fileHeader) && fstat(readFd, &fileStat) == 0);
+		if (!headerRead)
+		{
+			LOG_ERROR("Cannot read pcap header from file '%s'", m_FileName);
+			::close(readFd);
+			return false;
+		}
+
+		// records are appended as they're written by this class, so the existing ones must have the same format
+		if (fileHeader.magic != PCAP_MAGIC_MICROSEC)
+		{
+			LOG_ERROR("File '%s' isn't a pcap file with microsecond timestamps in the byte order of this machine", m_FileName);
+			::close(readFd);
+			return false;
+		}
+
+		LinkLayerType linkLayerType = static_cast<LinkLayerType>(fileHeader.linktype);
+		if (linkLayerType != m_PcapLinkLayerType)
+		{
+			LOG_ERROR("Pcap file has a different link layer type than the one chosen in BufferedPcapFileWriterDevice c'tor, %d, %d", linkLayerType, m_PcapLinkLayerType);
+			::close(readFd);
+			return false;
+		}
+
+		fileSize = (uint64_t)fileStat.st_size;
+		m_FileOffset = fileSize;
+
+		// in direct I/O mode writes must start at a block boundary, so the partial block at the end of the file is read into the buffer
+		// and written again with the new records
+		if (m_Config.directIO)
+		{
+			m_BufferUsed = (size_t)(fileSize % BUFFERED_DEVICE_ALIGNMENT);
+			m_FileOffset = fileSize - m_BufferUsed;
+			if (m_BufferUsed > 0 && pread(readFd, m_Buffers[0].data, m_BufferUsed, (off_t)m_FileOffset) != (ssize_t)m_BufferUsed)
+			{
+				LOG_ERROR("Cannot read the end of file '%s'", m_FileName);
+				::close(readFd);
+				return false;
+			}
+		}
+
+		::close(readFd);
+	}
+
+	int flags = O_WRONLY | O_CREAT | (appendMode ? 0 : O_TRUNC);
+	m_DirectIO = false;
+	m_Fd = -1;
+	if (m_Config.directIO)
+	{
+#ifdef O_DIRECT
+		m_Fd = ::open(m_FileName, flags | O_DIRECT, 0644);
+		if (m_Fd >= 0)
+			m_DirectIO = true;
+		else if (errno == EINVAL)
+			LOG_DEBUG("File system of '%s' doesn't support direct I/O, writing through the page cache", m_FileName);
+#else
+		LOG_DEBUG("Direct I/O isn't supported on this platform, writing through the page cache");
+#endif
+	}
+
+	if (m_Fd < 0)
+		m_Fd = ::open(m_FileName, flags, 0644);
+
+	if (m_Fd < 0)
+	{
+		LOG_ERROR("Error opening file writer device for file '%s': %s", m_FileName, strerror(errno));
+		return false;
+	}
+
+	// without direct I/O there's no need to write the last block of the file again
+	if (appendMode && !m_DirectIO)
+	{
+		m_FileOffset = fileSize;
+		m_BufferUsed = 0;
+	}
+
 	if (!appendMode)
-		return open();
+	{
+		pcap_file_header fileHeader;
+		fileHeader.magic = PCAP_MAGIC_MICROSEC;
+		fileHeader.version_major = 2;
+		fileHeader.version_minor = 4;
+		fileHeader.thiszone = 0;
+		fileHeader.sigfigs = 0;
+		fileHeader.snaplen = PCPP_MAX_PACKET_SIZE;
+		fileHeader.linktype = (uint32_t)m_PcapLinkLayerType;
+		memcpy(m_Buffers[0].data, &fileHeader, sizeof(fileHeader));
+		m_BufferUsed = sizeof(fileHeader);
+	}
 
-	m_AppendMode = appendMode;
+	if (m_Config.useIoUring)
+	{
+		m_IoUring = new IoUringQueue();
+		bool buffersAllocated = m_IoUring->init(BUFFERED_WRITER_IO_URING_BUFFERS);
+		for (size_t i = 0; buffersAllocated && i < m_Buffers.size(); i++)
+		{
+			m_Buffers[i].inFlight = false;
+			if (m_Buffers[i].data == NULL && posix_memalign((void**)&m_Buffers[i].data, BUFFERED_DEVICE_ALIGNMENT, m_BufferSize) != 0)
+			{
+				m_Buffers[i].data = NULL;
+				buffersAllocated = false;
+			}
+		}
 
-#if !defined(WIN32) && !defined(WINx64)
-	m_File = fopen(m_FileName, "r+");
+		if (!buffersAllocated)
+		{
+			LOG_DEBUG("io_uring isn't available, writing file '%s' %s", m_FileName, (m_Config.backgroundFlush ? "on a background thread" : "with blocking writes"));
+			delete m_IoUring;
+			m_IoUring = NULL;
+		}
+	}
+
+	if (m_Config.backgroundFlush && m_IoUring == NULL)
+	{
+		FlushThread* flushThread = new FlushThread();
+		flushThread->device = this;
+		flushThread->pendingBuffer = NULL;
+		flushThread->pendingLength = 0;
+		flushThread->pendingOffset = 0;
+		flushThread->pendingNumOfPackets = 0;
+		flushThread->stopRequested = false;
+		flushThread->writeFailed = false;
+		flushThread->numOfPacketsLost = 0;
+		pthread_mutex_init(&flushThread->mutex, NULL);
+		pthread_cond_init(&flushThread->cond, NULL);
+
+		int err = pthread_create(&flushThread->thread, NULL, flushThreadMain, flushThread);
+		if (err != 0)
+		{
+			LOG_ERROR("Cannot create the flush thread: [%s]", strerror(err));
+			pthread_cond_destroy(&flushThread->cond);
+			pthread_mutex_destroy(&flushThread->mutex);
+			delete flushThread;
+			::close(m_Fd);
+			m_Fd = -1;
+			return false;
+		}
+
+		m_FlushThread = flushThread;
+	}
+
+	m_DeviceOpened = true;
+	LOG_DEBUG("Buffered file writer device for file '%s' opened successfully%s%s", m_FileName, (appendMode ? " in append mode" : ""), (m_IoUring != NULL ? " using io_uring" : ""));
+	return true;
+#endif
+}
+
+bool BufferedPcapFileWriterDevice::writeToFile(const uint8_t* data, size_t dataLen, uint64_t offset)
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	while (dataLen > 0)
+	{
+		ssize_t written = pwrite(m_Fd, data, dataLen, (off_t)offset);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			LOG_ERROR("Error while writing packets to file '%s': %s", m_FileName, strerror(errno));
+			return false;
+		}
+
+		data += written;
+		dataLen -= (size_t)written;
+		offset += (uint64_t)written;
+	}
+
+	return true;
 #else
-	m_File = fopen(m_FileName, "rb+");
+	return false;
 #endif
+}
 
-	if (m_File == NULL)
+void* BufferedPcapFileWriterDevice::flushThreadMain(void* flushThreadPtr)
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	FlushThread* flushThread = (FlushThread*)flushThreadPtr;
+
+	pthread_mutex_lock(&flushThread->mutex);
+	while (true)
 	{
-		LOG_ERROR("Cannot open '%s' for reading and writing", m_FileName);
+		while (flushThread->pendingBuffer == NULL && !flushThread->stopRequested)
+			pthread_cond_wait(&flushThread->cond, &flushThread->mutex);
+
+		// the buffer handed over before the stop request is written before stopping
+		if (flushThread->pendingBuffer == NULL)
+			break;
+
+		const uint8_t* buffer = flushThread->pendingBuffer;
+		size_t length = flushThread->pendingLength;
+		uint64_t offset = flushThread->pendingOffset;
+		pthread_mutex_unlock(&flushThread->mutex);
+
+		bool written = flushThread->device->writeToFile(buffer, length, offset);
+
+		pthread_mutex_lock(&flushThread->mutex);
+		if (!written)
+		{
+			flushThread->writeFailed = true;
+			flushThread->numOfPacketsLost += flushThread->pendingNumOfPackets;
+		}
+		flushThread->pendingBuffer = NULL;
+		pthread_cond_broadcast(&flushThread->cond);
+	}
+	pthread_mutex_unlock(&flushThread->mutex);
+#endif
+
+	return NULL;
+}
+
+void BufferedPcapFileWriterDevice::waitForFlushThread()
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	if (m_FlushThread == NULL)
+		return;
+
+	pthread_mutex_lock(&m_FlushThread->mutex);
+	while (m_FlushThread->pendingBuffer != NULL)
+		pthread_cond_wait(&m_FlushThread->cond, &m_FlushThread->mutex);
+
+	if (m_FlushThread->writeFailed)
+	{
+		m_WriteFailed = true;
+		dropPackets(m_FlushThread->numOfPacketsLost);
+		m_FlushThread->numOfPacketsLost = 0;
+	}
+	pthread_mutex_unlock(&m_FlushThread->mutex);
+#endif
+}
+
+void BufferedPcapFileWriterDevice::stopFlushThread()
+{
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	if (m_FlushThread == NULL)
+		return;
+
+	pthread_mutex_lock(&m_FlushThread->mutex);
+	m_FlushThread->stopRequested = true;
+	pthread_cond_broadcast(&m_FlushThread->cond);
+	pthread_mutex_unlock(&m_FlushThread->mutex);
+	pthread_join(m_FlushThread->thread, NULL);
+
+	pthread_cond_destroy(&m_FlushThread->cond);
+	pthread_mutex_destroy(&m_FlushThread->mutex);
+	delete m_FlushThread;
+	m_FlushThread = NULL;
+#endif
+}
+
+void BufferedPcapFileWriterDevice::waitForBuffer(size_t bufferIndex)
+{
+	while (m_Buffers[bufferIndex].inFlight)
+	{
+		uint64_t completedIndex = 0;
+		int result = 0;
+		if (!m_IoUring->waitForCompletion(completedIndex, result))
+		{
+			// the ring is broken, nothing more can be written reliably
+			m_WriteFailed = true;
+			m_Buffers[bufferIndex].inFlight = false;
+			dropPackets(m_Buffers[bufferIndex].numOfPackets);
+			return;
+		}
+
+		WriteBuffer& buffer = m_Buffers[completedIndex];
+		buffer.inFlight = false;
+		if (result < 0)
+		{
+			LOG_ERROR("Error while writing packets to file '%s': %s", m_FileName, strerror(-result));
+			m_WriteFailed = true;
+			dropPackets(buffer.numOfPackets);
+		}
+		else if ((size_t)result < buffer.length && !writeToFile(buffer.data + result, buffer.length - result, buffer.offset + result))
+		{
+			// the rest of a short write is written with a blocking write
+			m_WriteFailed = true;
+			dropPackets(buffer.numOfPackets);
+		}
+	}
+}
+
+void BufferedPcapFileWriterDevice::waitForAllBuffers()
+{
+	if (m_IoUring == NULL)
+		return;
+
+	for (size_t i = 0; i < m_Buffers.size(); i++)
+		waitForBuffer(i);
+}
+
+void BufferedPcapFileWriterDevice::dropPackets(uint32_t numOfPackets)
+{
+	m_NumOfPacketsWritten -= numOfPackets;
+	m_NumOfPacketsNotWritten += numOfPackets;
+}
+
+void BufferedPcapFileWriterDevice::dropActiveBuffer()
+{
+	dropPackets(m_NumOfPacketsInActiveBuffer);
+	m_NumOfPacketsInActiveBuffer = 0;
+	m_BufferUsed = 0;
+}
+
+bool BufferedPcapFileWriterDevice::flushActiveBuffer()
+{
+	// a failed background write is reported only here, and nothing is written after a failed write. The packets waiting in the buffer are
+	// never written then
+	waitForFlushThread();
+	if (m_WriteFailed)
+	{
+		dropActiveBuffer();
 		return false;
 	}
 
-	pcap_file_header pcapFileHeader;
-	int amountRead = fread(&pcapFileHeader, 1, sizeof(pcapFileHeader), m_File);
-	if (amountRead != sizeof(pcap_file_header))
+	// in direct I/O mode only whole blocks can be written, the partial block at the end of the buffer moves to the start of the next one
+	size_t length = m_BufferUsed;
+	if (m_DirectIO)
+		length -= length % BUFFERED_DEVICE_ALIGNMENT;
+
+	if (length == 0)
+		return true;
+
+	uint8_t* buffer = m_Buffers[m_ActiveBuffer].data;
+	size_t remaining = m_BufferUsed - length;
+
+	// the records that don't end in the written part move to the next buffer with the partial block
+	uint32_t numOfCarriedPackets = 0;
+	for (size_t recordStart = m_BoundaryRecordStart; remaining > 0 && recordStart < m_BufferUsed; numOfCarriedPackets++)
 	{
-		if (ferror(m_File))
-			LOG_ERROR("Cannot read pcap header from file '%s', error was: %d", m_FileName, errno);
-		else
-			LOG_ERROR("Cannot read pcap header from file '%s', unknown error", m_FileName);
+		packet_header recordHeader;
+		memcpy(&recordHeader, buffer + recordStart, sizeof(recordHeader));
+		recordStart += sizeof(recordHeader) + recordHeader.caplen;
+	}
+	uint32_t numOfPackets = m_NumOfPacketsInActiveBuffer - numOfCarriedPackets;
 
-		closeFile();
+	if (m_IoUring != NULL)
+	{
+		// the next buffer is free once its previous write is complete
+		size_t nextBufferIndex = (m_ActiveBuffer + 1) % m_Buffers.size();
+		waitForBuffer(nextBufferIndex);
+		memcpy(m_Buffers[nextBufferIndex].data, buffer + length, remaining);
+
+		WriteBuffer& activeBuffer = m_Buffers[m_ActiveBuffer];
+		activeBuffer.length = length;
+		activeBuffer.offset = m_FileOffset;
+		activeBuffer.numOfPackets = numOfPackets;
+		// if submitting fails the write is taken back from the ring, so the blocking write below is the only one of this buffer
+		activeBuffer.inFlight = (m_IoUring->queueWrite(m_Fd, buffer, length, m_FileOffset, m_ActiveBuffer) && m_IoUring->submit());
+		if (!activeBuffer.inFlight && !writeToFile(buffer, length, m_FileOffset))
+		{
+			m_WriteFailed = true;
+			dropPackets(numOfPackets);
+		}
+
+		m_ActiveBuffer = nextBufferIndex;
+	}
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	else if (m_FlushThread != NULL)
+	{
+		// the other buffer is free, flushActiveBuffer() waited for the thread to finish writing it
+		uint8_t* nextBuffer = m_Buffers[1 - m_ActiveBuffer].data;
+		memcpy(nextBuffer, buffer + length, remaining);
+
+		pthread_mutex_lock(&m_FlushThread->mutex);
+		m_FlushThread->pendingBuffer = buffer;
+		m_FlushThread->pendingLength = length;
+		m_FlushThread->pendingOffset = m_FileOffset;
+		m_FlushThread->pendingNumOfPackets = numOfPackets;
+		pthread_cond_broadcast(&m_FlushThread->cond);
+		pthread_mutex_unlock(&m_FlushThread->mutex);
+
+		m_ActiveBuffer = 1 - m_ActiveBuffer;
+	}
+	else
+#endif
+	{
+		if (!writeToFile(buffer, length, m_FileOffset))
+		{
+			m_WriteFailed = true;
+			dropPackets(numOfPackets);
+		}
+		memmove(buffer, buffer + length, remaining);
+	}
+
+	m_FileOffset += length;
+	m_BufferUsed = remaining;
+	m_NumOfPacketsInActiveBuffer = numOfCarriedPackets;
+	m_BoundaryRecordStart = 0;
+	return !m_WriteFailed;
+}
+
+bool BufferedPcapFileWriterDevice::bufferPacket(const RawPacket& packet)
+{
+	if (packet.getLinkLayerType() != m_PcapLinkLayerType)
+	{
+		LOG_ERROR("Cannot write a packet with a different link layer type");
+		m_NumOfPacketsNotWritten++;
 		return false;
 	}
 
-	LinkLayerType linkLayerType = static_cast<LinkLayerType>(pcapFileHeader.linktype);
-	if (linkLayerType != m_PcapLinkLayerType)
+	int packetDataLen = packet.getRawDataLen();
+	if (packetDataLen > PCAP_MAX_RECORD_LENGTH)
 	{
-		LOG_ERROR("Pcap file has a different link layer type than the one chosen in PcapFileWriterDevice c'tor, %d, %d", linkLayerType, m_PcapLinkLayerType);
-		closeFile();
+		LOG_ERROR("Cannot write a packet of %d bytes, the max length is %d bytes", packetDataLen, PCAP_MAX_RECORD_LENGTH);
+		m_NumOfPacketsNotWritten++;
 		return false;
 	}
 
-	if (fseek(m_File, 0, SEEK_END) == -1)
+	size_t recordLen = sizeof(packet_header) + packetDataLen;
+	if ((m_BufferSize - m_BufferUsed < recordLen && !flushActiveBuffer()) || m_WriteFailed)
 	{
-		LOG_ERROR("Cannot read pcap file '%s' to it's end, error was: %d", m_FileName, errno);
-		closeFile();
+		m_NumOfPacketsNotWritten++;
 		return false;
 	}
 
-	m_PcapDumpHandler = ((pcap_dumper_t *)m_File);
+	// the pcap format uses 32-bit timestamps regardless of the size of timeval
+	timespec timestamp = packet.getPacketTimeStamp();
+	packet_header recordHeader;
+	recordHeader.tv_sec = (uint32_t)timestamp.tv_sec;
+	recordHeader.tv_usec = (uint32_t)(timestamp.tv_nsec / 1000);
+	recordHeader.caplen = (uint32_t)packetDataLen;
+	recordHeader.len = (uint32_t)packet.getFrameLength();
+
+	uint8_t* record = m_Buffers[m_ActiveBuffer].data + m_BufferUsed;
+	memcpy(record, &recordHeader, sizeof(recordHeader));
+	memcpy(record + sizeof(recordHeader), packet.getRawData(), packetDataLen);
+	if ((m_BufferUsed + BUFFERED_DEVICE_ALIGNMENT - 1) / BUFFERED_DEVICE_ALIGNMENT * BUFFERED_DEVICE_ALIGNMENT < m_BufferUsed + recordLen)
+		m_BoundaryRecordStart = m_BufferUsed;
+	m_BufferUsed += recordLen;
+	m_NumOfPacketsInActiveBuffer++;
+	m_NumOfPacketsWritten++;
+	return true;
+}
+
+bool BufferedPcapFileWriterDevice::writePacket(RawPacket const& packet)
+{
+	if (m_Fd < 0)
+	{
+		LOG_ERROR("Device not opened");
+		m_NumOfPacketsNotWritten++;
+		return false;
+	}
+
+	return bufferPacket(packet);
+}
+
+bool BufferedPcapFileWriterDevice::writePackets(const RawPacketVector& packets)
+{
+	if (m_Fd < 0)
+	{
+		LOG_ERROR("Device not opened");
+		m_NumOfPacketsNotWritten += packets.size();
+		return false;
+	}
+
+	for (RawPacketVector::ConstVectorIterator iter = packets.begin(); iter != packets.end(); iter++)
+	{
+		if (!bufferPacket(**iter))
+			return false;
+	}
 
-	m_DeviceOpened = true;
-	LOG_DEBUG("File writer device for file '%s' opened successfully in append mode", m_FileName);
 	return true;
 }
 
+void BufferedPcapFileWriterDevice::flush()
+{
+	if (m_Fd < 0)
+		return;
+
+	flushActiveBuffer();
+	waitForFlushThread();
+	waitForAllBuffers();
+
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV) && defined(O_DIRECT)
+	// what's left is a partial block which can't be written with O_DIRECT. It's written through the page cache, and stays in the buffer
+	// to be written again as a whole block with the next records
+	if (m_DirectIO && m_BufferUsed > 0 && !m_WriteFailed)
+	{
+		int flags = fcntl(m_Fd, F_GETFL);
+		if (fcntl(m_Fd, F_SETFL, flags & ~O_DIRECT) != 0 || !writeToFile(m_Buffers[m_ActiveBuffer].data, m_BufferUsed, m_FileOffset))
+			m_WriteFailed = true;
+		fcntl(m_Fd, F_SETFL, flags);
+	}
+#endif
+
+	if (m_WriteFailed)
+	{
+		dropActiveBuffer();
+		LOG_ERROR("Error while flushing the packets to file");
+	}
+}
+
+void BufferedPcapFileWriterDevice::close()
+{
+	if (m_Fd < 0)
+		return;
+
+	flush();
+	stopFlushThread();
+	delete m_IoUring;
+	m_IoUring = NULL;
+
+#if !defined(WIN32) && !defined(WINx64) && !defined(PCAPPP_MINGW_ENV)
+	::close(m_Fd);
+#endif
+	m_Fd = -1;
+	m_BufferUsed = 0;
+	m_DeviceOpened = false;
+	LOG_DEBUG("File writer closed for file '%s'", m_FileName);
+}
+
+void BufferedPcapFileWriterDevice::getStatistics(pcap_stat& stats) const
+{
+	stats.ps_recv = m_NumOfPacketsWritten;
+	stats.ps_drop = m_NumOfPacketsNotWritten;
+	stats.ps_ifdrop = 0;
+	LOG_DEBUG("Statistics received for writer device for filename '%s'", m_FileName);
+}
+
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // PcapNgFileWriterDevice members
@@ -0,0 +1,355 @@
+#define LOG_MODULE PcapLogModuleShardedTcpReassembly
+
+#include "ShardedTcpReassembly.h"
+#include "FlowKey.h"
+#include "IPv4Layer.h"
+#include "Logger.h"
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define DEFAULT_RING_CAPACITY 4096
+
+// the ring indices are shared between the capture thread and a worker without locks. The barrier makes sure a slot is fully written
+// before the index publishing it is, and fully read before the index releasing it is
+#if defined(_MSC_VER)
+#include <windows.h>
+#define RING_MEMORY_BARRIER() MemoryBarrier()
+#else
+#define RING_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+#define CACHE_LINE_SIZE 64
+
+namespace pcpp
+{
+
+struct ShardedTcpReassembly::Shard
+{
+	// a copy of a packet waiting in the ring. The buffer is kept when the slot is reused and only grows when a bigger packet arrives
+	struct Slot
+	{
+		uint8_t* data;
+		int capacity;
+		int dataLen;
+		timespec timestamp;
+		LinkLayerType linkType;
+	};
+
+	ShardedTcpReassembly* owner;
+	size_t id;
+	TcpReassembly* reassembly;
+	Slot* slots;
+	size_t ringMask;
+	pthread_t thread;
+
+	// written by the capture thread only. cachedTail is the last value of tail the capture thread read, so it doesn't have to read
+	// the worker's cache line for every packet
+	char padding1[CACHE_LINE_SIZE];
+	volatile size_t head;
+	size_t cachedTail;
+	uint64_t numOfDroppedPackets;
+	volatile bool stopRequested;
+
+	// written by the worker thread only
+	char padding2[CACHE_LINE_SIZE];
+	volatile size_t tail;
+	volatile uint64_t numOfHandledPackets;
+	char padding3[CACHE_LINE_SIZE];
+};
+
+
+ShardedTcpReassembly::ShardedTcpReassembly(OnTcpMessageReady onMessageReadyCallback, void* userCookie, OnTcpConnectionStart onConnectionStartCallback,
+	OnTcpConnectionEnd onConnectionEndCallback, const ShardedTcpReassemblyConfiguration& config)
+{
+	m_OnMessageReadyCallback = onMessageReadyCallback;
+	m_UserCookie = userCookie;
+	m_OnConnStart = onConnectionStartCallback;
+	m_OnConnEnd = onConnectionEndCallback;
+	m_WaitWhenRingIsFull = config.waitWhenRingIsFull;
+	m_CoreMask = config.coreMask;
+	m_Running = false;
+
+	// a seed that changes between runs, so whoever generates the traffic can't aim all connections at one shard
+	m_HashSeed = ((uint64_t)time(NULL) << 32) ^ (uint64_t)(size_t)this;
+
+	size_t numOfShards = config.numOfShards;
+	if (numOfShards == 0)
+		numOfShards = (size_t)getNumOfCores();
+	if (numOfShards == 0)
+		numOfShards = 1;
+
+	size_t ringCapacity = 1;
+	while (ringCapacity < (config.ringCapacity > 0 ? config.ringCapacity : DEFAULT_RING_CAPACITY))
+		ringCapacity <<= 1;
+
+	for (size_t i = 0; i < numOfShards; i++)
+	{
+		Shard* shard = new Shard();
+		shard->owner = this;
+		shard->id = i;
+		shard->reassembly = new TcpReassembly(onShardMessageReady, shard,
+			(onConnectionStartCallback != NULL ? onShardConnectionStart : NULL),
+			(onConnectionEndCallback != NULL ? onShardConnectionEnd : NULL),
+			config.reassemblyConfig);
+		shard->slots = new Shard::Slot[ringCapacity];
+		memset(shard->slots, 0, sizeof(Shard::Slot) * ringCapacity);
+		shard->ringMask = ringCapacity - 1;
+		shard->head = 0;
+		shard->cachedTail = 0;
+		shard->numOfDroppedPackets = 0;
+		shard->stopRequested = false;
+		shard->tail = 0;
+		shard->numOfHandledPackets = 0;
+		m_Shards.push_back(shard);
+	}
+}
+
+ShardedTcpReassembly::~ShardedTcpReassembly()
+{
+	stop();
+
+	for (std::vector<Shard*>::iterator iter = m_Shards.begin(); iter != m_Shards.end(); ++iter)
+	{
+		Shard* shard = *iter;
+		for (size_t i = 0; i <= shard->ringMask; i++)
+			delete [] shard->slots[i].data;
+
+		delete [] shard->slots;
+		delete shard->reassembly;
+		delete shard;
+	}
+}
+
+bool ShardedTcpReassembly::start()
+{
+	if (m_Running)
+	{
+		LOG_ERROR("Worker threads are already running");
+		return false;
+	}
+
+	std::vector<SystemCore> cores;
+	if (m_CoreMask != 0)
+	{
+		createCoreVectorFromCoreMask(m_CoreMask, cores);
+		if (cores.size() < m_Shards.size())
+		{
+			LOG_ERROR("Core mask contains %d cores but there are %d shards", (int)cores.size(), (int)m_Shards.size());
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < m_Shards.size(); i++)
+	{
+		Shard* shard = m_Shards[i];
+		shard->stopRequested = false;
+
+		int err = pthread_create(&shard->thread, NULL, workerThreadMain, shard);
+		if (err != 0)
+		{
+			LOG_ERROR("Cannot create worker thread for shard #%d: [%s]", (int)i, strerror(err));
+		}
+#ifdef LINUX
+		else if (m_CoreMask != 0)
+		{
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			CPU_SET(cores[i].Id, &cpuset);
+			if ((err = pthread_setaffinity_np(shard->thread, sizeof(cpu_set_t), &cpuset)) != 0)
+			{
+				LOG_ERROR("Error while binding the worker thread of shard #%d to core %d: errno=%i", (int)i, (int)cores[i].Id, err);
+				shard->stopRequested = true;
+				pthread_join(shard->thread, NULL);
+			}
+		}
+#endif
+
+		if (err != 0)
+		{
+			// stop the threads that were already started
+			for (size_t j = 0; j < i; j++)
+				m_Shards[j]->stopRequested = true;
+			for (size_t j = 0; j < i; j++)
+				pthread_join(m_Shards[j]->thread, NULL);
+
+			return false;
+		}
+	}
+
+#ifndef LINUX
+	if (m_CoreMask != 0)
+		LOG_DEBUG("Binding worker threads to cores is supported on Linux only, the core mask is ignored");
+#endif
+
+	m_Running = true;
+	return true;
+}
+
+void ShardedTcpReassembly::stop()
+{
+	if (!m_Running)
+		return;
+
+	// the workers handle all packets published before they see the stop request
+	RING_MEMORY_BARRIER();
+	for (std::vector<Shard*>::iterator iter = m_Shards.begin(); iter != m_Shards.end(); ++iter)
+		(*iter)->stopRequested = true;
+
+	for (std::vector<Shard*>::iterator iter = m_Shards.begin(); iter != m_Shards.end(); ++iter)
+		pthread_join((*iter)->thread, NULL);
+
+	m_Running = false;
+}
+
+int ShardedTcpReassembly::getShardId(RawPacket* rawPacket) const
+{
+	// the 5-tuple is first looked for without creating a Packet. Encapsulations PacketView doesn't decode (such as PPPoE) need a full parse
+	FlowKey flowKey;
+	if (!flowKey.fromRawPacket(rawPacket))
+	{
+		Packet packet(rawPacket, false);
+		flowKey.fromPacket(packet);
+	}
+
+	if (!flowKey.isValid() || flowKey.getProtocol() != PACKETPP_IPPROTO_TCP)
+		return -1;
+
+	// the flow key is the same for both directions of a connection, so both sides go to the same shard
+	return (int)(flowKey.hash(m_HashSeed) % m_Shards.size());
+}
+
+bool ShardedTcpReassembly::reassemblePacket(RawPacket* rawPacket)
+{
+	if (!m_Running)
+	{
+		LOG_ERROR("Worker threads aren't running, call start() first");
+		return false;
+	}
+
+	int shardId = getShardId(rawPacket);
+	if (shardId < 0)
+		return false;
+
+	Shard* shard = m_Shards[shardId];
+	size_t head = shard->head;
+	if (head - shard->cachedTail > shard->ringMask)
+	{
+		shard->cachedTail = shard->tail;
+		while (head - shard->cachedTail > shard->ringMask)
+		{
+			if (!m_WaitWhenRingIsFull)
+			{
+				shard->numOfDroppedPackets++;
+				return false;
+			}
+
+			sched_yield();
+			shard->cachedTail = shard->tail;
+		}
+
+		// don't write the slot before the worker is done reading it
+		RING_MEMORY_BARRIER();
+	}
+
+	Shard::Slot& slot = shard->slots[head & shard->ringMask];
+	int dataLen = rawPacket->getRawDataLen();
+	if (slot.capacity < dataLen)
+	{
+		delete [] slot.data;
+		slot.data = new uint8_t[dataLen];
+		slot.capacity = dataLen;
+	}
+
+	memcpy(slot.data, rawPacket->getRawData(), dataLen);
+	slot.dataLen = dataLen;
+	slot.timestamp = rawPacket->getPacketTimeStamp();
+	slot.linkType = rawPacket->getLinkLayerType();
+
+	RING_MEMORY_BARRIER();
+	shard->head = head + 1;
+	return true;
+}
+
+uint64_t ShardedTcpReassembly::getNumOfHandledPackets(size_t shardId) const
+{
+	return m_Shards[shardId]->numOfHandledPackets;
+}
+
+uint64_t ShardedTcpReassembly::getNumOfDroppedPackets(size_t shardId) const
+{
+	return m_Shards[shardId]->numOfDroppedPackets;
+}
+
+const TcpReassembly::OutOfOrderStatistics& ShardedTcpReassembly::getOutOfOrderStatistics(size_t shardId) const
+{
+	return m_Shards[shardId]->reassembly->getOutOfOrderStatistics();
+}
+
+void* ShardedTcpReassembly::workerThreadMain(void* shardPtr)
+{
+	Shard* shard = (Shard*)shardPtr;
+	Packet packet;
+
+	while (true)
+	{
+		size_t tail = shard->tail;
+		size_t head = shard->head;
+		if (tail == head)
+		{
+			if (shard->stopRequested)
+			{
+				// packets published before the stop request are visible once the request is seen
+				RING_MEMORY_BARRIER();
+				if (shard->head == tail)
+					break;
+				continue;
+			}
+
+			sched_yield();
+			continue;
+		}
+
+		// don't read the slots before seeing the index that published them
+		RING_MEMORY_BARRIER();
+
+		for (; tail != head; tail++)
+		{
+			Shard::Slot& slot = shard->slots[tail & shard->ringMask];
+			RawPacket rawPacket(slot.data, slot.dataLen, slot.timestamp, false, slot.linkType);
+			packet.setRawPacket(&rawPacket, false);
+			shard->reassembly->reassemblePacket(packet);
+			shard->numOfHandledPackets++;
+		}
+
+		RING_MEMORY_BARRIER();
+		shard->tail = tail;
+	}
+
+	// the connections are closed on the worker thread, so the user gets all callbacks of a shard on the same thread
+	shard->reassembly->closeAllConnections();
+
+	return NULL;
+}
+
+void ShardedTcpReassembly::onShardMessageReady(int side, const TcpStreamData& tcpData, void* shardPtr)
+{
+	Shard* shard = (Shard*)shardPtr;
+	if (shard->owner->m_OnMessageReadyCallback != NULL)
+		shard->owner->m_OnMessageReadyCallback(shard->id, side, tcpData, shard->owner->m_UserCookie);
+}
+
+void ShardedTcpReassembly::onShardConnectionStart(const ConnectionData& connectionData, void* shardPtr)
+{
+	Shard* shard = (Shard*)shardPtr;
+	shard->owner->m_OnConnStart(shard->id, connectionData, shard->owner->m_UserCookie);
+}
+
+void ShardedTcpReassembly::onShardConnectionEnd(const ConnectionData& connectionData, TcpReassembly::ConnectionEndReason reason, void* shardPtr)
+{
+	Shard* shard = (Shard*)shardPtr;
+	shard->owner->m_OnConnEnd(shard->id, connectionData, reason, shard->owner->m_UserCookie);
+}
+
+} // namespace pcpp
@@ -22,6 +22,7 @@ PTF_TEST_CASE(IPv4FragmentationTest);
 PTF_TEST_CASE(IPv4OptionsParsingTest);
 PTF_TEST_CASE(IPv4OptionsEditTest);
 PTF_TEST_CASE(IPv4UdpChecksum);
+PTF_TEST_CASE(IPv4IncrementalChecksumTest);
 
 // Implemented in IPv6Tests.cpp
 PTF_TEST_CASE(IPv6UdpPacketParseAndCreate);
@@ -46,6 +47,16 @@ PTF_TEST_CASE(RawPacketTimeStampSetterTest);
 PTF_TEST_CASE(ParsePartialPacketTest);
 PTF_TEST_CASE(PacketTrailerTest);
 PTF_TEST_CASE(ResizeLayerTest);
+PTF_TEST_CASE(ReuseParsedPacketTest);
+PTF_TEST_CASE(ReparsePacketTest);
+PTF_TEST_CASE(LazyParsingTest);
+PTF_TEST_CASE(PacketViewTest);
+PTF_TEST_CASE(ParseBatchTest);
+PTF_TEST_CASE(PortDissectorRegistryTest);
+PTF_TEST_CASE(EnabledProtocolsTest);
+PTF_TEST_CASE(ChecksumOffloadTest);
+PTF_TEST_CASE(FlowKeyTest);
+PTF_TEST_CASE(FlowTableTest);
 
 // Implemented in HttpTests.cpp
 PTF_TEST_CASE(HttpRequestLayerParsingTest);
@@ -7,9 +7,13 @@
 #include "Packet.h"
 #include "EthLayer.h"
 #include "IPv4Layer.h"
+#include "TcpLayer.h"
 #include "UdpLayer.h"
 #include "PayloadLayer.h"
 #include "SystemUtils.h"
+#include "IpUtils.h"
+#include <stdlib.h>
+#include <string.h>
 
 PTF_TEST_CASE(IPv4PacketCreation)
 {
@@ -514,4 +518,157 @@ PTF_TEST_CASE(IPv4UdpChecksum)
 		udpLayer->computeCalculateFields();
 		PTF_ASSERT_EQUAL(udpLayer->getUdpHeader()->headerChecksum, packetChecksum, hex);
 	}
-} // Ipv4UdpChecksum
\ No newline at end of file
+} // Ipv4UdpChecksum
+
+
+
+// the scalar one's complement sum compute_checksum() is expected to match
+static uint16_t referenceChecksum(const uint8_t* data, size_t dataLen)
+{
+	uint32_t sum = 0;
+	for (; dataLen > 1; dataLen -= 2, data += 2)
+	{
+		uint16_t word;
+		memcpy(&word, data, sizeof(word));
+		sum += word;
+	}
+	if (dataLen == 1)
+		sum += *data;
+
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+	sum = be16toh((uint16_t)sum);
+	return (uint16_t)~sum;
+}
+
+
+
+PTF_TEST_CASE(IPv4IncrementalChecksumTest)
+{
+	// compute_checksum() on all lengths up to a few SIMD blocks and on unaligned buffers
+	uint8_t buffer[600];
+	srand(1);
+	for (size_t i = 0; i < sizeof(buffer); i++)
+		buffer[i] = (uint8_t)rand();
+
+	for (size_t offset = 0; offset < 4; offset++)
+	{
+		for (size_t len = 0; len <= 520; len++)
+		{
+			pcpp::ScalarBuffer<uint16_t> scalar = { (uint16_t*)(buffer + offset), len };
+			PTF_ASSERT_EQUAL(pcpp::compute_checksum(&scalar, 1), referenceChecksum(buffer + offset, len), hex);
+		}
+	}
+
+	// each implementation the CPU supports gives the same result, not only the one compute_checksum() selects
+	pcpp::ChecksumImplementation implementations[] = { pcpp::ChecksumScalar, pcpp::ChecksumSSE2, pcpp::ChecksumAVX2 };
+	PTF_ASSERT_TRUE(pcpp::isChecksumImplementationSupported(pcpp::ChecksumScalar));
+	for (size_t i = 0; i < sizeof(implementations)/sizeof(implementations[0]); i++)
+	{
+		if (!pcpp::isChecksumImplementationSupported(implementations[i]))
+			continue;
+
+		for (size_t offset = 0; offset < 4; offset++)
+		{
+			for (size_t len = 0; len <= 520; len++)
+			{
+				pcpp::ScalarBuffer<uint16_t> scalar = { (uint16_t*)(buffer + offset), len };
+				PTF_ASSERT_EQUAL(pcpp::compute_checksum(&scalar, 1, implementations[i]), referenceChecksum(buffer + offset, len), hex);
+			}
+		}
+	}
+
+	// all bytes 0xff make the 64-bit lanes carry
+	memset(buffer, 0xff, sizeof(buffer));
+	pcpp::ScalarBuffer<uint16_t> allOnes = { (uint16_t*)buffer, sizeof(buffer) };
+	PTF_ASSERT_EQUAL(pcpp::compute_checksum(&allOnes, 1), referenceChecksum(buffer, sizeof(buffer)), hex);
+	for (size_t i = 0; i < sizeof(implementations)/sizeof(implementations[0]); i++)
+	{
+		if (pcpp::isChecksumImplementationSupported(implementations[i]))
+		{
+			PTF_ASSERT_EQUAL(pcpp::compute_checksum(&allOnes, 1, implementations[i]), referenceChecksum(buffer, sizeof(buffer)), hex);
+		}
+	}
+
+	// the buffers aren't modified
+	pcpp::ScalarBuffer<uint16_t> vec[2] = { { (uint16_t*)buffer, 10 }, { (uint16_t*)(buffer + 20), 7 } };
+	pcpp::compute_checksum(vec, 2);
+	PTF_ASSERT_TRUE(vec[0].buffer == (uint16_t*)buffer);
+	PTF_ASSERT_TRUE(vec[1].buffer == (uint16_t*)(buffer + 20));
+
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/UdpPacket4Checksum1.dat");
+
+	// TCP: address, TTL and port rewrites
+	pcpp::Packet tcpPacket(&rawPacket1);
+	pcpp::IPv4Layer* ipLayer = tcpPacket.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::TcpLayer* tcpLayer = tcpPacket.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_NOT_NULL(ipLayer);
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+
+	ipLayer->setSrcIpAddress(pcpp::IPv4Address(std::string("10.20.30.40")), true);
+	ipLayer->setDstIpAddress(pcpp::IPv4Address(std::string("255.1.0.254")), true);
+	uint8_t ttl = ipLayer->getIPv4Header()->timeToLive;
+	PTF_ASSERT_TRUE(ipLayer->decrementTTL());
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->timeToLive, ttl - 1, u8);
+	tcpLayer->setSrcPort(12345, true);
+	tcpLayer->setDstPort(8080, true);
+	PTF_ASSERT_EQUAL(be16toh(tcpLayer->getTcpHeader()->portSrc), 12345, u16);
+	PTF_ASSERT_EQUAL(be16toh(tcpLayer->getTcpHeader()->portDst), 8080, u16);
+
+	uint16_t ipChecksum = ipLayer->getIPv4Header()->headerChecksum;
+	uint16_t tcpChecksum = tcpLayer->getTcpHeader()->headerChecksum;
+	PTF_ASSERT_EQUAL(tcpChecksum, htobe16(tcpLayer->calculateChecksum(false)), hex);
+	ipLayer->computeCalculateFields();
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, ipChecksum, hex);
+
+	// without updateChecksums the checksums are left as is
+	ipLayer->setSrcIpAddress(pcpp::IPv4Address(std::string("1.2.3.4")));
+	tcpLayer->setDstPort(80);
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, ipChecksum, hex);
+	PTF_ASSERT_EQUAL(tcpLayer->getTcpHeader()->headerChecksum, tcpChecksum, hex);
+
+	ipLayer->getIPv4Header()->timeToLive = 0;
+	PTF_ASSERT_FALSE(ipLayer->decrementTTL());
+
+	// in a lazily parsed packet the TCP layer doesn't exist yet when the address is changed, and is parsed for updating its checksum
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/TwoHttpRequests1.dat");
+	pcpp::Packet lazyPacket;
+	lazyPacket.setLazyParsing(true);
+	lazyPacket.setRawPacket(&rawPacket3, false);
+	ipLayer = lazyPacket.getLayerOfType<pcpp::IPv4Layer>();
+	PTF_ASSERT_NOT_NULL(ipLayer);
+	ipLayer->setSrcIpAddress(pcpp::IPv4Address(std::string("10.20.30.40")), true);
+	ipLayer->setDstIpAddress(pcpp::IPv4Address(std::string("255.1.0.254")), true);
+	tcpLayer = lazyPacket.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+	PTF_ASSERT_EQUAL(tcpLayer->getTcpHeader()->headerChecksum, htobe16(tcpLayer->calculateChecksum(false)), hex);
+	ipChecksum = ipLayer->getIPv4Header()->headerChecksum;
+	ipLayer->computeCalculateFields();
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, ipChecksum, hex);
+
+	// UDP: address and port rewrites
+	pcpp::Packet udpPacket(&rawPacket2);
+	ipLayer = udpPacket.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::UdpLayer* udpLayer = udpPacket.getLayerOfType<pcpp::UdpLayer>();
+	PTF_ASSERT_NOT_NULL(ipLayer);
+	PTF_ASSERT_NOT_NULL(udpLayer);
+	PTF_ASSERT_NOT_EQUAL(udpLayer->getUdpHeader()->headerChecksum, 0, u16);
+
+	ipLayer->setDstIpAddress(pcpp::IPv4Address(std::string("192.168.100.1")), true);
+	udpLayer->setSrcPort(5000, true);
+	udpLayer->setDstPort(53, true);
+	PTF_ASSERT_EQUAL(udpLayer->getUdpHeader()->headerChecksum, htobe16(udpLayer->calculateChecksum(false)), hex);
+	ipChecksum = ipLayer->getIPv4Header()->headerChecksum;
+	ipLayer->computeCalculateFields();
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, ipChecksum, hex);
+
+	// a zero UDP checksum means no checksum and stays zero
+	udpLayer->getUdpHeader()->headerChecksum = 0;
+	ipLayer->setSrcIpAddress(pcpp::IPv4Address(std::string("172.16.0.1")), true);
+	udpLayer->setSrcPort(5001, true);
+	PTF_ASSERT_EQUAL(udpLayer->getUdpHeader()->headerChecksum, 0, u16);
+} // IPv4IncrementalChecksumTest
\ No newline at end of file
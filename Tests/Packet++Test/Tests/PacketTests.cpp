@@ -17,8 +17,13 @@
 #include "SSLLayer.h"
 #include "RadiusLayer.h"
 #include "PacketTrailerLayer.h"
+#include "PacketView.h"
+#include "PortDissectorRegistry.h"
+#include "FlowKey.h"
+#include "FlowTable.h"
 #include "PayloadLayer.h"
 #include "SystemUtils.h"
+#include "IpUtils.h"
 
 PTF_TEST_CASE(InsertDataToPacket)
 {
@@ -915,4 +920,822 @@ PTF_TEST_CASE(ResizeLayerTest)
 	PTF_ASSERT_EQUAL(rawData2[5], 0xAD, u8);
 	PTF_ASSERT_EQUAL(rawData2[6], 0xBE, u8);
 	PTF_ASSERT_EQUAL(rawData2[7], 0xEF, u8);
-} // ResizeLayerTest
\ No newline at end of file
+} // ResizeLayerTest
+
+
+PTF_TEST_CASE(ReuseParsedPacketTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/packet_trailer_ipv4.dat");
+
+	// parse a few packets using the same Packet instance, layers are re-allocated from the same arena each time
+	pcpp::Packet packet(&rawPacket1);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+	PTF_ASSERT_NOT_NULL(packet.getLayerOfType<pcpp::HttpRequestLayer>());
+
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::HTTPRequest));
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::DNS));
+	PTF_ASSERT_NOT_NULL(packet.getLayerOfType<pcpp::DnsLayer>());
+	PTF_ASSERT_EQUAL(packet.getLayerOfType<pcpp::DnsLayer>()->getQueryCount(), 2, size);
+
+	packet.setRawPacket(&rawPacket3, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::PacketTrailer));
+	PTF_ASSERT_NULL(packet.getLayerOfType<pcpp::DnsLayer>());
+	PTF_ASSERT_EQUAL(packet.getFirstLayer()->getProtocol(), pcpp::Ethernet, enum);
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::PacketTrailer, enum);
+
+	// a layer detached from the packet must stay valid after the packet is re-parsed and destroyed
+	pcpp::Packet* httpPacket = new pcpp::Packet(&rawPacket1);
+	pcpp::TcpLayer* tcpLayer = dynamic_cast<pcpp::TcpLayer*>(httpPacket->detachLayer(pcpp::TCP));
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+	httpPacket->setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_TRUE(httpPacket->isPacketOfType(pcpp::DNS));
+	delete httpPacket;
+	PTF_ASSERT_FALSE(tcpLayer->isAllocatedToPacket());
+	PTF_ASSERT_EQUAL(be16toh(tcpLayer->getTcpHeader()->portDst), 80, u16);
+	delete tcpLayer;
+} // ReuseParsedPacketTest
+
+
+PTF_TEST_CASE(ReparsePacketTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/TwoHttpRequests2.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/Dns2.dat");
+	READ_FILE_AND_CREATE_PACKET(4, "PacketExamples/ipv6_options_multi.dat");
+	READ_FILE_AND_CREATE_PACKET(5, "PacketExamples/IPv6UdpPacket.dat");
+	READ_FILE_AND_CREATE_PACKET(6, "PacketExamples/ArpRequestWithVlan.dat");
+	READ_FILE_AND_CREATE_PACKET(7, "PacketExamples/packet_trailer_ipv4.dat");
+	READ_FILE_AND_CREATE_PACKET(8, "PacketExamples/IPv6Frag1.dat");
+
+	pcpp::RawPacket* rawPackets[] = { &rawPacket1, &rawPacket2, &rawPacket3, &rawPacket4, &rawPacket5, &rawPacket6, &rawPacket7, &rawPacket8, &rawPacket1 };
+
+	// re-parsing must produce exactly the same layers as parsing the raw packet from scratch
+	pcpp::Packet packet;
+	for (size_t i = 0; i < sizeof(rawPackets)/sizeof(rawPackets[0]); i++)
+	{
+		packet.reparse(rawPackets[i]);
+		pcpp::Packet expectedPacket(rawPackets[i]);
+		PTF_ASSERT_TRUE(packet.getRawPacket() == rawPackets[i]);
+		PTF_ASSERT_EQUAL(packet.toString(), expectedPacket.toString(), string);
+		PTF_ASSERT_TRUE(packet.isPacketOfType(expectedPacket.getLastLayer()->getProtocol()));
+		PTF_ASSERT_EQUAL(packet.getLastLayer()->getDataLen(), expectedPacket.getLastLayer()->getDataLen(), size);
+	}
+
+	// layers of the same protocol stack are re-bound to the new data instead of being re-created
+	packet.reparse(&rawPacket1);
+	pcpp::EthLayer* ethLayer = packet.getLayerOfType<pcpp::EthLayer>();
+	pcpp::IPv4Layer* ipLayer = packet.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::TcpLayer* tcpLayer = packet.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+	uint16_t srcPort1 = be16toh(tcpLayer->getTcpHeader()->portSrc);
+	packet.reparse(&rawPacket2);
+	PTF_ASSERT_TRUE(packet.getLayerOfType<pcpp::EthLayer>() == ethLayer);
+	PTF_ASSERT_TRUE(packet.getLayerOfType<pcpp::IPv4Layer>() == ipLayer);
+	PTF_ASSERT_TRUE(packet.getLayerOfType<pcpp::TcpLayer>() == tcpLayer);
+	PTF_ASSERT_TRUE(tcpLayer->getData() == rawPacket2.getRawData() + sizeof(pcpp::ether_header) + ipLayer->getHeaderLen());
+	PTF_ASSERT_NOT_EQUAL(be16toh(tcpLayer->getTcpHeader()->portSrc), srcPort1, u16);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// parse only up to a certain protocol
+	packet.reparse(&rawPacket1, pcpp::TCP);
+	PTF_ASSERT_TRUE(packet.getLayerOfType<pcpp::TcpLayer>() == tcpLayer);
+	PTF_ASSERT_TRUE(packet.getLastLayer() == tcpLayer);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::HTTPRequest));
+	packet.reparse(&rawPacket2, pcpp::UnknownProtocol, pcpp::OsiModelNetworkLayer);
+	PTF_ASSERT_TRUE(packet.getLastLayer() == ipLayer);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::TCP));
+	packet.reparse(&rawPacket2);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// a detached layer prevents re-using the layers, the packet is parsed from scratch
+	pcpp::Layer* detachedLayer = packet.detachLayer(pcpp::HTTPRequest);
+	PTF_ASSERT_NOT_NULL(detachedLayer);
+	packet.reparse(&rawPacket1);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+	PTF_ASSERT_EQUAL(packet.toString(), pcpp::Packet(&rawPacket1).toString(), string);
+	delete detachedLayer;
+} // ReparsePacketTest
+
+
+PTF_TEST_CASE(LazyParsingTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/packet_trailer_ipv4.dat");
+	READ_FILE_AND_CREATE_PACKET(4, "PacketExamples/ipv6_options_multi.dat");
+
+	pcpp::Packet packet;
+	PTF_ASSERT_FALSE(packet.isLazyParsing());
+	packet.setLazyParsing(true);
+	PTF_ASSERT_TRUE(packet.isLazyParsing());
+
+	// layers are parsed as they're accessed
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_EQUAL(packet.getFirstLayer()->getProtocol(), pcpp::Ethernet, enum);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::TCP));
+	pcpp::TcpLayer* tcpLayer = packet.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+	PTF_ASSERT_EQUAL(be16toh(tcpLayer->getTcpHeader()->portDst), 80, u16);
+	PTF_ASSERT_NOT_NULL(packet.getLayerOfType<pcpp::HttpRequestLayer>());
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::DNS));
+
+	// the result of lazy parsing is identical to eager parsing
+	pcpp::RawPacket* rawPackets[] = { &rawPacket1, &rawPacket2, &rawPacket3, &rawPacket4 };
+	for (size_t i = 0; i < sizeof(rawPackets)/sizeof(rawPackets[0]); i++)
+	{
+		packet.setRawPacket(rawPackets[i], false);
+		pcpp::Packet expectedPacket(rawPackets[i]);
+		PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), expectedPacket.getLastLayer()->getProtocol(), enum);
+		PTF_ASSERT_EQUAL(packet.toString(), expectedPacket.toString(), string);
+
+		packet.reparse(rawPackets[i]);
+		PTF_ASSERT_TRUE(packet.isPacketOfType(expectedPacket.getLastLayer()->getProtocol()));
+		PTF_ASSERT_EQUAL(packet.toString(), expectedPacket.toString(), string);
+	}
+
+	packet.setRawPacket(&rawPacket3, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::PacketTrailer));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::PacketTrailer, enum);
+
+	// parse-until limits are kept when layers are parsed on demand
+	packet.setRawPacket(&rawPacket1, false, pcpp::TCP);
+	PTF_ASSERT_NOT_NULL(packet.getLayerOfType<pcpp::TcpLayer>());
+	PTF_ASSERT_NULL(packet.getLayerOfType<pcpp::HttpRequestLayer>());
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::TCP, enum);
+	packet.setRawPacket(&rawPacket2, false, pcpp::UnknownProtocol, pcpp::OsiModelNetworkLayer);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::UDP));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::IPv6, enum);
+
+	// modifying a packet parses all of its layers first
+	packet.setRawPacket(&rawPacket2, false);
+	pcpp::PayloadLayer payloadLayer((const uint8_t*)"abcd", 4, false);
+	PTF_ASSERT_TRUE(packet.addLayer(&payloadLayer));
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::DNS));
+	PTF_ASSERT_TRUE(packet.getLastLayer() == &payloadLayer);
+	PTF_ASSERT_TRUE(packet.getLayerOfType<pcpp::DnsLayer>()->getNextLayer() == &payloadLayer);
+	PTF_ASSERT_NOT_NULL(packet.detachLayer(pcpp::GenericPayload));
+
+	// copies of a lazily parsed packet contain all layers
+	packet.setRawPacket(&rawPacket1, false);
+	pcpp::Packet copiedPacket(packet);
+	PTF_ASSERT_TRUE(copiedPacket.isLazyParsing());
+	PTF_ASSERT_TRUE(copiedPacket.isPacketOfType(pcpp::HTTPRequest));
+	PTF_ASSERT_EQUAL(copiedPacket.getLastLayer()->getProtocol(), pcpp::HTTPRequest, enum);
+} // LazyParsingTest
+
+
+
+PTF_TEST_CASE(PacketViewTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/ipv6_options_multi.dat");
+	READ_FILE_AND_CREATE_PACKET(4, "PacketExamples/ArpRequestWithVlan.dat");
+	READ_FILE_AND_CREATE_PACKET(5, "PacketExamples/MplsPackets1.dat");
+	READ_FILE_AND_CREATE_PACKET(6, "PacketExamples/GREv1_1.dat");
+	READ_FILE_AND_CREATE_PACKET(7, "PacketExamples/Vxlan1.dat");
+	READ_FILE_AND_CREATE_PACKET(8, "PacketExamples/gtp-u-2ext.dat");
+	READ_FILE_AND_CREATE_PACKET(9, "PacketExamples/IPv6Frag1.dat");
+	READ_FILE_AND_CREATE_PACKET(10, "PacketExamples/IPv4Frag2.dat");
+	READ_FILE_AND_CREATE_PACKET(11, "PacketExamples/packet_trailer_ipv4.dat");
+	READ_FILE_AND_CREATE_PACKET_LINKTYPE(12, "PacketExamples/SllPacket2.dat", pcpp::LINKTYPE_LINUX_SLL);
+
+	// the decoded headers match the layers of a fully parsed packet
+	pcpp::RawPacket* rawPackets[] = { &rawPacket1, &rawPacket2, &rawPacket3, &rawPacket4, &rawPacket5, &rawPacket6,
+		&rawPacket7, &rawPacket8, &rawPacket9, &rawPacket10, &rawPacket11, &rawPacket12 };
+	for (size_t i = 0; i < sizeof(rawPackets)/sizeof(rawPackets[0]); i++)
+	{
+		pcpp::PacketView view(rawPackets[i]);
+		pcpp::Packet packet(rawPackets[i]);
+		PTF_ASSERT_TRUE(view.getRawPacket() == rawPackets[i]);
+		PTF_ASSERT_GREATER_THAN(view.getHeaderCount(), 0, size);
+
+		pcpp::Layer* curLayer = packet.getFirstLayer();
+		for (size_t j = 0; j < view.getHeaderCount(); j++)
+		{
+			PTF_ASSERT_NOT_NULL(curLayer);
+			const pcpp::PacketView::HeaderInfo& header = view.getHeader(j);
+			PTF_ASSERT_EQUAL(header.protocol, curLayer->getProtocol(), enum);
+			PTF_ASSERT_TRUE(view.getHeaderData(header) == curLayer->getData());
+			PTF_ASSERT_EQUAL((size_t)header.length, curLayer->getHeaderLen(), size);
+			PTF_ASSERT_TRUE(view.isPacketOfType(header.protocol));
+			curLayer = curLayer->getNextLayer();
+		}
+	}
+
+	// 5-tuple and payload of a TCP packet
+	pcpp::PacketView view(&rawPacket1);
+	PTF_ASSERT_EQUAL(view.getHeaderCount(), 3, size);
+	PTF_ASSERT_FALSE(view.isFragment());
+	PTF_ASSERT_EQUAL(view.getNetworkHeader()->protocol, pcpp::IPv4, enum);
+	PTF_ASSERT_EQUAL(view.getTransportHeader()->protocol, pcpp::TCP, enum);
+	PTF_ASSERT_TRUE(view.getHeaderOfType(pcpp::TCP) == view.getTransportHeader());
+	PTF_ASSERT_NULL(view.getHeaderOfType(pcpp::UDP));
+	pcpp::Packet tcpPacket(&rawPacket1);
+	pcpp::IPv4Layer* ip4Layer = tcpPacket.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::TcpLayer* tcpLayer = tcpPacket.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_EQUAL(view.getSrcIPv4Address(), ip4Layer->getSrcIpAddress(), object);
+	PTF_ASSERT_EQUAL(view.getDstIPv4Address(), ip4Layer->getDstIpAddress(), object);
+	PTF_ASSERT_EQUAL(view.getSrcIPv6Address(), pcpp::IPv6Address::Zero, object);
+	PTF_ASSERT_EQUAL(view.getSrcPort(), be16toh(tcpLayer->getTcpHeader()->portSrc), u16);
+	PTF_ASSERT_EQUAL(view.getDstPort(), 80, u16);
+	PTF_ASSERT_EQUAL(view.getTransportPayloadOffset(), (size_t)(tcpLayer->getLayerPayload() - rawPacket1.getRawData()), size);
+	PTF_ASSERT_EQUAL(view.getTransportPayloadLen(), tcpLayer->getLayerPayloadSize(), size);
+
+	// 5-tuple of an IPv6 packet
+	PTF_ASSERT_TRUE(view.parse(&rawPacket2));
+	pcpp::Packet ip6Packet(&rawPacket2);
+	pcpp::IPv6Layer* ip6Layer = ip6Packet.getLayerOfType<pcpp::IPv6Layer>();
+	pcpp::UdpLayer* udpLayer = ip6Packet.getLayerOfType<pcpp::UdpLayer>();
+	PTF_ASSERT_NOT_NULL(udpLayer);
+	PTF_ASSERT_EQUAL(view.getSrcIPv6Address(), ip6Layer->getSrcIpAddress(), object);
+	PTF_ASSERT_EQUAL(view.getDstIPv6Address(), ip6Layer->getDstIpAddress(), object);
+	PTF_ASSERT_EQUAL(view.getSrcIPv4Address(), pcpp::IPv4Address::Zero, object);
+	PTF_ASSERT_EQUAL(view.getDstPort(), be16toh(udpLayer->getUdpHeader()->portDst), u16);
+	PTF_ASSERT_EQUAL(view.getTransportPayloadLen(), udpLayer->getLayerPayloadSize(), size);
+
+	// tunnels: the network and transport headers are the innermost ones
+	PTF_ASSERT_TRUE(view.parse(&rawPacket7));
+	PTF_ASSERT_TRUE(view.isPacketOfType(pcpp::VXLAN));
+	PTF_ASSERT_TRUE(view.getHeaderOfType(pcpp::IPv4, true) == view.getNetworkHeader());
+	PTF_ASSERT_TRUE(view.getHeaderOfType(pcpp::IPv4) != view.getNetworkHeader());
+	PTF_ASSERT_TRUE(view.parse(&rawPacket8));
+	PTF_ASSERT_TRUE(view.isPacketOfType(pcpp::GTPv1));
+	PTF_ASSERT_TRUE(view.getHeaderOfType(pcpp::IPv4, true) == view.getNetworkHeader());
+	PTF_ASSERT_TRUE(view.getHeaderOfType(pcpp::GTPv1)->offset < view.getNetworkHeader()->offset);
+
+	// fragments: decoding stops after the IP header
+	PTF_ASSERT_TRUE(view.parse(&rawPacket9));
+	PTF_ASSERT_TRUE(view.isFragment());
+	PTF_ASSERT_NULL(view.getTransportHeader());
+	PTF_ASSERT_EQUAL(view.getSrcPort(), 0, u16);
+	PTF_ASSERT_EQUAL(view.getTransportPayloadLen(), 0, size);
+	PTF_ASSERT_TRUE(view.parse(&rawPacket10));
+	PTF_ASSERT_TRUE(view.isFragment());
+	PTF_ASSERT_EQUAL(view.getHeaderCount(), 2, size);
+
+	// padding and trailers aren't counted as transport payload
+	PTF_ASSERT_TRUE(view.parse(&rawPacket11));
+	pcpp::Packet trailerPacket(&rawPacket11);
+	PTF_ASSERT_TRUE(trailerPacket.isPacketOfType(pcpp::PacketTrailer));
+	pcpp::Layer* transportLayer = trailerPacket.getLayerOfType<pcpp::TcpLayer>();
+	if (transportLayer == NULL)
+		transportLayer = trailerPacket.getLayerOfType<pcpp::UdpLayer>();
+	PTF_ASSERT_NOT_NULL(transportLayer);
+	PTF_ASSERT_EQUAL(view.getTransportPayloadLen(),
+		(size_t)(trailerPacket.getLayerOfType<pcpp::PacketTrailerLayer>()->getData() - transportLayer->getLayerPayload()), size);
+
+	// upgrading the view to a full packet
+	PTF_ASSERT_TRUE(view.parse(&rawPacket2));
+	pcpp::Packet packet;
+	PTF_ASSERT_TRUE(view.toPacket(packet));
+	PTF_ASSERT_TRUE(packet.getRawPacket() == &rawPacket2);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::DNS));
+	PTF_ASSERT_TRUE(view.toPacket(packet, pcpp::UDP));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::UDP, enum);
+
+	// empty views
+	view.clear();
+	PTF_ASSERT_EQUAL(view.getHeaderCount(), 0, size);
+	PTF_ASSERT_NULL(view.getNetworkHeader());
+	PTF_ASSERT_FALSE(view.toPacket(packet));
+	PTF_ASSERT_FALSE(view.parse(NULL));
+	pcpp::PacketView emptyView;
+	PTF_ASSERT_NULL(emptyView.getRawPacket());
+	PTF_ASSERT_EQUAL(emptyView.getDstPort(), 0, u16);
+
+	// more stacked headers than the view can hold: Ethernet, VLAN tags, IPv4 and UDP
+	for (int numOfVlans = 14; numOfVlans <= 15; numOfVlans++)
+	{
+		uint8_t stackedData[14 + 15 * 4 + 20 + 8 + 4];
+		memset(stackedData, 0, sizeof(stackedData));
+		size_t stackedLen = 14 + numOfVlans * 4 + 20 + 8 + 4;
+		stackedData[12] = 0x81;
+		for (int i = 0; i < numOfVlans; i++)
+		{
+			stackedData[14 + i * 4 + 2] = (i == numOfVlans - 1 ? 0x08 : 0x81);
+		}
+		uint8_t* ipData = stackedData + 14 + numOfVlans * 4;
+		ipData[0] = 0x45;
+		ipData[3] = 20 + 8 + 4;
+		ipData[8] = 64;
+		ipData[9] = 17;
+		ipData[20 + 5] = 8 + 4;
+
+		pcpp::RawPacket stackedRawPacket(stackedData, (int)stackedLen, time, false);
+		PTF_ASSERT_TRUE(view.parse(&stackedRawPacket));
+		PTF_ASSERT_EQUAL(view.getHeaderCount(), pcpp::PacketView::MaxHeaders, size);
+		PTF_ASSERT_NULL(view.getTransportHeader());
+		PTF_ASSERT_EQUAL(view.getTransportPayloadLen(), 0, size);
+		if (numOfVlans == 14)
+		{
+			// IPv4 is the last header recorded
+			PTF_ASSERT_NOT_NULL(view.getNetworkHeader());
+			PTF_ASSERT_EQUAL(view.getNetworkHeader()->protocol, pcpp::IPv4, enum);
+			PTF_ASSERT_TRUE(view.getNetworkHeader() == &view.getHeader(pcpp::PacketView::MaxHeaders - 1));
+		}
+		else
+		{
+			PTF_ASSERT_NULL(view.getNetworkHeader());
+			PTF_ASSERT_FALSE(view.isPacketOfType(pcpp::IPv4));
+		}
+	}
+} // PacketViewTest
+
+
+
+PTF_TEST_CASE(ParseBatchTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/ArpRequestWithVlan.dat");
+	READ_FILE_AND_CREATE_PACKET(4, "PacketExamples/TwoHttpRequests2.dat");
+	READ_FILE_AND_CREATE_PACKET(5, "PacketExamples/Vxlan1.dat");
+	READ_FILE_AND_CREATE_PACKET(6, "PacketExamples/IPv4Frag2.dat");
+	READ_FILE_AND_CREATE_PACKET(7, "PacketExamples/packet_trailer_ipv4.dat");
+	READ_FILE_AND_CREATE_PACKET(8, "PacketExamples/Dns1.dat");
+	READ_FILE_AND_CREATE_PACKET(9, "PacketExamples/gtp-u1.dat");
+	READ_FILE_AND_CREATE_PACKET(10, "PacketExamples/SSL-ClientHello1.dat");
+
+	// a burst larger than the prefetch distance
+	pcpp::RawPacket* rawPackets[] = { &rawPacket1, &rawPacket2, &rawPacket3, &rawPacket4, &rawPacket5, &rawPacket6, &rawPacket7,
+		&rawPacket8, &rawPacket9, &rawPacket10 };
+	const size_t burstSize = sizeof(rawPackets)/sizeof(rawPackets[0]);
+	pcpp::Packet packets[burstSize];
+
+	pcpp::Packet::parseBatch(rawPackets, packets, burstSize);
+	for (size_t i = 0; i < burstSize; i++)
+	{
+		pcpp::Packet expectedPacket(rawPackets[i]);
+		PTF_ASSERT_TRUE(packets[i].getRawPacket() == rawPackets[i]);
+		PTF_ASSERT_EQUAL(packets[i].toString(), expectedPacket.toString(), string);
+	}
+
+	// parsing the next burst into the same packets
+	pcpp::Packet::parseBatch(rawPackets + 1, packets, burstSize - 1, pcpp::UnknownProtocol, pcpp::OsiModelTransportLayer);
+	for (size_t i = 0; i < burstSize - 1; i++)
+	{
+		pcpp::Packet expectedPacket(rawPackets[i + 1], false, pcpp::UnknownProtocol, pcpp::OsiModelTransportLayer);
+		PTF_ASSERT_TRUE(packets[i].getRawPacket() == rawPackets[i + 1]);
+		PTF_ASSERT_EQUAL(packets[i].toString(), expectedPacket.toString(), string);
+	}
+	PTF_ASSERT_TRUE(packets[burstSize - 1].getRawPacket() == rawPackets[burstSize - 1]);
+
+	// short and empty bursts
+	pcpp::Packet::parseBatch(rawPackets, packets, 1, pcpp::IPv4);
+	PTF_ASSERT_EQUAL(packets[0].getLastLayer()->getProtocol(), pcpp::IPv4, enum);
+	pcpp::Packet::parseBatch(rawPackets, packets, 0);
+	PTF_ASSERT_TRUE(packets[0].getRawPacket() == rawPackets[0]);
+} // ParseBatchTest
+
+
+
+static int portDissectorTestCallCount = 0;
+
+static pcpp::Layer* countingPortDissector(uint8_t* /*data*/, size_t /*dataLen*/, pcpp::Layer* /*prevLayer*/, pcpp::Packet* /*packet*/, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	portDissectorTestCallCount++;
+	return NULL;
+}
+
+static pcpp::Layer* payloadPortDissector(uint8_t* data, size_t dataLen, pcpp::Layer* prevLayer, pcpp::Packet* packet, uint16_t /*srcPort*/, uint16_t /*dstPort*/)
+{
+	return new(packet) pcpp::PayloadLayer(data, dataLen, prevLayer, packet);
+}
+
+PTF_TEST_CASE(PortDissectorRegistryTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+
+	pcpp::PortDissectorRegistry& registry = pcpp::PortDissectorRegistry::getInstance();
+	registry.resetToDefaults();
+
+	// built-in dissectors are registered on their well-known ports
+	PTF_ASSERT_TRUE(registry.isPortRegistered(pcpp::TCP, pcpp::HTTPRequest, 80));
+	PTF_ASSERT_TRUE(registry.isPortRegistered(pcpp::TCP, pcpp::SSL, 443));
+	PTF_ASSERT_TRUE(registry.isPortRegistered(pcpp::UDP, pcpp::DNS, 53));
+	PTF_ASSERT_TRUE(registry.isPortRegistered(pcpp::UDP, pcpp::GTPv1, 2152));
+	PTF_ASSERT_FALSE(registry.isPortRegistered(pcpp::UDP, pcpp::DNS, 80));
+	PTF_ASSERT_FALSE(registry.isPortRegistered(pcpp::TCP, pcpp::DNS, 53));
+	PTF_ASSERT_TRUE(registry.isDissectorEnabled(pcpp::UDP, pcpp::SIP));
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::TCP, pcpp::HTTPRequest), 0, int);
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::DHCP), 0, int);
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::BGP), -1, int);
+
+	pcpp::Packet packet(&rawPacket1);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// disabling a dissector
+	PTF_ASSERT_TRUE(registry.setDissectorEnabled(pcpp::TCP, pcpp::HTTPRequest, false));
+	PTF_ASSERT_FALSE(registry.isDissectorEnabled(pcpp::TCP, pcpp::HTTPRequest));
+	PTF_ASSERT_TRUE(registry.isPortRegistered(pcpp::TCP, pcpp::HTTPRequest, 80));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::HTTPRequest));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::GenericPayload, enum);
+	PTF_ASSERT_TRUE(registry.setDissectorEnabled(pcpp::TCP, pcpp::HTTPRequest, true));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// removing and adding ports
+	PTF_ASSERT_TRUE(registry.removePort(pcpp::TCP, pcpp::HTTPRequest, 80));
+	PTF_ASSERT_FALSE(registry.removePort(pcpp::TCP, pcpp::HTTPRequest, 80));
+	PTF_ASSERT_FALSE(registry.isPortRegistered(pcpp::TCP, pcpp::HTTPRequest, 80));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::HTTPRequest));
+	PTF_ASSERT_TRUE(registry.addPort(pcpp::TCP, pcpp::HTTPRequest, 80));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// a higher priority dissector on the same port is tried first. SIP claims all data on its ports so DNS isn't tried
+	PTF_ASSERT_TRUE(registry.addPort(pcpp::UDP, pcpp::SIP, 5353));
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::DNS));
+	PTF_ASSERT_TRUE(registry.setDissectorPriority(pcpp::UDP, pcpp::SIP, 0));
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::SIP), 0, int);
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::DHCP), 1, int);
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::DNS));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::GenericPayload, enum);
+	PTF_ASSERT_TRUE(registry.setDissectorPriority(pcpp::UDP, pcpp::SIP, 100));
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::SIP), 5, int);
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::DNS));
+
+	// user-defined dissectors
+	PTF_ASSERT_TRUE(registry.registerDissector(pcpp::UDP, pcpp::SDP, countingPortDissector));
+	PTF_ASSERT_TRUE(registry.addPort(pcpp::UDP, pcpp::SDP, 5353));
+	PTF_ASSERT_TRUE(registry.setDissectorPriority(pcpp::UDP, pcpp::SDP, 0));
+	portDissectorTestCallCount = 0;
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_EQUAL(portDissectorTestCallCount, 1, int);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::DNS));
+	PTF_ASSERT_TRUE(registry.unregisterDissector(pcpp::UDP, pcpp::SDP));
+	PTF_ASSERT_FALSE(registry.unregisterDissector(pcpp::UDP, pcpp::SDP));
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_EQUAL(portDissectorTestCallCount, 1, int);
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::DHCP), 0, int);
+
+	// dissectors that match only the source port aren't tried on the destination port
+	PTF_ASSERT_TRUE(registry.registerDissector(pcpp::TCP, pcpp::SDP, payloadPortDissector, pcpp::PortDissectorRegistry::MatchSrcPort));
+	PTF_ASSERT_TRUE(registry.addPort(pcpp::TCP, pcpp::SDP, 80));
+	PTF_ASSERT_TRUE(registry.setDissectorPriority(pcpp::TCP, pcpp::SDP, 0));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// invalid input
+	pcpp::LoggerPP::getInstance().supressErrors();
+	PTF_ASSERT_FALSE(registry.registerDissector(pcpp::TCP, pcpp::SDP, payloadPortDissector));
+	PTF_ASSERT_FALSE(registry.registerDissector(pcpp::IPv4, pcpp::ICMP, payloadPortDissector));
+	PTF_ASSERT_FALSE(registry.registerDissector(pcpp::UDP, pcpp::ICMP, NULL));
+	pcpp::LoggerPP::getInstance().enableErrors();
+	PTF_ASSERT_FALSE(registry.addPort(pcpp::UDP, pcpp::ICMP, 1));
+	PTF_ASSERT_FALSE(registry.setDissectorEnabled(pcpp::TCP, pcpp::DNS, false));
+	PTF_ASSERT_FALSE(registry.setDissectorPriority(pcpp::TCP, pcpp::DNS, 0));
+
+	// back to defaults
+	registry.resetToDefaults();
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::TCP, pcpp::SDP), -1, int);
+	PTF_ASSERT_EQUAL(registry.getDissectorPriority(pcpp::UDP, pcpp::SIP), 3, int);
+	PTF_ASSERT_FALSE(registry.isPortRegistered(pcpp::UDP, pcpp::SIP, 5353));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+} // PortDissectorRegistryTest
+
+
+
+PTF_TEST_CASE(EnabledProtocolsTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/sip_req1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Bgp_open.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(4, "PacketExamples/SSL-ClientHello1.dat");
+
+	pcpp::Packet packet;
+	PTF_ASSERT_EQUAL(packet.getEnabledProtocols(), pcpp::AllProtocols, u64);
+	PTF_ASSERT_EQUAL(pcpp::Packet::getDefaultEnabledProtocols(), pcpp::AllProtocols, u64);
+
+	// disabling a protocol that comes on top of an enabled one
+	packet.setEnabledProtocols(pcpp::AllProtocols & ~pcpp::SDP);
+	PTF_ASSERT_FALSE(packet.isProtocolEnabled(pcpp::SDP));
+	PTF_ASSERT_TRUE(packet.isProtocolEnabled(pcpp::SIP));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::SIPRequest));
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::SDP));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::GenericPayload, enum);
+
+	// disabled application layer protocols are emitted as payload
+	packet.setEnabledProtocols(pcpp::AllProtocols & ~(pcpp::SIP | pcpp::BGP | pcpp::HTTP));
+	packet.setRawPacket(&rawPacket1, false);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::SIP));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::GenericPayload, enum);
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getPrevLayer()->getProtocol(), pcpp::UDP, enum);
+	packet.setRawPacket(&rawPacket2, false);
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::BGP));
+	PTF_ASSERT_EQUAL(packet.getLastLayer()->getProtocol(), pcpp::GenericPayload, enum);
+	packet.reparse(&rawPacket3);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::TCP));
+	PTF_ASSERT_FALSE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// disabling only one sub-protocol of HTTP doesn't affect the other
+	packet.setEnabledProtocols(pcpp::AllProtocols & ~pcpp::HTTPResponse);
+	packet.reparse(&rawPacket3);
+	PTF_ASSERT_TRUE(packet.isPacketOfType(pcpp::HTTPRequest));
+
+	// copies keep the enabled protocols
+	packet.setEnabledProtocols(pcpp::AllProtocols & ~pcpp::HTTP);
+	packet.reparse(&rawPacket3);
+	pcpp::Packet copiedPacket(packet);
+	PTF_ASSERT_EQUAL(copiedPacket.getEnabledProtocols(), (pcpp::AllProtocols & ~pcpp::HTTP), u64);
+	PTF_ASSERT_FALSE(copiedPacket.isPacketOfType(pcpp::HTTPRequest));
+
+	// the default applies to packets created afterwards
+	pcpp::Packet::setDefaultEnabledProtocols(pcpp::AllProtocols & ~pcpp::SSL);
+	pcpp::Packet sslPacket(&rawPacket4);
+	PTF_ASSERT_FALSE(sslPacket.isPacketOfType(pcpp::SSL));
+	PTF_ASSERT_TRUE(sslPacket.isPacketOfType(pcpp::GenericPayload));
+	pcpp::Packet::setDefaultEnabledProtocols(pcpp::AllProtocols);
+	pcpp::Packet sslPacket2(&rawPacket4);
+	PTF_ASSERT_TRUE(sslPacket2.isPacketOfType(pcpp::SSL));
+	PTF_ASSERT_FALSE(packet.isProtocolEnabled(pcpp::HTTP));
+} // EnabledProtocolsTest
+
+
+
+PTF_TEST_CASE(ChecksumOffloadTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+
+	pcpp::Packet tcpPacket(&rawPacket1);
+	pcpp::IPv4Layer* ipLayer = tcpPacket.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::TcpLayer* tcpLayer = tcpPacket.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_NOT_NULL(ipLayer);
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+	PTF_ASSERT_EQUAL(tcpPacket.getChecksumOffload(), pcpp::ChecksumOffloadNone, u8);
+	PTF_ASSERT_EQUAL(rawPacket1.getChecksumOffloadInfo().flags, pcpp::ChecksumOffloadNone, u8);
+	uint16_t ipChecksum = ipLayer->getIPv4Header()->headerChecksum;
+	uint16_t tcpChecksum = tcpLayer->getTcpHeader()->headerChecksum;
+
+	// offloaded checksums are left the way devices expect them
+	tcpPacket.setChecksumOffload(pcpp::ChecksumOffloadAll);
+	PTF_ASSERT_TRUE(tcpPacket.isChecksumOffloaded(ipLayer));
+	PTF_ASSERT_TRUE(tcpPacket.isChecksumOffloaded(tcpLayer));
+	PTF_ASSERT_FALSE(tcpPacket.isChecksumOffloaded(tcpPacket.getFirstLayer()));
+	tcpPacket.computeCalculateFields();
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, 0, u16);
+	PTF_ASSERT_EQUAL(tcpLayer->getTcpHeader()->headerChecksum, htobe16(tcpLayer->calculatePseudoHeaderChecksum(false)), hex);
+	const pcpp::ChecksumOffloadInfo& tcpOffloadInfo = rawPacket1.getChecksumOffloadInfo();
+	PTF_ASSERT_EQUAL(tcpOffloadInfo.flags, (pcpp::ChecksumOffloadIPv4 | pcpp::ChecksumOffloadTCP), u8);
+	PTF_ASSERT_FALSE(tcpOffloadInfo.isIPv6);
+	PTF_ASSERT_EQUAL(tcpOffloadInfo.l2Len, 14, u16);
+	PTF_ASSERT_EQUAL(tcpOffloadInfo.l3Len, 20, u16);
+	PTF_ASSERT_EQUAL(tcpOffloadInfo.getL4ChecksumStart(), 34, u16);
+	PTF_ASSERT_EQUAL(tcpOffloadInfo.getL4ChecksumOffset(), 16, u16);
+
+	// a device summing the TCP header and payload on top of the pseudo header checksum gets the full checksum
+	pcpp::ScalarBuffer<uint16_t> tcpData = { (uint16_t*)tcpLayer->getData(), tcpLayer->getDataLen() };
+	PTF_ASSERT_EQUAL(htobe16(pcpp::compute_checksum(&tcpData, 1)), tcpChecksum, hex);
+
+	// copies keep the offload information, new raw data resets it
+	pcpp::RawPacket rawPacketCopy(rawPacket1);
+	PTF_ASSERT_EQUAL(rawPacketCopy.getChecksumOffloadInfo().flags, tcpOffloadInfo.flags, u8);
+	pcpp::Packet tcpPacketCopy(tcpPacket);
+	PTF_ASSERT_EQUAL(tcpPacketCopy.getChecksumOffload(), pcpp::ChecksumOffloadAll, u8);
+
+	// only the IPv4 header checksum
+	tcpPacket.setChecksumOffload(pcpp::ChecksumOffloadIPv4);
+	tcpPacket.computeCalculateFields();
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, 0, u16);
+	PTF_ASSERT_EQUAL(tcpLayer->getTcpHeader()->headerChecksum, tcpChecksum, hex);
+	PTF_ASSERT_EQUAL(rawPacket1.getChecksumOffloadInfo().flags, pcpp::ChecksumOffloadIPv4, u8);
+	PTF_ASSERT_EQUAL(rawPacket1.getChecksumOffloadInfo().getL4ChecksumOffset(), 0, u16);
+
+	// disabling the offload computes all checksums in software again
+	tcpPacket.setChecksumOffload(pcpp::ChecksumOffloadNone);
+	tcpPacket.computeCalculateFields();
+	PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, ipChecksum, hex);
+	PTF_ASSERT_EQUAL(tcpLayer->getTcpHeader()->headerChecksum, tcpChecksum, hex);
+	PTF_ASSERT_EQUAL(rawPacket1.getChecksumOffloadInfo().flags, pcpp::ChecksumOffloadNone, u8);
+
+	// UDP over IPv6
+	pcpp::Packet udpPacket(&rawPacket2);
+	pcpp::UdpLayer* udpLayer = udpPacket.getLayerOfType<pcpp::UdpLayer>();
+	PTF_ASSERT_NOT_NULL(udpLayer);
+	uint16_t udpChecksum = udpLayer->getUdpHeader()->headerChecksum;
+	udpPacket.setChecksumOffload(pcpp::ChecksumOffloadIPv4 | pcpp::ChecksumOffloadTCP);
+	udpPacket.computeCalculateFields();
+	PTF_ASSERT_EQUAL(udpLayer->getUdpHeader()->headerChecksum, udpChecksum, hex);
+	PTF_ASSERT_EQUAL(rawPacket2.getChecksumOffloadInfo().flags, pcpp::ChecksumOffloadNone, u8);
+	udpPacket.setChecksumOffload(pcpp::ChecksumOffloadAll);
+	udpPacket.computeCalculateFields();
+	PTF_ASSERT_EQUAL(udpLayer->getUdpHeader()->headerChecksum, htobe16(udpLayer->calculatePseudoHeaderChecksum(false)), hex);
+	const pcpp::ChecksumOffloadInfo& udpOffloadInfo = rawPacket2.getChecksumOffloadInfo();
+	PTF_ASSERT_EQUAL(udpOffloadInfo.flags, pcpp::ChecksumOffloadUDP, u8);
+	PTF_ASSERT_TRUE(udpOffloadInfo.isIPv6);
+	PTF_ASSERT_EQUAL(udpOffloadInfo.l2Len, 14, u16);
+	PTF_ASSERT_EQUAL(udpOffloadInfo.l3Len, 40, u16);
+	PTF_ASSERT_EQUAL(udpOffloadInfo.getL4ChecksumOffset(), 6, u16);
+	pcpp::ScalarBuffer<uint16_t> udpData = { (uint16_t*)udpLayer->getData(), udpLayer->getDataLen() };
+	PTF_ASSERT_EQUAL(htobe16(pcpp::compute_checksum(&udpData, 1)), udpChecksum, hex);
+
+	uint8_t* newData = new uint8_t[64];
+	memset(newData, 0, 64);
+	rawPacketCopy.setRawData(newData, 64, time, pcpp::LINKTYPE_ETHERNET);
+	PTF_ASSERT_EQUAL(rawPacketCopy.getChecksumOffloadInfo().flags, pcpp::ChecksumOffloadNone, u8);
+} // ChecksumOffloadTest
+
+
+
+PTF_TEST_CASE(FlowKeyTest)
+{
+	timeval time;
+	gettimeofday(&time, NULL);
+
+	READ_FILE_AND_CREATE_PACKET(1, "PacketExamples/TwoHttpRequests1.dat");
+	READ_FILE_AND_CREATE_PACKET(2, "PacketExamples/Dns2.dat");
+	READ_FILE_AND_CREATE_PACKET(3, "PacketExamples/ArpResponsePacket.dat");
+
+	pcpp::FlowKey emptyKey;
+	PTF_ASSERT_FALSE(emptyKey.isValid());
+
+	// IPv4 TCP
+	pcpp::Packet tcpPacket(&rawPacket1);
+	pcpp::IPv4Layer* ipLayer = tcpPacket.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::TcpLayer* tcpLayer = tcpPacket.getLayerOfType<pcpp::TcpLayer>();
+	PTF_ASSERT_NOT_NULL(ipLayer);
+	PTF_ASSERT_NOT_NULL(tcpLayer);
+	pcpp::FlowKey tcpKey;
+	bool isReversed = true;
+	PTF_ASSERT_TRUE(tcpKey.fromPacket(tcpPacket, &isReversed));
+	PTF_ASSERT_TRUE(tcpKey.isValid());
+	PTF_ASSERT_EQUAL(tcpKey.getIPVersion(), 4, u8);
+	PTF_ASSERT_EQUAL(tcpKey.getProtocol(), pcpp::PACKETPP_IPPROTO_TCP, u8);
+	size_t srcEndpoint = (isReversed ? 1 : 0);
+	PTF_ASSERT_EQUAL(tcpKey.getIPv4Address(srcEndpoint), ipLayer->getSrcIpAddress(), object);
+	PTF_ASSERT_EQUAL(tcpKey.getIPv4Address(1 - srcEndpoint), ipLayer->getDstIpAddress(), object);
+	PTF_ASSERT_EQUAL(tcpKey.getPort(srcEndpoint), be16toh(tcpLayer->getTcpHeader()->portSrc), u16);
+	PTF_ASSERT_EQUAL(tcpKey.getPort(1 - srcEndpoint), be16toh(tcpLayer->getTcpHeader()->portDst), u16);
+	PTF_ASSERT_EQUAL(tcpKey.getIPv6Address(0), pcpp::IPv6Address::Zero, object);
+
+	// the same key straight from the raw packet or from a packet view
+	pcpp::FlowKey rawKey;
+	bool rawIsReversed = !isReversed;
+	PTF_ASSERT_TRUE(rawKey.fromRawPacket(&rawPacket1, &rawIsReversed));
+	PTF_ASSERT_TRUE(rawKey == tcpKey);
+	PTF_ASSERT_TRUE(rawIsReversed == isReversed);
+	PTF_ASSERT_EQUAL(rawKey.hash(), tcpKey.hash(), u64);
+	pcpp::PacketView view(&rawPacket1);
+	pcpp::FlowKey viewKey;
+	PTF_ASSERT_TRUE(viewKey.fromPacketView(view));
+	PTF_ASSERT_TRUE(viewKey == tcpKey);
+
+	// the other direction produces the same key
+	pcpp::Packet reversedPacket(tcpPacket);
+	pcpp::IPv4Layer* reversedIpLayer = reversedPacket.getLayerOfType<pcpp::IPv4Layer>();
+	pcpp::TcpLayer* reversedTcpLayer = reversedPacket.getLayerOfType<pcpp::TcpLayer>();
+	reversedIpLayer->setSrcIpAddress(ipLayer->getDstIpAddress());
+	reversedIpLayer->setDstIpAddress(ipLayer->getSrcIpAddress());
+	reversedTcpLayer->setSrcPort(be16toh(tcpLayer->getTcpHeader()->portDst));
+	reversedTcpLayer->setDstPort(be16toh(tcpLayer->getTcpHeader()->portSrc));
+	pcpp::FlowKey reversedKey;
+	bool reversedIsReversed = isReversed;
+	PTF_ASSERT_TRUE(reversedKey.fromPacket(reversedPacket, &reversedIsReversed));
+	PTF_ASSERT_TRUE(reversedKey == tcpKey);
+	PTF_ASSERT_FALSE(reversedKey < tcpKey);
+	PTF_ASSERT_FALSE(tcpKey < reversedKey);
+	PTF_ASSERT_TRUE(reversedIsReversed == !isReversed);
+	PTF_ASSERT_EQUAL(reversedKey.hash(12345), tcpKey.hash(12345), u64);
+
+	// a different port is a different flow, a different seed is a different hash
+	reversedTcpLayer->setSrcPort(be16toh(tcpLayer->getTcpHeader()->portDst) + 1);
+	PTF_ASSERT_TRUE(reversedKey.fromPacket(reversedPacket));
+	PTF_ASSERT_TRUE(reversedKey != tcpKey);
+	PTF_ASSERT_TRUE((reversedKey < tcpKey) != (tcpKey < reversedKey));
+	PTF_ASSERT_NOT_EQUAL(reversedKey.hash(), tcpKey.hash(), u64);
+	PTF_ASSERT_NOT_EQUAL(tcpKey.hash(1), tcpKey.hash(2), u64);
+
+	// IPv6 UDP
+	pcpp::Packet udpPacket(&rawPacket2);
+	pcpp::IPv6Layer* ipv6Layer = udpPacket.getLayerOfType<pcpp::IPv6Layer>();
+	PTF_ASSERT_NOT_NULL(ipv6Layer);
+	pcpp::FlowKey udpKey;
+	PTF_ASSERT_TRUE(udpKey.fromPacket(udpPacket, &isReversed));
+	PTF_ASSERT_EQUAL(udpKey.getIPVersion(), 6, u8);
+	PTF_ASSERT_EQUAL(udpKey.getProtocol(), pcpp::PACKETPP_IPPROTO_UDP, u8);
+	PTF_ASSERT_EQUAL(udpKey.getIPv6Address(isReversed ? 1 : 0), ipv6Layer->getSrcIpAddress(), object);
+	PTF_ASSERT_EQUAL(udpKey.getPort(0), 5353, u16);
+	PTF_ASSERT_EQUAL(udpKey.getIPv4Address(0), pcpp::IPv4Address::Zero, object);
+	PTF_ASSERT_TRUE(rawKey.fromRawPacket(&rawPacket2));
+	PTF_ASSERT_TRUE(rawKey == udpKey);
+	PTF_ASSERT_TRUE(udpKey != tcpKey);
+
+	// packets without a 5-tuple
+	pcpp::Packet arpPacket(&rawPacket3);
+	PTF_ASSERT_FALSE(rawKey.fromPacket(arpPacket));
+	PTF_ASSERT_FALSE(rawKey.isValid());
+	PTF_ASSERT_TRUE(rawKey == emptyKey);
+	PTF_ASSERT_FALSE(rawKey.fromRawPacket(&rawPacket3));
+	PTF_ASSERT_FALSE(rawKey.fromRawPacket(NULL));
+} // FlowKeyTest
+
+
+
+PTF_TEST_CASE(FlowTableTest)
+{
+	pcpp::FlowTable<int> table;
+	PTF_ASSERT_TRUE(table.empty());
+	PTF_ASSERT_NULL(table.find(1));
+	PTF_ASSERT_FALSE(table.erase(1));
+
+	// insert enough keys to make the table grow several times. Keys that differ only in their high bits are included on purpose
+	const int numOfKeys = 5000;
+	for (int i = 0; i < numOfKeys; i++)
+	{
+		PTF_ASSERT_NOT_NULL(table.insert((uint32_t)i, i));
+		PTF_ASSERT_NOT_NULL(table.insert((uint32_t)i << 16, -i));
+	}
+	// key 0 is inserted twice
+	PTF_ASSERT_EQUAL(table.size(), 2 * numOfKeys - 1, size);
+	PTF_ASSERT_TRUE(table.getCapacity() >= table.size());
+	PTF_ASSERT_EQUAL(*table.find(1234), 1234, int);
+	PTF_ASSERT_EQUAL(*table.find(1234 << 16), -1234, int);
+	PTF_ASSERT_NULL(table.find(numOfKeys));
+
+	// inserting an existing key replaces its value
+	*table.insert(1234, 4321) += 1;
+	PTF_ASSERT_EQUAL(*table.find(1234), 4322, int);
+	PTF_ASSERT_EQUAL(table.size(), 2 * numOfKeys - 1, size);
+
+	// erase every other key and make sure all remaining keys are still reachable
+	for (int i = 0; i < numOfKeys; i += 2)
+		PTF_ASSERT_TRUE(table.erase((uint32_t)i << 16));
+	PTF_ASSERT_FALSE(table.erase(2 << 16));
+	for (int i = 1; i < numOfKeys; i++)
+	{
+		PTF_ASSERT_NOT_NULL(table.find((uint32_t)i));
+		if (i % 2 == 0)
+		{
+			PTF_ASSERT_NULL(table.find((uint32_t)i << 16));
+		}
+		else
+		{
+			PTF_ASSERT_EQUAL(*table.find((uint32_t)i << 16), -i, int);
+		}
+	}
+
+	// slot iteration visits every key exactly once
+	size_t usedSlots = 0;
+	int64_t valueSum = 0;
+	for (size_t slot = 0; slot < table.getCapacity(); slot++)
+	{
+		if (!table.isSlotUsed(slot))
+			continue;
+		usedSlots++;
+		valueSum += table.getValueAt(slot);
+		PTF_ASSERT_TRUE(table.find(table.getKeyAt(slot)) == &table.getValueAt(slot));
+	}
+	PTF_ASSERT_EQUAL(usedSlots, table.size(), size);
+	// key 0 was erased together with the even shifted keys, key 1234 holds 4322 and the odd shifted keys hold negative values
+	int64_t expectedSum = (int64_t)numOfKeys * (numOfKeys - 1) / 2 + (4322 - 1234) - (int64_t)(numOfKeys / 2) * (numOfKeys / 2);
+	PTF_ASSERT_EQUAL(valueSum, expectedSum, u64);
+
+	size_t capacity = table.getCapacity();
+	table.clear();
+	PTF_ASSERT_TRUE(table.empty());
+	PTF_ASSERT_EQUAL(table.getCapacity(), capacity, size);
+	PTF_ASSERT_NULL(table.find(1));
+
+	pcpp::FlowTable<int> presizedTable(100000);
+	size_t presizedCapacity = presizedTable.getCapacity();
+	for (int i = 0; i < 100000; i++)
+		presizedTable.insert((uint32_t)i * 2654435761U, i);
+	PTF_ASSERT_EQUAL(presizedTable.getCapacity(), presizedCapacity, size);
+} // FlowTableTest
@@ -117,6 +117,7 @@ int main(int argc, char* argv[])
 	PTF_RUN_TEST(IPv4OptionsParsingTest, "ipv4");
 	PTF_RUN_TEST(IPv4OptionsEditTest, "ipv4");
 	PTF_RUN_TEST(IPv4UdpChecksum, "ipv4");
+	PTF_RUN_TEST(IPv4IncrementalChecksumTest, "ipv4;checksum");
 
 	PTF_RUN_TEST(IPv6UdpPacketParseAndCreate, "ipv6");
 	PTF_RUN_TEST(IPv6FragmentationTest, "ipv6");
@@ -138,6 +139,16 @@ int main(int argc, char* argv[])
 	PTF_RUN_TEST(ParsePartialPacketTest, "packet;partial_packet");
 	PTF_RUN_TEST(PacketTrailerTest, "packet;packet_trailer");
 	PTF_RUN_TEST(ResizeLayerTest, "packet;resize");
+	PTF_RUN_TEST(ReuseParsedPacketTest, "packet;reuse_packet");
+	PTF_RUN_TEST(ReparsePacketTest, "packet;reuse_packet");
+	PTF_RUN_TEST(LazyParsingTest, "packet;lazy_parsing");
+	PTF_RUN_TEST(PacketViewTest, "packet;packet_view");
+	PTF_RUN_TEST(ParseBatchTest, "packet;parse_batch");
+	PTF_RUN_TEST(PortDissectorRegistryTest, "packet;port_dissector");
+	PTF_RUN_TEST(EnabledProtocolsTest, "packet;enabled_protocols");
+	PTF_RUN_TEST(ChecksumOffloadTest, "packet;checksum");
+	PTF_RUN_TEST(FlowKeyTest, "packet;flow_key");
+	PTF_RUN_TEST(FlowTableTest, "packet;flow_table");
 
 	PTF_RUN_TEST(HttpRequestLayerParsingTest, "http");
 	PTF_RUN_TEST(HttpRequestLayerCreationTest, "http");
@@ -2,6 +2,10 @@
 #define EXAMPLE_PCAP_WRITE_PATH "PcapExamples/example_copy.pcap"
 #define EXAMPLE_PCAP_PATH "PcapExamples/example.pcap"
 #define EXAMPLE2_PCAP_PATH "PcapExamples/example2.pcap"
+#define EXAMPLE_PCAP_NANOSEC_SWAPPED_WRITE_PATH "PcapExamples/example_nsec_swapped_copy.pcap"
+#define EXAMPLE_PCAP_BUFFERED_WRITE_PATH "PcapExamples/example_buffered_copy.pcap"
+#define EXAMPLE_PCAP_PARALLEL_CORRUPT_PATH "PcapExamples/example_parallel_corrupt_copy.pcap"
+#define EXAMPLE_PCAP_PARALLEL_EMBEDDED_PATH "PcapExamples/example_parallel_embedded_copy.pcap"
 #define EXAMPLE_PCAP_HTTP_REQUEST "PcapExamples/4KHttpRequests.pcap"
 #define EXAMPLE_PCAP_HTTP_RESPONSE "PcapExamples/650HttpResponses.pcap"
 #define EXAMPLE_PCAP_VLAN "PcapExamples/VlanPackets.pcap"
@@ -14,6 +14,11 @@ PTF_TEST_CASE(TestPcapFileReadWrite);
 PTF_TEST_CASE(TestPcapSllFileReadWrite);
 PTF_TEST_CASE(TestPcapRawIPFileReadWrite);
 PTF_TEST_CASE(TestPcapFileAppend);
+PTF_TEST_CASE(TestMmapPcapFileRead);
+PTF_TEST_CASE(TestPcapFileReadBatch);
+PTF_TEST_CASE(TestBufferedPcapFileWrite);
+PTF_TEST_CASE(TestBufferedPcapFileRead);
+PTF_TEST_CASE(TestParallelPcapFileRead);
 PTF_TEST_CASE(TestPcapNgFileReadWrite);
 PTF_TEST_CASE(TestPcapNgFileReadWriteAdv);
 
@@ -54,6 +59,12 @@ PTF_TEST_CASE(TestTcpReassemblyIPv6MultConns);
 PTF_TEST_CASE(TestTcpReassemblyIPv6_OOO);
 PTF_TEST_CASE(TestTcpReassemblyCleanup);
 PTF_TEST_CASE(TestTcpReassemblyMaxSeq);
+PTF_TEST_CASE(TestTcpReassemblyOutOfOrderWrapAround);
+PTF_TEST_CASE(TestTcpReassemblyIdleTimeout);
+PTF_TEST_CASE(TestTcpReassemblyOutOfOrderLimits);
+PTF_TEST_CASE(TestTcpReassemblySegmentReferences);
+PTF_TEST_CASE(TestTcpReassemblySharded);
+PTF_TEST_CASE(TestTcpReassemblyConnectionStatistics);
 
 // Implemented in IPFragmentationTests.cpp
 PTF_TEST_CASE(TestIPFragmentationSanity);
@@ -62,6 +73,8 @@ PTF_TEST_CASE(TestIPFragPartialData);
 PTF_TEST_CASE(TestIPFragMultipleFrags);
 PTF_TEST_CASE(TestIPFragMapOverflow);
 PTF_TEST_CASE(TestIPFragRemove);
+PTF_TEST_CASE(TestIPFragPooledBuffers);
+PTF_TEST_CASE(TestIPFragTimeout);
 
 // Implemented in PfRingTests.cpp
 PTF_TEST_CASE(TestPfRingDevice);
@@ -79,6 +92,7 @@ PTF_TEST_CASE(TestDpdkMultiThread);
 PTF_TEST_CASE(TestDpdkDeviceSendPackets);
 PTF_TEST_CASE(TestDpdkDeviceWorkerThreads);
 PTF_TEST_CASE(TestDpdkMbufRawPacket);
+PTF_TEST_CASE(TestDpdkChecksumOffload);
 
 // Implemented in KniTests.cpp
 PTF_TEST_CASE(TestKniDevice);
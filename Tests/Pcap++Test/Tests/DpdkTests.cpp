@@ -14,6 +14,9 @@
 #include "DpdkDeviceList.h"
 #include "PcapFileDevice.h"
 #include "PlatformSpecificUtils.h"
+#ifdef USE_DPDK
+#include <rte_mbuf.h>
+#endif
 
 
 extern PcapTestArgs PcapTestGlobalArgs;
@@ -968,3 +971,91 @@ PTF_TEST_CASE(TestDpdkMbufRawPacket)
 	PTF_SKIP_TEST("DPDK not configured");
 #endif
 } // TestDpdkMbufRawPacket
+
+
+
+
+PTF_TEST_CASE(TestDpdkChecksumOffload)
+{
+#ifdef USE_DPDK
+	PTF_ASSERT_GREATER_THAN(pcpp::DpdkDeviceList::getInstance().getDpdkDeviceList().size(), 0, size);
+
+	pcpp::DpdkDevice* dev = pcpp::DpdkDeviceList::getInstance().getDeviceByPort(PcapTestGlobalArgs.dpdkPort);
+	PTF_ASSERT_NOT_NULL(dev);
+	DeviceTeardown devTeardown(dev);
+
+	// PMDs that don't support IPv4/TCP/UDP TX checksum offload (such as net_null or net_ring) refuse to open with it. The mbuf
+	// offload metadata is still set in that case, so it's checked on every PMD and packets are sent only if the port accepted it
+	pcpp::DpdkDevice::DpdkDeviceConfiguration offloadConfig;
+	offloadConfig.txChecksumOffload = true;
+	pcpp::LoggerPP::getInstance().supressErrors();
+	bool offloadSupported = dev->openMultiQueues(1, 1, offloadConfig);
+	pcpp::LoggerPP::getInstance().enableErrors();
+	if (!offloadSupported)
+	{
+		PTF_ASSERT_FALSE(dev->isOpened());
+		PTF_ASSERT_TRUE(dev->openMultiQueues(1, 1));
+	}
+
+	pcpp::PcapFileReaderDevice reader(EXAMPLE2_PCAP_PATH);
+	PTF_ASSERT_TRUE(reader.open());
+
+	int tcpCount = 0;
+	int udpCount = 0;
+	while (tcpCount < 10 || udpCount < 10)
+	{
+		pcpp::MBufRawPacket mBufRawPacket;
+		PTF_ASSERT_TRUE(mBufRawPacket.init(dev));
+		if (!reader.getNextPacket(mBufRawPacket))
+			break;
+
+		pcpp::Packet packet(&mBufRawPacket);
+		pcpp::IPv4Layer* ipLayer = packet.getLayerOfType<pcpp::IPv4Layer>();
+		if (ipLayer == NULL || ipLayer->isFragment())
+			continue;
+
+		pcpp::Layer* l4Layer = ipLayer->getNextLayer();
+		bool isTcp = (l4Layer != NULL && l4Layer->getProtocol() == pcpp::TCP);
+		bool isUdp = (l4Layer != NULL && l4Layer->getProtocol() == pcpp::UDP);
+		if (!isTcp && !isUdp)
+			continue;
+
+		packet.setChecksumOffload(pcpp::ChecksumOffloadAll);
+		packet.computeCalculateFields();
+
+		rte_mbuf* mBuf = mBufRawPacket.getMBuf();
+		PTF_ASSERT_NOT_NULL(mBuf);
+		PTF_ASSERT_EQUAL((uint64_t)(mBuf->ol_flags & (PKT_TX_IPV4 | PKT_TX_IPV6)), (uint64_t)PKT_TX_IPV4, u64);
+		PTF_ASSERT_TRUE((mBuf->ol_flags & PKT_TX_IP_CKSUM) != 0);
+		PTF_ASSERT_EQUAL((uint64_t)(mBuf->ol_flags & PKT_TX_L4_MASK), (uint64_t)(isTcp ? PKT_TX_TCP_CKSUM : PKT_TX_UDP_CKSUM), u64);
+		PTF_ASSERT_EQUAL((int)mBuf->l2_len, (int)(ipLayer->getData() - packet.getRawPacket()->getRawData()), int);
+		PTF_ASSERT_EQUAL((int)mBuf->l3_len, (int)ipLayer->getHeaderLen(), int);
+		PTF_ASSERT_EQUAL(ipLayer->getIPv4Header()->headerChecksum, 0, u16);
+
+		if (offloadSupported)
+		{
+			PTF_ASSERT_TRUE(dev->sendPacket(packet, 0));
+		}
+
+		// turning offload off clears the mbuf offload flags, so the packet is sent with the checksums computed in software
+		packet.setChecksumOffload(pcpp::ChecksumOffloadNone);
+		packet.computeCalculateFields();
+		PTF_ASSERT_EQUAL((uint64_t)(mBuf->ol_flags & (PKT_TX_IPV4 | PKT_TX_IPV6 | PKT_TX_IP_CKSUM | PKT_TX_L4_MASK)), (uint64_t)0, u64);
+		PTF_ASSERT_TRUE(dev->sendPacket(packet, 0));
+
+		if (isTcp)
+			tcpCount++;
+		else
+			udpCount++;
+	}
+
+	PTF_ASSERT_EQUAL(tcpCount, 10, int);
+	PTF_ASSERT_EQUAL(udpCount, 10, int);
+
+	reader.close();
+	dev->close();
+
+#else
+	PTF_SKIP_TEST("DPDK not configured");
+#endif
+} // TestDpdkChecksumOffload
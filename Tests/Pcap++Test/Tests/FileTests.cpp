@@ -3,6 +3,10 @@
 #include "Packet.h"
 #include "PcapFileDevice.h"
 #include "../Common/PcapFileNamesDef.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
 
 
 class FileReaderTeardown
@@ -267,6 +271,795 @@ PTF_TEST_CASE(TestPcapFileAppend)
 
 
 
+static uint32_t swapFileUint32(uint32_t value)
+{
+	return ((value & 0x000000ff) << 24) | ((value & 0x0000ff00) << 8) | ((value & 0x00ff0000) >> 8) | ((value & 0xff000000) >> 24);
+}
+
+PTF_TEST_CASE(TestMmapPcapFileRead)
+{
+	// the mapped reader returns the same packets as the libpcap-based reader
+	pcpp::PcapFileReaderDevice readerDev(EXAMPLE_PCAP_PATH);
+	pcpp::MmapPcapFileReaderDevice mmapReaderDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_TRUE(readerDev.open());
+	PTF_ASSERT_TRUE(mmapReaderDev.open());
+	PTF_ASSERT_TRUE(mmapReaderDev.isOpened());
+	PTF_ASSERT_EQUAL(mmapReaderDev.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+	PTF_ASSERT_EQUAL(mmapReaderDev.getFileSize(), 3812643, u64);
+
+	pcpp::RawPacket rawPacket;
+	pcpp::RawPacket mmapRawPacket;
+	std::vector<pcpp::RawPacket> copies;
+	int packetCount = 0;
+	while (readerDev.getNextPacket(rawPacket))
+	{
+		PTF_ASSERT_TRUE(mmapReaderDev.getNextPacket(mmapRawPacket));
+		PTF_ASSERT_EQUAL(mmapRawPacket.getRawDataLen(), rawPacket.getRawDataLen(), int);
+		PTF_ASSERT_EQUAL(mmapRawPacket.getFrameLength(), rawPacket.getFrameLength(), int);
+		PTF_ASSERT_BUF_COMPARE(mmapRawPacket.getRawData(), rawPacket.getRawData(), rawPacket.getRawDataLen());
+		PTF_ASSERT_EQUAL(mmapRawPacket.getPacketTimeStamp().tv_sec, rawPacket.getPacketTimeStamp().tv_sec, u64);
+		PTF_ASSERT_EQUAL(mmapRawPacket.getPacketTimeStamp().tv_nsec, rawPacket.getPacketTimeStamp().tv_nsec, u64);
+		PTF_ASSERT_EQUAL(mmapRawPacket.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+
+		// copies of mapped packets own their data
+		if (packetCount < 100)
+			copies.push_back(mmapRawPacket);
+
+		packetCount++;
+	}
+
+	PTF_ASSERT_EQUAL(packetCount, 4631, int);
+	PTF_ASSERT_FALSE(mmapReaderDev.getNextPacket(mmapRawPacket));
+
+	pcap_stat readerStatistics;
+	mmapReaderDev.getStatistics(readerStatistics);
+	PTF_ASSERT_EQUAL((uint32_t)readerStatistics.ps_recv, 4631, u32);
+	PTF_ASSERT_EQUAL((uint32_t)readerStatistics.ps_drop, 0, u32);
+
+	// a RawPacket pointing at the mapped file can be reused by other readers once it's cleared, and doesn't free the mapped data
+	readerDev.close();
+	PTF_ASSERT_TRUE(readerDev.open());
+	PTF_ASSERT_TRUE(readerDev.getNextPacket(mmapRawPacket));
+	PTF_ASSERT_BUF_COMPARE(mmapRawPacket.getRawData(), copies.front().getRawData(), copies.front().getRawDataLen());
+	readerDev.close();
+
+	mmapReaderDev.close();
+	PTF_ASSERT_FALSE(mmapReaderDev.isOpened());
+
+	pcpp::LoggerPP::getInstance().supressErrors();
+	PTF_ASSERT_FALSE(mmapReaderDev.getNextPacket(mmapRawPacket));
+	pcpp::LoggerPP::getInstance().enableErrors();
+
+	// reading all packets in a bulk
+	PTF_ASSERT_TRUE(mmapReaderDev.open());
+	pcpp::RawPacketVector packetVec;
+	PTF_ASSERT_EQUAL(mmapReaderDev.getNextPackets(packetVec), 4631, int);
+	PTF_ASSERT_BUF_COMPARE(packetVec.at(99)->getRawData(), copies.back().getRawData(), copies.back().getRawDataLen());
+	packetVec.clear();
+	mmapReaderDev.close();
+
+	// link layer types other than Ethernet
+	pcpp::MmapPcapFileReaderDevice sllReaderDev(SLL_PCAP_PATH);
+	PTF_ASSERT_TRUE(sllReaderDev.open());
+	PTF_ASSERT_EQUAL(sllReaderDev.getLinkLayerType(), pcpp::LINKTYPE_LINUX_SLL, enum);
+	PTF_ASSERT_TRUE(sllReaderDev.getNextPacket(mmapRawPacket));
+	PTF_ASSERT_EQUAL(mmapRawPacket.getLinkLayerType(), pcpp::LINKTYPE_LINUX_SLL, enum);
+	sllReaderDev.close();
+
+	// a file written in the opposite byte order with nanosecond timestamps, ending with a truncated record
+	std::ifstream exampleFile(EXAMPLE_PCAP_PATH, std::ifstream::binary);
+	std::vector<char> fileData((std::istreambuf_iterator<char>(exampleFile)), std::istreambuf_iterator<char>());
+	exampleFile.close();
+
+	uint32_t* fileHeader = (uint32_t*)&fileData[0];
+	fileHeader[0] = swapFileUint32(0xa1b23c4d);
+	fileHeader[4] = swapFileUint32(fileHeader[4]);
+	fileHeader[5] = swapFileUint32(fileHeader[5]);
+	size_t offset = 24;
+	for (int i = 0; i < 10; i++)
+	{
+		uint32_t recordHeader[4];
+		memcpy(recordHeader, &fileData[offset], sizeof(recordHeader));
+		uint32_t capLen = recordHeader[2];
+		recordHeader[1] *= 1000;
+		for (int j = 0; j < 4; j++)
+			recordHeader[j] = swapFileUint32(recordHeader[j]);
+		memcpy(&fileData[offset], recordHeader, sizeof(recordHeader));
+		offset += sizeof(recordHeader) + capLen;
+	}
+
+	std::ofstream swappedFile(EXAMPLE_PCAP_NANOSEC_SWAPPED_WRITE_PATH, std::ofstream::binary | std::ofstream::trunc);
+	swappedFile.write(&fileData[0], offset + 12);
+	swappedFile.close();
+
+	pcpp::MmapPcapFileReaderDevice swappedReaderDev(EXAMPLE_PCAP_NANOSEC_SWAPPED_WRITE_PATH);
+	PTF_ASSERT_TRUE(swappedReaderDev.open());
+	PTF_ASSERT_EQUAL(swappedReaderDev.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+	PTF_ASSERT_TRUE(readerDev.open());
+	for (int i = 0; i < 10; i++)
+	{
+		PTF_ASSERT_TRUE(readerDev.getNextPacket(rawPacket));
+		PTF_ASSERT_TRUE(swappedReaderDev.getNextPacket(mmapRawPacket));
+		PTF_ASSERT_EQUAL(mmapRawPacket.getRawDataLen(), rawPacket.getRawDataLen(), int);
+		PTF_ASSERT_BUF_COMPARE(mmapRawPacket.getRawData(), rawPacket.getRawData(), rawPacket.getRawDataLen());
+		PTF_ASSERT_EQUAL(mmapRawPacket.getPacketTimeStamp().tv_sec, rawPacket.getPacketTimeStamp().tv_sec, u64);
+		PTF_ASSERT_EQUAL(mmapRawPacket.getPacketTimeStamp().tv_nsec, rawPacket.getPacketTimeStamp().tv_nsec, u64);
+	}
+	PTF_ASSERT_FALSE(swappedReaderDev.getNextPacket(mmapRawPacket));
+	readerDev.close();
+	swappedReaderDev.close();
+
+	// files that aren't pcap files
+	pcpp::LoggerPP::getInstance().supressErrors();
+	pcpp::MmapPcapFileReaderDevice pcapNgReaderDev(EXAMPLE_PCAPNG_PATH);
+	PTF_ASSERT_FALSE(pcapNgReaderDev.open());
+	PTF_ASSERT_FALSE(pcapNgReaderDev.isOpened());
+	pcpp::MmapPcapFileReaderDevice nonExistingReaderDev("PcapExamples/non_existing_file.pcap");
+	PTF_ASSERT_FALSE(nonExistingReaderDev.open());
+	pcpp::LoggerPP::getInstance().enableErrors();
+} // TestMmapPcapFileRead
+
+
+
+// a reader like the ones written outside the library, which implements only getNextPacket(). Batch reads use the default
+// getNextPacketData() for it
+class GetNextPacketOnlyReaderDevice : public pcpp::IFileReaderDevice
+{
+public:
+	GetNextPacketOnlyReaderDevice(const char* fileName) : pcpp::IFileReaderDevice(fileName), m_Reader(fileName) {}
+
+	bool open() { m_DeviceOpened = m_Reader.open(); return m_DeviceOpened; }
+	void close() { m_Reader.close(); m_DeviceOpened = false; }
+	bool getNextPacket(pcpp::RawPacket& rawPacket) { return m_Reader.getNextPacket(rawPacket); }
+	void getStatistics(pcap_stat& stats) const { m_Reader.getStatistics(stats); }
+
+private:
+	pcpp::PcapFileReaderDevice m_Reader;
+};
+
+PTF_TEST_CASE(TestPcapFileReadBatch)
+{
+	// a small initial buffer makes the batch grow while it's filled, and the packets already in it have to move with the buffer
+	pcpp::RawPacketBatch batch(64, 1024);
+	PTF_ASSERT_EQUAL(batch.getMaxNumOfPackets(), 64, size);
+	PTF_ASSERT_EQUAL(batch.size(), 0, size);
+	PTF_ASSERT_EQUAL(batch.getBufferSize(), 1024, size);
+
+	pcpp::PcapFileReaderDevice readerDev(EXAMPLE_PCAP_PATH);
+	pcpp::PcapFileReaderDevice batchReaderDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_TRUE(readerDev.open());
+	PTF_ASSERT_TRUE(batchReaderDev.open());
+
+	pcpp::RawPacket rawPacket;
+	int packetCount = 0;
+	int batchCount = 0;
+	int numOfPacketsRead;
+	while ((numOfPacketsRead = batchReaderDev.getNextPackets(batch)) > 0)
+	{
+		PTF_ASSERT_EQUAL(batch.size(), (size_t)numOfPacketsRead, size);
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			PTF_ASSERT_TRUE(readerDev.getNextPacket(rawPacket));
+			const pcpp::RawPacket& batchPacket = batch.at(i);
+			PTF_ASSERT_EQUAL(batchPacket.getRawDataLen(), rawPacket.getRawDataLen(), int);
+			PTF_ASSERT_EQUAL(batchPacket.getFrameLength(), rawPacket.getFrameLength(), int);
+			PTF_ASSERT_BUF_COMPARE(batchPacket.getRawData(), rawPacket.getRawData(), rawPacket.getRawDataLen());
+			PTF_ASSERT_EQUAL(batchPacket.getPacketTimeStamp().tv_sec, rawPacket.getPacketTimeStamp().tv_sec, u64);
+			PTF_ASSERT_EQUAL(batchPacket.getPacketTimeStamp().tv_nsec, rawPacket.getPacketTimeStamp().tv_nsec, u64);
+			PTF_ASSERT_EQUAL(batchPacket.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+			packetCount++;
+		}
+
+		batchCount++;
+	}
+
+	PTF_ASSERT_EQUAL(packetCount, 4631, int);
+	PTF_ASSERT_EQUAL(batchCount, 73, int);
+	PTF_ASSERT_EQUAL(batch.size(), 0, size);
+	PTF_ASSERT_FALSE(readerDev.getNextPacket(rawPacket));
+	PTF_ASSERT_GREATER_THAN(batch.getBufferSize(), 1024, size);
+
+	pcap_stat readerStatistics;
+	batchReaderDev.getStatistics(readerStatistics);
+	PTF_ASSERT_EQUAL((uint32_t)readerStatistics.ps_recv, 4631, u32);
+
+	// once the buffer is big enough reading the file again doesn't grow it
+	size_t bufferSize = batch.getBufferSize();
+	batchReaderDev.close();
+	PTF_ASSERT_TRUE(batchReaderDev.open());
+	packetCount = 0;
+	while ((numOfPacketsRead = batchReaderDev.getNextPackets(batch)) > 0)
+	{
+		packetCount += numOfPacketsRead;
+	}
+	PTF_ASSERT_EQUAL(packetCount, 4631, int);
+	PTF_ASSERT_EQUAL(batch.getBufferSize(), bufferSize, size);
+	batchReaderDev.close();
+	readerDev.close();
+
+	pcpp::LoggerPP::getInstance().supressErrors();
+	PTF_ASSERT_EQUAL(batchReaderDev.getNextPackets(batch), 0, int);
+	pcpp::LoggerPP::getInstance().enableErrors();
+
+	// the memory-mapped reader copies the packets into the batch too
+	pcpp::MmapPcapFileReaderDevice mmapReaderDev(SLL_PCAP_PATH);
+	pcpp::PcapFileReaderDevice sllReaderDev(SLL_PCAP_PATH);
+	PTF_ASSERT_TRUE(mmapReaderDev.open());
+	PTF_ASSERT_TRUE(sllReaderDev.open());
+	PTF_ASSERT_GREATER_THAN(mmapReaderDev.getNextPackets(batch), 0, int);
+	for (size_t i = 0; i < batch.size(); i++)
+	{
+		PTF_ASSERT_TRUE(sllReaderDev.getNextPacket(rawPacket));
+		PTF_ASSERT_EQUAL(batch.at(i).getRawDataLen(), rawPacket.getRawDataLen(), int);
+		PTF_ASSERT_BUF_COMPARE(batch.at(i).getRawData(), rawPacket.getRawData(), rawPacket.getRawDataLen());
+		PTF_ASSERT_EQUAL(batch.at(i).getLinkLayerType(), pcpp::LINKTYPE_LINUX_SLL, enum);
+	}
+	mmapReaderDev.close();
+	sllReaderDev.close();
+
+	// a reader that implements only getNextPacket() reads batches too
+	GetNextPacketOnlyReaderDevice getNextPacketOnlyReaderDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_TRUE(readerDev.open());
+	PTF_ASSERT_TRUE(getNextPacketOnlyReaderDev.open());
+	packetCount = 0;
+	while ((numOfPacketsRead = getNextPacketOnlyReaderDev.getNextPackets(batch)) > 0)
+	{
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			PTF_ASSERT_TRUE(readerDev.getNextPacket(rawPacket));
+			PTF_ASSERT_EQUAL(batch.at(i).getRawDataLen(), rawPacket.getRawDataLen(), int);
+			PTF_ASSERT_BUF_COMPARE(batch.at(i).getRawData(), rawPacket.getRawData(), rawPacket.getRawDataLen());
+			PTF_ASSERT_EQUAL(batch.at(i).getPacketTimeStamp().tv_nsec, rawPacket.getPacketTimeStamp().tv_nsec, u64);
+			packetCount++;
+		}
+	}
+	PTF_ASSERT_EQUAL(packetCount, 4631, int);
+	getNextPacketOnlyReaderDev.close();
+	readerDev.close();
+
+	// pcap-ng files have a link layer type per packet
+	pcpp::PcapNgFileReaderDevice pcapNgReaderDev(EXAMPLE_PCAPNG_PATH);
+	pcpp::PcapNgFileReaderDevice pcapNgBatchReaderDev(EXAMPLE_PCAPNG_PATH);
+	PTF_ASSERT_TRUE(pcapNgReaderDev.open());
+	PTF_ASSERT_TRUE(pcapNgBatchReaderDev.open());
+
+	pcpp::RawPacketBatch pcapNgBatch(10);
+	packetCount = 0;
+	int nullLinkLayerCount = 0;
+	while (pcapNgBatchReaderDev.getNextPackets(pcapNgBatch) > 0)
+	{
+		for (size_t i = 0; i < pcapNgBatch.size(); i++)
+		{
+			PTF_ASSERT_TRUE(pcapNgReaderDev.getNextPacket(rawPacket));
+			const pcpp::RawPacket& batchPacket = pcapNgBatch.at(i);
+			PTF_ASSERT_EQUAL(batchPacket.getRawDataLen(), rawPacket.getRawDataLen(), int);
+			PTF_ASSERT_EQUAL(batchPacket.getFrameLength(), rawPacket.getFrameLength(), int);
+			PTF_ASSERT_BUF_COMPARE(batchPacket.getRawData(), rawPacket.getRawData(), rawPacket.getRawDataLen());
+			PTF_ASSERT_EQUAL(batchPacket.getPacketTimeStamp().tv_nsec, rawPacket.getPacketTimeStamp().tv_nsec, u64);
+			PTF_ASSERT_EQUAL(batchPacket.getLinkLayerType(), rawPacket.getLinkLayerType(), enum);
+			if (batchPacket.getLinkLayerType() == pcpp::LINKTYPE_NULL)
+				nullLinkLayerCount++;
+			packetCount++;
+		}
+	}
+
+	PTF_ASSERT_EQUAL(packetCount, 64, int);
+	PTF_ASSERT_EQUAL(nullLinkLayerCount, 2, int);
+	PTF_ASSERT_EQUAL(pcapNgBatch.getBufferSize(), 10 * 2048, size);
+
+	pcapNgBatchReaderDev.getStatistics(readerStatistics);
+	PTF_ASSERT_EQUAL((uint32_t)readerStatistics.ps_recv, 64, u32);
+
+	pcapNgReaderDev.close();
+	pcapNgBatchReaderDev.close();
+} // TestPcapFileReadBatch
+
+
+
+PTF_TEST_CASE(TestBufferedPcapFileWrite)
+{
+	pcpp::PcapFileReaderDevice readerDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_TRUE(readerDev.open());
+	pcpp::RawPacketVector packets;
+	PTF_ASSERT_EQUAL(readerDev.getNextPackets(packets), 4631, int);
+	readerDev.close();
+
+	// the smallest buffers (1MB) make the example file span several buffers
+	// io_uring is used only if the library is built with it and the kernel supports it, otherwise the writer falls back to blocking writes
+	pcpp::BufferedPcapFileWriterConfiguration configs[6];
+	configs[0] = pcpp::BufferedPcapFileWriterConfiguration();
+	configs[1] = pcpp::BufferedPcapFileWriterConfiguration(1, false, true);
+	configs[2] = pcpp::BufferedPcapFileWriterConfiguration(1, true, false);
+	configs[3] = pcpp::BufferedPcapFileWriterConfiguration(1, true, true);
+	configs[4] = pcpp::BufferedPcapFileWriterConfiguration(1, false, false, true);
+	configs[5] = pcpp::BufferedPcapFileWriterConfiguration(1, true, false, true);
+
+	for (int configIndex = 0; configIndex < 6; configIndex++)
+	{
+		pcpp::BufferedPcapFileWriterDevice writerDev(EXAMPLE_PCAP_BUFFERED_WRITE_PATH, pcpp::LINKTYPE_ETHERNET, configs[configIndex]);
+		PTF_ASSERT_EQUAL(writerDev.getBufferSize(), (configIndex == 0 ? 8 * 1024 * 1024 : 1024 * 1024), size);
+		PTF_ASSERT_TRUE(writerDev.open());
+		PTF_ASSERT_TRUE(writerDev.isOpened());
+		if (!configs[configIndex].directIO)
+		{
+			PTF_ASSERT_FALSE(writerDev.isUsingDirectIO());
+		}
+		if (!configs[configIndex].useIoUring)
+		{
+			PTF_ASSERT_FALSE(writerDev.isUsingIoUring());
+		}
+
+		// the first half of the packets is readable from the file once it's flushed
+		for (int i = 0; i < 2000; i++)
+		{
+			PTF_ASSERT_TRUE(writerDev.writePacket(*packets.at(i)));
+		}
+		writerDev.flush();
+
+		pcpp::PcapFileReaderDevice flushedReaderDev(EXAMPLE_PCAP_BUFFERED_WRITE_PATH);
+		PTF_ASSERT_TRUE(flushedReaderDev.open());
+		pcpp::RawPacketVector flushedPackets;
+		PTF_ASSERT_EQUAL(flushedReaderDev.getNextPackets(flushedPackets), 2000, int);
+		flushedReaderDev.close();
+
+		for (int i = 2000; i < 4631; i++)
+		{
+			PTF_ASSERT_TRUE(writerDev.writePacket(*packets.at(i)));
+		}
+
+		pcpp::LoggerPP::getInstance().supressErrors();
+		pcpp::RawPacket sllPacket(packets.at(0)->getRawData(), packets.at(0)->getRawDataLen(), packets.at(0)->getPacketTimeStamp(), false, pcpp::LINKTYPE_LINUX_SLL);
+		PTF_ASSERT_FALSE(writerDev.writePacket(sllPacket));
+		pcpp::LoggerPP::getInstance().enableErrors();
+
+		pcap_stat writerStatistics;
+		writerDev.getStatistics(writerStatistics);
+		PTF_ASSERT_EQUAL((uint32_t)writerStatistics.ps_recv, 4631, u32);
+		PTF_ASSERT_EQUAL((uint32_t)writerStatistics.ps_drop, 1, u32);
+		writerDev.close();
+		PTF_ASSERT_FALSE(writerDev.isOpened());
+
+		// appending the first packets again
+		PTF_ASSERT_TRUE(writerDev.open(true));
+		pcpp::RawPacketVector firstPackets;
+		for (int i = 0; i < 10; i++)
+		{
+			firstPackets.pushBack(new pcpp::RawPacket(*packets.at(i)));
+		}
+		PTF_ASSERT_TRUE(writerDev.writePackets(firstPackets));
+		writerDev.close();
+
+		pcpp::PcapFileReaderDevice writtenReaderDev(EXAMPLE_PCAP_BUFFERED_WRITE_PATH);
+		PTF_ASSERT_TRUE(writtenReaderDev.open());
+		PTF_ASSERT_EQUAL(writtenReaderDev.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+		pcpp::RawPacket rawPacket;
+		int packetCount = 0;
+		while (writtenReaderDev.getNextPacket(rawPacket))
+		{
+			pcpp::RawPacket* origPacket = packets.at(packetCount < 4631 ? packetCount : packetCount - 4631);
+			PTF_ASSERT_EQUAL(rawPacket.getRawDataLen(), origPacket->getRawDataLen(), int);
+			PTF_ASSERT_EQUAL(rawPacket.getFrameLength(), origPacket->getFrameLength(), int);
+			PTF_ASSERT_BUF_COMPARE(rawPacket.getRawData(), origPacket->getRawData(), origPacket->getRawDataLen());
+			PTF_ASSERT_EQUAL(rawPacket.getPacketTimeStamp().tv_sec, origPacket->getPacketTimeStamp().tv_sec, u64);
+			PTF_ASSERT_EQUAL(rawPacket.getPacketTimeStamp().tv_nsec, origPacket->getPacketTimeStamp().tv_nsec, u64);
+			packetCount++;
+		}
+		PTF_ASSERT_EQUAL(packetCount, 4641, int);
+		writtenReaderDev.close();
+	}
+
+	pcpp::LoggerPP::getInstance().supressErrors();
+	pcpp::BufferedPcapFileWriterDevice notOpenedWriterDev(EXAMPLE_PCAP_BUFFERED_WRITE_PATH);
+	PTF_ASSERT_FALSE(notOpenedWriterDev.writePacket(*packets.front()));
+	pcpp::BufferedPcapFileWriterDevice sllWriterDev(EXAMPLE_PCAP_BUFFERED_WRITE_PATH, pcpp::LINKTYPE_LINUX_SLL);
+	PTF_ASSERT_FALSE(sllWriterDev.open(true));
+	pcpp::BufferedPcapFileWriterDevice pcapNgWriterDev(EXAMPLE_PCAPNG_PATH);
+	PTF_ASSERT_FALSE(pcapNgWriterDev.open(true));
+	pcpp::BufferedPcapFileWriterDevice nonExistingWriterDev("PcapExamples/non_existing_file.pcap");
+	PTF_ASSERT_FALSE(nonExistingWriterDev.open(true));
+	pcpp::LoggerPP::getInstance().enableErrors();
+
+#ifdef LINUX
+	// every write to /dev/full fails, so all packets end up dropped, including those copied to a buffer before its write failed. The
+	// packets are written twice so io_uring writes wrap around its buffers, and the failure is noticed before close()
+	pcpp::BufferedPcapFileWriterConfiguration failingConfigs[3];
+	failingConfigs[0] = pcpp::BufferedPcapFileWriterConfiguration(1);
+	failingConfigs[1] = pcpp::BufferedPcapFileWriterConfiguration(1, false, true);
+	failingConfigs[2] = pcpp::BufferedPcapFileWriterConfiguration(1, false, false, true);
+	for (int configIndex = 0; configIndex < 3; configIndex++)
+	{
+		pcpp::BufferedPcapFileWriterDevice failingWriterDev("/dev/full", pcpp::LINKTYPE_ETHERNET, failingConfigs[configIndex]);
+		PTF_ASSERT_TRUE(failingWriterDev.open());
+		pcpp::LoggerPP::getInstance().supressErrors();
+		bool allPacketsWritten = true;
+		for (int i = 0; i < 2 * 4631; i++)
+		{
+			allPacketsWritten = failingWriterDev.writePacket(*packets.at(i % 4631)) && allPacketsWritten;
+		}
+		failingWriterDev.close();
+		pcpp::LoggerPP::getInstance().enableErrors();
+
+		PTF_ASSERT_FALSE(allPacketsWritten);
+		pcap_stat failingWriterStatistics;
+		failingWriterDev.getStatistics(failingWriterStatistics);
+		PTF_ASSERT_EQUAL((uint32_t)failingWriterStatistics.ps_recv, 0, u32);
+		PTF_ASSERT_EQUAL((uint32_t)failingWriterStatistics.ps_drop, 2 * 4631, u32);
+	}
+#endif
+} // TestBufferedPcapFileWrite
+
+
+
+PTF_TEST_CASE(TestBufferedPcapFileRead)
+{
+	pcpp::PcapFileReaderDevice readerDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_TRUE(readerDev.open());
+	pcpp::RawPacketVector packets;
+	PTF_ASSERT_EQUAL(readerDev.getNextPackets(packets), 4631, int);
+	readerDev.close();
+
+	// the smallest buffers (1MB) make the example file span several chunks, so some records cross the border between chunks. io_uring is
+	// used only if the library is built with it and the kernel supports it, otherwise each chunk is read with a blocking read
+	pcpp::BufferedPcapFileReaderConfiguration configs[4];
+	configs[0] = pcpp::BufferedPcapFileReaderConfiguration();
+	configs[1] = pcpp::BufferedPcapFileReaderConfiguration(1, 2, false);
+	configs[2] = pcpp::BufferedPcapFileReaderConfiguration(1, 2, true);
+	configs[3] = pcpp::BufferedPcapFileReaderConfiguration(1, 0, true);
+
+	for (int configIndex = 0; configIndex < 4; configIndex++)
+	{
+		pcpp::BufferedPcapFileReaderDevice bufferedReaderDev(EXAMPLE_PCAP_PATH, configs[configIndex]);
+		PTF_ASSERT_EQUAL(bufferedReaderDev.getBufferSize(), (configIndex == 0 ? 4 * 1024 * 1024 : 1024 * 1024), size);
+		PTF_ASSERT_TRUE(bufferedReaderDev.open());
+		PTF_ASSERT_TRUE(bufferedReaderDev.isOpened());
+		PTF_ASSERT_EQUAL(bufferedReaderDev.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+		if (!configs[configIndex].useIoUring)
+		{
+			PTF_ASSERT_FALSE(bufferedReaderDev.isUsingIoUring());
+		}
+
+		pcpp::RawPacket rawPacket;
+		int packetCount = 0;
+		while (bufferedReaderDev.getNextPacket(rawPacket))
+		{
+			pcpp::RawPacket* origPacket = packets.at(packetCount);
+			PTF_ASSERT_EQUAL(rawPacket.getRawDataLen(), origPacket->getRawDataLen(), int);
+			PTF_ASSERT_EQUAL(rawPacket.getFrameLength(), origPacket->getFrameLength(), int);
+			PTF_ASSERT_BUF_COMPARE(rawPacket.getRawData(), origPacket->getRawData(), origPacket->getRawDataLen());
+			PTF_ASSERT_EQUAL(rawPacket.getPacketTimeStamp().tv_sec, origPacket->getPacketTimeStamp().tv_sec, u64);
+			PTF_ASSERT_EQUAL(rawPacket.getPacketTimeStamp().tv_nsec, origPacket->getPacketTimeStamp().tv_nsec, u64);
+			packetCount++;
+		}
+		PTF_ASSERT_EQUAL(packetCount, 4631, int);
+
+		pcap_stat readerStatistics;
+		bufferedReaderDev.getStatistics(readerStatistics);
+		PTF_ASSERT_EQUAL((uint32_t)readerStatistics.ps_recv, 4631, u32);
+
+		// reading the file again in batches
+		bufferedReaderDev.close();
+		PTF_ASSERT_FALSE(bufferedReaderDev.isOpened());
+		PTF_ASSERT_TRUE(bufferedReaderDev.open());
+		pcpp::RawPacketBatch batch(100);
+		packetCount = 0;
+		int numOfPacketsRead;
+		while ((numOfPacketsRead = bufferedReaderDev.getNextPackets(batch)) > 0)
+		{
+			for (size_t i = 0; i < batch.size(); i++)
+			{
+				PTF_ASSERT_BUF_COMPARE(batch.at(i).getRawData(), packets.at(packetCount)->getRawData(), packets.at(packetCount)->getRawDataLen());
+				packetCount++;
+			}
+		}
+		PTF_ASSERT_EQUAL(packetCount, 4631, int);
+		bufferedReaderDev.close();
+	}
+
+	pcpp::BufferedPcapFileReaderDevice sllReaderDev(SLL_PCAP_PATH, pcpp::BufferedPcapFileReaderConfiguration(0, 0, true));
+	pcpp::PcapFileReaderDevice origSllReaderDev(SLL_PCAP_PATH);
+	PTF_ASSERT_TRUE(sllReaderDev.open());
+	PTF_ASSERT_TRUE(origSllReaderDev.open());
+	PTF_ASSERT_EQUAL(sllReaderDev.getLinkLayerType(), pcpp::LINKTYPE_LINUX_SLL, enum);
+	PTF_ASSERT_GREATER_THAN(sllReaderDev.getSnapshotLength(), 0, u32);
+	pcpp::RawPacket rawPacket;
+	pcpp::RawPacket origRawPacket;
+	int sllPacketCount = 0;
+	while (sllReaderDev.getNextPacket(rawPacket))
+	{
+		PTF_ASSERT_TRUE(origSllReaderDev.getNextPacket(origRawPacket));
+		PTF_ASSERT_EQUAL(rawPacket.getRawDataLen(), origRawPacket.getRawDataLen(), int);
+		PTF_ASSERT_BUF_COMPARE(rawPacket.getRawData(), origRawPacket.getRawData(), origRawPacket.getRawDataLen());
+		PTF_ASSERT_EQUAL(rawPacket.getLinkLayerType(), pcpp::LINKTYPE_LINUX_SLL, enum);
+		sllPacketCount++;
+	}
+	PTF_ASSERT_FALSE(origSllReaderDev.getNextPacket(origRawPacket));
+	PTF_ASSERT_GREATER_THAN(sllPacketCount, 0, int);
+	sllReaderDev.close();
+	origSllReaderDev.close();
+
+	pcpp::LoggerPP::getInstance().supressErrors();
+	pcpp::BufferedPcapFileReaderDevice notOpenedReaderDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_FALSE(notOpenedReaderDev.getNextPacket(rawPacket));
+	pcpp::BufferedPcapFileReaderDevice pcapNgReaderDev(EXAMPLE_PCAPNG_PATH);
+	PTF_ASSERT_FALSE(pcapNgReaderDev.open());
+	pcpp::BufferedPcapFileReaderDevice nonExistingReaderDev("PcapExamples/non_existing_file.pcap");
+	PTF_ASSERT_FALSE(nonExistingReaderDev.open());
+	pcpp::LoggerPP::getInstance().enableErrors();
+} // TestBufferedPcapFileRead
+
+
+
+struct ParallelReadPacketDigest
+{
+	uint64_t hash;
+	int dataLen;
+	int frameLen;
+	uint64_t timestampNsec;
+
+	bool operator<(const ParallelReadPacketDigest& other) const
+	{
+		return (hash != other.hash ? hash < other.hash : timestampNsec < other.timestampNsec);
+	}
+
+	bool operator==(const ParallelReadPacketDigest& other) const
+	{
+		return hash == other.hash && dataLen == other.dataLen && frameLen == other.frameLen && timestampNsec == other.timestampNsec;
+	}
+};
+
+static ParallelReadPacketDigest getParallelReadPacketDigest(const pcpp::RawPacket& rawPacket)
+{
+	// FNV-1a
+	ParallelReadPacketDigest digest;
+	digest.hash = 0xcbf29ce484222325ULL;
+	for (int i = 0; i < rawPacket.getRawDataLen(); i++)
+		digest.hash = (digest.hash ^ rawPacket.getRawData()[i]) * 0x100000001b3ULL;
+	digest.dataLen = rawPacket.getRawDataLen();
+	digest.frameLen = rawPacket.getFrameLength();
+	digest.timestampNsec = (uint64_t)rawPacket.getPacketTimeStamp().tv_sec * 1000000000ULL + rawPacket.getPacketTimeStamp().tv_nsec;
+	return digest;
+}
+
+// each worker writes only its own vector, so the callback needs no locking
+struct ParallelReadCookie
+{
+	std::vector<std::vector<ParallelReadPacketDigest> > digestsPerWorker;
+	std::vector<ParallelReadPacketDigest> orderedDigests;
+	bool wrongWorkerId;
+};
+
+static void parallelReadPacketArrives(size_t workerId, pcpp::RawPacket& packet, void* userCookie)
+{
+	ParallelReadCookie* cookie = (ParallelReadCookie*)userCookie;
+	if (workerId >= cookie->digestsPerWorker.size())
+	{
+		cookie->wrongWorkerId = true;
+		return;
+	}
+
+	cookie->digestsPerWorker[workerId].push_back(getParallelReadPacketDigest(packet));
+}
+
+static void parallelReadPacketArrivesInOrder(size_t workerId, pcpp::RawPacket& packet, void* userCookie)
+{
+	ParallelReadCookie* cookie = (ParallelReadCookie*)userCookie;
+	if (workerId >= cookie->digestsPerWorker.size())
+		cookie->wrongWorkerId = true;
+
+	cookie->orderedDigests.push_back(getParallelReadPacketDigest(packet));
+}
+
+PTF_TEST_CASE(TestParallelPcapFileRead)
+{
+	std::vector<ParallelReadPacketDigest> origDigests;
+	pcpp::PcapFileReaderDevice readerDev(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_TRUE(readerDev.open());
+	pcpp::RawPacket rawPacket;
+	while (readerDev.getNextPacket(rawPacket))
+	{
+		origDigests.push_back(getParallelReadPacketDigest(rawPacket));
+	}
+	readerDev.close();
+	PTF_ASSERT_EQUAL(origDigests.size(), 4631, size);
+	std::vector<ParallelReadPacketDigest> sortedOrigDigests = origDigests;
+	std::sort(sortedOrigDigests.begin(), sortedOrigDigests.end());
+
+	// the smallest chunks (1MB) split the example file into 4 chunks, so the 3 workers have to share them
+	pcpp::ParallelPcapFileReader parallelReader(EXAMPLE_PCAP_PATH, pcpp::ParallelPcapFileReaderConfiguration(3, 1));
+	PTF_ASSERT_EQUAL(parallelReader.getNumOfWorkers(), 3, size);
+	PTF_ASSERT_EQUAL(parallelReader.getChunkSize(), 1024 * 1024, size);
+	PTF_ASSERT_TRUE(parallelReader.open());
+	PTF_ASSERT_TRUE(parallelReader.isOpened());
+	PTF_ASSERT_EQUAL(parallelReader.getLinkLayerType(), pcpp::LINKTYPE_ETHERNET, enum);
+	PTF_ASSERT_TRUE(parallelReader.getIndex().empty());
+
+	ParallelReadCookie cookie;
+	cookie.digestsPerWorker.resize(3);
+	cookie.wrongWorkerId = false;
+	PTF_ASSERT_TRUE(parallelReader.readPackets(parallelReadPacketArrives, &cookie));
+	PTF_ASSERT_FALSE(cookie.wrongWorkerId);
+	PTF_ASSERT_EQUAL(parallelReader.getNumOfPacketsRead(), 4631, u64);
+	PTF_ASSERT_EQUAL(parallelReader.getIndex().size(), 4, size);
+
+	// each chunk is delivered in order, and all chunks together hold all packets of the file
+	std::vector<ParallelReadPacketDigest> parallelDigests;
+	for (size_t workerId = 0; workerId < 3; workerId++)
+	{
+		PTF_ASSERT_EQUAL(parallelReader.getNumOfPacketsRead(workerId), cookie.digestsPerWorker[workerId].size(), u64);
+		parallelDigests.insert(parallelDigests.end(), cookie.digestsPerWorker[workerId].begin(), cookie.digestsPerWorker[workerId].end());
+	}
+	std::sort(parallelDigests.begin(), parallelDigests.end());
+	PTF_ASSERT_TRUE(parallelDigests == sortedOrigDigests);
+
+	// the borders found by scanning are the same as the ones found by walking all records
+	std::vector<uint64_t> scannedIndex = parallelReader.getIndex();
+	PTF_ASSERT_EQUAL(scannedIndex.front(), 24, u64);
+	PTF_ASSERT_TRUE(parallelReader.buildIndex());
+	PTF_ASSERT_TRUE(parallelReader.getIndex() == scannedIndex);
+
+	// preserving the order delivers the packets as they're written in the file
+	pcpp::ParallelPcapFileReader orderedReader(EXAMPLE_PCAP_PATH, pcpp::ParallelPcapFileReaderConfiguration(2, 1, true));
+	PTF_ASSERT_TRUE(orderedReader.open());
+	PTF_ASSERT_TRUE(orderedReader.setIndex(scannedIndex));
+	ParallelReadCookie orderedCookie;
+	orderedCookie.digestsPerWorker.resize(2);
+	orderedCookie.wrongWorkerId = false;
+	PTF_ASSERT_TRUE(orderedReader.readPackets(parallelReadPacketArrivesInOrder, &orderedCookie));
+	PTF_ASSERT_FALSE(orderedCookie.wrongWorkerId);
+	PTF_ASSERT_TRUE(orderedCookie.orderedDigests == origDigests);
+	PTF_ASSERT_EQUAL(orderedReader.getNumOfPacketsRead(), 4631, u64);
+
+	// the file can be read again, and a single chunk is read by one worker
+	orderedCookie.orderedDigests.clear();
+	PTF_ASSERT_TRUE(orderedReader.setIndex(std::vector<uint64_t>(1, 24)));
+	PTF_ASSERT_TRUE(orderedReader.readPackets(parallelReadPacketArrivesInOrder, &orderedCookie));
+	PTF_ASSERT_TRUE(orderedCookie.orderedDigests == origDigests);
+	PTF_ASSERT_EQUAL(orderedReader.getNumOfPacketsRead(0) + orderedReader.getNumOfPacketsRead(1), 4631, u64);
+
+	// a border that isn't at a record is noticed before any packet after it is delivered, and the borders from there on are found by
+	// walking the records
+	std::vector<uint64_t> wrongIndex = scannedIndex;
+	wrongIndex[1]--;
+	orderedCookie.orderedDigests.clear();
+	PTF_ASSERT_TRUE(orderedReader.setIndex(wrongIndex));
+	PTF_ASSERT_TRUE(orderedReader.readPackets(parallelReadPacketArrivesInOrder, &orderedCookie));
+	PTF_ASSERT_TRUE(orderedCookie.orderedDigests == origDigests);
+	PTF_ASSERT_TRUE(orderedReader.getIndex() == scannedIndex);
+
+	ParallelReadCookie wrongIndexCookie;
+	wrongIndexCookie.digestsPerWorker.resize(3);
+	wrongIndexCookie.wrongWorkerId = false;
+	PTF_ASSERT_TRUE(parallelReader.setIndex(wrongIndex));
+	PTF_ASSERT_TRUE(parallelReader.readPackets(parallelReadPacketArrives, &wrongIndexCookie));
+	PTF_ASSERT_EQUAL(parallelReader.getNumOfPacketsRead(), 4631, u64);
+	PTF_ASSERT_TRUE(parallelReader.getIndex() == scannedIndex);
+	parallelDigests.clear();
+	for (size_t workerId = 0; workerId < 3; workerId++)
+		parallelDigests.insert(parallelDigests.end(), wrongIndexCookie.digestsPerWorker[workerId].begin(), wrongIndexCookie.digestsPerWorker[workerId].end());
+	std::sort(parallelDigests.begin(), parallelDigests.end());
+	PTF_ASSERT_TRUE(parallelDigests == sortedOrigDigests);
+	orderedReader.close();
+	PTF_ASSERT_FALSE(orderedReader.isOpened());
+	PTF_ASSERT_TRUE(orderedReader.getIndex().empty());
+
+	pcpp::ParallelPcapFileReader defaultReader(SLL_PCAP_PATH);
+	PTF_ASSERT_GREATER_THAN(defaultReader.getNumOfWorkers(), 0, size);
+	PTF_ASSERT_EQUAL(defaultReader.getChunkSize(), 64 * 1024 * 1024, size);
+	PTF_ASSERT_TRUE(defaultReader.open());
+	PTF_ASSERT_EQUAL(defaultReader.getLinkLayerType(), pcpp::LINKTYPE_LINUX_SLL, enum);
+	ParallelReadCookie sllCookie;
+	sllCookie.digestsPerWorker.resize(defaultReader.getNumOfWorkers());
+	sllCookie.wrongWorkerId = false;
+	PTF_ASSERT_TRUE(defaultReader.readPackets(parallelReadPacketArrives, &sllCookie));
+	PTF_ASSERT_GREATER_THAN(defaultReader.getNumOfPacketsRead(), 0, u64);
+	defaultReader.close();
+
+	// a pcap file captured inside a packet looks like records to the scan. Put the record headers of one in the packet that spans the
+	// first nominal border, where the scan starts
+	std::ifstream exampleFile(EXAMPLE_PCAP_PATH, std::ifstream::binary);
+	std::vector<char> fileContent((std::istreambuf_iterator<char>(exampleFile)), std::istreambuf_iterator<char>());
+	exampleFile.close();
+	std::vector<char> embeddedContent = fileContent;
+	uint64_t nominalBorder = 24 + 1024 * 1024;
+	uint64_t recordOffset = 24;
+	uint32_t recordCapLen = 0;
+	while (true)
+	{
+		memcpy(&recordCapLen, &embeddedContent[(size_t)recordOffset + 8], sizeof(recordCapLen));
+		if (recordOffset + 16 + recordCapLen > nominalBorder)
+			break;
+		recordOffset += 16 + recordCapLen;
+	}
+	PTF_ASSERT_GREATER_THAN(recordOffset + 16 + recordCapLen, nominalBorder + 8 * 16, u64);
+	for (size_t i = 0; i < 8; i++)
+	{
+		// an empty capture of a 60 bytes frame, at the time of the packet it's captured in
+		uint32_t embeddedHeader[4];
+		memcpy(&embeddedHeader[0], &embeddedContent[(size_t)recordOffset], sizeof(uint32_t));
+		embeddedHeader[1] = 0;
+		embeddedHeader[2] = 0;
+		embeddedHeader[3] = 60;
+		memcpy(&embeddedContent[(size_t)nominalBorder + i * sizeof(embeddedHeader)], embeddedHeader, sizeof(embeddedHeader));
+	}
+	std::ofstream embeddedFile(EXAMPLE_PCAP_PARALLEL_EMBEDDED_PATH, std::ofstream::binary | std::ofstream::trunc);
+	embeddedFile.write(&embeddedContent[0], embeddedContent.size());
+	embeddedFile.close();
+
+	std::vector<ParallelReadPacketDigest> embeddedDigests;
+	pcpp::PcapFileReaderDevice embeddedReaderDev(EXAMPLE_PCAP_PARALLEL_EMBEDDED_PATH);
+	PTF_ASSERT_TRUE(embeddedReaderDev.open());
+	while (embeddedReaderDev.getNextPacket(rawPacket))
+	{
+		embeddedDigests.push_back(getParallelReadPacketDigest(rawPacket));
+	}
+	embeddedReaderDev.close();
+	PTF_ASSERT_EQUAL(embeddedDigests.size(), 4631, size);
+
+	pcpp::ParallelPcapFileReader embeddedOrderedReader(EXAMPLE_PCAP_PARALLEL_EMBEDDED_PATH, pcpp::ParallelPcapFileReaderConfiguration(2, 1, true));
+	PTF_ASSERT_TRUE(embeddedOrderedReader.open());
+	orderedCookie.orderedDigests.clear();
+	PTF_ASSERT_TRUE(embeddedOrderedReader.readPackets(parallelReadPacketArrivesInOrder, &orderedCookie));
+	PTF_ASSERT_TRUE(orderedCookie.orderedDigests == embeddedDigests);
+	PTF_ASSERT_TRUE(embeddedOrderedReader.getIndex() == scannedIndex);
+	embeddedOrderedReader.close();
+
+	pcpp::ParallelPcapFileReader embeddedReader(EXAMPLE_PCAP_PARALLEL_EMBEDDED_PATH, pcpp::ParallelPcapFileReaderConfiguration(3, 1));
+	PTF_ASSERT_TRUE(embeddedReader.open());
+	ParallelReadCookie embeddedCookie;
+	embeddedCookie.digestsPerWorker.resize(3);
+	embeddedCookie.wrongWorkerId = false;
+	PTF_ASSERT_TRUE(embeddedReader.readPackets(parallelReadPacketArrives, &embeddedCookie));
+	PTF_ASSERT_EQUAL(embeddedReader.getNumOfPacketsRead(), 4631, u64);
+	PTF_ASSERT_TRUE(embeddedReader.getIndex() == scannedIndex);
+	parallelDigests.clear();
+	for (size_t workerId = 0; workerId < 3; workerId++)
+		parallelDigests.insert(parallelDigests.end(), embeddedCookie.digestsPerWorker[workerId].begin(), embeddedCookie.digestsPerWorker[workerId].end());
+	std::sort(parallelDigests.begin(), parallelDigests.end());
+	std::sort(embeddedDigests.begin(), embeddedDigests.end());
+	PTF_ASSERT_TRUE(parallelDigests == embeddedDigests);
+	embeddedReader.close();
+
+	pcpp::LoggerPP::getInstance().supressErrors();
+
+	// a corrupt record makes reading fail, with or without an index
+	uint32_t corruptCapLen = 0x00ffffff;
+	memcpy(&fileContent[(size_t)scannedIndex[2] + 8], &corruptCapLen, sizeof(corruptCapLen));
+	std::ofstream corruptFile(EXAMPLE_PCAP_PARALLEL_CORRUPT_PATH, std::ofstream::binary | std::ofstream::trunc);
+	corruptFile.write(&fileContent[0], fileContent.size());
+	corruptFile.close();
+
+	pcpp::ParallelPcapFileReader corruptReader(EXAMPLE_PCAP_PARALLEL_CORRUPT_PATH, pcpp::ParallelPcapFileReaderConfiguration(2, 1, true));
+	PTF_ASSERT_TRUE(corruptReader.open());
+	PTF_ASSERT_FALSE(corruptReader.buildIndex());
+	PTF_ASSERT_TRUE(corruptReader.setIndex(scannedIndex));
+	orderedCookie.orderedDigests.clear();
+	PTF_ASSERT_FALSE(corruptReader.readPackets(parallelReadPacketArrivesInOrder, &orderedCookie));
+	PTF_ASSERT_LOWER_THAN(orderedCookie.orderedDigests.size(), 4631, size);
+	corruptReader.close();
+	PTF_ASSERT_TRUE(corruptReader.open());
+	PTF_ASSERT_FALSE(corruptReader.readPackets(parallelReadPacketArrivesInOrder, &orderedCookie));
+	corruptReader.close();
+
+	pcpp::ParallelPcapFileReader notOpenedReader(EXAMPLE_PCAP_PATH);
+	PTF_ASSERT_FALSE(notOpenedReader.readPackets(parallelReadPacketArrives, &cookie));
+	PTF_ASSERT_FALSE(notOpenedReader.buildIndex());
+	PTF_ASSERT_FALSE(notOpenedReader.setIndex(scannedIndex));
+	PTF_ASSERT_TRUE(notOpenedReader.open());
+	PTF_ASSERT_FALSE(notOpenedReader.setIndex(std::vector<uint64_t>()));
+	PTF_ASSERT_FALSE(notOpenedReader.setIndex(std::vector<uint64_t>(1, 0)));
+	std::vector<uint64_t> badIndex = scannedIndex;
+	badIndex.push_back(3812643);
+	PTF_ASSERT_FALSE(notOpenedReader.setIndex(badIndex));
+	notOpenedReader.close();
+	pcpp::ParallelPcapFileReader pcapNgReader(EXAMPLE_PCAPNG_PATH);
+	PTF_ASSERT_FALSE(pcapNgReader.open());
+	pcpp::ParallelPcapFileReader nonExistingReader("PcapExamples/non_existing_file.pcap");
+	PTF_ASSERT_FALSE(nonExistingReader.open());
+	pcpp::LoggerPP::getInstance().enableErrors();
+} // TestParallelPcapFileRead
+
+
+
 PTF_TEST_CASE(TestPcapNgFileReadWrite)
 {
 	pcpp::PcapNgFileReaderDevice readerDev(EXAMPLE_PCAPNG_PATH);
@@ -1,10 +1,12 @@
 #include "../TestDefinition.h"
 #include "../Common/TestUtils.h"
 #include "IPReassembly.h"
+#include "IPv4Layer.h"
 #include "IPv6Layer.h"
 #include "HttpLayer.h"
 #include "PcapFileDevice.h"
 #include "EndianPortable.h"
+#include <algorithm>
 
 
 static void ipReassemblyOnFragmentsClean(const pcpp::IPReassembly::PacketKey* key, void* userCookie)
@@ -1081,4 +1083,224 @@ PTF_TEST_CASE(TestIPFragRemove)
 
 	ipReassembly.processPacket(ip4Packet8Frags.at(0), status);
 	PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 6, size);
-} // TestIPFragRemove
\ No newline at end of file
+} // TestIPFragRemove
+
+
+
+PTF_TEST_CASE(TestIPFragPooledBuffers)
+{
+	const char* pcapFiles[] = { "PcapExamples/ip4_fragments.pcap", "PcapExamples/ip6_fragments.pcap", "PcapExamples/frag_http_req.pcap" };
+
+	for (size_t fileIndex = 0; fileIndex < 3; fileIndex++)
+	{
+		pcpp::PcapFileReaderDevice reader(pcapFiles[fileIndex]);
+		PTF_ASSERT_TRUE(reader.open());
+
+		pcpp::RawPacketVector fragments;
+		reader.getNextPackets(fragments);
+		reader.close();
+
+		// reassemble the fragments in the order they were captured, once with the default mode and once with pooled buffers
+		pcpp::IPReassembly defaultReassembly;
+		pcpp::IPReassembly pooledReassembly(NULL, NULL, PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE, true);
+		PTF_ASSERT_FALSE(defaultReassembly.isUsingPooledBuffers());
+		PTF_ASSERT_TRUE(pooledReassembly.isUsingPooledBuffers());
+
+		std::vector<std::string> defaultResults;
+		std::vector<std::string> pooledResults;
+
+		for (pcpp::RawPacketVector::VectorIterator iter = fragments.begin(); iter != fragments.end(); iter++)
+		{
+			pcpp::IPReassembly::ReassemblyStatus defaultStatus;
+			pcpp::IPReassembly::ReassemblyStatus pooledStatus;
+			pcpp::Packet* defaultResult = defaultReassembly.processPacket(*iter, defaultStatus);
+			pcpp::Packet* pooledResult = pooledReassembly.processPacket(*iter, pooledStatus);
+			PTF_ASSERT_EQUAL(pooledStatus, defaultStatus, enum);
+
+			if (defaultStatus == pcpp::IPReassembly::REASSEMBLED)
+			{
+				defaultResults.push_back(std::string((const char*)defaultResult->getRawPacket()->getRawData(), defaultResult->getRawPacket()->getRawDataLen()));
+				pooledResults.push_back(std::string((const char*)pooledResult->getRawPacket()->getRawData(), pooledResult->getRawPacket()->getRawDataLen()));
+			}
+
+			// results of processing a RawPacket are always new Packet objects, including non-fragments
+			delete defaultResult;
+			delete pooledResult;
+		}
+
+		PTF_ASSERT_TRUE(defaultResults.size() > 0);
+		PTF_ASSERT_TRUE(pooledResults == defaultResults);
+		PTF_ASSERT_EQUAL(pooledReassembly.getCurrentCapacity(), defaultReassembly.getCurrentCapacity(), size);
+
+		// reassemble the fragments in reverse order, so all fragments but the first one arrive out-of-order. The buffers of the previous
+		// round are reused
+		std::vector<std::string> reversedResults;
+		for (int i = (int)fragments.size() - 1; i >= 0; i--)
+		{
+			pcpp::IPReassembly::ReassemblyStatus status;
+			pcpp::Packet* result = pooledReassembly.processPacket(fragments.at(i), status);
+			if (status == pcpp::IPReassembly::REASSEMBLED)
+			{
+				reversedResults.push_back(std::string((const char*)result->getRawPacket()->getRawData(), result->getRawPacket()->getRawDataLen()));
+			}
+
+			delete result;
+		}
+
+		std::sort(reversedResults.begin(), reversedResults.end());
+		std::sort(defaultResults.begin(), defaultResults.end());
+		PTF_ASSERT_TRUE(reversedResults == defaultResults);
+	}
+
+
+	// partial data in pooled buffer mode
+	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	std::vector<pcpp::RawPacket> packetStream;
+	std::string errMsg;
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/frag_http_req.pcap", packetStream, errMsg));
+
+	int bufferLength = 0;
+	uint8_t* buffer = readFileIntoBuffer("PcapExamples/frag_http_req_partial.txt", bufferLength);
+
+	pcpp::IPReassembly ipReassembly(NULL, NULL, PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE, true);
+	pcpp::IPReassembly::ReassemblyStatus status;
+
+	// a fragment beyond the contiguous data doesn't show in the partial packet
+	ipReassembly.processPacket(&packetStream.at(7), status);
+	PTF_ASSERT_EQUAL(status, pcpp::IPReassembly::OUT_OF_ORDER_FRAGMENT, enum);
+
+	for (size_t i = 0; i < 6; i++)
+	{
+		pcpp::Packet packet(&packetStream.at(i));
+		ipReassembly.processPacket(&packet, status);
+	}
+
+	pcpp::IPReassembly::IPv4PacketKey ip4Key(16991, pcpp::IPv4Address(std::string("172.16.133.54")), pcpp::IPv4Address(std::string("216.137.33.81")));
+	pcpp::Packet* partialPacket = ipReassembly.getCurrentPacket(ip4Key);
+
+	PTF_ASSERT_NOT_NULL(partialPacket);
+	PTF_ASSERT_EQUAL(partialPacket->getRawPacket()->getRawDataLen(), bufferLength, int);
+	PTF_ASSERT_BUF_COMPARE(partialPacket->getRawPacket()->getRawData(), buffer, bufferLength);
+
+	delete partialPacket;
+	delete [] buffer;
+
+	ipReassembly.removePacket(ip4Key);
+	PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 0, size);
+	PTF_ASSERT_NULL(ipReassembly.getCurrentPacket(ip4Key));
+} // TestIPFragPooledBuffers
+
+
+
+
+PTF_TEST_CASE(TestIPFragTimeout)
+{
+	pcpp::PcapFileReaderDevice reader("PcapExamples/ip4_fragments.pcap");
+	PTF_ASSERT_TRUE(reader.open());
+
+	pcpp::RawPacketVector ip4Packet1Frags;
+	pcpp::RawPacketVector ip4Packet2Frags;
+	pcpp::RawPacketVector ip4Packet3Frags;
+	pcpp::RawPacketVector ip4Packet4Frags;
+	pcpp::RawPacketVector ip4Packet5Vec;
+
+	PTF_ASSERT_EQUAL(reader.getNextPackets(ip4Packet1Frags, 6), 6, int);
+	PTF_ASSERT_EQUAL(reader.getNextPackets(ip4Packet2Frags, 6), 6, int);
+	PTF_ASSERT_EQUAL(reader.getNextPackets(ip4Packet3Frags, 6), 6, int);
+	PTF_ASSERT_EQUAL(reader.getNextPackets(ip4Packet4Frags, 10), 10, int);
+	PTF_ASSERT_EQUAL(reader.getNextPackets(ip4Packet5Vec, 1), 1, int);
+
+	reader.close();
+
+	pcpp::Packet ip4Packet1FirstFrag(ip4Packet1Frags.at(0));
+	uint16_t ip4Packet1IpID = be16toh(ip4Packet1FirstFrag.getLayerOfType<pcpp::IPv4Layer>()->getIPv4Header()->ipId);
+
+	// the timeout behaves the same in both modes
+	for (int pooled = 0; pooled < 2; pooled++)
+	{
+		pcpp::PointerVector<pcpp::IPReassembly::PacketKey> packetsRemoved;
+		pcpp::IPReassembly ipReassembly(ipReassemblyOnFragmentsClean, &packetsRemoved, PCPP_IP_REASSEMBLY_DEFAULT_MAX_PACKETS_TO_STORE, pooled == 1, PCPP_IP_REASSEMBLY_DEFAULT_TIMEOUT);
+		PTF_ASSERT_EQUAL(ipReassembly.getTimeout(), PCPP_IP_REASSEMBLY_DEFAULT_TIMEOUT, u32);
+
+		pcpp::IPReassembly::ReassemblyStatus status;
+		timeval time;
+		time.tv_usec = 0;
+
+		// packet 1 starts at t=1000 and packet 2 at t=1010
+		time.tv_sec = 1000;
+		ip4Packet1Frags.at(0)->setPacketTimeStamp(time);
+		ipReassembly.processPacket(ip4Packet1Frags.at(0), status);
+		PTF_ASSERT_EQUAL(status, pcpp::IPReassembly::FIRST_FRAGMENT, enum);
+
+		time.tv_sec = 1010;
+		ip4Packet2Frags.at(0)->setPacketTimeStamp(time);
+		ipReassembly.processPacket(ip4Packet2Frags.at(0), status);
+		PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 2, size);
+
+		// at t=1030 packet 1 hasn't timed out yet
+		time.tv_sec = 1030;
+		ip4Packet2Frags.at(1)->setPacketTimeStamp(time);
+		ipReassembly.processPacket(ip4Packet2Frags.at(1), status);
+		PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 2, size);
+		PTF_ASSERT_EQUAL(packetsRemoved.size(), 0, size);
+
+		// at t=1031 it has, and its next fragment starts a new packet which is missing its first fragment
+		time.tv_sec = 1031;
+		ip4Packet1Frags.at(1)->setPacketTimeStamp(time);
+		ipReassembly.processPacket(ip4Packet1Frags.at(1), status);
+		PTF_ASSERT_EQUAL(status, pcpp::IPReassembly::OUT_OF_ORDER_FRAGMENT, enum);
+		PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 2, size);
+		PTF_ASSERT_EQUAL(packetsRemoved.size(), 1, size);
+		PTF_ASSERT_EQUAL(((pcpp::IPReassembly::IPv4PacketKey*)packetsRemoved.front())->getIpID(), ip4Packet1IpID, u16);
+		PTF_ASSERT_EQUAL(ipReassembly.getStatistics().numOfExpiredPackets, 1, u64);
+
+		// packet 2 completes before its timeout
+		pcpp::Packet* result = NULL;
+		for (size_t i = 2; i < ip4Packet2Frags.size(); i++)
+		{
+			ip4Packet2Frags.at(i)->setPacketTimeStamp(time);
+			result = ipReassembly.processPacket(ip4Packet2Frags.at(i), status);
+		}
+		PTF_ASSERT_EQUAL(status, pcpp::IPReassembly::REASSEMBLED, enum);
+		delete result;
+		PTF_ASSERT_EQUAL(ipReassembly.getStatistics().numOfReassembledPackets, 1, u64);
+
+		// a duplicated first fragment and a duplicated fragment overlap data already received
+		for (size_t i = 0; i < 2; i++)
+		{
+			ip4Packet3Frags.at(i)->setPacketTimeStamp(time);
+			ipReassembly.processPacket(ip4Packet3Frags.at(i), status);
+			ipReassembly.processPacket(ip4Packet3Frags.at(i), status);
+		}
+		PTF_ASSERT_EQUAL(ipReassembly.getStatistics().numOfOverlappingFragments, 2, u64);
+		PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 2, size);
+
+		// a packet arriving much later expires everything that's left, including packet 2's timer which is no longer in use
+		time.tv_sec = 5000;
+		ip4Packet5Vec.at(0)->setPacketTimeStamp(time);
+		result = ipReassembly.processPacket(ip4Packet5Vec.at(0), status);
+		PTF_ASSERT_EQUAL(status, pcpp::IPReassembly::NON_FRAGMENT, enum);
+		delete result;
+		PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 0, size);
+		PTF_ASSERT_EQUAL(packetsRemoved.size(), 3, size);
+		PTF_ASSERT_EQUAL(ipReassembly.getStatistics().numOfExpiredPackets, 3, u64);
+		PTF_ASSERT_EQUAL(ipReassembly.getStatistics().numOfReassembledPackets, 1, u64);
+
+		// packets start again after the jump
+		ip4Packet4Frags.at(0)->setPacketTimeStamp(time);
+		ipReassembly.processPacket(ip4Packet4Frags.at(0), status);
+		PTF_ASSERT_EQUAL(status, pcpp::IPReassembly::FIRST_FRAGMENT, enum);
+		PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 1, size);
+	}
+
+	// without a timeout packets wait for their fragments as long as there is room for them
+	pcpp::IPReassembly ipReassembly;
+	PTF_ASSERT_EQUAL(ipReassembly.getTimeout(), 0, u32);
+	pcpp::IPReassembly::ReassemblyStatus status;
+	ipReassembly.processPacket(ip4Packet1Frags.at(0), status);
+	pcpp::Packet* result = ipReassembly.processPacket(ip4Packet5Vec.at(0), status);
+	delete result;
+	PTF_ASSERT_EQUAL(ipReassembly.getCurrentCapacity(), 1, size);
+	PTF_ASSERT_EQUAL(ipReassembly.getStatistics().numOfExpiredPackets, 0, u64);
+} // TestIPFragTimeout
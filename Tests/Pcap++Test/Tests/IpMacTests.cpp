@@ -3,6 +3,8 @@
 #include "../Common/GlobalTestArgs.h"
 #include <sstream>
 #include <algorithm>
+#include <list>
+#include <stdlib.h>
 #include "EndianPortable.h"
 #include "Logger.h"
 #include "GeneralUtils.h"
@@ -137,6 +139,90 @@ PTF_TEST_CASE(TestMacAddress)
 
 
 
+// hashes the elements to only 4 home slots, so they collide in long probe chains
+struct LRUListCollidingHash
+{
+	size_t operator()(uint32_t element) const { return element % 4; }
+};
+
+struct LRUListStringHash
+{
+	size_t operator()(const std::string& element) const
+	{
+		// FNV-1a
+		size_t hash = 2166136261U;
+		for (std::string::const_iterator iter = element.begin(); iter != element.end(); ++iter)
+			hash = (hash ^ (uint8_t)*iter) * 16777619U;
+		return hash;
+	}
+};
+
+// a straightforward LRU list to compare LRUList with
+template<typename T>
+class LRUListModel
+{
+public:
+	LRUListModel(size_t maxSize) : m_MaxSize(maxSize) {}
+
+	int put(const T& element, T* deletedValue)
+	{
+		typename std::list<T>::iterator iter = std::find(m_List.begin(), m_List.end(), element);
+		if (iter != m_List.end())
+		{
+			m_List.splice(m_List.begin(), m_List, iter);
+			return 0;
+		}
+
+		m_List.push_front(element);
+		if (m_List.size() <= m_MaxSize)
+			return 0;
+
+		*deletedValue = m_List.back();
+		m_List.pop_back();
+		return 1;
+	}
+
+	void eraseElement(const T& element) { m_List.remove(element); }
+
+	const std::list<T>& getList() const { return m_List; }
+
+private:
+	std::list<T> m_List;
+	size_t m_MaxSize;
+};
+
+// put and erase random values in the list and the model, and compare them after each operation
+template<typename List, typename T>
+static bool lruListMatchesModel(List& lruList, const std::vector<T>& values, int numOfOperations)
+{
+	LRUListModel<T> model(lruList.getMaxSize());
+	for (int i = 0; i < numOfOperations; i++)
+	{
+		const T& value = values[rand() % values.size()];
+		if (rand() % 4 == 0)
+		{
+			lruList.eraseElement(value);
+			model.eraseElement(value);
+		}
+		else
+		{
+			T deletedValue = T();
+			T modelDeletedValue = T();
+			int result = lruList.put(value, &deletedValue);
+			if (result != model.put(value, &modelDeletedValue) || !(deletedValue == modelDeletedValue))
+				return false;
+		}
+
+		if (lruList.getSize() != model.getList().size())
+			return false;
+		if (lruList.getSize() > 0 && (!(lruList.getMRUElement() == model.getList().front()) || !(lruList.getLRUElement() == model.getList().back())))
+			return false;
+	}
+
+	// a new node is allocated only when there's no free one, and only one more than the max size is needed before evicting
+	return lruList.getNumOfAllocatedNodes() <= lruList.getMaxSize() + 1;
+}
+
 PTF_TEST_CASE(TestLRUList)
 {
 	pcpp::LRUList<uint32_t> lruList(2);
@@ -150,6 +236,92 @@ PTF_TEST_CASE(TestLRUList)
 	PTF_ASSERT_EQUAL(lruList.put(3, &deletedValue), 1, int);
 	PTF_ASSERT_EQUAL(deletedValue, 1, u32);
 
+	// putting an existing element advances it to the head of the list
+	PTF_ASSERT_EQUAL(lruList.put(2, &deletedValue), 0, int);
+	PTF_ASSERT_EQUAL(lruList.getMRUElement(), 2, u32);
+	PTF_ASSERT_EQUAL(lruList.getLRUElement(), 3, u32);
+	PTF_ASSERT_EQUAL(lruList.put(4, &deletedValue), 1, int);
+	PTF_ASSERT_EQUAL(deletedValue, 3, u32);
+	PTF_ASSERT_EQUAL(lruList.getSize(), 2, size);
+
+	lruList.eraseElement(4);
+	PTF_ASSERT_EQUAL(lruList.getMRUElement(), 2, u32);
+	PTF_ASSERT_EQUAL(lruList.getLRUElement(), 2, u32);
+
+
+	// the index grows several times past its initial 16 slots, and evicted elements leave in the order they were put
+	pcpp::LRUList<uint32_t> largeList(1000);
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		PTF_ASSERT_EQUAL(largeList.put(i), 0, int);
+	}
+	PTF_ASSERT_TRUE(largeList.getIndexCapacity() * 3 >= largeList.getSize() * 4);
+	for (uint32_t i = 1000; i < 3000; i++)
+	{
+		PTF_ASSERT_EQUAL(largeList.put(i, &deletedValue), 1, int);
+		PTF_ASSERT_EQUAL(deletedValue, i - 1000, u32);
+	}
+	PTF_ASSERT_EQUAL(largeList.getSize(), 1000, size);
+	PTF_ASSERT_EQUAL(largeList.getNumOfAllocatedNodes(), 1001, size);
+
+	// the nodes of erased elements are reused for new ones
+	for (uint32_t i = 2000; i < 3000; i += 2)
+		largeList.eraseElement(i);
+	PTF_ASSERT_EQUAL(largeList.getSize(), 500, size);
+	PTF_ASSERT_EQUAL(largeList.getLRUElement(), 2001, u32);
+	for (uint32_t i = 3000; i < 3500; i++)
+	{
+		PTF_ASSERT_EQUAL(largeList.put(i), 0, int);
+	}
+	PTF_ASSERT_EQUAL(largeList.getSize(), 1000, size);
+	PTF_ASSERT_EQUAL(largeList.getNumOfAllocatedNodes(), 1001, size);
+	PTF_ASSERT_EQUAL(largeList.getMRUElement(), 3499, u32);
+
+	// erasing from the middle of long probe chains moves the following elements back, and all of them are still found
+	pcpp::LRUList<uint32_t, LRUListCollidingHash> collidingList(40);
+	for (uint32_t i = 0; i < 40; i++)
+	{
+		PTF_ASSERT_EQUAL(collidingList.put(i), 0, int);
+	}
+	for (uint32_t i = 0; i < 40; i += 3)
+		collidingList.eraseElement(i);
+	collidingList.eraseElement(100);
+	PTF_ASSERT_EQUAL(collidingList.getSize(), 26, size);
+	for (uint32_t i = 0; i < 40; i++)
+	{
+		// putting an element that is still in the list only advances it
+		if (i % 3 != 0)
+		{
+			PTF_ASSERT_EQUAL(collidingList.put(i), 0, int);
+			PTF_ASSERT_EQUAL(collidingList.getSize(), 26, size);
+			PTF_ASSERT_EQUAL(collidingList.getMRUElement(), i, u32);
+		}
+	}
+	PTF_ASSERT_EQUAL(collidingList.getLRUElement(), 1, u32);
+
+	srand(1);
+	std::vector<uint32_t> intValues;
+	std::vector<std::string> stringValues;
+	for (uint32_t i = 0; i < 300; i++)
+	{
+		intValues.push_back(i * 7919);
+		// long enough not to fit in a short-string buffer, so an element moved from is left empty
+		std::stringstream stream;
+		stream << "lru-list-element-" << i;
+		stringValues.push_back(stream.str());
+	}
+	pcpp::LRUList<uint32_t> randomIntList(100);
+	PTF_ASSERT_TRUE(lruListMatchesModel(randomIntList, intValues, 20000));
+	pcpp::LRUList<uint32_t, LRUListCollidingHash> randomCollidingList(100);
+	PTF_ASSERT_TRUE(lruListMatchesModel(randomCollidingList, intValues, 20000));
+	// elements that the default hash function doesn't support are kept in an ordered index
+	pcpp::LRUList<std::string> randomStringList(100);
+	PTF_ASSERT_TRUE(lruListMatchesModel(randomStringList, stringValues, 20000));
+	pcpp::LRUList<std::string, LRUListStringHash> randomHashedStringList(100);
+	PTF_ASSERT_TRUE(lruListMatchesModel(randomHashedStringList, stringValues, 20000));
+	pcpp::LRUList<uint32_t> emptyList(0);
+	PTF_ASSERT_TRUE(lruListMatchesModel(emptyList, intValues, 1000));
+
 	lruList.eraseElement(1);
 	lruList.eraseElement(2);
 	lruList.eraseElement(3);
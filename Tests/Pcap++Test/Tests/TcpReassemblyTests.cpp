@@ -5,11 +5,14 @@
 #include <algorithm>
 #include "EndianPortable.h"
 #include "TcpReassembly.h"
+#include "ShardedTcpReassembly.h"
 #include "IPv4Layer.h"
 #include "TcpLayer.h"
 #include "PayloadLayer.h"
 #include "PcapFileDevice.h"
 #include "PlatformSpecificUtils.h"
+#include "Logger.h"
+#include <pthread.h>
 
 
 // ~~~~~~~~~~~~~~~~~~
@@ -20,16 +23,19 @@ struct TcpReassemblyStats
 {
 	std::string reassembledData;
 	int numOfDataPackets;
+	int maxNumOfSegments;
 	int curSide;
 	int numOfMessagesFromSide[2];
 	bool connectionsStarted;
 	bool connectionsEnded;
 	bool connectionsEndedManually;
+	bool connectionsEndedByTimeout;
 	pcpp::ConnectionData connData;
+	pcpp::ConnectionData connDataAtEnd;
 
 	TcpReassemblyStats() { clear(); }
 
-	void clear() { reassembledData = ""; numOfDataPackets = 0; curSide = -1; numOfMessagesFromSide[0] = 0; numOfMessagesFromSide[1] = 0; connectionsStarted = false; connectionsEnded = false; connectionsEndedManually = false; }
+	void clear() { reassembledData = ""; numOfDataPackets = 0; maxNumOfSegments = 0; curSide = -1; numOfMessagesFromSide[0] = 0; numOfMessagesFromSide[1] = 0; connectionsStarted = false; connectionsEnded = false; connectionsEndedManually = false; connectionsEndedByTimeout = false; }
 };
 
 
@@ -92,7 +98,21 @@ static void tcpReassemblyMsgReadyCallback(int sideIndex, const pcpp::TcpStreamDa
 	}
 
 	iter->second.numOfDataPackets++;
-	iter->second.reassembledData += std::string((char*)tcpData.getData(), tcpData.getDataLength());
+
+	// missing data is reported in a separate field when segment references are delivered. Add the same text TcpReassembly adds
+	// otherwise, so both modes can be compared with the same expected output
+	if (tcpData.getMissingDataLength() > 0)
+	{
+		std::stringstream missingDataText;
+		missingDataText << "[" << tcpData.getMissingDataLength() << " bytes missing]";
+		iter->second.reassembledData += missingDataText.str();
+	}
+
+	for (size_t i = 0; i < tcpData.getNumOfSegments(); i++)
+		iter->second.reassembledData += std::string((char*)tcpData.getSegmentData(i), tcpData.getSegmentLength(i));
+
+	if ((int)tcpData.getNumOfSegments() > iter->second.maxNumOfSegments)
+		iter->second.maxNumOfSegments = (int)tcpData.getNumOfSegments();
 }
 
 
@@ -139,13 +159,71 @@ static void tcpReassemblyConnectionEndCallback(const pcpp::ConnectionData& conne
 	if(std::find(flowKeys.begin(), flowKeys.end(), connectionData.flowKey) == flowKeys.end())
 		flowKeys.push_back(connectionData.flowKey);
 
+	iter->second.connDataAtEnd = connectionData;
+
 	if (reason == pcpp::TcpReassembly::TcpReassemblyConnectionClosedManually)
 		iter->second.connectionsEndedManually = true;
+	else if (reason == pcpp::TcpReassembly::TcpReassemblyConnectionClosedByTimeout)
+		iter->second.connectionsEndedByTimeout = true;
 	else
 		iter->second.connectionsEnded = true;
 }
 
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// ShardedTcpReassemblyStats + sharded callbacks
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// the callbacks of ShardedTcpReassembly run on the worker threads, so they take a lock and then update the same stats the
+// TcpReassembly callbacks do. The shard of every connection is kept to check all callbacks of a connection come from one shard
+struct ShardedTcpReassemblyStats
+{
+	TcpReassemblyMultipleConnStats results;
+	std::map<uint32_t, size_t> shardOfFlow;
+	bool shardMismatch;
+	pthread_mutex_t mutex;
+
+	ShardedTcpReassemblyStats() : shardMismatch(false) { pthread_mutex_init(&mutex, NULL); }
+	~ShardedTcpReassemblyStats() { pthread_mutex_destroy(&mutex); }
+
+	void checkShard(uint32_t flowKey, size_t shardId)
+	{
+		std::map<uint32_t, size_t>::iterator iter = shardOfFlow.find(flowKey);
+		if (iter == shardOfFlow.end())
+			shardOfFlow[flowKey] = shardId;
+		else if (iter->second != shardId)
+			shardMismatch = true;
+	}
+};
+
+static void shardedTcpReassemblyMsgReadyCallback(size_t shardId, int sideIndex, const pcpp::TcpStreamData& tcpData, void* userCookie)
+{
+	ShardedTcpReassemblyStats* stats = (ShardedTcpReassemblyStats*)userCookie;
+	pthread_mutex_lock(&stats->mutex);
+	stats->checkShard(tcpData.getConnectionData().flowKey, shardId);
+	tcpReassemblyMsgReadyCallback(sideIndex, tcpData, &stats->results);
+	pthread_mutex_unlock(&stats->mutex);
+}
+
+static void shardedTcpReassemblyConnectionStartCallback(size_t shardId, const pcpp::ConnectionData& connectionData, void* userCookie)
+{
+	ShardedTcpReassemblyStats* stats = (ShardedTcpReassemblyStats*)userCookie;
+	pthread_mutex_lock(&stats->mutex);
+	stats->checkShard(connectionData.flowKey, shardId);
+	tcpReassemblyConnectionStartCallback(connectionData, &stats->results);
+	pthread_mutex_unlock(&stats->mutex);
+}
+
+static void shardedTcpReassemblyConnectionEndCallback(size_t shardId, const pcpp::ConnectionData& connectionData, pcpp::TcpReassembly::ConnectionEndReason reason, void* userCookie)
+{
+	ShardedTcpReassemblyStats* stats = (ShardedTcpReassemblyStats*)userCookie;
+	pthread_mutex_lock(&stats->mutex);
+	stats->checkShard(connectionData.flowKey, shardId);
+	tcpReassemblyConnectionEndCallback(connectionData, reason, &stats->results);
+	pthread_mutex_unlock(&stats->mutex);
+}
+
+
 // ~~~~~~~~~~~~~~~~~~~
 // tcpReassemblyTest()
 // ~~~~~~~~~~~~~~~~~~~
@@ -187,6 +265,26 @@ static bool tcpReassemblyTest(std::vector<pcpp::RawPacket>& packetStream, TcpRea
 }
 
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// tcpReassemblyTestWithConfig()
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static void tcpReassemblyTestWithConfig(std::vector<pcpp::RawPacket>& packetStream, TcpReassemblyMultipleConnStats& results, const pcpp::TcpReassemblyConfiguration& config, pcpp::TcpReassembly::OutOfOrderStatistics& oooStats)
+{
+	pcpp::TcpReassembly tcpReassembly(tcpReassemblyMsgReadyCallback, &results, tcpReassemblyConnectionStartCallback, tcpReassemblyConnectionEndCallback, config);
+
+	for (std::vector<pcpp::RawPacket>::iterator iter = packetStream.begin(); iter != packetStream.end(); iter++)
+	{
+		pcpp::Packet packet(&(*iter));
+		tcpReassembly.reassemblePacket(packet);
+	}
+
+	tcpReassembly.closeAllConnections();
+
+	oooStats = tcpReassembly.getOutOfOrderStatistics();
+}
+
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // tcpReassemblyAddRetransmissions()
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -978,4 +1076,469 @@ PTF_TEST_CASE(TestTcpReassemblyMaxSeq)
 
 	std::string expectedReassemblyData = readFileIntoString(std::string("PcapExamples/one_tcp_stream_output.txt"));
 	PTF_ASSERT_EQUAL(expectedReassemblyData, stats.begin()->second.reassembledData, string);
-} //TestTcpReassemblyMaxSeq
\ No newline at end of file
+} //TestTcpReassemblyMaxSeq
+
+
+
+PTF_TEST_CASE(TestTcpReassemblyOutOfOrderWrapAround)
+{
+	// the server's response in one_tcp_stream_max_seq.pcap is in packets 9, 10, 12, 13 and 14 (packet 11 is an ACK of the client).
+	// Its sequence numbers wrap around between packets 10 and 12, so the sorted out-of-order segments of this side span the wrap
+	int responsePacketIndices[] = { 9, 10, 12, 13, 14 };
+	// the response segments in reverse order, and then interleaved
+	int reorders[][5] = { { 14, 13, 12, 10, 9 }, { 12, 9, 14, 10, 13 } };
+
+	std::string expectedReassemblyData = readFileIntoString(std::string("PcapExamples/one_tcp_stream_output.txt"));
+
+	for (int reorder = 0; reorder < 2; reorder++)
+	{
+		std::string errMsg;
+		std::vector<pcpp::RawPacket> origPacketStream;
+		PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_tcp_stream_max_seq.pcap", origPacketStream, errMsg));
+
+		std::vector<pcpp::RawPacket> packetStream = origPacketStream;
+		for (int i = 0; i < 5; i++)
+			packetStream[responsePacketIndices[i]] = origPacketStream[reorders[reorder][i]];
+
+		TcpReassemblyMultipleConnStats tcpReassemblyResults;
+		tcpReassemblyTest(packetStream, tcpReassemblyResults, true, true);
+
+		TcpReassemblyMultipleConnStats::Stats &stats = tcpReassemblyResults.stats;
+		PTF_ASSERT_EQUAL(stats.size(), 1, size);
+		PTF_ASSERT_EQUAL(stats.begin()->second.numOfMessagesFromSide[0], 2, int);
+		PTF_ASSERT_EQUAL(stats.begin()->second.numOfMessagesFromSide[1], 2, int);
+		PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedManually);
+		PTF_ASSERT_EQUAL(expectedReassemblyData, stats.begin()->second.reassembledData, string);
+	}
+} // TestTcpReassemblyOutOfOrderWrapAround
+
+
+// the cookie of a TcpReassembly whose connection end callback closes all other connections when a connection is closed by
+// timeout. It's used to check the callback may close connections the idle timeout is about to close too
+struct TcpReassemblyCloseOthersOnTimeout
+{
+	TcpReassemblyMultipleConnStats results;
+	pcpp::TcpReassembly* tcpReassembly;
+};
+
+static void tcpReassemblyCloseOthersMsgReadyCallback(int sideIndex, const pcpp::TcpStreamData& tcpData, void* userCookie)
+{
+	tcpReassemblyMsgReadyCallback(sideIndex, tcpData, &((TcpReassemblyCloseOthersOnTimeout*)userCookie)->results);
+}
+
+static void tcpReassemblyCloseOthersConnectionStartCallback(const pcpp::ConnectionData& connectionData, void* userCookie)
+{
+	tcpReassemblyConnectionStartCallback(connectionData, &((TcpReassemblyCloseOthersOnTimeout*)userCookie)->results);
+}
+
+static void tcpReassemblyCloseOthersConnectionEndCallback(const pcpp::ConnectionData& connectionData, pcpp::TcpReassembly::ConnectionEndReason reason, void* userCookie)
+{
+	TcpReassemblyCloseOthersOnTimeout* cookie = (TcpReassemblyCloseOthersOnTimeout*)userCookie;
+	tcpReassemblyConnectionEndCallback(connectionData, reason, &cookie->results);
+	if (reason != pcpp::TcpReassembly::TcpReassemblyConnectionClosedByTimeout)
+		return;
+
+	TcpReassemblyMultipleConnStats::FlowKeysList flowKeys = cookie->results.flowKeysList;
+	for (TcpReassemblyMultipleConnStats::FlowKeysList::iterator iter = flowKeys.begin(); iter != flowKeys.end(); ++iter)
+	{
+		if (*iter != connectionData.flowKey)
+			cookie->tcpReassembly->closeConnection(*iter);
+	}
+}
+
+PTF_TEST_CASE(TestTcpReassemblyIdleTimeout)
+{
+	std::string errMsg;
+	std::vector<pcpp::RawPacket> packetStream;
+
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_tcp_stream.pcap", packetStream, errMsg));
+
+	// the client's request takes the first 9 packets. Delay the server's response by 100 seconds
+	for (size_t i = 9; i < packetStream.size(); i++)
+	{
+		timespec timestamp = packetStream[i].getPacketTimeStamp();
+		timestamp.tv_sec += 100;
+		packetStream[i].setPacketTimeStamp(timestamp);
+	}
+
+	// the connection is idle for 100 seconds which is longer than the timeout. The first packet of the response closes it, and the
+	// rest of the response is ignored like any other packet of a closed connection
+	TcpReassemblyMultipleConnStats results;
+	pcpp::TcpReassemblyConfiguration config(true, 5, 30, 10);
+	pcpp::TcpReassembly tcpReassembly(tcpReassemblyMsgReadyCallback, &results, tcpReassemblyConnectionStartCallback, tcpReassemblyConnectionEndCallback, config);
+	for (size_t i = 0; i < packetStream.size(); i++)
+	{
+		pcpp::Packet packet(&packetStream[i]);
+		pcpp::TcpReassembly::ReassemblyStatus status = tcpReassembly.reassemblePacket(packet);
+		if (i == 9)
+		{
+			PTF_ASSERT_EQUAL(status, pcpp::TcpReassembly::Ignore_PacketOfClosedFlow, enum);
+		}
+	}
+	tcpReassembly.closeAllConnections();
+
+	TcpReassemblyMultipleConnStats::Stats &stats = results.stats;
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsStarted);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedByTimeout);
+	PTF_ASSERT_FALSE(stats.begin()->second.connectionsEnded);
+	PTF_ASSERT_FALSE(stats.begin()->second.connectionsEndedManually);
+	PTF_ASSERT_EQUAL(stats.begin()->second.numOfDataPackets, 3, int);
+	PTF_ASSERT_EQUAL(stats.begin()->second.numOfMessagesFromSide[0], 1, int);
+	PTF_ASSERT_EQUAL(stats.begin()->second.numOfMessagesFromSide[1], 0, int);
+	PTF_ASSERT_EQUAL(tcpReassembly.isConnectionOpen(stats.begin()->second.connData), 0, int);
+
+	// a longer timeout doesn't close the connection
+	results.clear();
+	pcpp::TcpReassemblyConfiguration longTimeoutConfig(true, 5, 30, 200);
+	pcpp::TcpReassembly longTimeoutTcpReassembly(tcpReassemblyMsgReadyCallback, &results, tcpReassemblyConnectionStartCallback, tcpReassemblyConnectionEndCallback, longTimeoutConfig);
+	for (size_t i = 0; i < packetStream.size(); i++)
+	{
+		pcpp::Packet packet(&packetStream[i]);
+		longTimeoutTcpReassembly.reassemblePacket(packet);
+	}
+	PTF_ASSERT_EQUAL(longTimeoutTcpReassembly.isConnectionOpen(stats.begin()->second.connData), 1, int);
+	longTimeoutTcpReassembly.closeAllConnections();
+
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	PTF_ASSERT_FALSE(stats.begin()->second.connectionsEndedByTimeout);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedManually);
+	PTF_ASSERT_TRUE(stats.begin()->second.numOfMessagesFromSide[1] > 0);
+
+	// ACK-only packets keep the connection open: with a 30 second timeout the 100 seconds the server takes to respond close the
+	// connection, unless the client keeps sending pure ACKs every 20 seconds meanwhile
+	int ackPacketIndex = -1;
+	for (int i = 0; i < 9 && ackPacketIndex < 0; i++)
+	{
+		pcpp::Packet packet(&packetStream[i]);
+		pcpp::TcpLayer* tcpLayer = packet.getLayerOfType<pcpp::TcpLayer>();
+		if (tcpLayer != NULL && tcpLayer->getLayerPayloadSize() == 0 && tcpLayer->getTcpHeader()->synFlag == 0 &&
+			tcpLayer->getTcpHeader()->finFlag == 0 && tcpLayer->getTcpHeader()->rstFlag == 0)
+			ackPacketIndex = i;
+	}
+	PTF_ASSERT_TRUE(ackPacketIndex >= 0);
+
+	std::vector<pcpp::RawPacket> keepAliveStream(packetStream.begin(), packetStream.begin() + 9);
+	for (int i = 1; i <= 4; i++)
+	{
+		pcpp::RawPacket ackPacket(packetStream[ackPacketIndex]);
+		timespec timestamp = packetStream[8].getPacketTimeStamp();
+		timestamp.tv_sec += 20 * i;
+		ackPacket.setPacketTimeStamp(timestamp);
+		keepAliveStream.push_back(ackPacket);
+	}
+	keepAliveStream.insert(keepAliveStream.end(), packetStream.begin() + 9, packetStream.end());
+
+	results.clear();
+	pcpp::TcpReassemblyConfiguration keepAliveConfig(true, 5, 30, 30);
+	pcpp::TcpReassembly keepAliveTcpReassembly(tcpReassemblyMsgReadyCallback, &results, tcpReassemblyConnectionStartCallback, tcpReassemblyConnectionEndCallback, keepAliveConfig);
+	for (size_t i = 0; i < keepAliveStream.size(); i++)
+	{
+		pcpp::Packet packet(&keepAliveStream[i]);
+		keepAliveTcpReassembly.reassemblePacket(packet);
+	}
+	PTF_ASSERT_EQUAL(keepAliveTcpReassembly.isConnectionOpen(stats.begin()->second.connData), 1, int);
+	keepAliveTcpReassembly.closeAllConnections();
+
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	PTF_ASSERT_FALSE(stats.begin()->second.connectionsEndedByTimeout);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedManually);
+	PTF_ASSERT_TRUE(stats.begin()->second.numOfMessagesFromSide[1] > 0);
+
+	// two connections become idle at the same second, and closing the first one by timeout closes the other from the callback
+	pcpp::Packet firstPacket(&packetStream[0]);
+	uint16_t clientPort = firstPacket.getLayerOfType<pcpp::TcpLayer>()->getTcpHeader()->portSrc;
+	uint16_t otherClientPort = htobe16(be16toh(clientPort) + 1);
+	std::vector<pcpp::RawPacket> twoConnsStream(packetStream.begin(), packetStream.begin() + 9);
+	for (size_t i = 0; i < 9; i++)
+	{
+		pcpp::RawPacket otherConnPacket(packetStream[i]);
+		pcpp::Packet packet(&otherConnPacket);
+		pcpp::tcphdr* tcpHeader = packet.getLayerOfType<pcpp::TcpLayer>()->getTcpHeader();
+		if (tcpHeader->portSrc == clientPort)
+			tcpHeader->portSrc = otherClientPort;
+		else
+			tcpHeader->portDst = otherClientPort;
+		twoConnsStream.push_back(otherConnPacket);
+	}
+	twoConnsStream.push_back(packetStream[9]);
+
+	TcpReassemblyCloseOthersOnTimeout closeOthersCookie;
+	pcpp::TcpReassembly closeOthersTcpReassembly(tcpReassemblyCloseOthersMsgReadyCallback, &closeOthersCookie, tcpReassemblyCloseOthersConnectionStartCallback, tcpReassemblyCloseOthersConnectionEndCallback, config);
+	closeOthersCookie.tcpReassembly = &closeOthersTcpReassembly;
+	for (size_t i = 0; i < twoConnsStream.size(); i++)
+	{
+		pcpp::Packet packet(&twoConnsStream[i]);
+		closeOthersTcpReassembly.reassemblePacket(packet);
+	}
+
+	TcpReassemblyMultipleConnStats::Stats &twoConnsStats = closeOthersCookie.results.stats;
+	PTF_ASSERT_EQUAL(twoConnsStats.size(), 2, size);
+	int numOfClosedByTimeout = 0, numOfClosedManually = 0;
+	for (TcpReassemblyMultipleConnStats::Stats::iterator iter = twoConnsStats.begin(); iter != twoConnsStats.end(); ++iter)
+	{
+		PTF_ASSERT_EQUAL(closeOthersTcpReassembly.isConnectionOpen(iter->second.connData), 0, int);
+		numOfClosedByTimeout += (iter->second.connectionsEndedByTimeout ? 1 : 0);
+		numOfClosedManually += (iter->second.connectionsEndedManually ? 1 : 0);
+	}
+	PTF_ASSERT_EQUAL(numOfClosedByTimeout, 1, int);
+	PTF_ASSERT_EQUAL(numOfClosedManually, 1, int);
+} // TestTcpReassemblyIdleTimeout
+
+
+
+PTF_TEST_CASE(TestTcpReassemblyOutOfOrderLimits)
+{
+	std::string errMsg;
+	std::vector<pcpp::RawPacket> packetStream;
+
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_tcp_stream.pcap", packetStream, errMsg));
+
+	// reverse order of all packets in message, so the data of 5 packets is buffered before the first packet of the message arrives
+	for (int i = 0; i < 12; i++)
+	{
+		pcpp::RawPacket oooPacketTemp = packetStream[35];
+		packetStream.erase(packetStream.begin() + 35);
+		packetStream.insert(packetStream.begin() + 24 + i, oooPacketTemp);
+	}
+
+	// no limits
+	TcpReassemblyMultipleConnStats results;
+	pcpp::TcpReassembly::OutOfOrderStatistics oooStats;
+	pcpp::TcpReassemblyConfiguration config;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+
+	TcpReassemblyMultipleConnStats::Stats &stats = results.stats;
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	std::string fullReassemblyData = stats.begin()->second.reassembledData;
+	PTF_ASSERT_EQUAL(oooStats.bufferedBytes, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.bufferedSegments, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.peakBufferedBytes, 5556, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfLimitsReached, 0, u64);
+
+	// a limit that is never reached doesn't change anything
+	results.clear();
+	config.maxOutOfOrderBytes = 5556;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(oooStats.numOfLimitsReached, 0, u64);
+	PTF_ASSERT_EQUAL(stats.begin()->second.reassembledData, fullReassemblyData, string);
+
+	// drop the newest segments once 4 segments are buffered
+	results.clear();
+	config.maxOutOfOrderBytes = 0;
+	config.maxOutOfOrderSegmentsPerSide = 4;
+	config.outOfOrderLimitPolicy = pcpp::TcpReassemblyConfiguration::DropNewest;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(oooStats.bufferedBytes, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.bufferedSegments, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.peakBufferedBytes, 4196, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfLimitsReached, 1, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedSegments, 1, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedBytes, 1360, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfFlushes, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedConnections, 0, u64);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedManually);
+	PTF_ASSERT_TRUE(stats.begin()->second.reassembledData.find("bytes missing]") != std::string::npos);
+
+	// flush the buffered data with a gap marker once more than 2800 bytes are buffered for a side
+	results.clear();
+	config.maxOutOfOrderSegmentsPerSide = 0;
+	config.maxOutOfOrderBytesPerSide = 2800;
+	config.outOfOrderLimitPolicy = pcpp::TcpReassemblyConfiguration::FlushWithGap;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(oooStats.bufferedBytes, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.peakBufferedBytes, 2836, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfLimitsReached, 1, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfFlushes, 1, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedSegments, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedBytes, 0, u64);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedManually);
+	PTF_ASSERT_TRUE(stats.begin()->second.reassembledData.find("bytes missing]") != std::string::npos);
+
+	// drop the connection once the total budget is exceeded
+	results.clear();
+	config.maxOutOfOrderBytesPerSide = 0;
+	config.maxOutOfOrderBytes = 5000;
+	config.outOfOrderLimitPolicy = pcpp::TcpReassemblyConfiguration::DropConnection;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(oooStats.bufferedBytes, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.bufferedSegments, 0, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfLimitsReached, 1, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedConnections, 1, u64);
+	PTF_ASSERT_EQUAL(oooStats.numOfDroppedBytes, 5556, u64);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEnded);
+	PTF_ASSERT_FALSE(stats.begin()->second.connectionsEndedManually);
+	PTF_ASSERT_TRUE(stats.begin()->second.reassembledData.length() < fullReassemblyData.length());
+} // TestTcpReassemblyOutOfOrderLimits
+
+
+
+PTF_TEST_CASE(TestTcpReassemblySegmentReferences)
+{
+	std::string errMsg;
+	std::vector<pcpp::RawPacket> packetStream;
+
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_tcp_stream.pcap", packetStream, errMsg));
+
+	// reverse order of all packets in message, so the data of 5 packets is buffered and sent together with the first packet of the message
+	for (int i = 0; i < 12; i++)
+	{
+		pcpp::RawPacket oooPacketTemp = packetStream[35];
+		packetStream.erase(packetStream.begin() + 35);
+		packetStream.insert(packetStream.begin() + 24 + i, oooPacketTemp);
+	}
+
+	TcpReassemblyMultipleConnStats results;
+	pcpp::TcpReassembly::OutOfOrderStatistics oooStats;
+	pcpp::TcpReassemblyConfiguration config;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+
+	TcpReassemblyMultipleConnStats::Stats &stats = results.stats;
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	std::string copiedReassemblyData = stats.begin()->second.reassembledData;
+	int copiedNumOfDataPackets = stats.begin()->second.numOfDataPackets;
+	PTF_ASSERT_EQUAL(stats.begin()->second.maxNumOfSegments, 1, int);
+
+	// the same data is delivered, but the buffered data is sent in one callback
+	results.clear();
+	config.deliverSegmentReferences = true;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	PTF_ASSERT_EQUAL(stats.begin()->second.reassembledData, copiedReassemblyData, string);
+	PTF_ASSERT_EQUAL(stats.begin()->second.numOfDataPackets, copiedNumOfDataPackets - 5, int);
+	PTF_ASSERT_EQUAL(stats.begin()->second.maxNumOfSegments, 6, int);
+	PTF_ASSERT_EQUAL(oooStats.bufferedBytes, 0, u64);
+
+	// remove one packet. The data after it is reported with a missing data length instead of a text marker
+	packetStream.erase(packetStream.begin() + 29);
+	results.clear();
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	std::string expectedReassemblyData = readFileIntoString(std::string("PcapExamples/one_tcp_stream_missing_data_output_ooo.txt"));
+	PTF_ASSERT_EQUAL(stats.begin()->second.reassembledData, expectedReassemblyData, string);
+	PTF_ASSERT_TRUE(stats.begin()->second.maxNumOfSegments > 1);
+	PTF_ASSERT_TRUE(stats.begin()->second.connectionsEndedManually);
+} // TestTcpReassemblySegmentReferences
+
+
+
+PTF_TEST_CASE(TestTcpReassemblySharded)
+{
+	std::string errMsg;
+	std::vector<pcpp::RawPacket> packetStream;
+
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/three_http_streams.pcap", packetStream, errMsg));
+	std::vector<pcpp::RawPacket> morePackets;
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_tcp_stream.pcap", morePackets, errMsg));
+	packetStream.insert(packetStream.end(), morePackets.begin(), morePackets.end());
+	morePackets.clear();
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_ipv6_http_stream.pcap", morePackets, errMsg));
+	packetStream.insert(packetStream.end(), morePackets.begin(), morePackets.end());
+
+	TcpReassemblyMultipleConnStats expectedResults;
+	tcpReassemblyTest(packetStream, expectedResults, true, true);
+	PTF_ASSERT_EQUAL(expectedResults.stats.size(), 5, size);
+
+	// small rings, so the capture thread has to wait for the workers many times
+	pcpp::ShardedTcpReassemblyConfiguration config(4, 8, true);
+	ShardedTcpReassemblyStats shardedStats;
+	pcpp::ShardedTcpReassembly shardedReassembly(shardedTcpReassemblyMsgReadyCallback, &shardedStats, shardedTcpReassemblyConnectionStartCallback, shardedTcpReassemblyConnectionEndCallback, config);
+	PTF_ASSERT_EQUAL(shardedReassembly.getNumOfShards(), 4, size);
+
+	// packets can't be queued before the workers are started
+	pcpp::LoggerPP::getInstance().supressErrors();
+	PTF_ASSERT_FALSE(shardedReassembly.reassemblePacket(&packetStream[0]));
+	pcpp::LoggerPP::getInstance().enableErrors();
+
+	PTF_ASSERT_TRUE(shardedReassembly.start());
+	PTF_ASSERT_TRUE(shardedReassembly.isRunning());
+	for (std::vector<pcpp::RawPacket>::iterator iter = packetStream.begin(); iter != packetStream.end(); iter++)
+	{
+		PTF_ASSERT_TRUE(shardedReassembly.reassemblePacket(&(*iter)));
+	}
+	shardedReassembly.stop();
+	PTF_ASSERT_FALSE(shardedReassembly.isRunning());
+
+	uint64_t numOfHandledPackets = 0;
+	for (size_t i = 0; i < shardedReassembly.getNumOfShards(); i++)
+	{
+		numOfHandledPackets += shardedReassembly.getNumOfHandledPackets(i);
+		PTF_ASSERT_EQUAL(shardedReassembly.getNumOfDroppedPackets(i), 0, u64);
+	}
+	PTF_ASSERT_EQUAL(numOfHandledPackets, (uint64_t)packetStream.size(), u64);
+
+	// every connection is handled by one shard and gets exactly the data it gets from a single TcpReassembly
+	PTF_ASSERT_FALSE(shardedStats.shardMismatch);
+	TcpReassemblyMultipleConnStats::Stats& stats = shardedStats.results.stats;
+	PTF_ASSERT_EQUAL(stats.size(), expectedResults.stats.size(), size);
+	for (TcpReassemblyMultipleConnStats::Stats::iterator iter = expectedResults.stats.begin(); iter != expectedResults.stats.end(); iter++)
+	{
+		TcpReassemblyMultipleConnStats::Stats::iterator shardedIter = stats.find(iter->first);
+		PTF_ASSERT_TRUE(shardedIter != stats.end());
+		PTF_ASSERT_EQUAL(shardedIter->second.numOfDataPackets, iter->second.numOfDataPackets, int);
+		PTF_ASSERT_EQUAL(shardedIter->second.reassembledData, iter->second.reassembledData, string);
+		PTF_ASSERT_TRUE(shardedIter->second.connectionsStarted);
+		PTF_ASSERT_TRUE(shardedIter->second.connectionsEndedManually == iter->second.connectionsEndedManually);
+	}
+} // TestTcpReassemblySharded
+
+
+
+PTF_TEST_CASE(TestTcpReassemblyConnectionStatistics)
+{
+	std::string errMsg;
+	std::vector<pcpp::RawPacket> packetStream;
+
+	PTF_ASSERT_TRUE(readPcapIntoPacketVec("PcapExamples/one_tcp_stream.pcap", packetStream, errMsg));
+	size_t numOfPackets = packetStream.size();
+
+	// one retransmission with the exact same data, one out-of-order packet and one missing packet
+	pcpp::RawPacket retPacket = tcpReassemblyAddRetransmissions(packetStream.at(4), 0, 0);
+	packetStream.insert(packetStream.begin() + 5, retPacket);
+	std::swap(packetStream[10], packetStream[11]);
+	packetStream.erase(packetStream.begin() + 29);
+
+	TcpReassemblyMultipleConnStats results;
+	pcpp::TcpReassembly::OutOfOrderStatistics oooStats;
+	pcpp::TcpReassemblyConfiguration config;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+
+	// the counters stay 0 unless they're collected
+	TcpReassemblyMultipleConnStats::Stats &stats = results.stats;
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	PTF_ASSERT_EQUAL(stats.begin()->second.connDataAtEnd.sideStats[0].numOfPackets, 0, u64);
+	PTF_ASSERT_EQUAL(stats.begin()->second.connDataAtEnd.sideStats[1].numOfPackets, 0, u64);
+
+	results.clear();
+	config.collectConnectionStatistics = true;
+	tcpReassemblyTestWithConfig(packetStream, results, config, oooStats);
+	PTF_ASSERT_EQUAL(stats.size(), 1, size);
+	const pcpp::ConnectionData& connData = stats.begin()->second.connDataAtEnd;
+	const pcpp::ConnectionData::SideStatistics& side0 = connData.sideStats[0];
+	const pcpp::ConnectionData::SideStatistics& side1 = connData.sideStats[1];
+
+	// pure ACKs are counted too. Side 0 has 3 retransmissions of its own besides the one added above
+	PTF_ASSERT_EQUAL(side0.numOfPackets, 19, u64);
+	PTF_ASSERT_EQUAL(side0.numOfBytes, 14209, u64);
+	PTF_ASSERT_EQUAL(side0.numOfRetransmittedPackets, 4, u64);
+	PTF_ASSERT_EQUAL(side0.numOfOutOfOrderPackets, 0, u64);
+	PTF_ASSERT_EQUAL(side0.numOfGaps, 0, u64);
+	PTF_ASSERT_EQUAL(side0.peakOutOfOrderBytes, 0, u64);
+
+	// the swapped packet and the 4 packets after the missing one are buffered, and the missing packet is found when the connection is closed
+	PTF_ASSERT_EQUAL(side1.numOfPackets, 17, u64);
+	PTF_ASSERT_EQUAL(side1.numOfBytes, 11084, u64);
+	PTF_ASSERT_EQUAL(side1.numOfRetransmittedPackets, 0, u64);
+	PTF_ASSERT_EQUAL(side1.numOfOutOfOrderPackets, 5, u64);
+	PTF_ASSERT_EQUAL(side1.numOfGaps, 1, u64);
+	PTF_ASSERT_EQUAL(side1.numOfMissingBytes, 1360, u64);
+	PTF_ASSERT_EQUAL(side1.peakOutOfOrderBytes, 4196, u64);
+	PTF_ASSERT_EQUAL(side0.numOfPackets + side1.numOfPackets, numOfPackets, u64);
+
+	PTF_ASSERT_EQUAL(connData.startTimePrecise.tv_sec, 1491516383, u64);
+	PTF_ASSERT_EQUAL(connData.startTimePrecise.tv_nsec, 915793000, u64);
+	PTF_ASSERT_EQUAL(connData.startTime.tv_usec, 915793, u64);
+	PTF_ASSERT_EQUAL(connData.endTimePrecise.tv_sec, 1491516399, u64);
+	PTF_ASSERT_EQUAL(connData.endTimePrecise.tv_nsec, 576245000, u64);
+	PTF_ASSERT_EQUAL(connData.endTime.tv_usec, 576245, u64);
+} // TestTcpReassemblyConnectionStatistics
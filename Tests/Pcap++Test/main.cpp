@@ -205,6 +205,11 @@ int main(int argc, char* argv[])
 	PTF_RUN_TEST(TestPcapSllFileReadWrite, "no_network;pcap");
 	PTF_RUN_TEST(TestPcapRawIPFileReadWrite, "no_network;pcap");
 	PTF_RUN_TEST(TestPcapFileAppend, "no_network;pcap");
+	PTF_RUN_TEST(TestMmapPcapFileRead, "no_network;pcap");
+	PTF_RUN_TEST(TestPcapFileReadBatch, "no_network;pcap");
+	PTF_RUN_TEST(TestBufferedPcapFileWrite, "no_network;pcap");
+	PTF_RUN_TEST(TestBufferedPcapFileRead, "no_network;pcap");
+	PTF_RUN_TEST(TestParallelPcapFileRead, "no_network;pcap");
 	PTF_RUN_TEST(TestPcapNgFileReadWrite, "no_network;pcap;pcapng");
 	PTF_RUN_TEST(TestPcapNgFileReadWriteAdv, "no_network;pcap;pcapng");
 
@@ -243,6 +248,7 @@ int main(int argc, char* argv[])
 	PTF_RUN_TEST(TestDpdkDeviceSendPackets, "dpdk");
 	PTF_RUN_TEST(TestDpdkDeviceWorkerThreads, "dpdk");
 	PTF_RUN_TEST(TestDpdkMbufRawPacket, "dpdk");
+	PTF_RUN_TEST(TestDpdkChecksumOffload, "dpdk");
 
 	PTF_RUN_TEST(TestKniDevice, "dpdk;kni;skip_mem_leak_check");
 	PTF_RUN_TEST(TestKniDeviceSendReceive, "dpdk;kni;skip_mem_leak_check");
@@ -259,6 +265,12 @@ int main(int argc, char* argv[])
 	PTF_RUN_TEST(TestTcpReassemblyIPv6_OOO, "no_network;tcp_reassembly");
 	PTF_RUN_TEST(TestTcpReassemblyCleanup, "no_network;tcp_reassembly");
 	PTF_RUN_TEST(TestTcpReassemblyMaxSeq, "no_network;tcp_reassembly");
+	PTF_RUN_TEST(TestTcpReassemblyOutOfOrderWrapAround, "no_network;tcp_reassembly");
+	PTF_RUN_TEST(TestTcpReassemblyIdleTimeout, "no_network;tcp_reassembly");
+	PTF_RUN_TEST(TestTcpReassemblyOutOfOrderLimits, "no_network;tcp_reassembly");
+	PTF_RUN_TEST(TestTcpReassemblySegmentReferences, "no_network;tcp_reassembly");
+	PTF_RUN_TEST(TestTcpReassemblySharded, "no_network;tcp_reassembly");
+	PTF_RUN_TEST(TestTcpReassemblyConnectionStatistics, "no_network;tcp_reassembly");
 
 	PTF_RUN_TEST(TestIPFragmentationSanity, "no_network;ip_frag");
 	PTF_RUN_TEST(TestIPFragOutOfOrder, "no_network;ip_frag");
@@ -266,6 +278,8 @@ int main(int argc, char* argv[])
 	PTF_RUN_TEST(TestIPFragMultipleFrags, "no_network;ip_frag");
 	PTF_RUN_TEST(TestIPFragMapOverflow, "no_network;ip_frag");
 	PTF_RUN_TEST(TestIPFragRemove, "no_network;ip_frag");
+	PTF_RUN_TEST(TestIPFragPooledBuffers, "no_network;ip_frag");
+	PTF_RUN_TEST(TestIPFragTimeout, "no_network;ip_frag");
 
 	PTF_RUN_TEST(TestRawSockets, "raw_sockets");
 